@@ -0,0 +1,87 @@
+/*
+ * adcDmaSim.c
+ */
+
+// Host implementation of adcDma.h. A simulated DMA engine that behaves like the PL330 program in adcDma.c:
+// every request writes one XADC data-register value into the current half of a double buffer, a full half
+// raises the done interrupt and the engine carries on in the other half. The done interrupt finds the
+// finished half the same way adcDmaIsr() does (from where the engine is writing now) and hands it to the
+// same isr_addXadcBlockToAdcBuffer(), so everything from the ADC buffer on is the real code.
+
+#include "adcDma.h"
+#include "halSim.h"
+#include "isr.h"
+#include "supportFiles/interrupts.h"
+
+#define XADC_DATA_SHIFT 4	// interrupts_getAdcData() drops these bits, the data register still has them.
+
+static uint32_t dmaBuffer[2][ADCDMA_BLOCK_SIZE];
+static bool running = false;
+static uint32_t writeHalf;				// Half the engine is writing, what the destination address register shows.
+static uint32_t writeIndex;
+static bool interruptPending = false;	// Like the PL330's interrupt status bit: several events are one interrupt.
+static uint32_t interruptCountdown;
+static uint32_t interruptLatency = 0;
+static uint32_t blockCount;
+static uint32_t lateBlockCount;
+static uint32_t lastFinishedHalf = 1;	// As if half 1 was just handled, the first block is half 0.
+
+// Same as adcDmaIsr() in adcDma.c.
+static void adcDmaIsr() {
+	uint32_t finishedHalf = writeHalf ^ 1;
+	if (finishedHalf == lastFinishedHalf)
+		lateBlockCount++;
+	lastFinishedHalf = finishedHalf;
+	isr_addXadcBlockToAdcBuffer(dmaBuffer[finishedHalf], ADCDMA_BLOCK_SIZE);
+	blockCount++;
+}
+
+void halSim_adcDmaRequest() {
+	if (!running)
+		return;
+	dmaBuffer[writeHalf][writeIndex] = interrupts_getAdcData() << XADC_DATA_SHIFT;
+	if (++writeIndex == ADCDMA_BLOCK_SIZE) {
+		writeIndex = 0;
+		writeHalf ^= 1;
+		if (!interruptPending) {
+			interruptPending = true;
+			interruptCountdown = interruptLatency;
+		}
+	}
+	if (interruptPending && interruptCountdown-- == 0) {
+		interruptPending = false;
+		adcDmaIsr();
+	}
+}
+
+void halSim_setAdcDmaInterruptLatency(uint32_t requestCount) {
+	interruptLatency = requestCount;
+}
+
+int adcDma_init() {
+	running = false;
+	return 0;
+}
+
+void adcDma_start() {
+	blockCount = 0;
+	lateBlockCount = 0;
+	lastFinishedHalf = 1;
+	writeHalf = 0;
+	writeIndex = 0;
+	interruptPending = false;
+	running = true;
+}
+
+void adcDma_stop() {
+	running = false;
+	interruptPending = false;
+}
+
+uint32_t adcDma_getBlockCount() {
+	return blockCount;
+}
+
+uint32_t adcDma_getLateBlockCount() {
+	return lateBlockCount;
+}
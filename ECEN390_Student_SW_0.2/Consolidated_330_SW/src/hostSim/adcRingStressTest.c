@@ -0,0 +1,99 @@
+/*
+ * adcRingStressTest.c
+ */
+
+// Host-only two-thread stress test for adcRing (src/laserTag/adcRing.c).
+// src/hostSim is excluded from the ZYBO build in .cproject. To build and run it on a Linux host,
+// from Consolidated_330_SW:
+//   g++ -O2 -x c++ -Isrc/laserTag src/laserTag/adcRing.c src/hostSim/adcRingStressTest.c -o adcRingStressTest -lpthread
+//   ./adcRingStressTest
+// The producer thread pushes as fast as it can, the consumer thread drains the ring with peekSpan()/consume(),
+// the same way detector_processBlock() does. Each accepted push carries the next value of a 16-bit sequence,
+// so the consumer must see 0, 1, 2, ... (mod 2^16) with nothing missing or repeated. Runs twice:
+// 1. Lossy: full rings drop the sample, so accepted + overflowCount must equal attempted.
+// 2. Lossless: the producer retries until the push succeeds, so every sample must be accepted.
+
+#include "adcRing.h"
+#include <stdio.h>
+#include <pthread.h>
+
+#define STRESS_TEST_SAMPLE_COUNT 200000000UL	// Wraps the ring about 1500 times.
+
+static adcRing_t ring;
+static volatile bool producerDone = false;
+static bool producerRetries = false;	// true for the lossless run.
+static uint64_t acceptedCount;			// Written by the producer thread, read after the join.
+
+static void* producer(void* arg) {
+	(void)arg;
+	acceptedCount = 0;
+	for (uint64_t i=0; i<STRESS_TEST_SAMPLE_COUNT; i++) {
+		bool accepted;
+		while (!(accepted = adcRing_push(&ring, (adcRing_data_t) acceptedCount)) && producerRetries)
+			;
+		if (accepted)
+			acceptedCount++;
+	}
+	ADCRING_RELEASE_BARRIER();
+	producerDone = true;
+	return NULL;
+}
+
+// Counts are kept by the consumer thread, runTest() reads them after the join.
+static uint64_t consumedCount;
+static uint64_t sequenceErrorCount;	// Values that were not the next one in the sequence.
+static uint64_t spanCount;
+
+static void* consumer(void* arg) {
+	(void)arg;
+	adcRing_data_t expectedValue = 0;
+	while (true) {
+		bool done = producerDone;	// Read before the span so that nothing pushed before done is missed.
+		ADCRING_ACQUIRE_BARRIER();
+		const adcRing_data_t* span;
+		uint32_t count = adcRing_peekSpan(&ring, &span);
+		if (!count) {
+			if (done)
+				break;
+			continue;
+		}
+		for (uint32_t i=0; i<count; i++) {
+			if (span[i] != expectedValue)
+				sequenceErrorCount++;
+			expectedValue = span[i] + 1;	// Resynchronize so that one error is only counted once.
+		}
+		adcRing_consume(&ring, count);
+		consumedCount += count;
+		spanCount++;
+	}
+	return NULL;
+}
+
+static bool runTest(bool lossless) {
+	adcRing_init(&ring);
+	producerDone = false;
+	producerRetries = lossless;
+	consumedCount = sequenceErrorCount = spanCount = 0;
+	pthread_t producerThread, consumerThread;
+	pthread_create(&consumerThread, NULL, consumer, NULL);
+	pthread_create(&producerThread, NULL, producer, NULL);
+	pthread_join(producerThread, NULL);
+	pthread_join(consumerThread, NULL);
+	uint32_t overflowCount = adcRing_getOverflowCount(&ring);	// Counts failed retries in the lossless run.
+	printf("%s: pushed %lu, accepted %llu, consumed %llu in %llu spans, overflows %u, high watermark %u\n",
+			lossless ? "lossless" : "lossy", STRESS_TEST_SAMPLE_COUNT, (unsigned long long) acceptedCount,
+			(unsigned long long) consumedCount, (unsigned long long) spanCount, overflowCount, adcRing_getHighWatermark(&ring));
+	uint64_t expectedAccepted = lossless ? STRESS_TEST_SAMPLE_COUNT : STRESS_TEST_SAMPLE_COUNT - overflowCount;
+	bool success = sequenceErrorCount == 0 && acceptedCount == expectedAccepted &&
+			consumedCount == acceptedCount && adcRing_elementCount(&ring) == 0;
+	if (!success)
+		printf("sequence errors %llu\n", (unsigned long long) sequenceErrorCount);
+	return success;
+}
+
+int main() {
+	bool success = runTest(false);
+	success &= runTest(true);
+	printf("adcRing stress test %s.\n", success ? "passed" : "failed");
+	return success ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * adcStorageBenchmark.c
+ */
+
+// Host-only replay benchmark: the old 32-bit ADC buffer vs. the packed 16-bit adcRing.
+// src/hostSim is excluded from the ZYBO build in .cproject. To build and run it on a Linux host,
+// from Consolidated_330_SW:
+//   g++ -O2 -x c++ -Isrc/laserTag src/laserTag/adcRing.c src/hostSim/adcStorageBenchmark.c -o adcStorageBenchmark
+//   ./adcStorageBenchmark
+// Replays a synthesized capture (a player frequency plus noise, 12-bit) through both kinds of storage the way
+// the ZYBO does: the "ISR" adds one sample at a time and the "detector" drains everything every DRAIN_PERIOD
+// samples and converts each sample to float in a stand-in for the FIR kernel.
+// 1. Old: uint32_t[100000] with % indexing, each sample went through a double on the way in (isr_function()).
+// 2. New: adcRing_t with uint16_t samples, drained in place with peekSpan()/consume().
+// Prints the storage size, the time, and the cache misses from perf_event_open() (if the kernel allows it).
+
+#include "adcRing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define REPLAY_SAMPLE_COUNT 10000000UL	// 100 seconds at 100 kHz.
+#define DRAIN_PERIOD 1000				// Detector runs every 10 ms worth of samples.
+#define ADC_MAX 4095
+#define REPLAY_PERIOD_TICKS 45			// Player 0 half-period in 100 kHz ticks (see transmitter.c).
+#define OLD_ADC_BUFFER_SIZE 100000
+#define A9_CACHE_LINE_SIZE 32
+
+// The old buffer from isr.c, element count and all.
+typedef struct {
+	uint32_t indexIn;
+	uint32_t indexOut;
+	uint32_t data[OLD_ADC_BUFFER_SIZE];
+	uint32_t elementCount;
+} oldAdcBuffer_t;
+
+static oldAdcBuffer_t oldBuffer;
+static adcRing_t newRing;
+static uint16_t capture[REPLAY_SAMPLE_COUNT];
+
+/*========================= perf_event_open() counters =========================*/
+
+typedef enum {COUNTER_CACHE_MISSES, COUNTER_L1D_READ_MISSES, COUNTER_COUNT} counter_t;
+static const char* counterNames[COUNTER_COUNT] = {"cache misses (LLC)", "L1D read misses"};
+static int counterFd[COUNTER_COUNT];
+
+static void openCounters() {
+	struct perf_event_attr attr;
+	for (int i=0; i<COUNTER_COUNT; i++) {
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		if (i == COUNTER_CACHE_MISSES) {
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		} else {
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		}
+		counterFd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);	// -1 if not allowed (e.g., in a container).
+	}
+}
+
+static void startCounters() {
+	for (int i=0; i<COUNTER_COUNT; i++) {
+		if (counterFd[i] < 0)
+			continue;
+		ioctl(counterFd[i], PERF_EVENT_IOC_RESET, 0);
+		ioctl(counterFd[i], PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+static void stopCounters(long long counts[]) {
+	for (int i=0; i<COUNTER_COUNT; i++) {
+		counts[i] = -1;
+		if (counterFd[i] < 0)
+			continue;
+		ioctl(counterFd[i], PERF_EVENT_IOC_DISABLE, 0);
+		if (read(counterFd[i], &counts[i], sizeof(counts[i])) != sizeof(counts[i]))
+			counts[i] = -1;
+	}
+}
+
+static double seconds() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1.0E-9;
+}
+
+/*=============================== Replay ==============================*/
+
+// Stand-in for the FIR kernel: converts to -1.0 .. 1.0 and accumulates, so every sample is read once as float.
+static float kernelSum;
+static inline void kernel(float x) {
+	kernelSum += x * x;
+}
+
+// Old path. Same code as the old isr.c/detector(), without the interrupt masking.
+static void replayOld() {
+	memset(&oldBuffer, 0, sizeof(oldBuffer));
+	for (uint32_t i=0; i<REPLAY_SAMPLE_COUNT; i++) {
+		double adcData = (double) capture[i];	// isr_function() went through queue_data_t.
+		if (oldBuffer.elementCount < OLD_ADC_BUFFER_SIZE)
+			oldBuffer.elementCount++;
+		oldBuffer.data[oldBuffer.indexIn] = adcData;
+		oldBuffer.indexIn = (oldBuffer.indexIn + 1) % OLD_ADC_BUFFER_SIZE;
+		if (oldBuffer.indexIn == oldBuffer.indexOut)
+			oldBuffer.indexOut = (oldBuffer.indexOut + 1) % OLD_ADC_BUFFER_SIZE;
+		if ((i+1) % DRAIN_PERIOD)
+			continue;
+		uint32_t elementCount = oldBuffer.elementCount;
+		for (uint32_t j=0; j<elementCount; j++) {
+			uint32_t raw = oldBuffer.data[oldBuffer.indexOut];
+			oldBuffer.indexOut = (oldBuffer.indexOut + 1) % OLD_ADC_BUFFER_SIZE;
+			oldBuffer.elementCount--;
+			kernel((float) ((raw * 1.0 / ADC_MAX) * 2 - 1));
+		}
+	}
+}
+
+// New path. Same code as isr.c/detector_processBlock().
+static void replayNew() {
+	adcRing_init(&newRing);
+	const float scale = 2.0f / ADC_MAX;
+	for (uint32_t i=0; i<REPLAY_SAMPLE_COUNT; i++) {
+		adcRing_push(&newRing, capture[i]);
+		if ((i+1) % DRAIN_PERIOD)
+			continue;
+		const adcRing_data_t* span;
+		uint32_t spanCount;
+		while ((spanCount = adcRing_peekSpan(&newRing, &span)) != 0) {
+			for (uint32_t j=0; j<spanCount; j++)
+				kernel(span[j] * scale - 1.0f);
+			adcRing_consume(&newRing, spanCount);
+		}
+	}
+}
+
+static void report(const char* name, size_t storageBytes, void (*replay)()) {
+	long long counts[COUNTER_COUNT];
+	kernelSum = 0;
+	startCounters();
+	double start = seconds();
+	replay();
+	double elapsed = seconds() - start;
+	stopCounters(counts);
+	printf("%s: storage %lu bytes, %.1lf ns/sample", name, (unsigned long) storageBytes, elapsed * 1.0E9 / REPLAY_SAMPLE_COUNT);
+	for (int i=0; i<COUNTER_COUNT; i++) {
+		if (counts[i] < 0)
+			printf(", %s n/a", counterNames[i]);
+		else
+			printf(", %s %lld", counterNames[i], counts[i]);
+	}
+	printf(" (checksum %g)\n", kernelSum);
+}
+
+int main() {
+	// Synthesize the capture: square wave at mid-scale, +/- 1/4 scale, plus a little noise.
+	srand(1);
+	for (uint32_t i=0; i<REPLAY_SAMPLE_COUNT; i++) {
+		int level = ((i / REPLAY_PERIOD_TICKS) & 1) ? 3 * ADC_MAX / 4 : ADC_MAX / 4;
+		capture[i] = level + (rand() % 64) - 32;
+	}
+	openCounters();
+	report("old uint32_t buffer", sizeof(oldAdcBuffer_t), replayOld);
+	report("new uint16_t adcRing", sizeof(adcRing_t), replayNew);
+	printf("Sample storage: %lu bytes per sample vs. %lu, %lu bytes of bss saved.\n",
+			(unsigned long) sizeof(oldBuffer.data[0]), (unsigned long) sizeof(adcRing_data_t),
+			(unsigned long) (sizeof(oldAdcBuffer_t) - sizeof(adcRing_t)));
+	printf("At 100 kHz the detector reads %lu vs. %lu %d-byte cache lines per second on the ZYBO.\n",
+			100000UL * sizeof(oldBuffer.data[0]) / A9_CACHE_LINE_SIZE, 100000UL * sizeof(adcRing_data_t) / A9_CACHE_LINE_SIZE,
+			A9_CACHE_LINE_SIZE);
+	return 0;
+}
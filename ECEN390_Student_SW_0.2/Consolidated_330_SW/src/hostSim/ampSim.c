@@ -0,0 +1,45 @@
+/*
+ * ampSim.c
+ */
+
+// Host side of the amp.h platform calls: CPU1 is a second thread running amp_cpu1Main(), and the shared memory is
+// plain statics, which both threads see (x86 keeps its caches coherent, the adcRing.h barriers order the accesses).
+// Link with -lpthread.
+
+#include "amp.h"
+#include <pthread.h>
+#include <sched.h>
+
+static amp_shared_t shared;
+static adcRing_t adcRing;
+static pthread_t cpu1Thread;
+
+static void* cpu1ThreadMain(void* argument) {
+	(void)argument;
+	amp_cpu1Main();
+	return NULL;
+}
+
+void amp_platformInit() {
+}
+
+amp_shared_t* amp_platformShared() {
+	return &shared;
+}
+
+adcRing_t* amp_platformAdcRing() {
+	return &adcRing;
+}
+
+void amp_platformStartCpu1() {
+	pthread_create(&cpu1Thread, NULL, cpu1ThreadMain, NULL);
+}
+
+void amp_platformWaitForCpu1() {
+	pthread_join(cpu1Thread, NULL);
+}
+
+// The host may have fewer cores than threads, so let the other side run.
+void amp_platformIdle() {
+	sched_yield();
+}
@@ -0,0 +1,132 @@
+/*
+ * barGraphTest.c
+ */
+
+// Host-only check of barGraph.c. Build it from Consolidated_330_SW:
+//   g++ -O2 -x c++ -I. -Isrc/laserTag src/laserTag/barGraph.c src/hostSim/barGraphTest.c -o barGraphTest
+//   ./barGraphTest [-f frames] [-r seed]
+//
+// The display calls are replaced by a 320x240 framebuffer. After every flush the framebuffer is saved, filled with
+// garbage, and barGraph_redrawAll() paints it again from scratch; the two have to be identical, i.e., the deltas the
+// flush drew add up to the same screen as a full redraw. Three kinds of frames are run:
+// - power: all bars move a little and labels change a digit or two, like continuousPowerMode().
+// - hit: one bar's count goes up and every bar is rescaled, like shooterMode().
+// - random: any height, label and color, to hit the color-change and clamping paths.
+// Pixels sent per flush are reported against what barGraph_redrawAll() sends.
+
+#include "barGraph.h"
+#include "supportFiles/display.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_WIDTH 320
+#define TEST_HEIGHT 240
+#define TEST_BAR_COUNT 10
+#define TEST_DEFAULT_FRAME_COUNT 20000
+#define TEST_LABEL_BUFFER_SIZE 16			// Room for any number, barGraph_setBar() cuts what does not fit.
+#define TEST_GARBAGE_COLOR 0x1234
+
+static uint16_t framebuffer[TEST_HEIGHT][TEST_WIDTH];
+static uint16_t savedFramebuffer[TEST_HEIGHT][TEST_WIDTH];
+
+int16_t display_width() {return TEST_WIDTH;}
+int16_t display_height() {return TEST_HEIGHT;}
+
+void display_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+	for (int16_t row=y; row<y+h; row++)
+		for (int16_t column=x; column<x+w; column++)
+			if (row >= 0 && row < TEST_HEIGHT && column >= 0 && column < TEST_WIDTH)
+				framebuffer[row][column] = color;
+}
+
+// Not the real font, any pattern that differs between characters will do.
+void display_drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t /*size*/) {
+	for (int16_t i=0; i<6; i++)
+		for (int16_t j=0; j<8; j++)
+			if (y+j < TEST_HEIGHT && x+i < TEST_WIDTH)
+				framebuffer[y+j][x+i] = ((c * 31 + i * 7 + j * 13) & 3) ? bg : color;
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t frameCount = TEST_DEFAULT_FRAME_COUNT;
+	unsigned int seed = 1;
+	int option;
+	while ((option = getopt(argc, argv, "f:r:")) != -1) {
+		if (option == 'f')
+			frameCount = strtoul(optarg, NULL, 0);
+		else if (option == 'r')
+			seed = strtoul(optarg, NULL, 0);
+		else {
+			fprintf(stderr, "usage: %s [-f frames] [-r seed]\n", argv[0]);
+			return 1;
+		}
+	}
+	srand(seed);
+	barGraph_init(TEST_BAR_COUNT);
+	uint16_t maxHeight = barGraph_getMaxBarHeight();
+	uint32_t fullRedrawPixels = barGraph_redrawAll();
+	printf("%d bars, max height %d, %d label chars, full redraw %lu pixels\n", TEST_BAR_COUNT, maxHeight,
+			barGraph_getLabelChars(), (unsigned long) fullRedrawPixels);
+	const char* kindNames[] = {"power", "hit", "random"};
+	uint64_t kindPixels[3] = {0};
+	uint32_t kindFrames[3] = {0};
+	uint32_t mismatches = 0;
+	uint16_t heights[TEST_BAR_COUNT] = {0};
+	uint32_t hitCounts[TEST_BAR_COUNT] = {0};
+	for (uint32_t frame=0; frame<frameCount; frame++) {
+		uint16_t kind = (frame / 1000) % 3;
+		char label[TEST_LABEL_BUFFER_SIZE];
+		if (kind == 0) {
+			for (uint16_t i=0; i<TEST_BAR_COUNT; i++) {
+				int32_t height = heights[i] + rand() % 21 - 10;
+				heights[i] = height < 0 ? 0 : height > maxHeight ? maxHeight : height;
+				snprintf(label, sizeof(label), "%d+%02d", 1 + heights[i] / 25, heights[i] % 8);
+				barGraph_setBar(i, heights[i], label);
+			}
+		} else if (kind == 1) {
+			hitCounts[rand() % TEST_BAR_COUNT]++;
+			uint32_t maxCount = 1;
+			for (uint16_t i=0; i<TEST_BAR_COUNT; i++)
+				if (hitCounts[i] > maxCount)
+					maxCount = hitCounts[i];
+			for (uint16_t i=0; i<TEST_BAR_COUNT; i++) {
+				snprintf(label, sizeof(label), "%lu", (unsigned long) hitCounts[i]);
+				barGraph_setBar(i, (uint64_t) hitCounts[i] * maxHeight / maxCount, label);
+			}
+		} else {
+			uint16_t i = rand() % TEST_BAR_COUNT;
+			uint16_t height = rand() % (maxHeight + 20);
+			snprintf(label, sizeof(label), "%d", rand() % 100000000);
+			bool inRange = barGraph_setBar(i, height, rand() % 4 ? label : NULL);
+			if (inRange != (height <= maxHeight)) {
+				printf("frame %lu: setBar(%d) returned %d\n", (unsigned long) frame, height, inRange);
+				mismatches++;
+			}
+			if (!(rand() % 8))
+				barGraph_setBarColor(rand() % TEST_BAR_COUNT, rand() % 2 ? DISPLAY_BLUE : DISPLAY_RED);
+		}
+		kindPixels[kind] += barGraph_flush();
+		kindFrames[kind]++;
+		memcpy(savedFramebuffer, framebuffer, sizeof(framebuffer));
+		for (uint16_t row=0; row<TEST_HEIGHT; row++)
+			for (uint16_t column=0; column<TEST_WIDTH; column++)
+				framebuffer[row][column] = TEST_GARBAGE_COLOR;
+		barGraph_redrawAll();
+		if (memcmp(savedFramebuffer, framebuffer, sizeof(framebuffer))) {
+			if (mismatches < 10)
+				printf("frame %lu (%s): flush and full redraw differ\n", (unsigned long) frame, kindNames[kind]);
+			mismatches++;
+		}
+	}
+	for (uint16_t kind=0; kind<3; kind++) {
+		if (!kindFrames[kind])
+			continue;
+		double meanPixels = (double) kindPixels[kind] / kindFrames[kind];
+		printf("%-6s %6lu frames, %8.0f pixels per flush, %5.1f%% of a full redraw\n", kindNames[kind],
+				(unsigned long) kindFrames[kind], meanPixels, 100.0 * meanPixels / fullRedrawPixels);
+	}
+	printf(mismatches ? "barGraphTest failed, %lu mismatches.\n" : "barGraphTest passed.\n", (unsigned long) mismatches);
+	return mismatches != 0;
+}
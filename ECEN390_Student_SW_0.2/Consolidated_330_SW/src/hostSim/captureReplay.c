@@ -0,0 +1,110 @@
+/*
+ * captureReplay.c
+ */
+
+// Host-only replay of a capture file (see capture.h) through the real isr_function()/detector() code.
+// The file can come from the ZYBO (capture_initUartSink(), saved from the terminal) or from laserTagSim -w.
+// Build it like laserTagSim, with captureReplay.c in place of laserTagSim.c (one command, split over lines here):
+//   g++ -O2 -x c++ -Isrc/hostSim -I. -Isrc/laserTag -I../HW3_bsp/ps7_cortexa9_0/include
+//     src/laserTag/isr.c src/laserTag/detector.c src/laserTag/filter.c src/laserTag/filterFixed.c src/laserTag/iirBank.c
+//     src/laserTag/windowedEnergy.c src/laserTag/slidingDft.c src/laserTag/orderStats.c src/laserTag/capture.c
+//     src/laserTag/staticQueue.c src/laserTag/queue.c src/laserTag/adcRing.c src/laserTag/timerService.c
+//     src/laserTag/transmitter.c src/laserTag/trigger.c src/laserTag/lockoutTimer.c src/laserTag/hitLedTimer.c
+//     src/laserTag/profiler.c src/laserTag/inputs.c src/hostSim/halSim.c src/hostSim/captureReplay.c -o captureReplay
+//   ./captureReplay captureFile
+//
+// Every recorded block is fed through isr_function() one sample at a time and then detector() runs, so the detector
+// sees the same blocks that it did when the capture was made. If the capture has the power, the replayed power is
+// compared against it after every block. A different coefficient hash only gets a warning: replaying with new
+// filters is the point of capturing in the first place.
+
+#include "halSim.h"
+#include "isr.h"
+#include "detector.h"
+#include "filter.h"
+#include "capture.h"
+#include "supportFiles/globalTimer.h"
+#include <stdio.h>
+#include <math.h>
+
+#define REPLAY_TICKS_PER_SECOND 100000	// isr_function() rate, one sample per call.
+#define REPLAY_POWER_TOLERANCE 1.0E-4	// Relative, the capture stores the power as float.
+
+int main(int argc, char* argv[]) {
+	if (argc != 2) {
+		printf("usage: %s captureFile\n", argv[0]);
+		return 2;
+	}
+	FILE* file = fopen(argv[1], "rb");
+	if (!file) {
+		printf("Cannot open %s.\n", argv[1]);
+		return 2;
+	}
+	capture_header_t header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION ||
+			header.headerSize < sizeof(header)) {
+		printf("%s is not a version %d capture.\n", argv[1], CAPTURE_VERSION);
+		return 2;
+	}
+	fseek(file, header.headerSize, SEEK_SET);
+	if (header.channelCount != FILTER_IIR_FILTER_COUNT || header.decimationFactor != FILTER_FIR_DECIMATION_FACTOR) {
+		printf("Capture has %u channels decimated by %u, the detector has %d decimated by %d.\n",
+				header.channelCount, header.decimationFactor, FILTER_IIR_FILTER_COUNT, FILTER_FIR_DECIMATION_FACTOR);
+		return 2;
+	}
+	if (header.coefficientHash != capture_coefficientHash())
+		printf("Warning: the capture was made with different filter coefficients, the power will not match.\n");
+	printf("Capture: %u Hz, flags 0x%x.\n", header.sampleRateHz, header.flags);
+	isr_init();
+	detector_init();
+	uint32_t blockCount = 0, sampleCount = 0, overflowCount = 0, powerMismatchCount = 0;
+	double maxPowerError = 0.0;
+	static uint16_t samples[UINT16_MAX + 1];
+	capture_blockHeader_t blockHeader;
+	while (fread(&blockHeader, sizeof(blockHeader), 1, file) == 1) {
+		if (blockHeader.magic != CAPTURE_BLOCK_MAGIC) {
+			printf("Bad block magic after %u blocks, stopping.\n", blockCount);
+			break;
+		}
+		uint32_t paddedCount = (blockHeader.sampleCount + 1) & ~1;
+		float power[FILTER_IIR_FILTER_COUNT];
+		if (fread(samples, sizeof(uint16_t), paddedCount, file) != paddedCount || blockHeader.powerCount > FILTER_IIR_FILTER_COUNT ||
+				fread(power, sizeof(float), blockHeader.powerCount, file) != blockHeader.powerCount) {
+			printf("Truncated block after %u blocks, stopping.\n", blockCount);
+			break;
+		}
+		if (blockHeader.firstSampleIndex != sampleCount)
+			printf("Block %u starts at sample %u, expected %u.\n", blockCount, blockHeader.firstSampleIndex, sampleCount);
+		overflowCount = blockHeader.adcOverflowCount;
+		for (uint32_t i=0; i<blockHeader.sampleCount; i++) {
+			halSim_setAdcData(samples[i]);
+			// Simulated time, so the lockout and hit LED timers the detector starts last as long as they did.
+			halSim_setGlobalTimerValue((uint64_t) (sampleCount + i) * (GLOBAL_TIMER_TICKS_PER_SECOND / REPLAY_TICKS_PER_SECOND));
+			isr_function();
+		}
+		detector();
+		for (uint16_t i=0; i<blockHeader.powerCount; i++) {
+			double replayed = filter_getCurrentPowerValue(i);
+			double error = fabs(replayed - power[i]) / fmax(fabs((double) power[i]), 1.0E-30);
+			if (error > maxPowerError)
+				maxPowerError = error;
+			if (error > REPLAY_POWER_TOLERANCE)
+				powerMismatchCount++;
+		}
+		blockCount++;
+		sampleCount += blockHeader.sampleCount;
+	}
+	fclose(file);
+	detector_hitCount_t hitCounts[FILTER_IIR_FILTER_COUNT];
+	detector_getHitCounts(hitCounts);
+	printf("Replayed %u blocks, %u samples (%.2lf s). ADC buffer overflows while capturing: %u.\n",
+			blockCount, sampleCount, (double) sampleCount / header.sampleRateHz, overflowCount);
+	printf("Hits:");
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		printf(" %lu", (unsigned long) hitCounts[i]);
+	printf("\n");
+	if (header.flags & CAPTURE_FLAG_POWER)
+		printf("Power: max relative error %le, %u values off by more than %le.\n",
+				maxPowerError, powerMismatchCount, REPLAY_POWER_TOLERANCE);
+	return powerMismatchCount ? 1 : 0;
+}
@@ -0,0 +1,474 @@
+/*
+ * channelPlanGenerator.c
+ */
+
+// Host-only generator of the tables for a channel plan (detectorCore.h): the transmitter half-periods, the decimating
+// FIR, and each player's IIR filter as biquads. Writes a header like src/laserTag/channelPlan16.h to stdout and a
+// summary of the filters to stderr. Build it from Consolidated_330_SW:
+//   g++ -O2 -x c++ src/hostSim/channelPlanGenerator.c -o channelPlanGenerator
+//   ./channelPlanGenerator [-n name] [-c channels] [-r sampleRateHz] [-d decimation] [-t firTaps] [-l lowestHz]
+//     [-h highestHz] [-f hz,hz,...] [-b bandwidthHz] [-w windowSeconds] > src/laserTag/channelPlanName.h
+// The defaults are the sizes of channelPlan.h (but not its half-periods, which were picked by hand). The checked-in
+// plans were made with:
+//   ./channelPlanGenerator -n 16 -c 16 > src/laserTag/channelPlan16.h
+//   ./channelPlanGenerator -n 20 -c 20 -r 200000 -d 20 -t 45 -b 30 > src/laserTag/channelPlan20.h
+// 20 players crowd the low end, so that plan uses narrower filters to keep its neighbors 40 dB down.
+//
+// The design follows the one behind the tables in filter.c:
+// - Players: the half-periods (in ADC samples, what the transmitter counts) are spread geometrically from lowestHz to
+//   highestHz and rounded, and each filter is centered on the frequency its half-period really gives. -f sets the
+//   centers instead (the half-periods are still rounded from them).
+// - FIR: windowed sinc, cutoff at sampleRate/decimation, passband gain 2, 4-term Nuttall window. The taps in filter.c
+//   used a slightly different window, these come within about 1e-4 of them.
+// - IIR: a 5th-order Butterworth lowpass with a cutoff of bandwidthHz at the decimated rate (bilinear, prewarped,
+//   gain 1 at DC), shifted up to the center frequency by modulation: H(z e^-jw0) + H(z e^jw0), which is 10th order.
+//   With the centers of the filter.c tables this reproduces their A coefficients to about 1e-13.
+// - Biquads: the same factoring as filterFixed_designSections(): pole pairs sorted by radius, each matched with the
+//   closest zero pair that is left (starting from the pole pair closest to the unit circle), each section scaled to a
+//   peak gain of 1 and the rest of the gain left for the end of the cascade.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <math.h>
+#include <complex>
+
+#define MAX_CHANNEL_COUNT 32
+#define MAX_FIR_TAP_COUNT 255
+#define SECTION_COUNT 5						// detectorCore sections per channel, a 10th-order filter.
+#define LOWPASS_ORDER SECTION_COUNT			// Modulation doubles the order.
+#define IIR_ORDER (2*LOWPASS_ORDER)
+#define DEFAULT_CHANNEL_COUNT 10
+#define DEFAULT_SAMPLE_RATE_HZ 100000
+#define DEFAULT_DECIMATION_FACTOR 10
+#define DEFAULT_FIR_TAP_COUNT 23
+#define DEFAULT_LOWEST_HZ 1111.1			// Half-period 45 at 100 kHz, player 0 of the 10-player plan.
+#define DEFAULT_HIGHEST_HZ 3846.2			// Half-period 13 at 100 kHz, player 9.
+#define DEFAULT_BANDWIDTH_HZ 50.0
+#define DEFAULT_WINDOW_SECONDS 2.0			// Power window, 20000 FIR outputs at 10 kHz.
+#define FIR_PASSBAND_GAIN 2.0
+#define ROOT_FINDER_ITERATIONS 500
+#define ROOT_POLISH_ITERATIONS 5			// Newton steps on each root after Durand-Kerner.
+#define ROOT_REAL_EPSILON 1.0E-7			// Roots with a smaller imaginary part (relative) are treated as real.
+#define PEAK_GAIN_GRID_POINTS 1024			// Same grid as filterFixed.c.
+#define RESPONSE_GRID_POINTS 8192			// For the summary.
+
+typedef std::complex<double> complex_t;
+
+// Quadratic 1 + c1*z^-1 + c2*z^-2, as in filterFixed.c.
+typedef struct {
+	double c1, c2;
+	double radius;
+	double angle;
+} quadratic_t;
+
+typedef struct {
+	double b0, b1, b2, a1, a2;
+} section_t;
+
+typedef struct {
+	uint16_t channelCount;
+	uint32_t sampleRateHz;
+	uint16_t decimationFactor;
+	uint16_t firTapCount;
+	double bandwidthHz;
+	double windowSeconds;
+	uint16_t halfPeriodTicks[MAX_CHANNEL_COUNT];
+	double centerHz[MAX_CHANNEL_COUNT];
+} plan_t;
+
+/*============================== Players =====================================*/
+
+// Half-periods spread geometrically between the lowest and the highest frequency, rounded, never two the same.
+static bool choosePlayers(plan_t* plan, double lowestHz, double highestHz) {
+	double longest = plan->sampleRateHz / (2.0 * lowestHz);
+	double shortest = plan->sampleRateHz / (2.0 * highestHz);
+	for (uint16_t i=0; i<plan->channelCount; i++) {
+		double ratio = plan->channelCount > 1 ? (double) i / (plan->channelCount - 1) : 0.0;
+		long ticks = lround(longest * pow(shortest / longest, ratio));
+		if (i > 0 && ticks >= plan->halfPeriodTicks[i-1])
+			ticks = plan->halfPeriodTicks[i-1] - 1;
+		if (ticks < 2) {
+			fprintf(stderr, "channelPlanGenerator: %u players do not fit between %.1lf and %.1lf Hz.\n",
+					plan->channelCount, lowestHz, highestHz);
+			return false;
+		}
+		plan->halfPeriodTicks[i] = ticks;
+		plan->centerHz[i] = plan->sampleRateHz / (2.0 * ticks);
+	}
+	return true;
+}
+
+// Reads comma-separated center frequencies. The half-periods are rounded from them.
+static bool readCenters(plan_t* plan, const char* list) {
+	uint16_t count = 0;
+	const char* p = list;
+	while (*p && count < MAX_CHANNEL_COUNT) {
+		char* end;
+		double hz = strtod(p, &end);
+		if (end == p || hz <= 0.0)
+			return false;
+		plan->centerHz[count] = hz;
+		plan->halfPeriodTicks[count] = lround(plan->sampleRateHz / (2.0 * hz));
+		count++;
+		p = (*end == ',') ? end + 1 : end;
+	}
+	plan->channelCount = count;
+	return count > 0 && !*p;
+}
+
+/*================================= FIR ======================================*/
+
+static void designFir(const plan_t* plan, double taps[]) {
+	const double a[4] = {0.355768, 0.487396, 0.144232, 0.012604};	// 4-term Nuttall.
+	double cutoff = 1.0 / plan->decimationFactor;	// Cycles per sample.
+	uint16_t n = plan->firTapCount;
+	for (uint16_t k=0; k<n; k++) {
+		double m = k - (n - 1) / 2.0;
+		double sinc = (m == 0.0) ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * m) / (M_PI * m);
+		double x = 2.0 * M_PI * (k + 1) / (n + 1);
+		double window = a[0] - a[1] * cos(x) + a[2] * cos(2.0 * x) - a[3] * cos(3.0 * x);
+		taps[k] = FIR_PASSBAND_GAIN * sinc * window;
+	}
+}
+
+/*================================= IIR ======================================*/
+
+// Multiplies polynomials in z^-1: c[0 .. na+nb] = a[0 .. na] * b[0 .. nb].
+static void multiply(const complex_t a[], uint16_t na, const complex_t b[], uint16_t nb, complex_t c[]) {
+	for (uint16_t i=0; i<=na+nb; i++)
+		c[i] = 0.0;
+	for (uint16_t i=0; i<=na; i++)
+		for (uint16_t j=0; j<=nb; j++)
+			c[i+j] += a[i] * b[j];
+}
+
+// The 5th-order Butterworth lowpass: its poles, and numerator and denominator coefficients in z^-1.
+static void designLowpass(double cutoffHz, double rateHz, complex_t poles[], complex_t num[], complex_t den[]) {
+	double warped = 2.0 * rateHz * tan(M_PI * cutoffHz / rateHz);
+	complex_t gain = 1.0;
+	den[0] = 1.0;
+	for (uint16_t k=0; k<LOWPASS_ORDER; k++) {
+		complex_t s = warped * std::polar(1.0, M_PI * (2*k + LOWPASS_ORDER + 1) / (2.0 * LOWPASS_ORDER));
+		poles[k] = (2.0 * rateHz + s) / (2.0 * rateHz - s);
+		complex_t factor[2] = {1.0, -poles[k]};
+		complex_t product[LOWPASS_ORDER+1];
+		multiply(den, k, factor, 1, product);
+		for (uint16_t i=0; i<=k+1; i++)
+			den[i] = product[i];
+		gain *= (1.0 - poles[k]) / 2.0;	// So that the gain at DC is 1, with all of the zeros at -1.
+	}
+	double binomial = 1.0;
+	for (uint16_t k=0; k<=LOWPASS_ORDER; k++) {
+		num[k] = gain.real() * binomial;
+		binomial = binomial * (LOWPASS_ORDER - k) / (k + 1);
+	}
+}
+
+// Evaluates the monic polynomial z^n + c[0] z^(n-1) + ... + c[n-1] and its derivative at z.
+static void evaluate(const double c[], uint16_t n, complex_t z, complex_t* value, complex_t* derivative) {
+	complex_t p = 1.0, d = 0.0;
+	for (uint16_t k=0; k<n; k++) {
+		d = d * z + p;
+		p = p * z + c[k];
+	}
+	*value = p;
+	*derivative = d;
+}
+
+// Durand-Kerner like filterFixed.c, then a few Newton steps on each root.
+static void findRoots(const double c[], uint16_t n, complex_t roots[]) {
+	complex_t seed(0.4, 0.9);
+	complex_t power = 1.0;
+	for (uint16_t i=0; i<n; i++) {
+		roots[i] = power;
+		power *= seed;
+	}
+	for (uint16_t iteration=0; iteration<ROOT_FINDER_ITERATIONS; iteration++) {
+		for (uint16_t i=0; i<n; i++) {
+			complex_t value, derivative;
+			evaluate(c, n, roots[i], &value, &derivative);
+			complex_t denominator = 1.0;
+			for (uint16_t j=0; j<n; j++)
+				if (j != i)
+					denominator *= roots[i] - roots[j];
+			roots[i] -= value / denominator;
+		}
+	}
+	for (uint16_t i=0; i<n; i++) {
+		for (uint16_t iteration=0; iteration<ROOT_POLISH_ITERATIONS; iteration++) {
+			complex_t value, derivative;
+			evaluate(c, n, roots[i], &value, &derivative);
+			if (std::abs(derivative) == 0.0)
+				break;
+			roots[i] -= value / derivative;
+		}
+	}
+}
+
+static quadratic_t conjugatePair(complex_t root) {
+	quadratic_t q = {-2.0 * root.real(), std::norm(root), std::abs(root), fabs(std::arg(root))};
+	return q;
+}
+
+// Groups the roots of a real polynomial into quadratics (conjugate pairs, or two real roots). Returns false if the
+// roots do not come out as LOWPASS_ORDER quadratics.
+static bool groupRoots(const complex_t roots[], uint16_t n, quadratic_t quadratics[]) {
+	uint16_t count = 0;
+	double realRoots[IIR_ORDER];
+	uint16_t realCount = 0;
+	for (uint16_t i=0; i<n; i++) {
+		if (fabs(roots[i].imag()) < ROOT_REAL_EPSILON * fmax(1.0, std::abs(roots[i])))
+			realRoots[realCount++] = roots[i].real();
+		else if (roots[i].imag() > 0.0 && count < LOWPASS_ORDER)
+			quadratics[count++] = conjugatePair(roots[i]);
+	}
+	for (uint16_t i=0; i+1<realCount && count<LOWPASS_ORDER; i+=2) {
+		quadratic_t q = {-(realRoots[i] + realRoots[i+1]), realRoots[i] * realRoots[i+1],
+				fmax(fabs(realRoots[i]), fabs(realRoots[i+1])), 0.0};
+		quadratics[count++] = q;
+	}
+	return count == LOWPASS_ORDER && realCount % 2 == 0;
+}
+
+// (1 + n1 z^-1 + n2 z^-2) / (1 + d1 z^-1 + d2 z^-2) at z = e^jw.
+static complex_t sectionResponse(double n1, double n2, double d1, double d2, double w) {
+	complex_t z1 = std::polar(1.0, -w);
+	return (1.0 + n1 * z1 + n2 * z1 * z1) / (1.0 + d1 * z1 + d2 * z1 * z1);
+}
+
+static double sectionPeakGain(const quadratic_t* zeros, const quadratic_t* poles) {
+	double peak = 0.0;
+	for (uint16_t i=0; i<PEAK_GAIN_GRID_POINTS; i++) {
+		double w = M_PI * i / (PEAK_GAIN_GRID_POINTS-1);
+		peak = fmax(peak, std::abs(sectionResponse(zeros->c1, zeros->c2, poles->c1, poles->c2, w)));
+	}
+	return peak;
+}
+
+// Designs one channel's 10th-order bandpass and factors it into sections. a[] gets a1..a10 (the direct form, for
+// comparing against filter.c).
+static bool designChannel(const plan_t* plan, uint16_t channel, section_t sections[], double* gain, double a[]) {
+	double rateHz = (double) plan->sampleRateHz / plan->decimationFactor;
+	complex_t lowpassPoles[LOWPASS_ORDER], num[LOWPASS_ORDER+1], den[LOWPASS_ORDER+1];
+	designLowpass(plan->bandwidthHz, rateHz, lowpassPoles, num, den);
+	// Substituting z e^-jw0 for z multiplies coefficient k (of z^-k) by e^jw0k.
+	double w0 = 2.0 * M_PI * plan->centerHz[channel] / rateHz;
+	complex_t numUp[LOWPASS_ORDER+1], numDown[LOWPASS_ORDER+1], denUp[LOWPASS_ORDER+1], denDown[LOWPASS_ORDER+1];
+	for (uint16_t k=0; k<=LOWPASS_ORDER; k++) {
+		complex_t shift = std::polar(1.0, w0 * k);
+		numUp[k] = num[k] * shift;
+		denUp[k] = den[k] * shift;
+		numDown[k] = num[k] * std::conj(shift);
+		denDown[k] = den[k] * std::conj(shift);
+	}
+	complex_t bandpassNum[IIR_ORDER+1], bandpassDen[IIR_ORDER+1], cross[IIR_ORDER+1];
+	multiply(numUp, LOWPASS_ORDER, denDown, LOWPASS_ORDER, bandpassNum);
+	multiply(numDown, LOWPASS_ORDER, denUp, LOWPASS_ORDER, cross);
+	multiply(denUp, LOWPASS_ORDER, denDown, LOWPASS_ORDER, bandpassDen);
+	double b0 = (bandpassNum[0] + cross[0]).real();
+	double monicB[IIR_ORDER];
+	for (uint16_t k=0; k<IIR_ORDER; k++) {
+		monicB[k] = (bandpassNum[k+1] + cross[k+1]).real() / b0;
+		a[k] = bandpassDen[k+1].real();
+	}
+	// The poles are the lowpass poles turned by w0 (and their conjugates), no need to search for them.
+	quadratic_t poles[SECTION_COUNT], zeros[SECTION_COUNT];
+	for (uint16_t k=0; k<LOWPASS_ORDER; k++)
+		poles[k] = conjugatePair(lowpassPoles[k] * std::polar(1.0, w0));
+	complex_t zeroRoots[IIR_ORDER];
+	findRoots(monicB, IIR_ORDER, zeroRoots);
+	if (!groupRoots(zeroRoots, IIR_ORDER, zeros)) {
+		fprintf(stderr, "channelPlanGenerator: channel %u, could not pair the zeros.\n", channel);
+		return false;
+	}
+	// From here on, filterFixed_designSections().
+	for (uint16_t i=1; i<SECTION_COUNT; i++) {
+		quadratic_t x = poles[i];
+		uint16_t j = i;
+		while (j > 0 && poles[j-1].radius > x.radius) {
+			poles[j] = poles[j-1];
+			j--;
+		}
+		poles[j] = x;
+	}
+	bool zeroUsed[SECTION_COUNT] = {false};
+	quadratic_t matchedZeros[SECTION_COUNT];
+	for (int16_t i=SECTION_COUNT-1; i>=0; i--) {
+		int16_t best = -1;
+		double bestDistance = 0.0;
+		for (uint16_t j=0; j<SECTION_COUNT; j++) {
+			if (zeroUsed[j])
+				continue;
+			double distance = std::norm(std::polar(zeros[j].radius, zeros[j].angle) -
+					std::polar(poles[i].radius, poles[i].angle));
+			if (best < 0 || distance < bestDistance) {
+				best = j;
+				bestDistance = distance;
+			}
+		}
+		zeroUsed[best] = true;
+		matchedZeros[i] = zeros[best];
+	}
+	*gain = b0;
+	for (uint16_t i=0; i<SECTION_COUNT; i++) {
+		double scale = 1.0 / sectionPeakGain(&matchedZeros[i], &poles[i]);
+		*gain /= scale;
+		sections[i].b0 = scale;
+		sections[i].b1 = scale * matchedZeros[i].c1;
+		sections[i].b2 = scale * matchedZeros[i].c2;
+		sections[i].a1 = poles[i].c1;
+		sections[i].a2 = poles[i].c2;
+	}
+	return true;
+}
+
+// Magnitude of a channel's cascade at frequencyHz (at the decimated rate).
+static double cascadeGain(const plan_t* plan, const section_t sections[], double gain, double frequencyHz) {
+	double w = 2.0 * M_PI * frequencyHz * plan->decimationFactor / plan->sampleRateHz;
+	complex_t h = gain;
+	for (uint16_t s=0; s<SECTION_COUNT; s++)
+		h *= sections[s].b0 * sectionResponse(sections[s].b1 / sections[s].b0, sections[s].b2 / sections[s].b0,
+				sections[s].a1, sections[s].a2, w);
+	return std::abs(h);
+}
+
+/*================================ Output ====================================*/
+
+static void printSummary(const plan_t* plan, const section_t sections[][SECTION_COUNT], const double gains[]) {
+	double decimatedRateHz = (double) plan->sampleRateHz / plan->decimationFactor;
+	fprintf(stderr, "%u players, %lu Hz, FIR outputs at %.1lf Hz.\n", plan->channelCount,
+			(unsigned long) plan->sampleRateHz, decimatedRateHz);
+	if (plan->centerHz[plan->channelCount-1] > decimatedRateHz / 2.0)
+		fprintf(stderr, "Warning: the highest player is above the decimated Nyquist frequency and aliases.\n");
+	for (uint16_t c=0; c<plan->channelCount; c++) {
+		// Leakage: the most any other player's tone gets through this filter, relative to its own.
+		double own = cascadeGain(plan, sections[c], gains[c], plan->centerHz[c]);
+		double worst = 0.0;
+		for (uint16_t other=0; other<plan->channelCount; other++)
+			if (other != c)
+				worst = fmax(worst, cascadeGain(plan, sections[c], gains[c], plan->centerHz[other]));
+		double peak = 0.0;
+		for (uint32_t i=0; i<RESPONSE_GRID_POINTS; i++)
+			peak = fmax(peak, cascadeGain(plan, sections[c], gains[c], decimatedRateHz / 2.0 * i / RESPONSE_GRID_POINTS));
+		fprintf(stderr, "Player %2u: half-period %3u, %7.1lf Hz, gain %.4lf (peak %.4lf), other players %6.1lf dB\n", c,
+				plan->halfPeriodTicks[c], plan->centerHz[c], own, peak, 20.0 * log10(worst / own));
+	}
+}
+
+static void printHeader(const plan_t* plan, const char* name, const char* commandLine, const double fir[],
+		const section_t sections[][SECTION_COUNT], const double gains[]) {
+	char upper[64];
+	snprintf(upper, sizeof(upper), "CHANNELPLAN%s", name);
+	for (char* p=upper; *p; p++)
+		*p = toupper(*p);
+	uint32_t windowLength = lround(plan->windowSeconds * plan->sampleRateHz / plan->decimationFactor);
+	printf("/*\n * channelPlan%s.h\n *\n *  Generated by src/hostSim/channelPlanGenerator.c, do not edit:\n", name);
+	printf(" *    %s\n */\n\n", commandLine);
+	printf("#ifndef %s_H_\n#define %s_H_\n\n#include <stdint.h>\n#include \"xparameters.h\"\n\n", upper, upper);
+	printf("// %u players, %lu Hz sampling, FIR outputs at %lu Hz, filters %.0lf Hz wide. Same meaning as the\n",
+			plan->channelCount, (unsigned long) plan->sampleRateHz,
+			(unsigned long) (plan->sampleRateHz / plan->decimationFactor), 2.0 * plan->bandwidthHz);
+	printf("// CHANNELPLAN_* values of channelPlan.h.\n");
+	printf("#define %s_CHANNEL_COUNT %u\n", upper, plan->channelCount);
+	printf("#define %s_SAMPLE_RATE_HZ %lu\n", upper, (unsigned long) plan->sampleRateHz);
+	printf("#define %s_DECIMATION_FACTOR %u\n", upper, plan->decimationFactor);
+	printf("#define %s_FIR_TAP_COUNT %u\n", upper, plan->firTapCount);
+	printf("#define %s_IIR_ORDER %u\n", upper, IIR_ORDER);
+	printf("#define %s_POWER_WINDOW_LENGTH %lu\n", upper, (unsigned long) windowLength);
+	printf("#define %s_HALF_PERIOD_TICKS {", upper);
+	for (uint16_t c=0; c<plan->channelCount; c++)
+		printf("%s%u", c ? ", " : "", plan->halfPeriodTicks[c]);
+	printf("}\n");
+	printf("#define %s_PRIVATE_TIMER_LOAD_VALUE (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2 / %s_SAMPLE_RATE_HZ - 1)\n\n",
+			upper, upper);
+	printf("#ifdef __cplusplus\n#include \"detectorCore.h\"\n\n");
+	printf("typedef detectorCore::ChannelPlan<%u, %lu, %u, %u, %u, %lu> channelPlan%s_t;\n\n", plan->channelCount,
+			(unsigned long) plan->sampleRateHz, plan->decimationFactor, plan->firTapCount, SECTION_COUNT,
+			(unsigned long) windowLength, name);
+	printf("static const double channelPlan%s_firCoefficients[%u] = {", name, plan->firTapCount);
+	for (uint16_t k=0; k<plan->firTapCount; k++)
+		printf("%s%s%.17g", k ? "," : "", k % 4 ? " " : "\n\t", fir[k]);
+	printf("\n};\n\n");
+	printf("// {b0, b1, b2, a1, a2} for each section, see detectorCore::Section.\n");
+	printf("static const detectorCore::Section channelPlan%s_sections[%u][%u] = {\n", name, plan->channelCount,
+			SECTION_COUNT);
+	for (uint16_t c=0; c<plan->channelCount; c++) {
+		printf("\t{\t// Player %u, %.1lf Hz.\n", c, plan->centerHz[c]);
+		for (uint16_t s=0; s<SECTION_COUNT; s++)
+			printf("\t\t{%.17g, %.17g, %.17g, %.17g, %.17g},\n", sections[c][s].b0, sections[c][s].b1, sections[c][s].b2,
+					sections[c][s].a1, sections[c][s].a2);
+		printf("\t},\n");
+	}
+	printf("};\n\n");
+	printf("static const double channelPlan%s_gains[%u] = {", name, plan->channelCount);
+	for (uint16_t c=0; c<plan->channelCount; c++)
+		printf("%s%s%.17g", c ? "," : "", c % 4 ? " " : "\n\t", gains[c]);
+	printf("\n};\n\n");
+	printf("static const uint16_t channelPlan%s_halfPeriodTicks[%u] = %s_HALF_PERIOD_TICKS;\n\n", name,
+			plan->channelCount, upper);
+	printf("static const detectorCore::PlanTables<channelPlan%s_t> channelPlan%s_tables = {\n", name, name);
+	printf("\tchannelPlan%s_firCoefficients, channelPlan%s_sections, channelPlan%s_gains, channelPlan%s_halfPeriodTicks\n",
+			name, name, name, name);
+	printf("};\n#endif\n\n#endif /* %s_H_ */\n", upper);
+}
+
+int main(int argc, char* argv[]) {
+	static plan_t plan;
+	plan.channelCount = DEFAULT_CHANNEL_COUNT;
+	plan.sampleRateHz = DEFAULT_SAMPLE_RATE_HZ;
+	plan.decimationFactor = DEFAULT_DECIMATION_FACTOR;
+	plan.firTapCount = DEFAULT_FIR_TAP_COUNT;
+	plan.bandwidthHz = DEFAULT_BANDWIDTH_HZ;
+	plan.windowSeconds = DEFAULT_WINDOW_SECONDS;
+	const char* name = "";
+	const char* centers = NULL;
+	double lowestHz = DEFAULT_LOWEST_HZ, highestHz = DEFAULT_HIGHEST_HZ;
+	char commandLine[512] = "channelPlanGenerator";
+	for (int i=1; i<argc; i++) {
+		strncat(commandLine, " ", sizeof(commandLine) - strlen(commandLine) - 1);
+		strncat(commandLine, argv[i], sizeof(commandLine) - strlen(commandLine) - 1);
+	}
+	int option;
+	while ((option = getopt(argc, argv, "n:c:r:d:t:l:h:f:b:w:")) != -1) {
+		switch (option) {
+		case 'n': name = optarg; break;
+		case 'c': plan.channelCount = atoi(optarg); break;
+		case 'r': plan.sampleRateHz = strtoul(optarg, NULL, 10); break;
+		case 'd': plan.decimationFactor = atoi(optarg); break;
+		case 't': plan.firTapCount = atoi(optarg); break;
+		case 'l': lowestHz = atof(optarg); break;
+		case 'h': highestHz = atof(optarg); break;
+		case 'f': centers = optarg; break;
+		case 'b': plan.bandwidthHz = atof(optarg); break;
+		case 'w': plan.windowSeconds = atof(optarg); break;
+		default:
+			fprintf(stderr, "usage: %s [-n name] [-c channels] [-r sampleRateHz] [-d decimation] [-t firTaps] "
+					"[-l lowestHz] [-h highestHz] [-f hz,hz,...] [-b bandwidthHz] [-w windowSeconds]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (plan.channelCount < 2 || plan.channelCount > MAX_CHANNEL_COUNT || plan.firTapCount < 1 ||
+			plan.firTapCount > MAX_FIR_TAP_COUNT || plan.decimationFactor < 1 || !plan.sampleRateHz) {
+		fprintf(stderr, "channelPlanGenerator: 2 to %d channels and 1 to %d FIR taps.\n", MAX_CHANNEL_COUNT,
+				MAX_FIR_TAP_COUNT);
+		return 2;
+	}
+	if (centers ? !readCenters(&plan, centers) : !choosePlayers(&plan, lowestHz, highestHz))
+		return 1;
+	static double fir[MAX_FIR_TAP_COUNT];
+	static section_t sections[MAX_CHANNEL_COUNT][SECTION_COUNT];
+	static double gains[MAX_CHANNEL_COUNT];
+	designFir(&plan, fir);
+	for (uint16_t c=0; c<plan.channelCount; c++) {
+		double a[IIR_ORDER];
+		if (!designChannel(&plan, c, sections[c], &gains[c], a))
+			return 1;
+	}
+	printSummary(&plan, sections, gains);
+	printHeader(&plan, name, commandLine, fir, sections, gains);
+	return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * detectorCoreTest.c
+ */
+
+// Host-only check of the channel plans the firmware does not run yet: the detectorCore.h templates with the generated
+// tables of channelPlan16.h (16 players, 100 kHz) and channelPlan20.h (20 players, 200 kHz). Build it from
+// Consolidated_330_SW (one command, split over lines here):
+//   g++ -O2 -x c++ -I. -Isrc/laserTag -I../HW3_bsp/ps7_cortexa9_0/include src/hostSim/detectorCoreTest.c
+//     -o detectorCoreTest
+//   ./detectorCoreTest [-n noiseRms] [-a amplitude] [-r seed]
+//
+// For every player of a plan, a fresh Detector<> gets a quiet lead-in as long as the power window, one shot (a square
+// wave at the player's half-period for 200 ms, like transmitter.c sends) and a quiet tail, in ADC counts with gaussian
+// noise. The lead-in only fills the window: until it does, the median of a few noise samples is no threshold and noise
+// alone can hit, the same as detector.c right after power-up. After it, the shot has to give at least one hit, and
+// every hit has to be on that player. The margin is how far the player's power is above the loudest other player at
+// the end of the shot. Expect about 10 dB at worst: a square wave's 3rd harmonic is 1/3 of the fundamental, and with
+// 16 or 20 players it lands near another player's frequency.
+
+#include "channelPlan16.h"
+#include "channelPlan20.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+
+#define TEST_ADC_MAX 4095
+#define TEST_ADC_OFFSET 2048
+#define TEST_DEFAULT_AMPLITUDE 200.0			// ADC counts, the pin high adds this.
+#define TEST_DEFAULT_NOISE_RMS 20.0				// ADC counts.
+#define TEST_SHOT_MS 200						// transmitter.c's PULSE_LENGTH.
+#define TEST_TAIL_MS 300
+#define TEST_FUDGE_FACTOR 5						// Same as detector.c.
+#define TEST_LOCKOUT_MS 500						// Same as lockoutTimer.c.
+#define TEST_BLOCK_SIZE 1000					// Samples per processBlock(), like the ADC buffer drains.
+
+static double amplitude = TEST_DEFAULT_AMPLITUDE;
+static double noiseRms = TEST_DEFAULT_NOISE_RMS;
+
+// Box-Muller.
+static double gaussian() {
+	double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static uint16_t adcSample(bool pin) {
+	long value = lround(TEST_ADC_OFFSET + (pin ? amplitude : 0.0) + noiseRms * gaussian());
+	return value < 0 ? 0 : (value > TEST_ADC_MAX ? TEST_ADC_MAX : value);
+}
+
+// Runs n samples of the player's square wave (or just noise if halfPeriod is 0) through the detector. Returns the
+// number of hits, and counts the ones that are not on player in *wrongHits.
+template <class Plan>
+static uint32_t runSamples(detectorCore::Detector<Plan>* detector, uint16_t halfPeriod, uint32_t n, uint16_t player,
+		uint32_t* wrongHits) {
+	static uint16_t block[TEST_BLOCK_SIZE];
+	const float scale = 2.0f / TEST_ADC_MAX;
+	uint32_t hits = 0;
+	for (uint32_t done=0; done<n; ) {
+		uint32_t count = (n - done < TEST_BLOCK_SIZE) ? n - done : TEST_BLOCK_SIZE;
+		for (uint32_t i=0; i<count; i++)
+			block[i] = adcSample(halfPeriod && ((done + i) / halfPeriod) % 2 == 0);
+		uint32_t blockHits = detector->processBlock(block, count, scale);
+		// Hits are locked out for far longer than a block, so there is at most one per block.
+		if (blockHits && detector->getLastHitChannel() != player)
+			*wrongHits += blockHits;
+		hits += blockHits;
+		done += count;
+	}
+	return hits;
+}
+
+template <class Plan>
+static bool runPlan(const char* name, const detectorCore::PlanTables<Plan>& tables) {
+	static detectorCore::Detector<Plan> detector;	// The power window is too big for the stack.
+	const uint32_t ticksPerMs = Plan::SAMPLE_RATE_HZ / 1000;
+	const uint32_t lockoutOutputs = TEST_LOCKOUT_MS * ticksPerMs / Plan::DECIMATION_FACTOR;
+	uint32_t failures = 0;
+	double worstMarginDb = HUGE_VAL;
+	for (uint16_t player=0; player<Plan::CHANNEL_COUNT; player++) {
+		detector.init(tables, TEST_FUDGE_FACTOR, lockoutOutputs);
+		uint32_t wrongHits = 0;
+		uint32_t ignored = 0;
+		runSamples(&detector, 0, Plan::POWER_WINDOW_LENGTH * Plan::DECIMATION_FACTOR, player, &ignored);
+		uint32_t hits = runSamples(&detector, tables.halfPeriodTicks[player], TEST_SHOT_MS * ticksPerMs, player,
+				&wrongHits);
+		double other = 0.0;
+		for (uint16_t c=0; c<Plan::CHANNEL_COUNT; c++)
+			if (c != player && detector.getPower(c) > other)
+				other = detector.getPower(c);
+		double marginDb = 10.0 * log10(detector.getPower(player) / other);
+		if (marginDb < worstMarginDb)
+			worstMarginDb = marginDb;
+		hits += runSamples(&detector, 0, TEST_TAIL_MS * ticksPerMs, player, &wrongHits);
+		if (!hits || wrongHits) {
+			printf("%s, player %u (half-period %u): %lu hits, %lu on other players, margin %.1lf dB.\n", name, player,
+					tables.halfPeriodTicks[player], (unsigned long) hits, (unsigned long) wrongHits, marginDb);
+			failures++;
+		}
+	}
+	printf("%s: %d players, %lu failed, worst margin %.1lf dB.\n", name, Plan::CHANNEL_COUNT, (unsigned long) failures,
+			worstMarginDb);
+	return !failures;
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t seed = 1;
+	int option;
+	while ((option = getopt(argc, argv, "n:a:r:")) != -1) {
+		switch (option) {
+		case 'n': noiseRms = atof(optarg); break;
+		case 'a': amplitude = atof(optarg); break;
+		case 'r': seed = atoi(optarg); break;
+		default:
+			printf("usage: %s [-n noiseRms] [-a amplitude] [-r seed]\n", argv[0]);
+			return 2;
+		}
+	}
+	srand(seed);
+	bool success = true;	// Be optimistic.
+	success &= runPlan("channelPlan16", channelPlan16_tables);
+	success &= runPlan("channelPlan20", channelPlan20_tables);
+	printf("detectorCoreTest %s.\n", success ? "passed" : "failed");
+	return success ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+/*
+ * eventsStressTest.c
+ */
+
+// Host-only multi-producer stress test for the event queue (src/laserTag/events.c). To build and run it on a Linux
+// host, from Consolidated_330_SW (one command, split over lines here):
+//   g++ -O2 -x c++ -Isrc/hostSim -I. -Isrc/laserTag -I../HW3_bsp/ps7_cortexa9_0/include src/laserTag/events.c
+//     src/laserTag/timerService.c src/laserTag/inputs.c src/hostSim/halSim.c src/hostSim/eventsStressTest.c
+//     -o eventsStressTest -lpthread
+//   ./eventsStressTest
+// Runs events_runTest() first. Then two producer threads (standing in for the ISR and main) post as fast as they
+// can, each with its own event type and a 16-bit sequence in the value, and retry when the queue is full. The
+// consumer thread must see each producer's sequence in order with nothing missing or repeated, and the dropped count
+// must equal the number of retries.
+
+#include "events.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define STRESS_TEST_EVENT_COUNT 2000000UL	// Per producer.
+#define STRESS_TEST_PRODUCER_COUNT 2
+
+static const events_type_t producerTypes[STRESS_TEST_PRODUCER_COUNT] = {EVENTS_SWITCHES_CHANGED, EVENTS_BUTTONS_PRESSED};
+static uint64_t retryCounts[STRESS_TEST_PRODUCER_COUNT];	// Read after the join.
+
+static void* producer(void* arg) {
+	uint32_t id = (uint32_t) (uintptr_t) arg;
+	uint64_t retries = 0;
+	for (uint64_t i=0; i<STRESS_TEST_EVENT_COUNT; i++)
+		while (!events_post(producerTypes[id], (uint16_t) i)) {
+			retries++;
+			sched_yield();	// The host may have a single core.
+		}
+	retryCounts[id] = retries;
+	return NULL;
+}
+
+int main() {
+	bool success = events_runTest();
+	events_init();
+	pthread_t producers[STRESS_TEST_PRODUCER_COUNT];
+	for (uint32_t id=0; id<STRESS_TEST_PRODUCER_COUNT; id++)
+		pthread_create(&producers[id], NULL, producer, (void*) (uintptr_t) id);
+	uint64_t receivedCounts[STRESS_TEST_PRODUCER_COUNT] = {0};
+	uint64_t outOfOrderCount = 0, unknownCount = 0;
+	uint64_t totalCount = 0;
+	while (totalCount < STRESS_TEST_PRODUCER_COUNT * STRESS_TEST_EVENT_COUNT) {
+		events_event_t event;
+		if (!events_get(&event)) {
+			sched_yield();
+			continue;
+		}
+		totalCount++;
+		uint32_t id = 0;
+		while (id < STRESS_TEST_PRODUCER_COUNT && producerTypes[id] != event.type)
+			id++;
+		if (id == STRESS_TEST_PRODUCER_COUNT) {
+			unknownCount++;
+			continue;
+		}
+		if (event.value != (uint16_t) receivedCounts[id])
+			outOfOrderCount++;
+		receivedCounts[id]++;
+	}
+	uint64_t retries = 0;
+	for (uint32_t id=0; id<STRESS_TEST_PRODUCER_COUNT; id++) {
+		pthread_join(producers[id], NULL);
+		retries += retryCounts[id];
+		printf("producer %lu: %llu events received, %llu retries\n", (unsigned long) id,
+				(unsigned long long) receivedCounts[id], (unsigned long long) retryCounts[id]);
+		success &= receivedCounts[id] == STRESS_TEST_EVENT_COUNT;
+	}
+	printf("out of order %llu, unknown type %llu, dropped count %lu\n", (unsigned long long) outOfOrderCount,
+			(unsigned long long) unknownCount, (unsigned long) events_getDroppedCount());
+	success &= !outOfOrderCount && !unknownCount && events_getDroppedCount() == (uint32_t) retries;
+	success &= events_getHandledCount() == (uint32_t) totalCount;
+	printf(success ? "eventsStressTest passed.\n" : "eventsStressTest failed.\n");
+	return !success;
+}
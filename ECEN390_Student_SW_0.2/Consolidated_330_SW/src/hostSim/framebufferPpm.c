@@ -0,0 +1,58 @@
+/*
+ * framebufferPpm.c
+ */
+
+#include "framebufferPpm.h"
+#include "supportFiles/framebuffer.h"
+#include <stdio.h>
+
+static void toRgb(uint16_t color, uint8_t rgb[3]) {
+	uint8_t r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+bool framebufferPpm_write(const char* path) {
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+	fprintf(file, "P6\n%d %d\n255\n", framebuffer_width(), framebuffer_height());
+	for (int16_t y=0; y<framebuffer_height(); y++) {
+		const uint16_t* row = framebuffer_getRow(y);
+		for (int16_t x=0; x<framebuffer_width(); x++) {
+			uint8_t rgb[3];
+			toRgb(row[x], rgb);
+			fwrite(rgb, 1, 3, file);
+		}
+	}
+	return fclose(file) == 0;
+}
+
+int32_t framebufferPpm_compare(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return -1;
+	int width, height, maxValue;
+	if (fscanf(file, "P6 %d %d %d", &width, &height, &maxValue) != 3 || fgetc(file) == EOF ||
+			width != framebuffer_width() || height != framebuffer_height() || maxValue != 255) {
+		fclose(file);
+		return -1;
+	}
+	int32_t differences = 0;
+	for (int16_t y=0; y<height; y++) {
+		const uint16_t* row = framebuffer_getRow(y);
+		for (int16_t x=0; x<width; x++) {
+			uint8_t expected[3], actual[3];
+			if (fread(expected, 1, 3, file) != 3) {
+				fclose(file);
+				return -1;
+			}
+			toRgb(row[x], actual);
+			if (expected[0] != actual[0] || expected[1] != actual[1] || expected[2] != actual[2])
+				differences++;
+		}
+	}
+	fclose(file);
+	return differences;
+}
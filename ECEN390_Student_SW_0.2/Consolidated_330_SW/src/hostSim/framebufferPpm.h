@@ -0,0 +1,20 @@
+/*
+ * framebufferPpm.h
+ */
+
+#ifndef FRAMEBUFFERPPM_H_
+#define FRAMEBUFFERPPM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Host-only: saves supportFiles/framebuffer.c's pixels as a binary PPM (P6, 8 bits per channel, RGB565 expanded by
+// replicating the top bits), and compares the framebuffer with a PPM saved earlier, for golden-image tests.
+
+// Returns false if the file could not be written.
+bool framebufferPpm_write(const char* path);
+
+// Returns the number of pixels that differ from the image in path, or -1 if it cannot be read or is a different size.
+int32_t framebufferPpm_compare(const char* path);
+
+#endif /* FRAMEBUFFERPPM_H_ */
@@ -0,0 +1,168 @@
+/*
+ * framebufferTest.c
+ */
+
+// Host-only check of supportFiles/framebuffer.c. Build it from Consolidated_330_SW (one command, split over lines here):
+//   g++ -O2 -x c++ -I. -Isrc/hostSim supportFiles/framebuffer.c src/hostSim/framebufferPpm.c
+//     src/hostSim/framebufferTest.c -o framebufferTest
+//   ./framebufferTest [-f frames] [-o out.ppm] [-g golden.ppm]
+//
+// A second 320x240 array stands in for the TFT. Flushing copies each dirty rectangle into it, the way display_flush()
+// sends them, so after every flush it has to match the framebuffer pixel for pixel, and the rectangles must not
+// overlap. Two scenes:
+// - The text of printRunTimeStatistics() (13 lines, size 1), drawn once and flushed. The bus bytes are compared with
+//   drawing the same text straight to the TFT, where Adafruit_GFX::drawChar() sets up an address window (ILI9341:
+//   two 5-byte commands) and sends a 1-byte GRAM command and 2 data bytes for every pixel of every character.
+// - Frames of random fills, pixels, and text of sizes 1 to 3 with and without background.
+// The final image can be saved as a PPM (-o) and compared with a saved one (-g); the scene is the same for a given
+// frame count, so a saved image serves as the golden image.
+
+#include "supportFiles/framebuffer.h"
+#include "framebufferPpm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_WIDTH 320
+#define TEST_HEIGHT 240
+#define TEST_DEFAULT_FRAME_COUNT 2000
+#define TEST_GARBAGE_COLOR 0x1234
+#define TEST_BYTES_PER_WINDOW_SETUP 11	// setAddrWindow() (2 x 5 bytes) and the GRAM write command.
+#define TEST_BYTES_PER_PIXEL 2
+
+static uint16_t lcd[TEST_HEIGHT][TEST_WIDTH];
+static uint32_t flushedRects;
+static uint32_t flushedPixels;
+
+// Returns false if the rectangles overlap.
+static bool flush() {
+	framebuffer_rect_t rects[FRAMEBUFFER_MAX_DIRTY_RECTS];
+	uint16_t count = framebuffer_takeDirtyRects(rects);
+	bool ok = true;
+	for (uint16_t i=0; i<count; i++) {
+		framebuffer_rect_t* r = &rects[i];
+		for (uint16_t j=0; j<i; j++) {
+			framebuffer_rect_t* o = &rects[j];
+			if (r->x < o->x + o->w && o->x < r->x + r->w && r->y < o->y + o->h && o->y < r->y + r->h)
+				ok = false;
+		}
+		for (int16_t row=r->y; row<r->y+r->h; row++)
+			memcpy(&lcd[row][r->x], framebuffer_getRow(row) + r->x, r->w * sizeof(uint16_t));
+		flushedRects++;
+		flushedPixels += r->w * r->h;
+	}
+	return ok;
+}
+
+static uint32_t lcdDifferences() {
+	uint32_t differences = 0;
+	for (int16_t y=0; y<TEST_HEIGHT; y++)
+		for (int16_t x=0; x<TEST_WIDTH; x++)
+			if (lcd[y][x] != framebuffer_getPixel(x, y))
+				differences++;
+	return differences;
+}
+
+static void drawString(int16_t x, int16_t y, const char* text, uint16_t color, uint16_t bg, uint8_t size) {
+	for (; *text; text++, x += 6 * size)
+		framebuffer_drawChar(x, y, *text, color, bg, size);
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t frameCount = TEST_DEFAULT_FRAME_COUNT;
+	const char* outPath = NULL;
+	const char* goldenPath = NULL;
+	int option;
+	while ((option = getopt(argc, argv, "f:o:g:")) != -1) {
+		if (option == 'f')
+			frameCount = strtoul(optarg, NULL, 0);
+		else if (option == 'o')
+			outPath = optarg;
+		else if (option == 'g')
+			goldenPath = optarg;
+		else {
+			fprintf(stderr, "usage: %s [-f frames] [-o out.ppm] [-g golden.ppm]\n", argv[0]);
+			return 1;
+		}
+	}
+	bool failed = false;
+	for (int16_t y=0; y<TEST_HEIGHT; y++)
+		for (int16_t x=0; x<TEST_WIDTH; x++)
+			lcd[y][x] = TEST_GARBAGE_COLOR;
+	framebuffer_init(TEST_WIDTH, TEST_HEIGHT);
+	flush();	// The whole screen, like the first display_flush() after display_init().
+
+	// printRunTimeStatistics(), black background, white text.
+	const char* lines[] = {
+		"Elements remaining in ADC queue:0", "", "Max detector latency in ms: 0.12", "",
+		"ADC buffer high watermark: 37, overflows: 0", "", "Measured run time in seconds: 42.18", "",
+		"Cumulative run time in timerIsr: 3.51 (8.32%)", "", "Cumulative run-time in main loop: 30.07 (71.29%)", "",
+		"Total interrupts:            4218311", "", "Interrupts detected in main: 4218311", "",
+		"Detected interrupts in main: 100.00%"
+	};
+	framebuffer_fillRect(0, 0, TEST_WIDTH, TEST_HEIGHT, 0x0000);
+	flush();
+	flushedRects = flushedPixels = 0;
+	uint32_t textPixels = 0;
+	for (uint16_t i=0; i<sizeof(lines) / sizeof(lines[0]); i++) {
+		drawString(0, i * 8, lines[i], 0xFFFF, 0xFFFF, 1);	// Transparent, like display_print() after setTextColor(c).
+		textPixels += strlen(lines[i]) * 6 * 8;
+	}
+	failed |= !flush();
+	uint64_t directBytes = (uint64_t) textPixels * (TEST_BYTES_PER_WINDOW_SETUP + TEST_BYTES_PER_PIXEL);
+	uint64_t flushBytes = (uint64_t) flushedRects * TEST_BYTES_PER_WINDOW_SETUP + (uint64_t) flushedPixels * TEST_BYTES_PER_PIXEL;
+	printf("statistics text: %lu character pixels; direct %llu bus bytes, flush %lu rects %lu pixels %llu bus bytes (%.1fx)\n",
+			(unsigned long) textPixels, (unsigned long long) directBytes, (unsigned long) flushedRects,
+			(unsigned long) flushedPixels, (unsigned long long) flushBytes, (double) directBytes / flushBytes);
+	if (lcdDifferences()) {
+		printf("statistics text: LCD differs from the framebuffer\n");
+		failed = true;
+	}
+
+	srand(1);
+	flushedRects = flushedPixels = 0;
+	uint32_t mismatchedFrames = 0;
+	for (uint32_t frame=0; frame<frameCount; frame++) {
+		uint16_t operations = 1 + rand() % 8;
+		for (uint16_t i=0; i<operations; i++) {
+			int16_t x = rand() % (TEST_WIDTH + 40) - 20, y = rand() % (TEST_HEIGHT + 40) - 20;
+			uint16_t color = rand();
+			switch (rand() % 4) {
+			case 0:
+				framebuffer_fillRect(x, y, rand() % 60, rand() % 60, color);
+				break;
+			case 1:
+				for (uint16_t p=0; p<20; p++)
+					framebuffer_drawPixel(x + rand() % 30, y + rand() % 30, color);
+				break;
+			default:
+				char text[8];
+				snprintf(text, sizeof(text), "%d", rand() % 100000);
+				drawString(x, y, text, color, rand() % 2 ? color : (uint16_t) rand(), 1 + rand() % 3);
+				break;
+			}
+		}
+		if (!flush() || lcdDifferences()) {
+			if (mismatchedFrames < 10)
+				printf("frame %lu: LCD differs from the framebuffer or rectangles overlap\n", (unsigned long) frame);
+			mismatchedFrames++;
+		}
+	}
+	if (frameCount)
+		printf("random frames: %lu, %.1f rects and %.0f pixels per flush\n", (unsigned long) frameCount,
+				(double) flushedRects / frameCount, (double) flushedPixels / frameCount);
+	failed |= mismatchedFrames != 0;
+
+	if (outPath && !framebufferPpm_write(outPath)) {
+		printf("could not write %s\n", outPath);
+		failed = true;
+	}
+	if (goldenPath) {
+		int32_t differences = framebufferPpm_compare(goldenPath);
+		printf("golden image %s: %ld pixels differ\n", goldenPath, (long) differences);
+		failed |= differences != 0;
+	}
+	printf(failed ? "framebufferTest failed.\n" : "framebufferTest passed.\n");
+	return failed;
+}
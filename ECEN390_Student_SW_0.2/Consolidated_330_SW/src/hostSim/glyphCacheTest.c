@@ -0,0 +1,152 @@
+/*
+ * glyphCacheTest.c
+ */
+
+// Host-only check of supportFiles/glyphCache.c. Build it from Consolidated_330_SW (one command, split over lines here):
+//   g++ -O2 -x c++ -I. supportFiles/glyphCache.c supportFiles/framebuffer.c src/hostSim/glyphCacheTest.c
+//     -o glyphCacheTest
+//   ./glyphCacheTest [-n lookups] [-r seed]
+//
+// Every cell handed out is compared, byte for byte, with the same character drawn by framebuffer_drawChar(), which
+// follows Adafruit_GFX::drawChar(). The lookups come from a small working set that drifts, so there are hits, misses
+// and evictions, and the hit and miss counts are checked against a plain LRU list kept here. Each time, the cells of
+// the GLYPHCACHE_ENTRY_COUNT most recent lookups are checked to still hold their characters, since display.cpp
+// holds on to that many pointers while it sends a run. Then the expansion is timed against framebuffer_drawChar().
+
+#include "supportFiles/glyphCache.h"
+#include "supportFiles/framebuffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#define TEST_DEFAULT_LOOKUP_COUNT 200000
+#define TEST_WORKING_SET 80				// More than the cache holds.
+#define TEST_TIMING_CHARS 1000000
+
+typedef struct {
+	unsigned char c;
+	uint16_t color, bg;
+	uint8_t size;
+} glyphKey_t;
+
+static bool sameKey(const glyphKey_t* a, const glyphKey_t* b) {
+	return a->c == b->c && a->color == b->color && a->bg == b->bg && a->size == b->size;
+}
+
+// True if cell holds the glyph, as framebuffer_drawChar() would draw it at (0, 0).
+static bool cellMatches(const uint8_t* cell, const glyphKey_t* key) {
+	framebuffer_drawChar(0, 0, key->c, key->color, key->bg, key->size);
+	uint16_t width = GLYPHCACHE_CHAR_WIDTH * key->size;
+	for (int16_t y=0; y<GLYPHCACHE_CHAR_HEIGHT * key->size; y++) {
+		for (int16_t x=0; x<width; x++) {
+			uint16_t pixel = framebuffer_getPixel(x, y);
+			const uint8_t* bytes = cell + y * GLYPHCACHE_ROW_BYTES(key->size) + x * 2;
+			if (bytes[0] != pixel >> 8 || bytes[1] != (pixel & 0xFF))
+				return false;
+		}
+	}
+	return true;
+}
+
+static glyphKey_t randomKey() {
+	const uint16_t colors[] = {0x0000, 0xFFFF, 0x001F, 0xF800, 0x07E0};
+	glyphKey_t key;
+	key.c = 32 + rand() % 95;
+	key.color = colors[rand() % 5];
+	do {
+		key.bg = colors[rand() % 5];
+	} while (key.bg == key.color);
+	key.size = 1 + rand() % GLYPHCACHE_MAX_TEXT_SIZE;
+	return key;
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t lookupCount = TEST_DEFAULT_LOOKUP_COUNT;
+	unsigned int seed = 1;
+	int option;
+	while ((option = getopt(argc, argv, "n:r:")) != -1) {
+		if (option == 'n')
+			lookupCount = strtoul(optarg, NULL, 0);
+		else if (option == 'r')
+			seed = strtoul(optarg, NULL, 0);
+		else {
+			fprintf(stderr, "usage: %s [-n lookups] [-r seed]\n", argv[0]);
+			return 1;
+		}
+	}
+	srand(seed);
+	framebuffer_init(FRAMEBUFFER_MAX_WIDTH, FRAMEBUFFER_MAX_HEIGHT);
+	glyphCache_clear();
+	bool failed = false;
+	if (glyphCache_get('A', 0xFFFF, 0x0000, 0) || glyphCache_get('A', 0xFFFF, 0x0000, GLYPHCACHE_MAX_TEXT_SIZE + 1)) {
+		printf("sizes 0 and GLYPHCACHE_MAX_TEXT_SIZE + 1 should not be cached\n");
+		failed = true;
+	}
+
+	glyphKey_t workingSet[TEST_WORKING_SET];
+	for (uint16_t i=0; i<TEST_WORKING_SET; i++)
+		workingSet[i] = randomKey();
+	glyphKey_t lru[GLYPHCACHE_ENTRY_COUNT];	// Most recent first.
+	uint16_t lruCount = 0;
+	const uint8_t* recentCells[GLYPHCACHE_ENTRY_COUNT];
+	glyphKey_t recentKeys[GLYPHCACHE_ENTRY_COUNT];
+	uint32_t expectedHits = 0, expectedMisses = 0, badCells = 0, staleCells = 0;
+	for (uint32_t n=0; n<lookupCount; n++) {
+		if (!(rand() % 64))
+			workingSet[rand() % TEST_WORKING_SET] = randomKey();	// Drift.
+		// Mostly the first half of the set, like the characters of a screen that is redrawn.
+		glyphKey_t key = workingSet[rand() % 4 ? rand() % (TEST_WORKING_SET / 2) : rand() % TEST_WORKING_SET];
+		uint16_t found = lruCount;
+		for (uint16_t i=0; i<lruCount; i++)
+			if (sameKey(&lru[i], &key))
+				found = i;
+		if (found < lruCount) {
+			expectedHits++;
+		} else {
+			expectedMisses++;
+			if (lruCount < GLYPHCACHE_ENTRY_COUNT)
+				lruCount++;
+			found = lruCount - 1;
+		}
+		memmove(&lru[1], &lru[0], found * sizeof(lru[0]));
+		lru[0] = key;
+		const uint8_t* cell = glyphCache_get(key.c, key.color, key.bg, key.size);
+		if (!cellMatches(cell, &key))
+			badCells++;
+		recentCells[n % GLYPHCACHE_ENTRY_COUNT] = cell;
+		recentKeys[n % GLYPHCACHE_ENTRY_COUNT] = key;
+		if (!(n % 997)) {
+			uint16_t recent = n + 1 < GLYPHCACHE_ENTRY_COUNT ? n + 1 : GLYPHCACHE_ENTRY_COUNT;
+			for (uint16_t i=0; i<recent; i++)
+				if (!cellMatches(recentCells[i], &recentKeys[i]))
+					staleCells++;
+		}
+	}
+	uint32_t hits, misses;
+	glyphCache_getStats(&hits, &misses);
+	printf("%lu lookups: %lu hits, %lu misses (LRU model: %lu, %lu), %lu wrong cells, %lu stale cells\n",
+			(unsigned long) lookupCount, (unsigned long) hits, (unsigned long) misses, (unsigned long) expectedHits,
+			(unsigned long) expectedMisses, (unsigned long) badCells, (unsigned long) staleCells);
+	if (hits != expectedHits || misses != expectedMisses || badCells || staleCells)
+		failed = true;
+
+	// Timing: the statistics screen's characters at size 1, opaque.
+	const char* text = "Cumulative run time in timerIsr: 3.51 (8.32%)";
+	uint16_t length = strlen(text);
+	glyphCache_clear();
+	clock_t start = clock();
+	uint32_t checksum = 0;
+	for (uint32_t i=0; i<TEST_TIMING_CHARS; i++)
+		checksum += glyphCache_get(text[i % length], 0xFFFF, 0x0000, 1)[i % 96];
+	double cacheSeconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	start = clock();
+	for (uint32_t i=0; i<TEST_TIMING_CHARS; i++)
+		framebuffer_drawChar((i % 53) * 6, 0, text[i % length], 0xFFFF, 0x0000, 1);
+	double expandSeconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	printf("lookups %.1f ns/char, framebuffer_drawChar %.1f ns/char (checksum %lu)\n", cacheSeconds * 1e9 / TEST_TIMING_CHARS,
+			expandSeconds * 1e9 / TEST_TIMING_CHARS, (unsigned long) checksum);
+	printf(failed ? "glyphCacheTest failed.\n" : "glyphCacheTest passed.\n");
+	return failed;
+}
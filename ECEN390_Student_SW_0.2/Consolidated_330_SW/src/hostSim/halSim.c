@@ -0,0 +1,132 @@
+/*
+ * halSim.c
+ */
+
+// Host stand-ins for the ZYBO HAL, see halSim.h. Only the functions that the laser-tag code calls are here.
+// The tree is compiled as C++, so the stubs leave out the names of the parameters they ignore.
+
+#include "halSim.h"
+#include "histogram.h"
+#include "channelPlan.h"
+#include "supportFiles/interrupts.h"
+#include "supportFiles/mio.h"
+#include "supportFiles/buttons.h"
+#include "supportFiles/switches.h"
+#include "supportFiles/leds.h"
+#include "supportFiles/utils.h"
+#include "supportFiles/intervalTimer.h"
+#include "supportFiles/globalTimer.h"
+#include "xil_printf.h"
+#include <stdio.h>
+#include <time.h>
+
+#define INTERVAL_TIMER_COUNT 3
+
+static uint16_t currentAdcData = 0;
+static uint8_t mioOutput[HALSIM_MIO_PIN_COUNT];
+static uint8_t mioInput[HALSIM_MIO_PIN_COUNT];
+static int32_t buttonsValue = 0;
+static int32_t switchesValue = 0;
+static int ledsValue = 0;
+static bool simulatedTime = false;
+static u64 simulatedTimerValue;
+
+void halSim_setAdcData(uint16_t adcData) {currentAdcData = adcData;}
+uint8_t halSim_readMioOutput(uint8_t mioPinNumber) {return mioOutput[mioPinNumber];}
+void halSim_setMioInput(uint8_t mioPinNumber, uint8_t value) {mioInput[mioPinNumber] = value;}
+void halSim_setButtons(int32_t value) {buttonsValue = value;}
+void halSim_setSwitches(int32_t value) {switchesValue = value;}
+int halSim_readLeds() {return ledsValue;}
+
+/*================================ interrupts ================================*/
+
+uint32_t interrupts_getAdcData() {return currentAdcData;}
+int interrupts_enableArmInts() {return 0;}
+int interrupts_disableArmInts() {return 0;}
+// There is no timerIsr() on the host, so the hooks are never called and the ISR is never counted.
+void interrupts_setTimerIsrEntryHook(void (* /*hook*/)(uint32_t privateTimerCounterValue)) {}
+void interrupts_setArmIntsHook(void (* /*hook*/)(bool enabled)) {}
+u32 interrupts_isrInvocationCount() {return 0;}
+u32 interrupts_getPrivateTimerLoadValue() {return CHANNELPLAN_PRIVATE_TIMER_LOAD_VALUE;}
+u32 interrupts_getPrivateTimerPrescalerValue() {return 0;}
+
+/*=============================== mio, buttons, ... ===============================*/
+
+int mio_init(bool /*printFailedStatusFlag*/) {return 0;}
+u8 mio_readPin(u8 mioPinNumber) {return mioInput[mioPinNumber];}
+void mio_writePin(u8 mioPinNumber, u8 value) {mioOutput[mioPinNumber] = value;}
+void mio_setPinAsInput(u8 /*mioPinNo*/) {}
+void mio_setPinAsOutput(u8 /*mioPinNo*/) {}
+int buttons_init() {return 0;}
+int32_t buttons_read() {return buttonsValue;}
+int switches_init() {return 0;}
+int32_t switches_read() {return switchesValue;}
+int leds_init(bool /*printFailedStatusFlag*/) {return 0;}
+void leds_write(int ledValue) {ledsValue = ledValue;}
+
+/*================================ Timers ================================*/
+
+// Host monotonic clock in global-timer ticks.
+static u64 hostTicks() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (u64) t.tv_sec * GLOBAL_TIMER_TICKS_PER_SECOND + (u64) t.tv_nsec * GLOBAL_TIMER_TICKS_PER_SECOND / 1000000000ULL;
+}
+
+void halSim_setGlobalTimerValue(uint64_t value) {
+	simulatedTimerValue = value;
+	simulatedTime = true;
+}
+
+u64 globalTimer_getTimerValue(void) {return simulatedTime ? simulatedTimerValue : hostTicks();}
+void globalTimer_startTimer(bool /*printStatusFlag*/) {}
+void globalTimer_stopTimer(bool /*printStatusFlag*/) {}
+
+void utils_msDelay(long ms) {
+	struct timespec t = {ms / 1000, (ms % 1000) * 1000000L};
+	nanosleep(&t, NULL);
+}
+
+static u64 intervalTimerStart[INTERVAL_TIMER_COUNT];
+static u64 intervalTimerTotal[INTERVAL_TIMER_COUNT];
+static bool intervalTimerRunning[INTERVAL_TIMER_COUNT];
+
+u32 intervalTimer_init(u32 timerNumber) {return intervalTimer_reset(timerNumber);}
+
+u32 intervalTimer_reset(u32 timerNumber) {
+	intervalTimerTotal[timerNumber] = 0;
+	intervalTimerRunning[timerNumber] = false;
+	return 0;
+}
+
+u32 intervalTimer_start(u32 timerNumber) {
+	intervalTimerStart[timerNumber] = hostTicks();
+	intervalTimerRunning[timerNumber] = true;
+	return 0;
+}
+
+u32 intervalTimer_stop(u32 timerNumber) {
+	if (intervalTimerRunning[timerNumber])
+		intervalTimerTotal[timerNumber] += hostTicks() - intervalTimerStart[timerNumber];
+	intervalTimerRunning[timerNumber] = false;
+	return 0;
+}
+
+u32 intervalTimer_getTotalDurationInSeconds(u32 timerNumber, double *seconds) {
+	*seconds = (double) intervalTimerTotal[timerNumber] / GLOBAL_TIMER_TICKS_PER_SECOND;
+	return 0;
+}
+
+/*================================ UART ================================*/
+
+void outbyte(char c) {putchar(c);}
+
+/*================================ Histogram ================================*/
+
+void histogram_init(uint16_t /*barCount*/) {}
+bool histogram_setBarData(uint16_t /*barIndex*/, histogram_data_t /*data*/, const char* /*label*/) {return true;}
+void histogram_setBarColor(uint16_t /*barIndex*/, uint16_t /*color*/) {}
+void histogram_setBarLabel(uint16_t /*barIndex*/, const char* /*label*/) {}
+void histogram_redrawBottomLabels() {}
+void histogram_updateDisplay() {}
+void trimLabel(char* /*label*/) {}
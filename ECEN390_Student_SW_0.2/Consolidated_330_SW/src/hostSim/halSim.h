@@ -0,0 +1,54 @@
+/*
+ * halSim.h
+ */
+
+#ifndef HALSIM_H_
+#define HALSIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Host stand-ins for the ZYBO HAL (supportFiles/interrupts, mio, buttons, switches, leds, utils, intervalTimer,
+// globalTimer) and for the histogram display, so that the laser-tag code in src/laserTag runs unchanged on Linux.
+// Nothing here touches hardware:
+// - interrupts_getAdcData() returns whatever halSim_setAdcData() stored last.
+// - mio_writePin() records the pin level so the simulator can read it back (e.g., the transmitter output).
+// - globalTimer_getTimerValue() and the interval timers run off the host's monotonic clock,
+//   scaled to GLOBAL_TIMER_TICKS_PER_SECOND so that the cycle counts printed by the runTests still make sense.
+//   Simulators that run faster than real time set the global timer themselves (halSim_setGlobalTimerValue()),
+//   since the timer service (timerService.h) takes its deadlines from it.
+// - The display and histogram calls do nothing.
+
+#define HALSIM_MIO_PIN_COUNT 54	// MIO pins on the Zynq.
+
+// The value the next interrupts_getAdcData() call returns.
+void halSim_setAdcData(uint16_t adcData);
+
+// Last value written to an MIO output pin with mio_writePin().
+uint8_t halSim_readMioOutput(uint8_t mioPinNumber);
+
+// Level mio_readPin() returns for an input pin.
+void halSim_setMioInput(uint8_t mioPinNumber, uint8_t value);
+
+// Values buttons_read() and switches_read() return.
+void halSim_setButtons(int32_t value);
+void halSim_setSwitches(int32_t value);
+
+// Last value written with leds_write().
+int halSim_readLeds();
+
+// From the first call on, globalTimer_getTimerValue() returns the last value set here instead of the host clock.
+// Call it before every isr_function() with the simulated time, e.g., tick * GLOBAL_TIMER_TICKS_PER_SECOND / 100000.
+// The interval timers stay on the host clock, so they still measure how long the host took.
+void halSim_setGlobalTimerValue(uint64_t value);
+
+// Simulated DMA acquisition (adcDmaSim.c, the host side of adcDma.h for ISR_USE_ADC_DMA builds).
+// One DMA peripheral request: copies the current ADC value into the double buffer like the DMA program does, and
+// runs the done interrupt when it is due. Call it once per simulated sample, before isr_function().
+void halSim_adcDmaRequest();
+
+// Delays the done interrupt by this many requests after a half fills (0, the default, runs it right away).
+// More than ADCDMA_BLOCK_SIZE makes the interrupt miss blocks, which adcDma_getLateBlockCount() should report.
+void halSim_setAdcDmaInterruptLatency(uint32_t requestCount);
+
+#endif /* HALSIM_H_ */
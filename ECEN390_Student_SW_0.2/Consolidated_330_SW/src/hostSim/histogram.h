@@ -0,0 +1,29 @@
+/*
+ * histogram.h
+ */
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Host stand-in for the course histogram library, which is not part of this tree. Declares only what
+// filter.c and main.c use. halSim.c implements the functions as no-ops. Only on the include path for src/hostSim builds.
+
+#define HISTOGRAM_MAX_BAR_DATA_IN_PIXELS 200
+#define HISTOGRAM_BAR_TOP_MAX_LABEL_WIDTH_IN_CHARS 6
+#define DISPLAY_BLUE 0x001F
+#define DISPLAY_RED 0xF800
+
+typedef uint16_t histogram_data_t;
+
+void histogram_init(uint16_t barCount);
+bool histogram_setBarData(uint16_t barIndex, histogram_data_t data, const char* label);
+void histogram_setBarColor(uint16_t barIndex, uint16_t color);
+void histogram_setBarLabel(uint16_t barIndex, const char* label);
+void histogram_redrawBottomLabels();
+void histogram_updateDisplay();
+void trimLabel(char* label);
+
+#endif /* HISTOGRAM_H_ */
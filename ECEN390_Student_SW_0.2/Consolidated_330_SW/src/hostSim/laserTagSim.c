@@ -0,0 +1,296 @@
+/*
+ * laserTagSim.c
+ */
+
+// Host-only laser-tag simulator: runs the real isr_function()/detector() code on synthesized ADC data,
+// faster than real time. src/hostSim is excluded from the ZYBO build in .cproject. To build and run it on a Linux host,
+// from Consolidated_330_SW (one command, split over lines here):
+//   g++ -O2 -x c++ -Isrc/hostSim -I. -Isrc/laserTag -I../HW3_bsp/ps7_cortexa9_0/include
+//     src/laserTag/isr.c src/laserTag/detector.c src/laserTag/filter.c src/laserTag/filterFixed.c src/laserTag/iirBank.c
+//     src/laserTag/windowedEnergy.c src/laserTag/slidingDft.c src/laserTag/orderStats.c src/laserTag/capture.c
+//     src/laserTag/staticQueue.c src/laserTag/queue.c src/laserTag/adcRing.c src/laserTag/timerService.c
+//     src/laserTag/transmitter.c src/laserTag/trigger.c src/laserTag/lockoutTimer.c src/laserTag/hitLedTimer.c
+//     src/laserTag/profiler.c src/laserTag/inputs.c src/hostSim/halSim.c src/hostSim/adcDmaSim.c src/hostSim/laserTagSim.c
+//     -o laserTagSim
+//   ./laserTagSim [-s shots] [-n noiseRms] [-a amplitude] [-m delayTicks:gain] [-b adcBits] [-p detectorPeriodTicks] [-r seed]
+//     [-w captureFile] [-i dmaInterruptLatencyTicks]
+//
+// Add -DISR_USE_ADC_DMA to simulate DMA acquisition (adcDmaSim.c): the samples reach the ADC buffer a block at a time
+// from the simulated DMA's done interrupt instead of one at a time from isr_function(). -i delays that interrupt.
+// The HAL is replaced by halSim.c. Every simulated tick (10 us) is one timer interrupt:
+// 1. The simulator builds the ADC sample from the transmitter's output pin (the real transmitter.c, so the waveform has
+//    exactly the freq[] periods): DC offset + amplitude * pin + multipath gain * amplitude * (pin delayTicks ago)
+//    + gaussian noise, quantized to adcBits and clamped to 0 .. FILTER_ADC_MAX.
+// 2. isr_function() stores the sample and dispatches the state machines that are due (timerService.c), with the
+//    global timer set to the simulated time.
+// Every detectorPeriodTicks, detector() runs, like the main loop on the ZYBO.
+// Shots cycle through players 0 .. 9, one every SIM_SHOT_SPACING_TICKS after a quiet lead-in.
+// With -w, detector_processBlock() records the raw samples and the power to captureFile (see capture.h), for captureReplay.
+// The detector starts the way shooterMode() starts it: lockoutTimer_start() right after the inits.
+// A hit on the player of the shot that is in progress (or just ended) counts as a detection. Later hits on the same
+// player while the shot is still in the power window are repeat hits: the 2 s window keeps the player's power above
+// the threshold that long, on the ZYBO too. They are reported but they are not false hits. Any other hit is a false
+// hit, and the shots are spaced so that the next one starts after the last repeat hit's lockout.
+// Prints whether the run passed (every shot detected, no false hits) and exits with 1 if it did not.
+//
+// Add -DAMP_ENABLE src/laserTag/amp.c src/hostSim/ampSim.c -lpthread to run the two-core split of amp.h: the detector
+// runs on a second thread (CPU1) and every detectorPeriodTicks the simulator calls amp_poll() instead of detector().
+// The simulated ticks are not paced to the clock, so the simulator waits whenever more than SIM_AMP_MAX_BACKLOG samples
+// are waiting in the ADC buffer, the way CPU1 keeps up with the real 100 kHz. The detection latency includes that
+// backlog.
+
+#include "halSim.h"
+#include "isr.h"
+#include "detector.h"
+#include "filter.h"
+#include "transmitter.h"
+#include "trigger.h"
+#include "inputs.h"
+#include "hitLedTimer.h"
+#include "lockoutTimer.h"
+#include "capture.h"
+#include "adcDma.h"
+#include "amp.h"
+#include "supportFiles/globalTimer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+
+#define SIM_TICKS_PER_SECOND 100000
+#define SIM_GLOBAL_TIMER_TICKS_PER_TICK (GLOBAL_TIMER_TICKS_PER_SECOND / SIM_TICKS_PER_SECOND)
+#define SIM_SHOT_LENGTH_TICKS 20000		// Same as PULSE_LENGTH in transmitter.c.
+#define SIM_SHOT_SPACING_TICKS 300000	// Longer than SIM_SHOT_IN_WINDOW_TICKS plus the 500 ms lockout.
+#define SIM_LEAD_IN_TICKS 100000		// Noise only before the first shot, to catch false hits.
+#define SIM_ATTRIBUTION_TICKS (SIM_SHOT_LENGTH_TICKS + 30000)	// Hits this long after a shot starts belong to it.
+// How long a shot stays in the power window: the detector hits again on it after every lockout until then.
+#define SIM_SHOT_IN_WINDOW_TICKS (SIM_SHOT_LENGTH_TICKS + CHANNELPLAN_POWER_WINDOW_LENGTH * CHANNELPLAN_DECIMATION_FACTOR)
+#define SIM_MAX_MULTIPATH_DELAY_TICKS 1024
+#define SIM_ADC_BITS 12
+#define SIM_AMP_MAX_BACKLOG 1000		// 10 ms of samples.
+
+#ifdef AMP_ENABLE
+#define SIM_DETECTOR() amp_poll()
+#define SIM_HIT_DETECTED() amp_hitDetected()
+#define SIM_CLEAR_HIT() amp_clearHit()
+#define SIM_GET_HIT_COUNTS(hitCounts) amp_getHitCounts(hitCounts)
+#else
+#define SIM_DETECTOR() detector()
+#define SIM_HIT_DETECTED() detector_hitDetected()
+#define SIM_CLEAR_HIT() detector_clearHit()
+#define SIM_GET_HIT_COUNTS(hitCounts) detector_getHitCounts(hitCounts)
+#endif
+
+typedef struct {
+	uint32_t shotCount;
+	double noiseRms;				// ADC counts.
+	double amplitude;				// ADC counts between transmitter off and on.
+	double dcOffset;				// ADC counts with the transmitter off.
+	uint32_t multipathDelayTicks;
+	double multipathGain;			// Relative to the direct path.
+	uint32_t adcBits;				// Effective ADC resolution, the low bits are dropped.
+	uint32_t detectorPeriodTicks;	// How often detector() runs.
+	uint32_t seed;
+	const char* captureFileName;	// NULL for no capture.
+	uint32_t dmaInterruptLatencyTicks;	// ISR_USE_ADC_DMA only.
+} simConfig_t;
+
+typedef struct {
+	uint32_t detectedCount;
+	uint32_t falseHitCount;
+	uint32_t repeatHitCount;		// Hits on the player of a shot that is still in the power window.
+	double totalLatencyInSeconds;
+	double minLatencyInSeconds;
+	double maxLatencyInSeconds;
+} simResults_t;
+
+static uint8_t pinHistory[SIM_MAX_MULTIPATH_DELAY_TICKS];	// Transmitter pin level, indexed by tick % size.
+
+// Standard normal random number (Box-Muller).
+static double gaussian() {
+	double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static uint16_t adcSample(const simConfig_t* config, uint64_t tick) {
+	uint8_t level = halSim_readMioOutput(TRANSMITTER_OUTPUT_PIN);
+	pinHistory[tick % SIM_MAX_MULTIPATH_DELAY_TICKS] = level;
+	double analog = config->dcOffset + config->amplitude * level + config->noiseRms * gaussian();
+	if (config->multipathGain != 0.0 && tick >= config->multipathDelayTicks)
+		analog += config->multipathGain * config->amplitude *
+				pinHistory[(tick - config->multipathDelayTicks) % SIM_MAX_MULTIPATH_DELAY_TICKS];
+	long code = lround(analog);
+	if (code < 0)
+		code = 0;
+	if (code > FILTER_ADC_MAX)
+		code = FILTER_ADC_MAX;
+	uint32_t droppedBits = SIM_ADC_BITS - config->adcBits;
+	return (uint16_t) ((code >> droppedBits) << droppedBits);
+}
+
+// Finds the channel whose hit count went up since the last call.
+static int16_t newHitChannel(detector_hitCount_t previousHitCounts[]) {
+	detector_hitCount_t hitCounts[FILTER_IIR_FILTER_COUNT];
+	SIM_GET_HIT_COUNTS(hitCounts);
+	int16_t channel = -1;
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
+		if (hitCounts[i] != previousHitCounts[i])
+			channel = i;
+		previousHitCounts[i] = hitCounts[i];
+	}
+	return channel;
+}
+
+static void runSimulation(const simConfig_t* config, simResults_t* results) {
+	memset(results, 0, sizeof(simResults_t));
+	results->minLatencyInSeconds = 1.0E9;
+	memset(pinHistory, 0, sizeof(pinHistory));
+	srand(config->seed);
+	isr_init();
+#ifdef AMP_ENABLE
+	amp_start();	// detector_init() runs on the other thread.
+#else
+	detector_init();
+#endif
+	transmitter_init();
+	hitLedTimer_init();
+	inputs_init();
+	trigger_init();
+#ifdef ISR_USE_ADC_DMA
+	halSim_setAdcDmaInterruptLatency(config->dmaInterruptLatencyTicks);
+	adcDma_init();
+	adcDma_start();
+#endif
+	lockoutTimer_start();	// Ignore erroneous hits at startup, like shooterMode().
+	detector_hitCount_t previousHitCounts[FILTER_IIR_FILTER_COUNT] = {0};
+	int64_t shotStartTick = -1;			// Start of the most recent shot, -1 before the first.
+	uint16_t shotPlayer = 0;
+	bool shotDetected = false;
+	uint64_t tickCount = SIM_LEAD_IN_TICKS + (uint64_t) config->shotCount * SIM_SHOT_SPACING_TICKS;
+	for (uint64_t tick=0; tick<tickCount; tick++) {
+		halSim_setGlobalTimerValue(tick * SIM_GLOBAL_TIMER_TICKS_PER_TICK);	// Simulated time for the timer service.
+		if (tick >= SIM_LEAD_IN_TICKS && (tick - SIM_LEAD_IN_TICKS) % SIM_SHOT_SPACING_TICKS == 0) {
+			shotPlayer = ((tick - SIM_LEAD_IN_TICKS) / SIM_SHOT_SPACING_TICKS) % FILTER_IIR_FILTER_COUNT;
+			transmitter_setFrequencyNumber(shotPlayer);
+			transmitter_run();
+			shotStartTick = tick;
+			shotDetected = false;
+		}
+		halSim_setAdcData(adcSample(config, tick));
+#ifdef ISR_USE_ADC_DMA
+		halSim_adcDmaRequest();	// The DMA takes the sample, isr_function() only runs the ticks.
+#endif
+		isr_function();
+#ifdef AMP_ENABLE
+		while (isr_adcBufferElementCount() > SIM_AMP_MAX_BACKLOG)
+			sched_yield();	// The host may have a single core.
+#endif
+		if ((tick + 1) % config->detectorPeriodTicks)
+			continue;
+		SIM_DETECTOR();
+		if (!SIM_HIT_DETECTED())
+			continue;
+		int16_t channel = newHitChannel(previousHitCounts);
+		SIM_CLEAR_HIT();
+		bool inShot = shotStartTick >= 0 && (int64_t) tick - shotStartTick < SIM_ATTRIBUTION_TICKS;
+		if (inShot && !shotDetected && channel == shotPlayer) {
+			shotDetected = true;
+			results->detectedCount++;
+			double latency = (double) (tick + 1 - shotStartTick) / SIM_TICKS_PER_SECOND;
+			results->totalLatencyInSeconds += latency;
+			if (latency < results->minLatencyInSeconds)
+				results->minLatencyInSeconds = latency;
+			if (latency > results->maxLatencyInSeconds)
+				results->maxLatencyInSeconds = latency;
+		} else if (shotDetected && channel == shotPlayer && (int64_t) tick - shotStartTick < SIM_SHOT_IN_WINDOW_TICKS) {
+			results->repeatHitCount++;
+		} else {
+			results->falseHitCount++;
+			printf("False hit at %.3lf s on channel %d\n", (double) tick / SIM_TICKS_PER_SECOND, channel);
+		}
+	}
+#ifdef AMP_ENABLE
+	amp_stop();
+	if (amp_getDroppedMessageCount())
+		printf("CPU1 dropped %u messages.\n", amp_getDroppedMessageCount());
+#endif
+}
+
+static double seconds() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1.0E-9;
+}
+
+int main(int argc, char* argv[]) {
+	simConfig_t config = {20, 20.0, 400.0, 1500.0, 0, 0.0, SIM_ADC_BITS, 1000, 1, NULL, 0};
+	int option;
+	while ((option = getopt(argc, argv, "s:n:a:m:b:p:r:w:i:")) != -1) {
+		switch (option) {
+		case 's': config.shotCount = atoi(optarg); break;
+		case 'n': config.noiseRms = atof(optarg); break;
+		case 'a': config.amplitude = atof(optarg); break;
+		case 'm': sscanf(optarg, "%u:%lf", &config.multipathDelayTicks, &config.multipathGain); break;
+		case 'b': config.adcBits = atoi(optarg); break;
+		case 'p': config.detectorPeriodTicks = atoi(optarg); break;
+		case 'r': config.seed = atoi(optarg); break;
+		case 'w': config.captureFileName = optarg; break;
+		case 'i': config.dmaInterruptLatencyTicks = atoi(optarg); break;
+		default:
+			printf("usage: %s [-s shots] [-n noiseRms] [-a amplitude] [-m delayTicks:gain] [-b adcBits] [-p detectorPeriodTicks] [-r seed] [-w captureFile] [-i dmaInterruptLatencyTicks]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (config.multipathDelayTicks >= SIM_MAX_MULTIPATH_DELAY_TICKS || config.adcBits < 1 || config.adcBits > SIM_ADC_BITS ||
+			config.detectorPeriodTicks == 0) {
+		printf("Multipath delay must be < %d ticks, ADC bits 1 .. %d, detector period > 0.\n", SIM_MAX_MULTIPATH_DELAY_TICKS, SIM_ADC_BITS);
+		return 2;
+	}
+	printf("Simulating %u shots: amplitude %.0lf, noise %.1lf rms, multipath %u ticks x %.2lf, %u-bit ADC, detector every %u ticks.\n",
+			config.shotCount, config.amplitude, config.noiseRms, config.multipathDelayTicks, config.multipathGain,
+			config.adcBits, config.detectorPeriodTicks);
+	FILE* captureFile = NULL;
+	capture_sink_t captureSink;
+	if (config.captureFileName) {
+		captureFile = fopen(config.captureFileName, "wb");
+		if (!captureFile) {
+			printf("Cannot open %s.\n", config.captureFileName);
+			return 2;
+		}
+		capture_initFileSink(&captureSink, captureFile);
+		capture_start(&captureSink, true);
+	}
+	simResults_t results;
+	double start = seconds();
+	runSimulation(&config, &results);
+	double elapsed = seconds() - start;
+	if (captureFile) {
+		capture_stop();
+		fclose(captureFile);
+		printf("Captured %u bytes to %s%s.\n", captureSink.byteCount, config.captureFileName, captureSink.failed ? " (write failed)" : "");
+	}
+	uint64_t sampleCount = isr_getTotalAdcSampleCount();
+	printf("Detected %u of %u shots, %u false hits, %u repeat hits.\n", results.detectedCount, config.shotCount,
+			results.falseHitCount, results.repeatHitCount);
+	if (results.detectedCount)
+		printf("Detection latency: mean %.1lf ms, min %.1lf ms, max %.1lf ms (from the start of the shot).\n",
+				1000.0 * results.totalLatencyInSeconds / results.detectedCount,
+				1000.0 * results.minLatencyInSeconds, 1000.0 * results.maxLatencyInSeconds);
+	printf("Processed %llu samples in %.2lf s: %.0lf samples/s, %.1lf x real time. ADC buffer overflows: %u.\n",
+			(unsigned long long) sampleCount, elapsed, sampleCount / elapsed,
+			sampleCount / elapsed / SIM_TICKS_PER_SECOND, isr_getAdcBufferOverflowCount());
+#ifdef ISR_USE_ADC_DMA
+	printf("DMA acquisition: %u blocks of %d samples, %u late.\n", adcDma_getBlockCount(), ADCDMA_BLOCK_SIZE, adcDma_getLateBlockCount());
+#endif
+	bool passed = results.detectedCount == config.shotCount && results.falseHitCount == 0;
+	if (passed)
+		printf("laserTagSim passed.\n");
+	else
+		printf("laserTagSim FAILED: %u of %u shots missed, %u false hits.\n", config.shotCount - results.detectedCount,
+				config.shotCount, results.falseHitCount);
+	return passed ? 0 : 1;
+}
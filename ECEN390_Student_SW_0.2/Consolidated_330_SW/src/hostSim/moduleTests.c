@@ -0,0 +1,95 @@
+/*
+ * moduleTests.c
+ */
+
+// Host-only driver for the module self-tests (the module_runTest() functions in src/laserTag) that do not need the
+// ZYBO. To build and run it on a Linux host, from Consolidated_330_SW (one command, split over lines here):
+//   g++ -O2 -x c++ -Isrc/hostSim -I. -Isrc/laserTag -I../HW3_bsp/ps7_cortexa9_0/include
+//     src/laserTag/filter.c src/laserTag/filterFixed.c src/laserTag/iirBank.c src/laserTag/windowedEnergy.c
+//     src/laserTag/queue.c src/laserTag/staticQueue.c src/laserTag/orderStats.c src/laserTag/adcRing.c
+//     src/laserTag/slidingDft.c src/laserTag/capture.c src/laserTag/isr.c src/laserTag/timerService.c
+//     src/laserTag/profiler.c src/laserTag/isrJitter.c src/laserTag/inputs.c src/hostSim/halSim.c
+//     src/hostSim/moduleTests.c -o moduleTests
+//   ./moduleTests [test ...]
+// Runs the named tests (all of them by default) in the order of the table below, and exits with 1 if any of them
+// fails. Add -DPROFILER_ENABLE to profile the modules and run profiler_runTest() too, and -DISRJITTER_ENABLE to run
+// isrJitter_runTest(). The cycle counts the tests print come from halSim.c's global timer, which runs off the host
+// clock: they compare the code paths on the host, they are not ZYBO numbers, and they vary by 10-20% from run to run.
+
+#include "adcRing.h"
+#include "capture.h"
+#include "filter.h"
+#include "filterFixed.h"
+#include "iirBank.h"
+#include "inputs.h"
+#include "isrJitter.h"
+#include "orderStats.h"
+#include "profiler.h"
+#include "slidingDft.h"
+#include "staticQueue.h"
+#include "windowedEnergy.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+	const char* name;
+	bool (*runTest)();
+} moduleTest_t;
+
+static const moduleTest_t tests[] = {
+	{"filterFixed", filterFixed_runTest},
+	{"iirBank", iirBank_runTest},
+	{"decimateBlock", filter_runDecimateBlockTest},
+	{"staticQueue", staticQueue_runTest},
+	{"windowedEnergy", windowedEnergy_runTest},
+	{"orderStats", orderStats_runTest},
+	{"adcRing", adcRing_runTest},
+	{"slidingDft", slidingDft_runTest},
+	{"capture", capture_runTest},
+	{"inputs", inputs_runTest},
+#ifdef PROFILER_ENABLE
+	{"profiler", profiler_runTest},
+#endif
+#ifdef ISRJITTER_ENABLE
+	{"isrJitter", isrJitter_runTest},
+#endif
+};
+
+#define TEST_COUNT (sizeof(tests) / sizeof(tests[0]))
+
+// True if the test was named on the command line, or if nothing was.
+static bool selected(const char* name, int argc, char* argv[]) {
+	if (argc < 2)
+		return true;
+	for (int i=1; i<argc; i++)
+		if (!strcmp(argv[i], name))
+			return true;
+	return false;
+}
+
+int main(int argc, char* argv[]) {
+	for (int i=1; i<argc; i++) {
+		uint16_t t = 0;
+		while (t < TEST_COUNT && strcmp(argv[i], tests[t].name))
+			t++;
+		if (t == TEST_COUNT) {
+			printf("moduleTests: no test named %s. The tests are:", argv[i]);
+			for (t=0; t<TEST_COUNT; t++)
+				printf(" %s", tests[t].name);
+			printf("\n");
+			return 2;
+		}
+	}
+	uint16_t failedCount = 0, runCount = 0;
+	for (uint16_t t=0; t<TEST_COUNT; t++) {
+		if (!selected(tests[t].name, argc, argv))
+			continue;
+		runCount++;
+		if (!tests[t].runTest()) {
+			printf("moduleTests: %s failed.\n", tests[t].name);
+			failedCount++;
+		}
+	}
+	printf("moduleTests %s: %d of %d tests failed.\n", failedCount ? "failed" : "passed", failedCount, runCount);
+	return failedCount ? 1 : 0;
+}
@@ -0,0 +1,399 @@
+/*
+ * timerServiceTest.c
+ */
+
+// Host-only check of the timer-service state machines (transmitter, hitLedTimer, lockoutTimer, trigger on
+// timerService.c) against the tick functions they replaced. Build it from Consolidated_330_SW (one command, split over
+// lines here):
+//   g++ -O2 -x c++ -Isrc/hostSim -I. -Isrc/laserTag -I../HW3_bsp/ps7_cortexa9_0/include
+//     src/laserTag/timerService.c src/laserTag/transmitter.c src/laserTag/trigger.c src/laserTag/lockoutTimer.c
+//     src/laserTag/hitLedTimer.c src/laserTag/inputs.c src/hostSim/halSim.c src/hostSim/timerServiceTest.c
+//     -o timerServiceTest
+//   ./timerServiceTest [-t ticks] [-r seed]
+//
+// The reference machines below are the old 100 kHz tick functions, unchanged except for names and for writing their
+// outputs to variables instead of the MIO pins. The trigger is the exception: it now sees the gun through the
+// debounced edges of inputs.c, so its reference samples the gun every INPUTS_SAMPLE_TICKS with a plain counter to
+// INPUTS_TRIGGER_DEBOUNCE_SAMPLES. Both sets run in lockstep on the same random stimulus: main-loop calls
+// (transmitter_run(), trigger_enable(), the timer starts, frequency changes), the gun input (long presses and
+// short bounces), and stretches where transmitter_run() is called every tick like continuousPowerMode() does.
+// After every tick the transmitter pin, the hit LED pin and LEDs, and the running flags have to be identical.
+// The second half of the run adds interrupt-entry jitter (the global timer reads up to half a tick late).
+// Then both are timed on the same stimulus: the four tick functions against timerService_dispatch().
+
+#include "halSim.h"
+#include "timerService.h"
+#include "transmitter.h"
+#include "trigger.h"
+#include "lockoutTimer.h"
+#include "hitLedTimer.h"
+#include "inputs.h"
+#include "supportFiles/buttons.h"
+#include "supportFiles/mio.h"
+#include "supportFiles/globalTimer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#define TEST_TICKS_PER_SECOND 100000
+#define TEST_GLOBAL_TIMER_TICKS_PER_TICK (GLOBAL_TIMER_TICKS_PER_SECOND / TEST_TICKS_PER_SECOND)
+#define TEST_MAX_JITTER (TEST_GLOBAL_TIMER_TICKS_PER_TICK / 2 - 1)	// The most timerService.h allows for.
+#define TEST_DEFAULT_TICK_COUNT 20000000	// 200 s.
+#define TEST_CONTINUOUS_PERIOD 2000000		// Every other 20 s the main loop calls transmitter_run() every tick.
+#define TEST_BENCHMARK_TICK_COUNT 2000000
+#define TEST_MAX_REPORTED_MISMATCHES 10
+#define TEST_TRANSMITTER_PIN 13
+#define TEST_HIT_LED_PIN 11
+#define TEST_GUN_PIN 10
+
+/*========================= Reference tick functions (the code timerService replaced) =========================*/
+
+#define PLAYER_FREQUENCIES 10
+#define PULSE_LENGTH 20000
+#define LED_TIME 50000
+#define LOCKOUT_TIME 50000
+#define GUN_TRIGGER_PRESSED 1
+
+static const uint8_t freq[PLAYER_FREQUENCIES] = {45,36,29,25,22,19,17,15,14,13};	// Same as transmitter.c.
+
+static uint8_t referenceTransmitterPin = 0;
+static uint8_t referenceHitLedPin = 0;
+static int referenceLeds = 0;
+
+enum {transmitterInit_st, transmitterHigh_st, transmitterLow_st} referenceTransmitterState = transmitterInit_st;
+static bool referenceTransmitterEnable = false;
+static uint16_t referenceTransmitterCount = 0;
+static uint8_t referenceFreqIndex = 0;
+
+static void referenceTransmitter_run() {referenceTransmitterEnable = true;}
+static bool referenceTransmitter_running() {return referenceTransmitterEnable;}
+static void referenceTransmitter_setFrequencyNumber(uint16_t frequencyNumber) {
+	if (!referenceTransmitter_running())
+		referenceFreqIndex = frequencyNumber;
+}
+
+static void referenceTransmitter_tick() {
+	switch(referenceTransmitterState) {
+	case transmitterHigh_st:
+	case transmitterLow_st:
+		referenceTransmitterCount++;
+		break;
+	default:
+		break;
+	}
+	switch(referenceTransmitterState) {
+	case transmitterInit_st:
+		if(referenceTransmitterEnable) {
+			referenceTransmitterState = transmitterHigh_st;
+			referenceTransmitterPin = 1;
+			referenceTransmitterCount = 0;
+		}
+		break;
+	case transmitterHigh_st:
+		if(referenceTransmitterCount == PULSE_LENGTH) {
+			referenceTransmitterEnable = false;
+			referenceTransmitterPin = 0;
+			referenceTransmitterState = transmitterInit_st;
+		} else if(!(referenceTransmitterCount % freq[referenceFreqIndex])) {
+			referenceTransmitterPin = 0;
+			referenceTransmitterState = transmitterLow_st;
+		}
+		break;
+	case transmitterLow_st:
+		if(referenceTransmitterCount == PULSE_LENGTH) {
+			referenceTransmitterEnable = false;
+			referenceTransmitterState = transmitterInit_st;
+		} else if(!(referenceTransmitterCount % freq[referenceFreqIndex])) {
+			referenceTransmitterPin = 1;
+			referenceTransmitterState = transmitterHigh_st;
+		}
+		break;
+	}
+}
+
+enum {ledInit_st, ledHigh_st} referenceLedState = ledInit_st;
+static volatile bool referenceLedEnable = false;
+static uint32_t referenceLedCount = 0;
+
+static void referenceHitLedTimer_start() {referenceLedEnable = true;}
+static bool referenceHitLedTimer_running() {return referenceLedEnable;}
+
+static void referenceHitLedTimer_tick() {
+	if (referenceLedState == ledHigh_st)
+		referenceLedCount++;
+	switch(referenceLedState) {
+	case ledInit_st:
+		if(referenceLedEnable) {
+			referenceLedState = ledHigh_st;
+			referenceHitLedPin = 1;
+			referenceLeds = 1;
+			referenceLedCount = 0;
+		}
+		break;
+	case ledHigh_st:
+		if(referenceLedCount == LED_TIME) {
+			referenceLedEnable = false;
+			referenceHitLedPin = 0;
+			referenceLeds = 0;
+			referenceLedState = ledInit_st;
+		}
+		break;
+	}
+}
+
+enum {lockoutInit_st, lockoutRun_st} referenceLockoutState = lockoutInit_st;
+static volatile bool referenceLockoutEnable = false;
+static uint32_t referenceLockoutCount = 0;
+
+static void referenceLockoutTimer_start() {referenceLockoutEnable = true;}
+static bool referenceLockoutTimer_running() {return referenceLockoutEnable;}
+
+static void referenceLockoutTimer_tick() {
+	if (referenceLockoutState == lockoutRun_st)
+		referenceLockoutCount++;
+	switch(referenceLockoutState) {
+	case lockoutInit_st:
+		if(referenceLockoutEnable) {
+			referenceLockoutState = lockoutRun_st;
+			referenceLockoutCount = 0;
+		}
+		break;
+	case lockoutRun_st:
+		if(referenceLockoutCount == LOCKOUT_TIME) {
+			referenceLockoutEnable = false;
+			referenceLockoutState = lockoutInit_st;
+		}
+		break;
+	}
+}
+
+enum {triggerWaitPress_st, triggerWaitRelease_st} referenceTriggerState = triggerWaitPress_st;
+static bool referenceTriggerEnable = false;
+static uint32_t referenceSampleCount = 0;		// Ticks since the last input sample.
+static bool referenceGunState = false;			// Debounced.
+static uint32_t referenceGunCount = 0;			// Samples in a row that disagreed with referenceGunState.
+
+// The same inputs as triggerPressed() in trigger.c. The gun is always connected here and btn0 is never pressed.
+static bool referenceTriggerPressed() {
+	return mio_readPin(TEST_GUN_PIN) == GUN_TRIGGER_PRESSED || (buttons_read() & BUTTONS_BTN0_MASK);
+}
+
+static void referenceTrigger_enable() {
+	if(referenceTransmitter_running() || referenceTriggerEnable)
+		return;
+	referenceTriggerState = triggerWaitPress_st;
+	referenceTriggerEnable = true;
+}
+
+// inputs.c sampling and debouncing the gun, and trigger.c on its edges.
+static void referenceTrigger_tick() {
+	if (referenceSampleCount++ % INPUTS_SAMPLE_TICKS)
+		return;
+	if (referenceTriggerPressed() == referenceGunState) {
+		referenceGunCount = 0;
+		return;
+	}
+	if (++referenceGunCount < INPUTS_TRIGGER_DEBOUNCE_SAMPLES)
+		return;
+	referenceGunCount = 0;
+	referenceGunState = !referenceGunState;
+	if (!referenceTriggerEnable)
+		return;
+	if (referenceTriggerState == triggerWaitPress_st && referenceGunState) {
+		referenceTriggerState = triggerWaitRelease_st;
+		referenceTransmitter_run();
+	} else if (referenceTriggerState == triggerWaitRelease_st && !referenceGunState) {
+		referenceTriggerEnable = false;
+		referenceTriggerState = triggerWaitPress_st;
+	}
+}
+
+// What isr_function() used to run.
+static void referenceTicks() {
+	referenceTransmitter_tick();
+	referenceHitLedTimer_tick();
+	referenceLockoutTimer_tick();
+	referenceTrigger_tick();
+}
+
+/*================================ Stimulus ================================*/
+
+// Which machines a stimulus step drives.
+#define TEST_DRIVE_REFERENCE 1
+#define TEST_DRIVE_SERVICE 2
+
+static uint64_t nextGunToggleTick = 0;
+static uint8_t gunLevel = 0;
+
+static bool chance(uint32_t oneIn) {
+	return rand() % oneIn == 0;
+}
+
+// The main-loop side of one tick, applied to one or both sets of machines. Uses the same number of rand() calls
+// whichever it drives, so two runs with the same seed see the same stimulus.
+static void stimulate(uint64_t tick, uint8_t drive) {
+	bool continuous = (tick / TEST_CONTINUOUS_PERIOD) % 2;
+	bool run = continuous || chance(10000);
+	bool setFrequency = chance(5000);
+	uint16_t frequencyNumber = rand() % PLAYER_FREQUENCIES;
+	bool enable = chance(3000);
+	bool startLockout = chance(50000);
+	bool startHitLed = chance(50000);
+	if (tick >= nextGunToggleTick) {
+		gunLevel ^= 1;
+		halSim_setMioInput(TEST_GUN_PIN, gunLevel);
+		// Mostly holds of up to 0.2 s, sometimes a bounce of a few ticks.
+		nextGunToggleTick = tick + (chance(4) ? 1 + rand() % 20 : 1 + rand() % 20000);
+	}
+	if (drive & TEST_DRIVE_REFERENCE) {
+		if (setFrequency)
+			referenceTransmitter_setFrequencyNumber(frequencyNumber);
+		if (run)
+			referenceTransmitter_run();
+		if (enable)
+			referenceTrigger_enable();
+		if (startLockout)
+			referenceLockoutTimer_start();
+		if (startHitLed)
+			referenceHitLedTimer_start();
+	}
+	if (drive & TEST_DRIVE_SERVICE) {
+		if (setFrequency)
+			transmitter_setFrequencyNumber(frequencyNumber);
+		if (run)
+			transmitter_run();
+		if (enable)
+			trigger_enable();
+		if (startLockout)
+			lockoutTimer_start();
+		if (startHitLed)
+			hitLedTimer_start();
+	}
+}
+
+// Global-timer value when the ISR for this tick reads it.
+static uint64_t isrTime(uint64_t tick, bool jitter) {
+	return tick * TEST_GLOBAL_TIMER_TICKS_PER_TICK + (jitter ? rand() % (TEST_MAX_JITTER + 1) : 0);
+}
+
+/*================================ Test ================================*/
+
+// Returns the number of ticks on which the outputs differed.
+static uint64_t compare(uint64_t startTick, uint64_t tickCount) {
+	uint64_t mismatchCount = 0;
+	uint64_t transmitterEdges = 0, shots = 0, hitLedStarts = 0;
+	uint8_t lastPin = 0;
+	bool lastRunning = false, lastHitLed = false;
+	for (uint64_t tick=startTick; tick<startTick+tickCount; tick++) {
+		stimulate(tick, TEST_DRIVE_REFERENCE | TEST_DRIVE_SERVICE);
+		halSim_setGlobalTimerValue(isrTime(tick, tick >= tickCount / 2));
+		referenceTicks();
+		timerService_dispatch();
+		uint8_t pin = halSim_readMioOutput(TEST_TRANSMITTER_PIN);
+		bool same = pin == referenceTransmitterPin &&
+				transmitter_running() == referenceTransmitter_running() &&
+				halSim_readMioOutput(TEST_HIT_LED_PIN) == referenceHitLedPin &&
+				halSim_readLeds() == referenceLeds &&
+				hitLedTimer_running() == referenceHitLedTimer_running() &&
+				lockoutTimer_running() == referenceLockoutTimer_running();
+		if (!same && mismatchCount++ < TEST_MAX_REPORTED_MISMATCHES)
+			printf("Tick %llu: transmitter pin %u (reference %u), running %d (%d), hit LED %u (%u), lockout %d (%d).\n",
+					(unsigned long long) tick, pin, referenceTransmitterPin, transmitter_running(), referenceTransmitter_running(),
+					halSim_readMioOutput(TEST_HIT_LED_PIN), referenceHitLedPin, lockoutTimer_running(),
+					referenceLockoutTimer_running());
+		transmitterEdges += pin != lastPin;
+		shots += transmitter_running() && !lastRunning;
+		hitLedStarts += hitLedTimer_running() && !lastHitLed;
+		lastPin = pin;
+		lastRunning = transmitter_running();
+		lastHitLed = hitLedTimer_running();
+	}
+	printf("Compared %llu ticks (jitter up to %d global-timer ticks in the second half): %llu transmitter edges, "
+			"%llu shots, %llu hit LED flashes, %u callbacks.\n",
+			(unsigned long long) tickCount, TEST_MAX_JITTER, (unsigned long long) transmitterEdges,
+			(unsigned long long) shots, (unsigned long long) hitLedStarts, timerService_getCallbackCount());
+	return mismatchCount;
+}
+
+static double seconds() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1.0E-9;
+}
+
+// Host time per ISR for one set of machines. With stimulus, the stimulus is timed on its own and taken out. Without it,
+// the gun is released and nothing is started, so the machines finish what they are doing and sit idle.
+static double benchmark(uint64_t startTick, uint8_t drive, bool withStimulus, uint32_t seed) {
+	srand(seed);
+	if (!withStimulus)
+		halSim_setMioInput(TEST_GUN_PIN, 0);
+	double totalSeconds = 0.0;
+	for (uint64_t tick=startTick; tick<startTick+TEST_BENCHMARK_TICK_COUNT; tick++) {
+		if (withStimulus)
+			stimulate(tick, drive);
+		halSim_setGlobalTimerValue(isrTime(tick, false));
+		double isrStart = seconds();
+		if (drive == TEST_DRIVE_REFERENCE)
+			referenceTicks();
+		else
+			timerService_dispatch();
+		totalSeconds += seconds() - isrStart;
+	}
+	double emptySeconds = 0.0;	// What the two clock reads around the ISR cost by themselves.
+	for (uint32_t i=0; i<TEST_BENCHMARK_TICK_COUNT; i++) {
+		double isrStart = seconds();
+		emptySeconds += seconds() - isrStart;
+	}
+	return 1.0E9 * (totalSeconds - emptySeconds) / TEST_BENCHMARK_TICK_COUNT;
+}
+
+// Times both sets from the same state on the same ticks and prints the result.
+static void compareTimes(const char* name, uint64_t startTick, bool withStimulus, uint32_t seed) {
+	uint64_t gunToggleTick = nextGunToggleTick;
+	uint8_t level = gunLevel;
+	halSim_setMioInput(TEST_GUN_PIN, gunLevel);
+	double referenceNs = benchmark(startTick, TEST_DRIVE_REFERENCE, withStimulus, seed);
+	nextGunToggleTick = gunToggleTick;
+	gunLevel = level;
+	halSim_setMioInput(TEST_GUN_PIN, gunLevel);
+	uint32_t callbackCount = timerService_getCallbackCount();
+	double serviceNs = benchmark(startTick, TEST_DRIVE_SERVICE, withStimulus, seed);
+	printf("%s: tick functions %.1lf ns per ISR, timerService_dispatch() %.1lf ns (%.4lf callbacks per dispatch).\n",
+			name, referenceNs, serviceNs, (double) (timerService_getCallbackCount() - callbackCount) / TEST_BENCHMARK_TICK_COUNT);
+}
+
+int main(int argc, char* argv[]) {
+	uint64_t tickCount = TEST_DEFAULT_TICK_COUNT;
+	uint32_t seed = 1;
+	int option;
+	while ((option = getopt(argc, argv, "t:r:")) != -1) {
+		switch (option) {
+		case 't': tickCount = strtoull(optarg, NULL, 10); break;
+		case 'r': seed = atoi(optarg); break;
+		default:
+			printf("usage: %s [-t ticks] [-r seed]\n", argv[0]);
+			return 2;
+		}
+	}
+	srand(seed);
+	halSim_setMioInput(TEST_GUN_PIN, 0);	// Released at init, so trigger_init() does not ignore the gun.
+	halSim_setGlobalTimerValue(0);
+	timerService_init();
+	transmitter_init();
+	hitLedTimer_init();
+	lockoutTimer_init();
+	inputs_init();
+	trigger_init();
+	inputs_start();		// Samples at tick 0 and every INPUTS_SAMPLE_TICKS, like referenceTrigger_tick().
+	uint64_t mismatchCount = compare(0, tickCount);
+
+	// The two sets are in the same state here, and after each benchmark.
+	printf("Host time over %d ticks, clock overhead taken out:\n", TEST_BENCHMARK_TICK_COUNT);
+	compareTimes("Same stimulus", tickCount, true, seed);
+	compareTimes("Idle", tickCount + TEST_BENCHMARK_TICK_COUNT, false, seed);
+
+	printf("timerServiceTest %s: %llu mismatched ticks.\n", mismatchCount ? "failed" : "passed",
+			(unsigned long long) mismatchCount);
+	return mismatchCount ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * transmitterTest.c
+ */
+
+// Host-only check of the transmitter's precomputed toggle schedule (src/laserTag/transmitter.c) against the
+// divide-per-edge state machine it replaced, and of the PWM load values TRANSMITTER_USE_PL_TIMER writes. Build it
+// from Consolidated_330_SW (one command, split over lines here):
+//   g++ -O2 -x c++ -Isrc/hostSim -I. -Isrc/laserTag -I../HW3_bsp/ps7_cortexa9_0/include
+//     src/laserTag/timerService.c src/laserTag/transmitter.c src/hostSim/halSim.c src/hostSim/transmitterTest.c
+//     -o transmitterTest
+//   ./transmitterTest [-p pulses] [-r seed]
+//
+// Each pulse is a list of edge timestamps in ticks from its start. Three lists have to be identical:
+// - the reference, from the scheduling code transmitter.c used before the table (next edge at the next multiple of
+//   the half-period, the end of the pulse at PULSE_LENGTH),
+// - the real transmitter, run by timerService_dispatch() one tick at a time on the simulated global timer, with a new
+//   pulse (and a random frequency) started as soon as the last one ends, like continuousPowerMode() does,
+// - a model of the AXI timer in PWM mode with TRANSMITTER_PWM_PERIOD_LOAD()/TRANSMITTER_PWM_HIGH_LOAD(), counted in
+//   timer clocks (this one is not run in the pulse sequence, the PL timer path does not run on the host).
+
+#include "halSim.h"
+#include "timerService.h"
+#include "transmitter.h"
+#include "supportFiles/globalTimer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define TEST_GLOBAL_TIMER_TICKS_PER_TICK (GLOBAL_TIMER_TICKS_PER_SECOND / TIMERSERVICE_TICKS_PER_SECOND)
+#define TEST_DEFAULT_PULSE_COUNT 1000
+#define TEST_MAX_EDGE_COUNT 2000				// 20000 / 13 edges plus the ends, with room to spare.
+#define TEST_MAX_REPORTED_MISMATCHES 10
+
+#define PLAYER_FREQUENCIES CHANNELPLAN_CHANNEL_COUNT
+#define PULSE_LENGTH CHANNELPLAN_MS_TO_TICKS(200)
+
+static const uint8_t freq[PLAYER_FREQUENCIES] = CHANNELPLAN_HALF_PERIOD_TICKS;	// Same as transmitter.c.
+
+typedef struct {
+	uint32_t tick[TEST_MAX_EDGE_COUNT];		// From the start of the pulse.
+	uint8_t level[TEST_MAX_EDGE_COUNT];		// Of the pin after the edge.
+	uint32_t count;
+} edges_t;
+
+static void addEdge(edges_t* edges, uint32_t tick, uint8_t level) {
+	if (edges->count < TEST_MAX_EDGE_COUNT) {
+		edges->tick[edges->count] = tick;
+		edges->level[edges->count] = level;
+	}
+	edges->count++;
+}
+
+// The edges of the scheduleNextTransition()/transmitter_transition() pair the table replaced, with its divides.
+static void referenceEdges(uint16_t halfPeriod, edges_t* edges) {
+	edges->count = 0;
+	uint8_t level = 1;
+	addEdge(edges, 0, level);
+	uint16_t count = 0;
+	while (true) {
+		count = (count / halfPeriod + 1) * halfPeriod;
+		if (count >= PULSE_LENGTH) {
+			if (level)
+				addEdge(edges, PULSE_LENGTH, 0);
+			return;
+		}
+		level = !level;
+		addEdge(edges, count, level);
+	}
+}
+
+// The AXI timer in PWM mode, in its own clocks: pwm0 goes high at every reload of counter 0 (every TLR0 + 2 clocks)
+// and low TLR1 + 2 clocks later, until pwmStop() PULSE_LENGTH ticks after pwmStart(). Returns false if an edge does
+// not fall on a tick.
+static bool pwmEdges(uint16_t halfPeriod, edges_t* edges) {
+	edges->count = 0;
+	uint64_t periodClocks = (uint64_t) TRANSMITTER_PWM_PERIOD_LOAD(halfPeriod) + 2;
+	uint64_t highClocks = (uint64_t) TRANSMITTER_PWM_HIGH_LOAD(halfPeriod) + 2;
+	uint64_t stopClocks = (uint64_t) PULSE_LENGTH * TRANSMITTER_PWM_CLOCKS_PER_TICK;
+	for (uint64_t start=0; start<stopClocks; start+=periodClocks) {
+		if (start % TRANSMITTER_PWM_CLOCKS_PER_TICK || (start + highClocks) % TRANSMITTER_PWM_CLOCKS_PER_TICK)
+			return false;
+		addEdge(edges, start / TRANSMITTER_PWM_CLOCKS_PER_TICK, 1);
+		uint64_t fall = start + highClocks < stopClocks ? start + highClocks : stopClocks;
+		addEdge(edges, fall / TRANSMITTER_PWM_CLOCKS_PER_TICK, 0);
+	}
+	return true;
+}
+
+// Returns true if the lists match, and prints the first difference if not.
+static bool sameEdges(const char* name, uint16_t frequencyNumber, const edges_t* edges, const edges_t* reference) {
+	if (edges->count != reference->count || edges->count > TEST_MAX_EDGE_COUNT) {
+		printf("%s, player %u: %lu edges, reference %lu.\n", name, frequencyNumber, (unsigned long) edges->count,
+				(unsigned long) reference->count);
+		return false;
+	}
+	for (uint32_t i=0; i<edges->count; i++)
+		if (edges->tick[i] != reference->tick[i] || edges->level[i] != reference->level[i]) {
+			printf("%s, player %u: edge %lu to %u at tick %lu, reference to %u at tick %lu.\n", name, frequencyNumber,
+					(unsigned long) i, edges->level[i], (unsigned long) edges->tick[i], reference->level[i],
+					(unsigned long) reference->tick[i]);
+			return false;
+		}
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t pulseCount = TEST_DEFAULT_PULSE_COUNT;
+	uint32_t seed = 1;
+	int option;
+	while ((option = getopt(argc, argv, "p:r:")) != -1) {
+		switch (option) {
+		case 'p': pulseCount = strtoul(optarg, NULL, 10); break;
+		case 'r': seed = atoi(optarg); break;
+		default:
+			printf("usage: %s [-p pulses] [-r seed]\n", argv[0]);
+			return 2;
+		}
+	}
+	srand(seed);
+	static edges_t reference[PLAYER_FREQUENCIES];
+	static edges_t edges;
+	uint32_t mismatchCount = 0;
+	for (uint16_t i=0; i<PLAYER_FREQUENCIES; i++) {
+		referenceEdges(freq[i], &reference[i]);
+		bool exact = pwmEdges(freq[i], &edges);
+		if (!exact)
+			printf("PWM model, player %u: an edge is not on a tick.\n", i);
+		if ((!exact || !sameEdges("PWM model", i, &edges, &reference[i])) && mismatchCount++ >= TEST_MAX_REPORTED_MISMATCHES)
+			break;
+	}
+
+	halSim_setGlobalTimerValue(0);
+	timerService_init();
+	transmitter_init();
+	uint64_t tick = 0;
+	uint64_t edgeCount = 0;
+	for (uint32_t pulse=0; pulse<pulseCount && mismatchCount<TEST_MAX_REPORTED_MISMATCHES; pulse++) {
+		// The first pulses go through the players in order, then they are random.
+		uint16_t frequencyNumber = pulse < PLAYER_FREQUENCIES ? pulse : rand() % PLAYER_FREQUENCIES;
+		transmitter_setFrequencyNumber(frequencyNumber);
+		transmitter_run();
+		edges.count = 0;
+		uint8_t level = halSim_readMioOutput(TRANSMITTER_OUTPUT_PIN);
+		uint64_t startTick = tick + 1;	// transmitter_run() takes effect at the next dispatch.
+		do {
+			tick++;
+			halSim_setGlobalTimerValue(tick * TEST_GLOBAL_TIMER_TICKS_PER_TICK);
+			timerService_dispatch();
+			uint8_t pin = halSim_readMioOutput(TRANSMITTER_OUTPUT_PIN);
+			if (pin != level)
+				addEdge(&edges, tick - startTick, pin);
+			level = pin;
+		} while (transmitter_running() && tick - startTick <= 2 * PULSE_LENGTH);
+		edgeCount += edges.count;
+		if (!sameEdges("Transmitter", frequencyNumber, &edges, &reference[frequencyNumber]))
+			mismatchCount++;
+	}
+	printf("Compared %lu pulses (%llu edges) and the PWM loads of %d players.\n", (unsigned long) pulseCount,
+			(unsigned long long) edgeCount, PLAYER_FREQUENCIES);
+	printf("transmitterTest %s: %lu mismatched pulses.\n", mismatchCount ? "failed" : "passed",
+			(unsigned long) mismatchCount);
+	return mismatchCount ? 1 : 0;
+}
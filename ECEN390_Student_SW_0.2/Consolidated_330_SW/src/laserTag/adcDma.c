@@ -0,0 +1,181 @@
+/*
+ * adcDma.c
+ */
+
+#include "adcDma.h"
+#include "isr.h"
+#include "profiler.h"
+#include "supportFiles/interrupts.h"
+#include "xdmaps.h"
+#include "xsysmon_hw.h"
+#include "xparameters.h"
+#include "xil_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DMA_DEVICE_ID XPAR_XDMAPS_1_DEVICE_ID	// The secure DMAC interface, the one standalone programs use.
+#define DMA_DONE_INTERRUPT_ID XPAR_XDMAPS_0_DONE_INTR_0	// Done interrupt for event ADCDMA_CHANNEL (0).
+#define XADC_AUX_14_DATA_ADDRESS (XPAR_AXI_XADC_0_BASEADDR + XSM_AUX14_OFFSET)
+#define BLOCK_BYTE_COUNT (ADCDMA_BLOCK_SIZE * sizeof(uint32_t))
+#define CACHE_LINE_SIZE 32
+#define PROGRAM_BUFFER_SIZE 128
+#define INNER_LOOP_COUNT 256					// A loop counter holds at most 256 iterations.
+#define OUTER_LOOP_COUNT (ADCDMA_BLOCK_SIZE / INNER_LOOP_COUNT)
+
+// Channel control: 4-byte single reads from the fixed XADC register, 4-byte single writes to incrementing addresses.
+// Bits as in XDmaPs_ToCCRValue(): [17:15] dst burst size, [14] dst inc, [3:1] src burst size, [0] src inc.
+#define CCR_BURST_SIZE_4_BYTES 2
+#define CCR_VALUE ((CCR_BURST_SIZE_4_BYTES << 15) | (1 << 14) | (CCR_BURST_SIZE_4_BYTES << 1))
+
+// PL330 instruction encodings (DMA-330 TRM, the same ones xdmaps.c uses). Arguments that name a peripheral or an
+// event go in bits [7:3] of the second byte.
+#define DMAEND 0x00
+#define DMAWMB 0x13
+#define DMALP(lc) (0x20 | ((lc) << 1))
+#define DMALDPS 0x25		// Load, single, and tell the peripheral.
+#define DMALPEND(lc) (0x38 | ((lc) << 2))
+#define DMALPFE_END 0x28	// DMALPEND with nf = 0: loop forever.
+#define DMAST 0x08
+#define DMAWFPS 0x30		// Wait for a single request from the peripheral.
+#define DMASEV 0x34
+#define DMAFLUSHP 0x35
+#define DMAMOV 0xBC
+#define DMAMOV_SAR 0
+#define DMAMOV_CCR 1
+#define DMAMOV_DAR 2
+
+static XDmaPs dma;
+static XDmaPs_Cmd dmaCommand;
+static uint32_t dmaBuffer[2][ADCDMA_BLOCK_SIZE] __attribute__ ((aligned (CACHE_LINE_SIZE)));	// The two halves.
+static char dmaProgram[PROGRAM_BUFFER_SIZE] __attribute__ ((aligned (CACHE_LINE_SIZE)));
+static uint32_t dmaProgramLength;
+static volatile uint32_t blockCount;
+static volatile uint32_t lateBlockCount;
+static uint32_t lastFinishedHalf = 1;	// As if half 1 was just handled, the first block is half 0.
+
+/*========================= DMA program ==========================*/
+
+static char* emit1(char* program, uint8_t opcode) {
+	*program++ = opcode;
+	return program;
+}
+
+static char* emit2(char* program, uint8_t opcode, uint8_t number) {
+	*program++ = opcode;
+	*program++ = number << 3;
+	return program;
+}
+
+static char* emitMov(char* program, uint8_t rd, uint32_t value) {
+	*program++ = DMAMOV;
+	*program++ = rd;
+	for (uint16_t i=0; i<4; i++)	// Little-endian, not aligned.
+		*program++ = (value >> (8 * i)) & 0xFF;
+	return program;
+}
+
+static char* emitLoop(char* program, uint8_t lc, uint16_t count) {
+	*program++ = DMALP(lc);
+	*program++ = count - 1;
+	return program;
+}
+
+static char* emitLoopEnd(char* program, uint8_t opcode, const char* bodyStart) {
+	*program = opcode;
+	*(program+1) = program - bodyStart;	// Backward jump to the first instruction of the body.
+	return program + 2;
+}
+
+// Fills one half: ADCDMA_BLOCK_SIZE paced reads of the XADC register, then the done event.
+static char* emitHalf(char* program, uint32_t* half) {
+	program = emitMov(program, DMAMOV_DAR, (uint32_t) half);
+	program = emitLoop(program, 0, OUTER_LOOP_COUNT);
+	char* outerBody = program;
+	program = emitLoop(program, 1, INNER_LOOP_COUNT);
+	char* innerBody = program;
+	program = emit2(program, DMAWFPS, ADCDMA_PERIPHERAL_REQUEST);
+	program = emit2(program, DMALDPS, ADCDMA_PERIPHERAL_REQUEST);
+	program = emit1(program, DMAST);
+	program = emit2(program, DMAFLUSHP, ADCDMA_PERIPHERAL_REQUEST);
+	program = emitLoopEnd(program, DMALPEND(1), innerBody);
+	program = emitLoopEnd(program, DMALPEND(0), outerBody);
+	program = emit1(program, DMAWMB);	// The block is in memory before the interrupt.
+	return emit2(program, DMASEV, ADCDMA_CHANNEL);
+}
+
+// CCR and SAR once, then half 0, half 1, half 0, ... forever.
+static uint32_t buildProgram(char* program) {
+	char* start = program;
+	program = emitMov(program, DMAMOV_CCR, CCR_VALUE);
+	program = emitMov(program, DMAMOV_SAR, XADC_AUX_14_DATA_ADDRESS);
+	char* foreverBody = program;
+	program = emitHalf(program, dmaBuffer[0]);
+	program = emitHalf(program, dmaBuffer[1]);
+	program = emitLoopEnd(program, DMALPFE_END, foreverBody);
+	program = emit1(program, DMAEND);
+	return program - start;
+}
+
+/*========================= Done interrupt ==========================*/
+
+// The DMA raises the event after it finishes a half and then moves on to the other one. The destination address
+// tells which half it is in now, so a late interrupt still picks the half that was just finished.
+static void adcDmaIsr(void* /*callBackRef*/) {
+	PROFILER_BEGIN(PROFILER_ZONE_ADC_DMA);
+	uint32_t base = dma.Config.BaseAddress;
+	XDmaPs_WriteReg(base, XDMAPS_INTCLR_OFFSET, 1 << ADCDMA_CHANNEL);
+	uint32_t destination = XDmaPs_ReadReg(base, XDmaPs_DA_n_OFFSET(ADCDMA_CHANNEL));
+	// Right after the last write of half 0 the address is still at its end, which is the start of half 1. Either way
+	// half 0 is the one that finished.
+	uint32_t finishedHalf = (destination - (uint32_t) dmaBuffer[1] < BLOCK_BYTE_COUNT) ? 0 : 1;
+	if (finishedHalf == lastFinishedHalf)
+		lateBlockCount++;	// The other half finished and was overwritten while this interrupt was pending.
+	lastFinishedHalf = finishedHalf;
+	Xil_DCacheInvalidateRange((unsigned int) dmaBuffer[finishedHalf], BLOCK_BYTE_COUNT);
+	isr_addXadcBlockToAdcBuffer(dmaBuffer[finishedHalf], ADCDMA_BLOCK_SIZE);
+	blockCount++;
+	PROFILER_END(PROFILER_ZONE_ADC_DMA);
+}
+
+/*========================= Interface ==========================*/
+
+int adcDma_init() {
+	XDmaPs_Config* config = XDmaPs_LookupConfig(DMA_DEVICE_ID);
+	if (!config) {
+		printf("adcDma_init: XDmaPs_LookupConfig failed.\n\r");
+		return XST_FAILURE;
+	}
+	int status = XDmaPs_CfgInitialize(&dma, config, config->BaseAddress);
+	if (status != XST_SUCCESS) {
+		printf("adcDma_init: XDmaPs_CfgInitialize failed.\n\r");
+		return status;
+	}
+	dmaProgramLength = buildProgram(dmaProgram);
+	return interrupts_connectHandler(DMA_DONE_INTERRUPT_ID, adcDmaIsr, &dma);
+}
+
+void adcDma_start() {
+	blockCount = 0;
+	lateBlockCount = 0;
+	lastFinishedHalf = 1;
+	// The DMA reads the program from memory and writes the buffers behind the cache's back.
+	Xil_DCacheFlushRange((unsigned int) dmaProgram, PROGRAM_BUFFER_SIZE);
+	Xil_DCacheInvalidateRange((unsigned int) dmaBuffer, sizeof(dmaBuffer));
+	memset(&dmaCommand, 0, sizeof(dmaCommand));	// No BD, so XDmaPs_Start() does not touch the cache itself.
+	dmaCommand.UserDmaProg = dmaProgram;
+	dmaCommand.UserDmaProgLength = dmaProgramLength;
+	if (XDmaPs_Start(&dma, ADCDMA_CHANNEL, &dmaCommand, 0) != XST_SUCCESS)
+		printf("adcDma_start: XDmaPs_Start failed.\n\r");
+}
+
+void adcDma_stop() {
+	XDmaPs_ResetChannel(&dma, ADCDMA_CHANNEL);
+}
+
+uint32_t adcDma_getBlockCount() {
+	return blockCount;
+}
+
+uint32_t adcDma_getLateBlockCount() {
+	return lateBlockCount;
+}
@@ -0,0 +1,47 @@
+/*
+ * adcDma.h
+ */
+
+#ifndef ADCDMA_H_
+#define ADCDMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DMA acquisition of the XADC samples (ISR_USE_ADC_DMA in isr.h). The PL330 DMA controller (XDmaPs) reads the XADC's
+// aux channel 14 data register once per sample request and writes it into one half of a double buffer.
+// When a half is full the DMA program raises an interrupt and keeps going in the other half, so the DMA never stops
+// and there is one interrupt per ADCDMA_BLOCK_SIZE samples instead of one per sample. The interrupt hands the
+// finished half to isr_addXadcBlockToAdcBuffer(), which converts it into the ADC buffer that detector() reads.
+//
+// Each sample is paced by DMA peripheral request ADCDMA_PERIPHERAL_REQUEST (DMAC_DRREQ from the PL). The hardware
+// design has to drive it at 100 kHz, e.g., from a PL counter on FCLK. The DMA does not check when the
+// XADC converted, like interrupts_getAdcData() it reads whatever the latest conversion is.
+//
+// The timer ISR still dispatches the timer service. It has to stay at 100 kHz as long as the transmitter makes its
+// waveform from timer-service deadlines, because the player half-periods are only 13 to 45 ticks long.
+//
+// The host simulator uses src/hostSim/adcDmaSim.c, which implements this same interface.
+
+#define ADCDMA_BLOCK_SIZE 1024				// Samples per interrupt, 10.24 ms at 100 kHz.
+#define ADCDMA_CHANNEL 0					// DMA channel, its done interrupt is DMASEV event ADCDMA_CHANNEL.
+#define ADCDMA_PERIPHERAL_REQUEST 0			// PL DMA request line that paces the samples.
+
+// Sets up the DMA controller and connects the done interrupt to the GIC. Call after interrupts_initAll().
+// Returns 0 (XST_SUCCESS) on success.
+int adcDma_init();
+
+// Starts the DMA program. The first block arrives ADCDMA_BLOCK_SIZE sample requests later.
+void adcDma_start();
+
+// Stops the DMA channel. The partly filled block is lost.
+void adcDma_stop();
+
+// Number of blocks handed to the ADC buffer.
+uint32_t adcDma_getBlockCount();
+
+// Number of times the done interrupt ran so late that the DMA had already finished the other half too.
+// Each one means a block of samples was overwritten before it was read.
+uint32_t adcDma_getLateBlockCount();
+
+#endif /* ADCDMA_H_ */
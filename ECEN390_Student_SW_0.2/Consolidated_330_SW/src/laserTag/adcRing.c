@@ -0,0 +1,181 @@
+/*
+ * adcRing.c
+ */
+
+#include "adcRing.h"
+#include <stdio.h>
+
+void adcRing_init(adcRing_t* ring) {
+	ring->head = 0;
+	ring->tail = 0;
+	ring->overflowCount = 0;
+	ring->highWatermark = 0;
+}
+
+bool adcRing_push(adcRing_t* ring, adcRing_data_t value) {
+	adcRing_counter_t head = ring->head;	// Only the producer writes head, so this is current.
+	adcRing_counter_t tail = ring->tail;	// May be stale, which only makes the ring look fuller.
+	uint32_t count = head - tail;
+	if (count >= ADCRING_SIZE) {
+		ring->overflowCount++;
+		return false;
+	}
+	ring->data[head & ADCRING_INDEX_MASK] = value;
+	ADCRING_RELEASE_BARRIER();	// Data must be visible before the consumer can see the new head.
+	ring->head = head + 1;
+	if (count + 1 > ring->highWatermark)
+		ring->highWatermark = count + 1;
+	return true;
+}
+
+uint32_t adcRing_reserveSpan(adcRing_t* ring, adcRing_data_t** data) {
+	adcRing_counter_t head = ring->head;
+	uint32_t freeCount = ADCRING_SIZE - (head - ring->tail);	// tail may be stale, which only makes the ring look fuller.
+	uint32_t index = head & ADCRING_INDEX_MASK;
+	*data = &ring->data[index];
+	if (freeCount > ADCRING_SIZE - index)
+		return ADCRING_SIZE - index;	// Stop at the end of the array.
+	return freeCount;
+}
+
+void adcRing_commit(adcRing_t* ring, uint32_t count) {
+	ADCRING_RELEASE_BARRIER();	// Data must be visible before the consumer can see the new head.
+	adcRing_counter_t head = ring->head + count;
+	ring->head = head;
+	uint32_t elementCount = head - ring->tail;
+	if (elementCount > ring->highWatermark)
+		ring->highWatermark = elementCount;
+}
+
+void adcRing_addOverflow(adcRing_t* ring, uint32_t count) {
+	ring->overflowCount += count;
+}
+
+uint32_t adcRing_elementCount(adcRing_t* ring) {
+	return ring->head - ring->tail;
+}
+
+uint32_t adcRing_peekSpan(adcRing_t* ring, const adcRing_data_t** data) {
+	adcRing_counter_t head = ring->head;	// Read the producer's counter once.
+	ADCRING_ACQUIRE_BARRIER();	// Don't read any data until head has been read.
+	adcRing_counter_t tail = ring->tail;
+	uint32_t count = head - tail;
+	uint32_t index = tail & ADCRING_INDEX_MASK;
+	*data = &ring->data[index];
+	if (count > ADCRING_SIZE - index)
+		return ADCRING_SIZE - index;	// Stop at the end of the array.
+	return count;
+}
+
+void adcRing_consume(adcRing_t* ring, uint32_t count) {
+	ADCRING_RELEASE_BARRIER();	// Finish reading the data before the producer can overwrite it.
+	ring->tail = ring->tail + count;	// Only the consumer writes tail.
+}
+
+bool adcRing_pop(adcRing_t* ring, adcRing_data_t* value) {
+	const adcRing_data_t* data;
+	if (!adcRing_peekSpan(ring, &data))
+		return false;
+	*value = *data;
+	adcRing_consume(ring, 1);
+	return true;
+}
+
+uint32_t adcRing_getOverflowCount(adcRing_t* ring) {
+	return ring->overflowCount;
+}
+
+uint32_t adcRing_getHighWatermark(adcRing_t* ring) {
+	return ring->highWatermark;
+}
+
+/*=============================== Test Functions ==============================*/
+
+#define TEST_COUNTER_START 0xFFFFFF00UL	// Start just below 2^32 so the counters wrap during the test.
+#define TEST_OVERFLOW_COUNT 10
+#define TEST_BLOCK_SIZE 1000	// Not a power of two, so the blocks do not line up with the end of the array.
+
+static adcRing_t testRing;
+
+// Drains the ring with peekSpan()/consume(). Returns false if the values are not expectedValue, expectedValue+1, ...
+static bool testDrain(adcRing_data_t expectedValue, uint32_t expectedCount) {
+	uint32_t drainedCount = 0;
+	const adcRing_data_t* span;
+	uint32_t spanCount;
+	while ((spanCount = adcRing_peekSpan(&testRing, &span)) != 0) {
+		for (uint32_t i=0; i<spanCount; i++) {
+			if (span[i] != expectedValue) {
+				printf("adcRing_runTest: read %d, expected %d.\n\r", span[i], expectedValue);
+				return false;
+			}
+			expectedValue++;
+		}
+		adcRing_consume(&testRing, spanCount);
+		drainedCount += spanCount;
+	}
+	if (drainedCount != expectedCount) {
+		printf("adcRing_runTest: drained %lu samples, expected %lu.\n\r", (unsigned long) drainedCount,
+				(unsigned long) expectedCount);
+		return false;
+	}
+	return true;
+}
+
+bool adcRing_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("adcRing_runTest: single-threaded checks.\n\r");
+	// 1. Fill the ring exactly, starting partway through the array so that the data wrap too.
+	adcRing_init(&testRing);
+	testRing.head = testRing.tail = (adcRing_counter_t) (TEST_COUNTER_START + ADCRING_SIZE / 2);
+	for (uint32_t i=0; i<ADCRING_SIZE; i++)
+		success &= adcRing_push(&testRing, i);
+	if (adcRing_elementCount(&testRing) != ADCRING_SIZE || adcRing_getHighWatermark(&testRing) != ADCRING_SIZE) {
+		printf("adcRing_runTest: element count %lu, high watermark %lu, expected %lu.\n\r",
+				(unsigned long) adcRing_elementCount(&testRing), (unsigned long) adcRing_getHighWatermark(&testRing),
+				ADCRING_SIZE);
+		success = false;
+	}
+	// 2. Pushing into a full ring drops the new samples.
+	for (uint32_t i=0; i<TEST_OVERFLOW_COUNT; i++)
+		success &= !adcRing_push(&testRing, 0);
+	if (adcRing_getOverflowCount(&testRing) != TEST_OVERFLOW_COUNT) {
+		printf("adcRing_runTest: overflow count %lu, expected %d.\n\r",
+				(unsigned long) adcRing_getOverflowCount(&testRing), TEST_OVERFLOW_COUNT);
+		success = false;
+	}
+	// 3. Everything comes back out in order, in two spans.
+	success &= testDrain(0, ADCRING_SIZE);
+	// 4. Counters wrap past 2^32.
+	adcRing_init(&testRing);
+	testRing.head = testRing.tail = TEST_COUNTER_START;
+	for (uint32_t i=0; i<2*(0xFFFFFFFFUL - TEST_COUNTER_START); i++)
+		success &= adcRing_push(&testRing, i);
+	success &= testDrain(0, 2*(0xFFFFFFFFUL - TEST_COUNTER_START));
+	// 5. Block writes with reserveSpan()/commit(), wrapping the array, until the ring is full.
+	adcRing_init(&testRing);
+	testRing.head = testRing.tail = (adcRing_counter_t) (TEST_COUNTER_START + ADCRING_SIZE - TEST_BLOCK_SIZE / 2);
+	uint32_t pushedCount = 0;
+	adcRing_data_t* freeSpan;
+	uint32_t freeCount;
+	while ((freeCount = adcRing_reserveSpan(&testRing, &freeSpan)) != 0) {
+		uint32_t blockCount = (freeCount < TEST_BLOCK_SIZE) ? freeCount : TEST_BLOCK_SIZE;
+		for (uint32_t i=0; i<blockCount; i++)
+			freeSpan[i] = pushedCount + i;
+		adcRing_commit(&testRing, blockCount);
+		pushedCount += blockCount;
+	}
+	if (pushedCount != ADCRING_SIZE || adcRing_getHighWatermark(&testRing) != ADCRING_SIZE) {
+		printf("adcRing_runTest: block writes pushed %lu samples, high watermark %lu, expected %lu.\n\r",
+				(unsigned long) pushedCount, (unsigned long) adcRing_getHighWatermark(&testRing), ADCRING_SIZE);
+		success = false;
+	}
+	success &= testDrain(0, ADCRING_SIZE);
+	// 6. pop() on an empty ring.
+	adcRing_data_t value;
+	if (adcRing_pop(&testRing, &value)) {
+		printf("adcRing_runTest: pop() succeeded on an empty ring.\n\r");
+		success = false;
+	}
+	printf("adcRing_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
@@ -0,0 +1,81 @@
+/*
+ * adcRing.h
+ */
+
+#ifndef ADCRING_H_
+#define ADCRING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Lock-free single-producer/single-consumer ring buffer for handing ADC samples from the timer ISR to main.
+// The producer (isr_function()) only writes head, the consumer (detector()) only writes tail. Both are free-running
+// counters that are never wrapped, the element count is always head - tail (unsigned math handles the 2^32 wrap).
+// The size is a power of two so the array index is just counter & ADCRING_INDEX_MASK.
+// Nothing is shared read-modify-write, so neither side has to disable interrupts.
+// When the ring is full the newest sample is dropped (the producer never touches tail) and overflowCount is incremented.
+
+#define ADCRING_SIZE_LOG2 17	// 131072 samples (256 KB), a little over 1 second at 100 kHz.
+#define ADCRING_SIZE (1UL << ADCRING_SIZE_LOG2)
+#define ADCRING_INDEX_MASK (ADCRING_SIZE - 1)
+#define ADCRING_CACHE_LINE_SIZE 64	// Keeps head and tail on separate cache lines (32 bytes on the A9, 64 on most hosts).
+
+// Release: the data write is visible before head moves (producer), the data reads are done before tail moves (consumer).
+// Acquire: nothing is read from the data array until the counter has been read.
+// Both are a DMB on ARM and only stop compiler reordering on x86, where stores and loads are already ordered.
+#define ADCRING_RELEASE_BARRIER() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define ADCRING_ACQUIRE_BARRIER() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
+typedef uint16_t adcRing_data_t;	// Raw 12-bit XADC samples, converted to float only inside the FIR filter.
+typedef uint32_t adcRing_counter_t;
+
+typedef struct {
+	// Producer side.
+	volatile adcRing_counter_t head __attribute__ ((aligned (ADCRING_CACHE_LINE_SIZE)));	// Total samples pushed.
+	volatile uint32_t overflowCount;	// Samples dropped because the ring was full.
+	volatile uint32_t highWatermark;	// Most samples ever held at once.
+	// Consumer side.
+	volatile adcRing_counter_t tail __attribute__ ((aligned (ADCRING_CACHE_LINE_SIZE)));	// Total samples consumed.
+	adcRing_data_t data[ADCRING_SIZE] __attribute__ ((aligned (ADCRING_CACHE_LINE_SIZE)));
+} adcRing_t;
+
+// Empties the ring and clears the counters. Do this before the producer starts.
+void adcRing_init(adcRing_t* ring);
+
+// Producer only. Adds a sample. Returns false (and counts an overflow) if the ring is full.
+bool adcRing_push(adcRing_t* ring, adcRing_data_t value);
+
+// Producer only. Block version of adcRing_push() for a producer that delivers many samples at once (adcDma.c).
+// Points *data at the next free slot and returns how many samples can be written in place from there
+// (stops at the end of the array like adcRing_peekSpan()).
+uint32_t adcRing_reserveSpan(adcRing_t* ring, adcRing_data_t** data);
+
+// Producer only. Publishes count samples written through adcRing_reserveSpan() with a single head update.
+void adcRing_commit(adcRing_t* ring, uint32_t count);
+
+// Producer only. Counts count samples that were dropped because adcRing_reserveSpan() had no room for them.
+void adcRing_addOverflow(adcRing_t* ring, uint32_t count);
+
+// Either side. Number of samples in the ring, may already be stale when it returns.
+uint32_t adcRing_elementCount(adcRing_t* ring);
+
+// Consumer only. Points *data at the oldest sample and returns how many samples can be read in place from there.
+// Stops at the end of the array, the rest of the samples are returned by the next call after adcRing_consume().
+uint32_t adcRing_peekSpan(adcRing_t* ring, const adcRing_data_t** data);
+
+// Consumer only. Releases count samples returned by adcRing_peekSpan().
+void adcRing_consume(adcRing_t* ring, uint32_t count);
+
+// Consumer only. Removes the oldest sample into *value. Returns false if the ring is empty.
+bool adcRing_pop(adcRing_t* ring, adcRing_data_t* value);
+
+// Number of samples dropped because the ring was full.
+uint32_t adcRing_getOverflowCount(adcRing_t* ring);
+
+// Most samples the ring has held at once.
+uint32_t adcRing_getHighWatermark(adcRing_t* ring);
+
+// Single-threaded checks of wrap-around, spans and overflow. The two-thread stress test is in src/hostSim.
+bool adcRing_runTest();
+
+#endif /* ADCRING_H_ */
@@ -0,0 +1,186 @@
+/*
+ * amp.c
+ */
+
+#include "amp.h"
+#include "hitLedTimer.h"
+#include <string.h>
+
+// CPU0's copy of what CPU1 last reported. Only amp_poll() writes it.
+static bool hitFlag = false;
+static detector_hitCount_t hitCounts[DETECTOR_HIT_ARRAY_SIZE];
+static double currentPower[FILTER_IIR_FILTER_COUNT];
+static double maxLatencyInSeconds = 0.0;
+static uint64_t latestSampleCount = 0;	// Of the newest message seen, the two mailboxes are not in step.
+
+/*========================= Mailboxes ==========================*/
+
+void amp_mailboxInit(amp_mailbox_t* mailbox) {
+	mailbox->head = 0;
+	mailbox->tail = 0;
+	mailbox->droppedCount = 0;
+}
+
+bool amp_mailboxSend(amp_mailbox_t* mailbox, const amp_message_t* message) {
+	uint32_t head = mailbox->head;	// Only the sender writes head, so this is current.
+	if (head - mailbox->tail >= AMP_MAILBOX_SIZE) {	// tail may be stale, which only makes the mailbox look fuller.
+		mailbox->droppedCount++;
+		return false;
+	}
+	mailbox->messages[head & AMP_MAILBOX_INDEX_MASK] = *message;
+	ADCRING_RELEASE_BARRIER();	// The message must be visible before the receiver can see the new head.
+	mailbox->head = head + 1;
+	return true;
+}
+
+bool amp_mailboxReceive(amp_mailbox_t* mailbox, amp_message_t* message) {
+	uint32_t tail = mailbox->tail;
+	if (mailbox->head == tail)
+		return false;
+	ADCRING_ACQUIRE_BARRIER();	// Nothing is read from the message until head has been read.
+	*message = mailbox->messages[tail & AMP_MAILBOX_INDEX_MASK];
+	ADCRING_RELEASE_BARRIER();	// Done reading before the sender can reuse the slot.
+	mailbox->tail = tail + 1;
+	return true;
+}
+
+/*========================= CPU1 ==========================*/
+
+// Fills in the parts every message has.
+static void fillMessage(amp_message_t* message, amp_messageType_t type, uint64_t sampleCount) {
+	message->type = type;
+	message->channel = 0;
+	message->sampleCount = sampleCount;
+	detector_blockLatency_t latency;
+	detector_getBlockLatency(&latency);
+	message->maxLatencyInSeconds = latency.maxLatencyInSeconds;
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		message->power[i] = filter_getCurrentPowerValue(i);
+	detector_getHitCounts(message->hitCounts);
+}
+
+void amp_cpu1Main() {
+	amp_platformInit();
+	amp_shared_t* shared = amp_platformShared();
+	detector_init();
+	detector_startLockout();	// Ignore hits at startup, when all power values are essentially 0.
+	shared->cpu1Running = true;
+	detector_hitCount_t previousHitCounts[DETECTOR_HIT_ARRAY_SIZE] = {0};
+	uint64_t sampleCount = 0;
+	uint64_t nextSnapshot = AMP_POWER_SNAPSHOT_SAMPLES;
+	amp_message_t message;
+	while (!shared->stopRequested) {
+		uint32_t processedCount = detector_processBlock();
+		if (!processedCount) {
+			amp_platformIdle();
+			continue;
+		}
+		sampleCount += processedCount;
+		if (detector_hitDetected()) {
+			detector_clearHit();
+			fillMessage(&message, AMP_MESSAGE_HIT, sampleCount);
+			for (uint16_t i=0; i<DETECTOR_HIT_ARRAY_SIZE; i++) {
+				if (message.hitCounts[i] != previousHitCounts[i])
+					message.channel = i;
+				previousHitCounts[i] = message.hitCounts[i];
+			}
+			amp_mailboxSend(&shared->hitMailbox, &message);
+		}
+		if (sampleCount >= nextSnapshot) {
+			fillMessage(&message, AMP_MESSAGE_POWER, sampleCount);
+			amp_mailboxSend(&shared->powerMailbox, &message);
+			nextSnapshot = sampleCount + AMP_POWER_SNAPSHOT_SAMPLES;
+		}
+	}
+	shared->cpu1Running = false;
+}
+
+/*========================= CPU0 ==========================*/
+
+void amp_start() {
+	amp_platformInit();
+	amp_shared_t* shared = amp_platformShared();
+	amp_mailboxInit(&shared->hitMailbox);
+	amp_mailboxInit(&shared->powerMailbox);
+	shared->stopRequested = false;
+	shared->cpu1Running = false;
+	hitFlag = false;
+	memset(hitCounts, 0, sizeof(hitCounts));
+	memset(currentPower, 0, sizeof(currentPower));
+	maxLatencyInSeconds = 0.0;
+	latestSampleCount = 0;
+	amp_platformStartCpu1();
+	while (!shared->cpu1Running)
+		;	// detector_init() on CPU1 only takes a moment.
+}
+
+void amp_stop() {
+	amp_platformShared()->stopRequested = true;
+	amp_platformWaitForCpu1();
+}
+
+// Copies out what every message carries, unless a newer message already did.
+static void takeMessage(const amp_message_t* message) {
+	if (message->sampleCount < latestSampleCount)
+		return;
+	latestSampleCount = message->sampleCount;
+	for (uint16_t i=0; i<DETECTOR_HIT_ARRAY_SIZE; i++)
+		hitCounts[i] = message->hitCounts[i];
+	maxLatencyInSeconds = message->maxLatencyInSeconds;
+}
+
+void amp_poll() {
+	amp_shared_t* shared = amp_platformShared();
+	amp_message_t message;
+	while (amp_mailboxReceive(&shared->hitMailbox, &message)) {
+		takeMessage(&message);
+		hitFlag = true;
+		hitLedTimer_start();	// Runs off CPU0's timer ISR, like the rest of the timers.
+	}
+	bool gotPower = false;
+	while (amp_mailboxReceive(&shared->powerMailbox, &message))
+		gotPower = true;	// Only the newest snapshot matters.
+	if (gotPower) {
+		for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+			currentPower[i] = message.power[i];
+		takeMessage(&message);
+	}
+}
+
+bool amp_hitDetected() {
+	return hitFlag;
+}
+
+void amp_clearHit() {
+	hitFlag = false;
+}
+
+void amp_getHitCounts(detector_hitCount_t hitArray[]) {
+	for (uint16_t i=0; i<DETECTOR_HIT_ARRAY_SIZE; i++)
+		hitArray[i] = hitCounts[i];
+}
+
+// Same as filter_getNormalizedPowerValues(), on the last snapshot.
+void amp_getNormalizedPowerValues(double normalizedArray[], uint16_t* indexOfMaxValue) {
+	uint16_t max = 0;
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
+		if (currentPower[i] > currentPower[max])
+			max = i;
+	}
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		normalizedArray[i] = currentPower[max] > 0.0 ? currentPower[i] / currentPower[max] : 0.0;
+	*indexOfMaxValue = max;
+}
+
+double amp_getCurrentPowerValue(uint16_t filterNumber) {
+	return currentPower[filterNumber];
+}
+
+double amp_getMaxDetectorLatencyInSeconds() {
+	return maxLatencyInSeconds;
+}
+
+uint32_t amp_getDroppedMessageCount() {
+	amp_shared_t* shared = amp_platformShared();
+	return shared->hitMailbox.droppedCount + shared->powerMailbox.droppedCount;
+}
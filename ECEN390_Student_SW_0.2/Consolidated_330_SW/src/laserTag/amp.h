@@ -0,0 +1,115 @@
+/*
+ * amp.h
+ */
+
+#ifndef AMP_H_
+#define AMP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "adcRing.h"
+#include "filter.h"
+#include "detector.h"
+
+// Splits the laser-tag code across the two Cortex-A9 cores of the Zynq (AMP, each core runs its own ELF):
+// - CPU0 keeps everything it had except the detector: the timer ISR (ADC samples into the ring, transmitter, trigger,
+//   hitLedTimer), the buttons and switches, the TFT and the reports.
+// - CPU1 runs amp_cpu1Main(): it drains the ADC ring and runs the filters and the hit detection, nothing else.
+// The ADC ring (adcRing.h) and the mailboxes below live in memory that both cores map non-cacheable, so the
+// single-producer/single-consumer rules of adcRing.h carry over: CPU0 is the only producer of samples, CPU1 the only
+// producer of messages. CPU1 sends two kinds of message: a hit event (with the hit counts after the hit) and, every
+// AMP_POWER_SNAPSHOT_SAMPLES, the current power of every channel. amp_poll() on CPU0 reads them and keeps the latest,
+// and the amp_get*() calls below stand in for the detector_*() and filter_*() calls the main loop used before.
+//
+// Uncomment to build the split. Both ELFs need it. The CPU1 ELF also defines AMP_CPU1 (in its project settings), which
+// makes its main() call amp_cpu1Main(). The CPU1 BSP needs USE_AMP=1 and both linker scripts have to leave out the
+// memory at AMP_ADC_RING_ADDRESS and AMP_SHARED_ADDRESS.
+// The host build (src/hostSim/ampSim.c) runs amp_cpu1Main() on a second thread instead.
+//#define AMP_ENABLE
+
+#define AMP_SHARED_ADDRESS 0xFFFF0000		// Top 64 KB of OCM, mailboxes and flags.
+#define AMP_ADC_RING_ADDRESS 0x1FF00000		// Last MB of the 512 MB DDR, the ADC ring (256 KB) does not fit in OCM.
+#define AMP_CPU1_START_ADDRESS 0x02000000	// Entry point of the CPU1 ELF, must match its linker script.
+#define AMP_MAILBOX_SIZE 32					// Messages, a power of two.
+#define AMP_MAILBOX_INDEX_MASK (AMP_MAILBOX_SIZE - 1)
+#define AMP_POWER_SNAPSHOT_SAMPLES 10000	// CPU1 sends the power values every 100 ms of ADC samples.
+
+typedef enum {
+	AMP_MESSAGE_HIT,
+	AMP_MESSAGE_POWER
+} amp_messageType_t;
+
+typedef struct {
+	uint32_t type;						// amp_messageType_t.
+	uint32_t channel;					// AMP_MESSAGE_HIT: the channel that was hit.
+	uint64_t sampleCount;				// ADC samples CPU1 had processed when it sent the message.
+	float maxLatencyInSeconds;			// detector_blockLatency_t.maxLatencyInSeconds on CPU1.
+	float power[FILTER_IIR_FILTER_COUNT];	// AMP_MESSAGE_POWER: filter_getCurrentPowerValue() of every channel.
+	detector_hitCount_t hitCounts[DETECTOR_HIT_ARRAY_SIZE];	// detector_getHitCounts() when it was sent.
+} amp_message_t;
+
+// Single-producer/single-consumer message ring, same counter scheme as adcRing_t. A full mailbox drops the new message.
+typedef struct {
+	volatile uint32_t head __attribute__ ((aligned (ADCRING_CACHE_LINE_SIZE)));	// Written by CPU1 only.
+	volatile uint32_t droppedCount;
+	volatile uint32_t tail __attribute__ ((aligned (ADCRING_CACHE_LINE_SIZE)));	// Written by CPU0 only.
+	amp_message_t messages[AMP_MAILBOX_SIZE] __attribute__ ((aligned (ADCRING_CACHE_LINE_SIZE)));
+} amp_mailbox_t;
+
+// Everything at AMP_SHARED_ADDRESS. Hits and power snapshots have their own mailboxes so that a burst of snapshots
+// cannot crowd out a hit.
+typedef struct {
+	amp_mailbox_t hitMailbox;
+	amp_mailbox_t powerMailbox;
+	volatile uint32_t stopRequested;	// Set by CPU0, amp_cpu1Main() returns when it sees it.
+	volatile uint32_t cpu1Running;		// Set by CPU1 once the detector is initialized, cleared when it returns.
+} amp_shared_t;
+
+// CPU0. Clears the mailboxes and the flags, starts amp_cpu1Main() on CPU1 and waits until it is running.
+// Call after isr_init(), which empties the ADC ring.
+void amp_start();
+
+// CPU0. Asks CPU1 to stop and waits until it has.
+void amp_stop();
+
+// CPU1. Initializes the detector and runs it on the ADC ring until amp_stop(). Never called on CPU0.
+void amp_cpu1Main();
+
+// CPU0. Reads every message CPU1 has sent since the last call and starts the hitLedTimer for each hit.
+// Call it where the main loop called detector() before.
+void amp_poll();
+
+// CPU0. Same as detector_hitDetected(), detector_clearHit() and detector_getHitCounts(), from the messages.
+bool amp_hitDetected();
+void amp_clearHit();
+void amp_getHitCounts(detector_hitCount_t hitArray[]);
+
+// CPU0. Same as filter_getNormalizedPowerValues() and filter_getCurrentPowerValue(), from the last power snapshot.
+void amp_getNormalizedPowerValues(double normalizedArray[], uint16_t* indexOfMaxValue);
+double amp_getCurrentPowerValue(uint16_t filterNumber);
+
+// CPU0. Max detector latency on CPU1 as of the last message.
+double amp_getMaxDetectorLatencyInSeconds();
+
+// CPU0. Messages CPU1 had to drop because a mailbox was full.
+uint32_t amp_getDroppedMessageCount();
+
+// Mailbox calls. Send is CPU1 only, receive CPU0 only.
+void amp_mailboxInit(amp_mailbox_t* mailbox);
+bool amp_mailboxSend(amp_mailbox_t* mailbox, const amp_message_t* message);
+bool amp_mailboxReceive(amp_mailbox_t* mailbox, amp_message_t* message);
+
+// Platform side: ampZynq.c on the board, src/hostSim/ampSim.c on the host.
+// Maps the shared memory for the calling core (non-cacheable on the Zynq). Each core calls it before touching it.
+void amp_platformInit();
+amp_shared_t* amp_platformShared();
+// The ADC ring isr.c uses instead of its own when AMP_ENABLE is defined.
+adcRing_t* amp_platformAdcRing();
+// CPU0. Starts amp_cpu1Main() on the other core.
+void amp_platformStartCpu1();
+// CPU0. Returns once amp_cpu1Main() has returned.
+void amp_platformWaitForCpu1();
+// CPU1. Called when the ADC ring is empty, to let the other side run.
+void amp_platformIdle();
+
+#endif /* AMP_H_ */
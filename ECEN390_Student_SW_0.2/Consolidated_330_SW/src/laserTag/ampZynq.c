@@ -0,0 +1,48 @@
+/*
+ * ampZynq.c
+ */
+
+// Zynq side of the amp.h platform calls. src/hostSim/ampSim.c is the host side.
+
+#include "amp.h"
+#include "xil_io.h"
+#include "xil_mmu.h"
+#include "xpseudo_asm.h"
+
+// Shareable, non-cacheable, full access (TEX=b100, C=B=0, AP=b11, domain b1111), one entry per 1 MB section.
+// Both cores see each other's writes without any cache maintenance, so the adcRing.h barriers are all that is needed.
+#define SHARED_TLB_ATTRIBUTES 0x14de2
+#define TLB_SECTION_SIZE 0x100000
+// The boot ROM parks CPU1 in a WFE loop that jumps to whatever address is written here (UG585, Starting Code on CPU 1).
+#define CPU1_START_ADDRESS_REGISTER 0xFFFFFFF0
+
+#define sev() __asm__ __volatile__ ("sev" : : : "memory")
+
+void amp_platformInit() {
+	Xil_SetTlbAttributes(AMP_SHARED_ADDRESS, SHARED_TLB_ATTRIBUTES);
+	for (uint32_t offset=0; offset<sizeof(adcRing_t); offset+=TLB_SECTION_SIZE)
+		Xil_SetTlbAttributes(AMP_ADC_RING_ADDRESS + offset, SHARED_TLB_ATTRIBUTES);
+}
+
+amp_shared_t* amp_platformShared() {
+	return (amp_shared_t*) AMP_SHARED_ADDRESS;
+}
+
+adcRing_t* amp_platformAdcRing() {
+	return (adcRing_t*) AMP_ADC_RING_ADDRESS;
+}
+
+void amp_platformStartCpu1() {
+	Xil_Out32(CPU1_START_ADDRESS_REGISTER, AMP_CPU1_START_ADDRESS);
+	dsb();	// The address has to be there before CPU1 wakes up and reads it.
+	sev();
+}
+
+void amp_platformWaitForCpu1() {
+	while (amp_platformShared()->cpu1Running)
+		;
+}
+
+// Nothing else runs on CPU1, so it just polls again. WFE would need CPU0 to SEV from its timer ISR for every sample.
+void amp_platformIdle() {
+}
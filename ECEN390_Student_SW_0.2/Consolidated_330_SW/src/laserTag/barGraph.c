@@ -0,0 +1,151 @@
+/*
+ * barGraph.c
+ */
+
+#include "barGraph.h"
+#include "supportFiles/display.h"
+#include <string.h>
+
+#define CHAR_WIDTH 6				// Text size 1, drawChar() paints the whole cell, background included.
+#define CHAR_HEIGHT 8
+#define TOP_LABEL_Y 0
+#define BAR_TOP_Y (CHAR_HEIGHT + 2)	// Highest pixel a full bar reaches.
+#define BOTTOM_MARGIN (CHAR_HEIGHT + 2)	// Below the baseline: the bar numbers.
+#define BAR_GAP 4					// Pixels between neighboring bars.
+#define BAR_COLOR DISPLAY_BLUE
+#define BACKGROUND_COLOR DISPLAY_BLACK
+#define TEXT_COLOR DISPLAY_WHITE
+
+typedef struct {
+	uint16_t height;							// What the next flush should show.
+	uint16_t color;
+	char label[BARGRAPH_MAX_LABEL_CHARS + 1];	// Padded with spaces to labelChars.
+	uint16_t drawnHeight;						// What is on the screen.
+	uint16_t drawnColor;
+	char drawnLabel[BARGRAPH_MAX_LABEL_CHARS + 1];
+} bar_t;
+
+static bar_t bars[BARGRAPH_MAX_BAR_COUNT];
+static uint16_t barCount = 0;
+static uint16_t slotWidth;
+static uint16_t barWidth;
+static uint16_t baselineY;				// First row below the bars.
+static uint16_t maxBarHeight;
+static uint16_t labelChars;
+static uint16_t graphWidth;
+static uint16_t graphHeight;
+
+static uint16_t barX(uint16_t index) {
+	return index * slotWidth + BAR_GAP / 2;
+}
+
+static uint16_t labelX(uint16_t index) {
+	return index * slotWidth + (slotWidth - labelChars * CHAR_WIDTH) / 2;
+}
+
+// fillRect() that also counts the pixels sent.
+static uint32_t fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+	if (w <= 0 || h <= 0)
+		return 0;
+	display_fillRect(x, y, w, h, color);
+	return (uint32_t) w * h;
+}
+
+static uint32_t drawChar(int16_t x, int16_t y, char c) {
+	display_drawChar(x, y, c, TEXT_COLOR, BACKGROUND_COLOR, 1);
+	return CHAR_WIDTH * CHAR_HEIGHT;
+}
+
+void barGraph_init(uint16_t count) {
+	barCount = count < BARGRAPH_MAX_BAR_COUNT ? count : BARGRAPH_MAX_BAR_COUNT;
+	if (!barCount)
+		barCount = 1;
+	graphWidth = display_width();
+	graphHeight = display_height();
+	slotWidth = graphWidth / barCount;
+	barWidth = slotWidth - BAR_GAP;
+	baselineY = graphHeight - BOTTOM_MARGIN;
+	maxBarHeight = baselineY - BAR_TOP_Y;
+	labelChars = slotWidth / CHAR_WIDTH;
+	if (labelChars > BARGRAPH_MAX_LABEL_CHARS)
+		labelChars = BARGRAPH_MAX_LABEL_CHARS;
+	for (uint16_t i=0; i<barCount; i++) {
+		bars[i].height = 0;
+		bars[i].color = BAR_COLOR;
+		memset(bars[i].label, ' ', labelChars);
+		bars[i].label[labelChars] = '\0';
+	}
+	barGraph_redrawAll();
+}
+
+uint16_t barGraph_getMaxBarHeight() {
+	return maxBarHeight;
+}
+
+uint16_t barGraph_getLabelChars() {
+	return labelChars;
+}
+
+bool barGraph_setBar(uint16_t barIndex, uint16_t height, const char* label) {
+	if (barIndex >= barCount)
+		return false;
+	bar_t* bar = &bars[barIndex];
+	bool inRange = height <= maxBarHeight;
+	bar->height = inRange ? height : maxBarHeight;
+	if (label) {
+		// Copy what fits, pad the rest with spaces so the old characters get overwritten.
+		uint16_t i = 0;
+		for (; i<labelChars && label[i]; i++)
+			bar->label[i] = label[i];
+		for (; i<labelChars; i++)
+			bar->label[i] = ' ';
+	}
+	return inRange;
+}
+
+void barGraph_setBarColor(uint16_t barIndex, uint16_t color) {
+	if (barIndex < barCount)
+		bars[barIndex].color = color;
+}
+
+uint32_t barGraph_flush() {
+	uint32_t pixels = 0;
+	for (uint16_t i=0; i<barCount; i++) {
+		bar_t* bar = &bars[i];
+		uint16_t x = barX(i);
+		if (bar->color != bar->drawnColor) {
+			// The whole bar changes color, then clear whatever it lost.
+			pixels += fillRect(x, baselineY - bar->height, barWidth, bar->height, bar->color);
+			pixels += fillRect(x, baselineY - bar->drawnHeight, barWidth, bar->drawnHeight - bar->height, BACKGROUND_COLOR);
+			bar->drawnColor = bar->color;
+		} else if (bar->height > bar->drawnHeight) {
+			pixels += fillRect(x, baselineY - bar->height, barWidth, bar->height - bar->drawnHeight, bar->color);
+		} else if (bar->height < bar->drawnHeight) {
+			pixels += fillRect(x, baselineY - bar->drawnHeight, barWidth, bar->drawnHeight - bar->height, BACKGROUND_COLOR);
+		}
+		bar->drawnHeight = bar->height;
+		for (uint16_t c=0; c<labelChars; c++) {
+			if (bar->label[c] != bar->drawnLabel[c]) {
+				pixels += drawChar(labelX(i) + c * CHAR_WIDTH, TOP_LABEL_Y, bar->label[c]);
+				bar->drawnLabel[c] = bar->label[c];
+			}
+		}
+	}
+	return pixels;
+}
+
+uint32_t barGraph_redrawAll() {
+	uint32_t pixels = fillRect(0, 0, graphWidth, graphHeight, BACKGROUND_COLOR);
+	for (uint16_t i=0; i<barCount; i++) {
+		bar_t* bar = &bars[i];
+		pixels += fillRect(barX(i), baselineY - bar->height, barWidth, bar->height, bar->color);
+		bar->drawnHeight = bar->height;
+		bar->drawnColor = bar->color;
+		for (uint16_t c=0; c<labelChars; c++)
+			pixels += drawChar(labelX(i) + c * CHAR_WIDTH, TOP_LABEL_Y, bar->label[c]);
+		strcpy(bar->drawnLabel, bar->label);
+		// Bar numbers never change, so only a full redraw draws them.
+		pixels += drawChar(i * slotWidth + (slotWidth - CHAR_WIDTH) / 2, graphHeight - CHAR_HEIGHT, '0' + i % 10);
+	}
+	return pixels;
+}
@@ -0,0 +1,49 @@
+/*
+ * barGraph.h
+ */
+
+#ifndef BARGRAPH_H_
+#define BARGRAPH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Retained-mode bar graph for the power and hit-count displays in main.c, in place of the course histogram library.
+// The histogram library repaints every bar and label on each histogram_updateDisplay(), and every pixel of that goes
+// to the TFT through the bit-banged GPIO interface. Here barGraph_setBar() only records the new height and label.
+// barGraph_flush() then compares them with what is on the screen and draws the difference:
+// - A bar that grew gets one fillRect() for the new part, one that shrank gets one background fillRect() for the
+//   part that went away. Only a color change repaints the whole bar.
+// - Labels sit in a fixed row above the bars, and only the characters that changed are redrawn.
+// Call barGraph_flush() once per frame, after setting all of the bars.
+//
+// Layout, from display_width() x display_height(): a row of top labels, the bars (each in an equal-width slot),
+// and the bar numbers along the bottom.
+
+#define BARGRAPH_MAX_BAR_COUNT 10
+#define BARGRAPH_MAX_LABEL_CHARS 8		// Longer labels are cut; barGraph_getLabelChars() is what fits in a slot.
+
+// Computes the layout and paints the whole graph, with every bar at 0, blue, and no labels. Call after display_init().
+void barGraph_init(uint16_t barCount);
+
+// Height of a full bar in pixels.
+uint16_t barGraph_getMaxBarHeight();
+
+// Label characters that fit above one bar.
+uint16_t barGraph_getLabelChars();
+
+// Sets the height (pixels) and top label of a bar for the next flush. label may be NULL to keep the current one.
+// Returns false, and clamps the height to barGraph_getMaxBarHeight(), if the height is too big.
+bool barGraph_setBar(uint16_t barIndex, uint16_t height, const char* label);
+
+// Sets a bar's color for the next flush.
+void barGraph_setBarColor(uint16_t barIndex, uint16_t color);
+
+// Draws what changed since the last flush. Returns the number of pixels sent to the display.
+uint32_t barGraph_flush();
+
+// Repaints the whole graph from the retained state, e.g., after something else drew over it. Returns the number of
+// pixels sent, which is also what a full redraw of the graph costs.
+uint32_t barGraph_redrawAll();
+
+#endif /* BARGRAPH_H_ */
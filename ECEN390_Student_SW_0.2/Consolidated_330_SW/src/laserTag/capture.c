@@ -0,0 +1,245 @@
+/*
+ * capture.c
+ */
+
+#include "capture.h"
+#include "filter.h"
+#include "isr.h"
+#include "xil_printf.h"
+#include <string.h>
+
+#define ADC_SAMPLE_RATE_HZ CHANNELPLAN_SAMPLE_RATE_HZ	// One sample per timer interrupt (isr_function()).
+#define FNV_OFFSET_BASIS 2166136261UL
+#define FNV_PRIME 16777619UL
+
+static capture_sink_t* captureSink = NULL;	// NULL when not recording.
+static bool capturePower = false;
+static uint32_t capturedSampleCount = 0;
+
+/*================================ Sinks ================================*/
+
+static bool writeMemory(capture_sink_t* sink, const void* data, uint32_t byteCount) {
+	capture_memory_t* memory = (capture_memory_t*) sink->context;
+	if (byteCount > memory->size - memory->used)
+		return false;
+	memcpy(&memory->buffer[memory->used], data, byteCount);
+	memory->used += byteCount;
+	return true;
+}
+
+static bool writeUart(capture_sink_t* /*sink*/, const void* data, uint32_t byteCount) {
+	const char* bytes = (const char*) data;
+	for (uint32_t i=0; i<byteCount; i++)
+		outbyte(bytes[i]);
+	return true;
+}
+
+static bool writeFile(capture_sink_t* sink, const void* data, uint32_t byteCount) {
+	return fwrite(data, 1, byteCount, (FILE*) sink->context) == byteCount;
+}
+
+static void initSink(capture_sink_t* sink, bool (*write)(capture_sink_t*, const void*, uint32_t), void* context) {
+	sink->write = write;
+	sink->context = context;
+	sink->byteCount = 0;
+	sink->failed = false;
+}
+
+void capture_initMemorySink(capture_sink_t* sink, capture_memory_t* memory, uint8_t* buffer, uint32_t size) {
+	memory->buffer = buffer;
+	memory->size = size;
+	memory->used = 0;
+	initSink(sink, writeMemory, memory);
+}
+
+void capture_initUartSink(capture_sink_t* sink) {
+	initSink(sink, writeUart, NULL);
+}
+
+void capture_initFileSink(capture_sink_t* sink, FILE* file) {
+	initSink(sink, writeFile, file);
+}
+
+// Writes through the sink unless it has already failed.
+static void sinkWrite(const void* data, uint32_t byteCount) {
+	if (captureSink->failed)
+		return;
+	if (captureSink->write(captureSink, data, byteCount))
+		captureSink->byteCount += byteCount;
+	else
+		captureSink->failed = true;
+}
+
+/*================================ Recorder ================================*/
+
+static uint32_t hashBytes(uint32_t hash, const void* data, uint32_t byteCount) {
+	const uint8_t* bytes = (const uint8_t*) data;
+	for (uint32_t i=0; i<byteCount; i++) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+uint32_t capture_coefficientHash() {
+	uint32_t hash = FNV_OFFSET_BASIS;
+	hash = hashBytes(hash, filterTest_getFirCoefficientArray(), FILTER_FIR_COEFFICIENT_COUNT * sizeof(double));
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
+		hash = hashBytes(hash, filterTest_getIirACoefficientArray(i), FILTER_IIR_ORDER * sizeof(double));
+		hash = hashBytes(hash, filterTest_getIirBCoefficientArray(i), (FILTER_IIR_ORDER+1) * sizeof(double));
+	}
+	return hash;
+}
+
+void capture_start(capture_sink_t* sink, bool recordPower) {
+	captureSink = sink;
+	capturePower = recordPower;
+	capturedSampleCount = 0;
+	capture_header_t header;
+	memset(&header, 0, sizeof(header));
+	header.magic = CAPTURE_MAGIC;
+	header.version = CAPTURE_VERSION;
+	header.headerSize = sizeof(capture_header_t);
+	header.sampleRateHz = ADC_SAMPLE_RATE_HZ;
+	header.decimationFactor = FILTER_FIR_DECIMATION_FACTOR;
+	header.channelCount = FILTER_IIR_FILTER_COUNT;
+	header.coefficientHash = capture_coefficientHash();
+	header.flags = recordPower ? CAPTURE_FLAG_POWER : 0;
+	sinkWrite(&header, sizeof(header));
+}
+
+void capture_stop() {
+	captureSink = NULL;
+}
+
+bool capture_running() {
+	return captureSink != NULL;
+}
+
+void capture_recordBlock(const uint16_t* samples, uint32_t count) {
+	if (!captureSink || !count)
+		return;
+	capture_blockHeader_t blockHeader;
+	blockHeader.magic = CAPTURE_BLOCK_MAGIC;
+	blockHeader.firstSampleIndex = capturedSampleCount;
+	blockHeader.adcOverflowCount = isr_getAdcBufferOverflowCount();
+	blockHeader.sampleCount = (uint16_t) count;
+	blockHeader.powerCount = capturePower ? FILTER_IIR_FILTER_COUNT : 0;
+	sinkWrite(&blockHeader, sizeof(blockHeader));
+	sinkWrite(samples, count * sizeof(uint16_t));
+	if (count & 1) {
+		uint16_t padding = 0;	// Keeps the power floats 4-byte aligned in the stream.
+		sinkWrite(&padding, sizeof(padding));
+	}
+	if (capturePower) {
+		float power[FILTER_IIR_FILTER_COUNT];
+		for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+			power[i] = (float) filter_getCurrentPowerValue(i);
+		sinkWrite(power, sizeof(power));
+	}
+	capturedSampleCount += count;
+}
+
+uint32_t capture_drainAdcBuffer() {
+	uint32_t drainedCount = 0;
+	const uint16_t* span;
+	uint32_t spanCount;
+	while ((spanCount = isr_adcBufferPeekSpan(&span)) != 0) {
+		for (uint32_t blockStart = 0; blockStart < spanCount; blockStart += CAPTURE_MAX_BLOCK_SAMPLE_COUNT) {
+			uint32_t blockCount = spanCount - blockStart;
+			if (blockCount > CAPTURE_MAX_BLOCK_SAMPLE_COUNT)
+				blockCount = CAPTURE_MAX_BLOCK_SAMPLE_COUNT;
+			capture_recordBlock(&span[blockStart], blockCount);
+		}
+		isr_adcBufferConsume(spanCount);
+		drainedCount += spanCount;
+	}
+	return drainedCount;
+}
+
+/*=============================================================================
+ * ================= Test Routines Start Here =================================
+ ==============================================================================*/
+
+#define TEST_BUFFER_SIZE 8192
+#define TEST_BLOCK_COUNT 3
+static const uint16_t testBlockSampleCount[TEST_BLOCK_COUNT] = {200, 37, 1000};
+
+static uint16_t testSample(uint32_t index) {
+	return (uint16_t) ((index * 37) % (FILTER_ADC_MAX + 1));
+}
+
+bool capture_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("capture_runTest: record to memory and read back.\n\r");
+	static uint8_t buffer[TEST_BUFFER_SIZE];
+	capture_memory_t memory;
+	capture_sink_t sink;
+	capture_initMemorySink(&sink, &memory, buffer, TEST_BUFFER_SIZE);
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		filter_forceValueIntoPowerArray(i * 1.5, i);
+	capture_start(&sink, true);
+	uint16_t samples[1000];
+	uint32_t sampleIndex = 0;
+	for (uint16_t block=0; block<TEST_BLOCK_COUNT; block++) {
+		for (uint16_t i=0; i<testBlockSampleCount[block]; i++)
+			samples[i] = testSample(sampleIndex + i);
+		capture_recordBlock(samples, testBlockSampleCount[block]);
+		sampleIndex += testBlockSampleCount[block];
+	}
+	capture_stop();
+	// Read it back.
+	uint32_t offset = 0;
+	capture_header_t header;
+	memcpy(&header, &buffer[offset], sizeof(header));
+	offset += header.headerSize;
+	if (header.magic != CAPTURE_MAGIC || header.version != CAPTURE_VERSION || header.sampleRateHz != ADC_SAMPLE_RATE_HZ ||
+			header.decimationFactor != FILTER_FIR_DECIMATION_FACTOR || header.channelCount != FILTER_IIR_FILTER_COUNT ||
+			header.coefficientHash != capture_coefficientHash() || header.flags != CAPTURE_FLAG_POWER) {
+		printf("Header does not match.\n\r");
+		success = false;
+	}
+	sampleIndex = 0;
+	for (uint16_t block=0; block<TEST_BLOCK_COUNT && success; block++) {
+		capture_blockHeader_t blockHeader;
+		memcpy(&blockHeader, &buffer[offset], sizeof(blockHeader));
+		offset += sizeof(blockHeader);
+		if (blockHeader.magic != CAPTURE_BLOCK_MAGIC || blockHeader.firstSampleIndex != sampleIndex ||
+				blockHeader.sampleCount != testBlockSampleCount[block] || blockHeader.powerCount != FILTER_IIR_FILTER_COUNT) {
+			printf("Block %d header does not match.\n\r", block);
+			success = false;
+			break;
+		}
+		for (uint16_t i=0; i<blockHeader.sampleCount; i++) {
+			uint16_t sample;
+			memcpy(&sample, &buffer[offset + i * sizeof(uint16_t)], sizeof(sample));
+			if (sample != testSample(sampleIndex + i))
+				success = false;
+		}
+		offset += ((blockHeader.sampleCount + 1) & ~1) * sizeof(uint16_t);
+		for (uint16_t i=0; i<blockHeader.powerCount; i++) {
+			float power;
+			memcpy(&power, &buffer[offset + i * sizeof(float)], sizeof(power));
+			if (power != (float) (i * 1.5))
+				success = false;
+		}
+		offset += blockHeader.powerCount * sizeof(float);
+		sampleIndex += blockHeader.sampleCount;
+	}
+	if (offset != memory.used || offset != sink.byteCount || sink.failed) {
+		printf("Read %lu bytes, recorded %lu.\n\r", (unsigned long) offset, (unsigned long) memory.used);
+		success = false;
+	}
+	// A sink that runs out of room fails and stays failed.
+	capture_initMemorySink(&sink, &memory, buffer, sizeof(capture_header_t) + 8);
+	capture_start(&sink, false);
+	capture_recordBlock(samples, 100);
+	capture_recordBlock(samples, 1);
+	capture_stop();
+	if (!sink.failed || memory.used != sizeof(capture_header_t)) {
+		printf("Full memory sink was not reported.\n\r");
+		success = false;
+	}
+	printf("capture_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
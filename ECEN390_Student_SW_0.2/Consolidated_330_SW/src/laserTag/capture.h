@@ -0,0 +1,92 @@
+/*
+ * capture.h
+ */
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Binary capture of the raw ADC samples (and optionally the per-channel power) for debugging off-line.
+// printf over the UART is far too slow for 100 kHz, so the samples are written as-is (uint16_t) in blocks.
+//
+// Format (little-endian, which both the A9 and x86 are):
+//   capture_header_t, once.
+//   Blocks, each: capture_blockHeader_t, sampleCount uint16_t samples (padded to a multiple of 4 bytes),
+//   then powerCount floats: filter_getCurrentPowerValue() for each channel after the block went through the detector.
+// The coefficient hash identifies the FIR/IIR coefficients the capture was made with, so a replay can tell
+// whether it is running the same filters.
+//
+// Records go through a sink: a memory buffer, the UART (outbyte()) or a stdio FILE (host builds).
+// Two ways to record:
+// 1. With the detector running: capture_start(), then detector_processBlock() records every block it processes.
+// 2. Raw capture only: capture_start(), then call capture_drainAdcBuffer() instead of detector(). Nothing else may
+//    read the ADC buffer while it does.
+
+#define CAPTURE_MAGIC 0x5043544C		// "LTCP"
+#define CAPTURE_BLOCK_MAGIC 0x4B4C4254	// "TBLK"
+#define CAPTURE_VERSION 1
+#define CAPTURE_FLAG_POWER 0x1			// Blocks carry the per-channel power.
+#define CAPTURE_MAX_BLOCK_SAMPLE_COUNT 1024	// capture_drainAdcBuffer() splits spans into blocks this big.
+
+typedef struct {
+	uint32_t magic;					// CAPTURE_MAGIC
+	uint16_t version;				// CAPTURE_VERSION
+	uint16_t headerSize;			// sizeof(capture_header_t), so later versions can add fields.
+	uint32_t sampleRateHz;
+	uint16_t decimationFactor;
+	uint16_t channelCount;
+	uint32_t coefficientHash;		// See capture_coefficientHash().
+	uint32_t flags;					// CAPTURE_FLAG_*
+} capture_header_t;
+
+typedef struct {
+	uint32_t magic;					// CAPTURE_BLOCK_MAGIC, for resynchronizing a damaged stream.
+	uint32_t firstSampleIndex;		// Samples recorded before this block.
+	uint32_t adcOverflowCount;		// isr_getAdcBufferOverflowCount() when the block was recorded.
+	uint16_t sampleCount;
+	uint16_t powerCount;			// 0 or channelCount.
+} capture_blockHeader_t;
+
+// Where records go. write() returns false if the data did not fit or could not be written.
+typedef struct capture_sink_t {
+	bool (*write)(struct capture_sink_t* sink, const void* data, uint32_t byteCount);
+	void* context;
+	uint32_t byteCount;				// Bytes written so far.
+	bool failed;					// Set on the first failed write, nothing more is written after that.
+} capture_sink_t;
+
+// State for the memory sink.
+typedef struct {
+	uint8_t* buffer;
+	uint32_t size;
+	uint32_t used;
+} capture_memory_t;
+
+void capture_initMemorySink(capture_sink_t* sink, capture_memory_t* memory, uint8_t* buffer, uint32_t size);
+void capture_initUartSink(capture_sink_t* sink);
+void capture_initFileSink(capture_sink_t* sink, FILE* file);
+
+// FNV-1a hash of the FIR and IIR coefficients in filter.c.
+uint32_t capture_coefficientHash();
+
+// Writes the header and starts recording to sink.
+void capture_start(capture_sink_t* sink, bool recordPower);
+
+// Stops recording. The sink is left as it is.
+void capture_stop();
+
+bool capture_running();
+
+// Writes one block of samples (at most 65535) and, if enabled, the current per-channel power.
+void capture_recordBlock(const uint16_t* samples, uint32_t count);
+
+// Raw capture: moves everything in the ADC buffer to the sink in blocks and releases it. Returns the sample count.
+uint32_t capture_drainAdcBuffer();
+
+// Records a synthesized stream into memory, reads it back and checks every field.
+bool capture_runTest();
+
+#endif /* CAPTURE_H_ */
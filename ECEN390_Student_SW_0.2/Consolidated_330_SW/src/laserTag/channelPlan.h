@@ -0,0 +1,44 @@
+/*
+ * channelPlan.h
+ */
+
+#ifndef CHANNELPLAN_H_
+#define CHANNELPLAN_H_
+
+#include <stdint.h>
+#include "xparameters.h"
+
+// The channel plan the firmware runs: how many players, the ADC sample rate and the filter sizes. These used to be
+// separate #defines in filter.h, transmitter.c, timerService.h, capture.c, detector.c and the supportFiles timer code
+// that only worked because somebody kept them in agreement. Everything that depends on them is derived from here.
+//
+// The filter coefficients for this plan are the hand-designed tables in filter.c, which the golden-data tests are
+// built around, so this plan is fixed at 10 players. Other plans (more players, another sample rate) run on the
+// templates in detectorCore.h with tables from src/hostSim/channelPlanGenerator.c, e.g. channelPlan16.h and
+// channelPlan20.h; the generator also emits the CHANNELPLANn_* values below for them.
+
+#define CHANNELPLAN_CHANNEL_COUNT 10			// Players, one IIR filter and one transmitter frequency each.
+#define CHANNELPLAN_SAMPLE_RATE_HZ 100000		// ADC samples and timer interrupts per second.
+#define CHANNELPLAN_DECIMATION_FACTOR 10		// ADC samples per FIR output.
+#define CHANNELPLAN_FIR_TAP_COUNT 23
+#define CHANNELPLAN_IIR_ORDER 10				// Each filter is CHANNELPLAN_IIR_ORDER/2 biquads.
+#define CHANNELPLAN_POWER_WINDOW_LENGTH 20000	// FIR outputs in the power window, 2 s.
+
+// Transmitter half-periods in timer ticks, one per player.
+#define CHANNELPLAN_HALF_PERIOD_TICKS {45, 36, 29, 25, 22, 19, 17, 15, 14, 13}
+
+// The ARM private timer counts at half the CPU clock and interrupts every load value + 1 counts.
+#define CHANNELPLAN_PRIVATE_TIMER_LOAD_VALUE (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2 / CHANNELPLAN_SAMPLE_RATE_HZ - 1)
+
+// Ticks in the given number of milliseconds.
+#define CHANNELPLAN_MS_TO_TICKS(ms) ((uint32_t) ((ms) * (CHANNELPLAN_SAMPLE_RATE_HZ / 1000)))
+
+#ifdef __cplusplus
+#include "detectorCore.h"
+
+// The sizes above for the detectorCore.h templates, detector.c's Detector<> is one of these.
+typedef detectorCore::ChannelPlan<CHANNELPLAN_CHANNEL_COUNT, CHANNELPLAN_SAMPLE_RATE_HZ, CHANNELPLAN_DECIMATION_FACTOR,
+		CHANNELPLAN_FIR_TAP_COUNT, CHANNELPLAN_IIR_ORDER / 2, CHANNELPLAN_POWER_WINDOW_LENGTH> channelPlan_t;
+#endif
+
+#endif /* CHANNELPLAN_H_ */
@@ -0,0 +1,169 @@
+/*
+ * channelPlan16.h
+ *
+ *  Generated by src/hostSim/channelPlanGenerator.c, do not edit:
+ *    channelPlanGenerator -n 16 -c 16
+ */
+
+#ifndef CHANNELPLAN16_H_
+#define CHANNELPLAN16_H_
+
+#include <stdint.h>
+#include "xparameters.h"
+
+// 16 players, 100000 Hz sampling, FIR outputs at 10000 Hz, filters 100 Hz wide. Same meaning as the
+// CHANNELPLAN_* values of channelPlan.h.
+#define CHANNELPLAN16_CHANNEL_COUNT 16
+#define CHANNELPLAN16_SAMPLE_RATE_HZ 100000
+#define CHANNELPLAN16_DECIMATION_FACTOR 10
+#define CHANNELPLAN16_FIR_TAP_COUNT 23
+#define CHANNELPLAN16_IIR_ORDER 10
+#define CHANNELPLAN16_POWER_WINDOW_LENGTH 20000
+#define CHANNELPLAN16_HALF_PERIOD_TICKS {45, 41, 38, 35, 32, 30, 27, 25, 23, 21, 20, 18, 17, 15, 14, 13}
+#define CHANNELPLAN16_PRIVATE_TIMER_LOAD_VALUE (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2 / CHANNELPLAN16_SAMPLE_RATE_HZ - 1)
+
+#ifdef __cplusplus
+#include "detectorCore.h"
+
+typedef detectorCore::ChannelPlan<16, 100000, 10, 23, 5, 20000> channelPlan16_t;
+
+static const double channelPlan16_firCoefficients[23] = {
+	3.3195178602313613e-05, -9.0229927736858122e-20, -0.00083318239399628625, -0.0039777299203895616,
+	-0.0098278864054432442, -0.013192644075700897, 5.427727411833684e-18, 0.048153936687306678,
+	0.13955817122040692, 0.25731543203311047, 0.35936908171726245, 0.40000000000000002,
+	0.35936908171726251, 0.25731543203311047, 0.13955817122040703, 0.048153936687306727,
+	5.427727411833684e-18, -0.013192644075700907, -0.0098278864054432528, -0.0039777299203895616,
+	-0.00083318239399628787, -9.0229927736859061e-20, 3.3195178602313674e-05
+};
+
+// {b0, b1, b2, a1, a2} for each section, see detectorCore::Section.
+static const detectorCore::Section channelPlan16_sections[16][5] = {
+	{	// Player 0, 1111.1 Hz.
+		{0.0066059476100143065, 0.029092193444865706, 0.0065186272917647061, -1.4846974198979315, 0.93909165906664938},
+		{0.0037575935641343239, -0.0096628016357876399, -0.024342964855219012, -1.5165303627775981, 0.95043584058390662},
+		{0.045578867592484987, -0.11511935156731019, 0.069099750494355211, -1.4702361953181957, 0.95043584058390684},
+		{0.0044702235910859291, 0.0072967829186628896, 0.0028304392284632229, -1.4785766383937167, 0.98077370253308715},
+		{0.022644742590666931, -0.019499658150320176, 0.0033334256004735781, -1.5546472856038507, 0.98077370253308727},
+	},
+	{	// Player 1, 1219.5 Hz.
+		{0.0069124263455049399, 0.032353480177939535, 0.0068155280772777193, -1.3964679994861413, 0.93909165906664949},
+		{0.0038074442450707984, -0.01071223942738367, -0.027292669868391309, -1.3796668639444811, 0.95043584058390662},
+		{0.036036170019029375, -0.065444793502576676, 0.01264182240640354, -1.429608524035165, 0.95043584058390684},
+		{0.0045970063751409251, 0.0074051599111580367, 0.0028131924140173225, -1.4675180988465999, 0.98077370253308715},
+		{0.024900292944740551, -0.039554400628374613, 0.014824266445570826, -1.3854538861317165, 0.98077370253308738},
+	},
+	{	// Player 2, 1315.8 Hz.
+		{0.0094558334681809405, 0.042517388026614505, -0.0092665364591625835, -1.3126630066566201, 0.93909165906664938},
+		{0.0059890743184971536, -0.024442457345120218, -0.016723973974875992, -1.3468361841241363, 0.9504358405839064},
+		{0.0083345445392280313, 0.022156108265656099, 0.013803499885174809, -1.293848656966919, 0.95043584058390662},
+		{0.014193015368626933, -0.037247567842341435, 0.022900681690832758, -1.2973449634435537, 0.98077370253308738},
+		{0.016633935018403802, -0.006327176242608405, -0.0020547648307279601, -1.384414149609368, 0.98077370253308749},
+	},
+	{	// Player 3, 1428.6 Hz.
+		{0.0094637906678095851, 0.045201478863217084, -0.0092741971340739131, -1.2084073038678256, 0.93909165906664938},
+		{0.0062396440578640477, -0.027263182247859251, -0.017888615149125302, -1.1873226763700955, 0.95043584058390662},
+		{0.0085508098403052363, 0.023141133419860058, 0.014567123068394488, -1.2436309141596484, 0.95043584058390662},
+		{0.013703145755973482, -0.036652441887814607, 0.022794274893538028, -1.280645700711724, 0.98077370253308727},
+		{0.017006539987467692, -0.0063788616184273627, -0.0019295739439803784, -1.1881199177247046, 0.98077370253308738},
+	},
+	{	// Player 4, 1562.5 Hz.
+		{0.0094767891010981223, 0.048116622215505819, -0.0092867905948193948, -1.0767700215641201, 0.93909165906664949},
+		{0.0061438577315912285, -0.028754864406321048, -0.018072373642383448, -1.1130110124991166, 0.95043584058390662},
+		{0.0097287447213861306, 0.026836457961827844, 0.017074247618537736, -1.0531277899707461, 0.95043584058390684},
+		{0.011557233587175869, -0.031552338792336626, 0.019859869831986409, -1.0507157957289295, 0.98077370253308715},
+		{0.017177396047441295, -0.0063375346578576483, -0.0017849135254560747, -1.149115999140222, 0.98077370253308738},
+	},
+	{	// Player 5, 1666.7 Hz.
+		{0.01009050476302592, 0.049661419014144566, -0.030026505826838312, -0.96906741719379352, 0.9390916590666496},
+		{0.0063583914076787802, -0.031137593147351608, -0.019012776273054543, -0.94355072757239844, 0.95043584058390662},
+		{0.0099006463944456956, 0.027672581519161032, 0.017731767075220645, -1.0059226906636669, 0.95043584058390673},
+		{0.010560157317952686, -0.029244641722627248, 0.018559111724277433, -0.93865330227381982, 0.98077370253308727},
+		{0.016167172136819521, 1.016660319000804e-05, -0.00052145186079054792, -1.0411430080079214, 0.98077370253308738},
+	},
+	{	// Player 6, 1851.9 Hz.
+		{0.0082168173855748858, 0.03932938950954596, -0.046761951366240624, -0.7676559917565754, 0.9390916590666496},
+		{0.0064762612779641756, -0.033839884094815607, -0.019809191449567203, -0.73908158211741859, 0.95043584058390673},
+		{0.011019378558085446, 0.031409631557336858, 0.020332476789831383, -0.80521236867157353, 0.95043584058390684},
+		{0.0096056108043358398, -0.01607747288527784, -0.0030148189801598078, -0.72982415426524361, 0.98077370253308738},
+		{0.020332617410534718, -0.014184151970662034, 0.0018219568309587317, -0.83849036449791237, 0.98077370253308738},
+	},
+	{	// Player 7, 2000.0 Hz.
+		{0.0078198176079576683, 0.038930192175073944, -0.046029936796586957, -0.59891660121583856, 0.93909165906664938},
+		{0.006582174498403327, -0.035756175143936225, -0.020397142188723277, -0.56817242447255223, 0.95043584058390662},
+		{0.011965844743122867, 0.034522350392565432, 0.022481775812064387, -0.63666840816177517, 0.95043584058390673},
+		{0.010222924829393144, -0.020920915911263143, 0.0031608471905704852, -0.55551435237549918, 0.98077370253308727},
+		{0.017899552438902847, -0.0063241912178247858, -0.0015259085695064473, -0.66806705818024958, 0.98077370253308727},
+	},
+	{	// Player 8, 2173.9 Hz.
+		{0.0074178840368378952, 0.038139409119571407, -0.044914156819213374, -0.39432518616292495, 0.93909165906664938},
+		{0.0067228936686437148, -0.037713746675655593, -0.02104957559705253, -0.36137481137212857, 0.95043584058390662},
+		{0.013196909753744449, 0.03845683845468241, 0.02516176986167077, -0.43188936708067016, 0.95043584058390673},
+		{0.0092048843453633438, -0.016159402948076301, -0.0028225449170776584, -0.34486665071962763, 0.98077370253308727},
+		{0.0189628676054748, -0.012698854800455059, 0.0015454958547913879, -0.46073627717284837, 0.98077370253308738},
+	},
+	{	// Player 9, 2381.0 Hz.
+		{0.0070298812214583829, 0.036873999805130765, -0.043351189938872027, -0.1448369975568935, 0.93909165906664938},
+		{0.006905667444250513, -0.039541440933144018, -0.021753931680225411, -0.10977455388522658, 0.95043584058390662},
+		{0.014804438609493124, 0.043396998043203246, 0.028462158629307521, -0.181594108092829, 0.95043584058390684},
+		{0.0088088865795982116, -0.015689104330660571, -0.0026848308451453938, -0.08894336255186, 0.98077370253308715},
+		{0.018072856445117916, -0.01196570943415819, 0.0014342189967573909, -0.20695736454696442, 0.98077370253308727},
+	},
+	{	// Player 10, 2500.0 Hz.
+		{0.0085994574962751195, -0.049405542092852514, -0.027107249643900301, -1.1121741058589681e-16, 0.93909165906664949},
+		{0.0055365632673641946, 0.029120635594285044, -0.034251177313263929, 0.036010469680629105, 0.95043584058390662},
+		{0.02219698480995411, 0.04660231959980303, 0.0067611092358767161, -0.036010469680629327, 0.95043584058390662},
+		{0.0085724700830293304, -0.01799780438602322, 0.002611138726673133, 0.059172459194748964, 0.98077370253308727},
+		{0.012196157620315872, 0.0059212056140390771, -0.006089351780433773, -0.0591724591947492, 0.98077370253308727},
+	},
+	{	// Player 11, 2777.8 Hz.
+		{0.0089962929840362773, -0.050870267063218955, -0.02817588810104827, 0.33655358206420177, 0.9390916590666496},
+		{0.0052411932005257999, 0.027066590601456868, -0.031993994825923598, 0.3739858962179084, 0.95043584058390662},
+		{0.017857039877231289, -0.043532321912361643, 0.017547918949231328, 0.303059116755719, 0.95043584058390684},
+		{0.0097070996163531216, 0.020206138095784382, 0.0029673993635723353, 0.4020615180119238, 0.98077370253308727},
+		{0.014250519300492724, 0.011813168440862148, -0.0022414100321255653, 0.28551452485234896, 0.9807737025330876},
+	},
+	{	// Player 12, 2941.2 Hz.
+		{0.0092715725960890571, -0.051119739837715852, -0.028770628634400771, 0.53039577394136816, 0.93909165906664938},
+		{0.0065218479201834424, 0.035872381805842901, -0.020292462606059842, 0.56813451786205227, 0.95043584058390662},
+		{0.01282262327881872, -0.037138559405773139, 0.024230677661478184, 0.49886293153899924, 0.95043584058390673},
+		{0.010365064604372415, 0.021325794449211576, 0.0031926289462081408, 0.59871056662848532, 0.98077370253308727},
+		{0.014514573340463114, 0.011964370212697662, -0.0023330537144309275, 0.48488338938227149, 0.98077370253308749},
+	},
+	{	// Player 13, 3333.3 Hz.
+		{0.0094748930236033344, -0.050091151723682913, -0.0092848308564038549, 0.96906741719379286, 0.93909165906664938},
+		{0.0076884147766521083, 0.040488930786239961, -0.0075331315560706758, 1.0059226906636662, 0.95043584058390662},
+		{0.010319648591730847, -0.028843704292274681, 0.018482187711436268, 0.94355072757239777, 0.95043584058390662},
+		{0.011187985234478686, 0.030983309237651156, 0.019662497601551962, 1.0411430080079207, 0.98077370253308715},
+		{0.014249788061513025, -6.6157654797677516e-05, -0.0042593204927839625, 0.93865330227381916, 0.98077370253308715},
+	},
+	{	// Player 14, 3571.4 Hz.
+		{0.009798440364486136, -0.039092539243077214, -0.047932921991407411, 1.2084073038678256, 0.9390916590666496},
+		{0.0076722128280405861, 0.036448331309401678, -0.0075170540338806262, 1.2436309141596484, 0.95043584058390684},
+		{0.0089583183064275845, -0.02424397723937869, 0.015261352748188768, 1.1873226763700955, 0.95043584058390684},
+		{0.014918886333756433, 0.033779129923553072, 0.014458310611520574, 1.280645700711724, 0.98077370253308749},
+		{0.012050997054774401, -0.0046069326973399655, -0.0013756784120491912, 1.1881199177247046, 0.9807737025330876},
+	},
+	{	// Player 15, 3846.2 Hz.
+		{0.0067300534039236781, -0.030382863587605207, 0.0066389007994377049, 1.4507147549439257, 0.93909165906664949},
+		{0.0087631133872881559, 0.050998304594938343, 0.058339708178373362, 1.4830811652026694, 0.95043584058390684},
+		{0.0074501824516557758, -0.019251159940213015, 0.011789818265084632, 1.4353224484444327, 0.95043584058390684},
+		{0.027932119656554219, 0.044695182523073723, 0.016951154563083975, 1.5211374158712385, 0.9807737025330876},
+		{0.010256489291360329, -0.0040758956964726065, -0.0014690117103292055, 1.4426602189995046, 0.9807737025330876},
+	},
+};
+
+static const double channelPlan16_gains[16] = {
+	15.879093221895818, 16.751300645452552, 16.319984032825385, 15.45476339592963,
+	16.171875824236761, 16.768825354037535, 15.87915608008146, 16.136304256500022,
+	15.830692536635917, 15.894152815037353, 16.458736008559608, 15.613755950110352,
+	15.590266922661808, 15.173804131768112, 15.019909696328449, 14.447221034477488
+};
+
+static const uint16_t channelPlan16_halfPeriodTicks[16] = CHANNELPLAN16_HALF_PERIOD_TICKS;
+
+static const detectorCore::PlanTables<channelPlan16_t> channelPlan16_tables = {
+	channelPlan16_firCoefficients, channelPlan16_sections, channelPlan16_gains, channelPlan16_halfPeriodTicks
+};
+#endif
+
+#endif /* CHANNELPLAN16_H_ */
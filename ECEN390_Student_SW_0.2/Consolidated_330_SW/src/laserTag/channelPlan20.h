@@ -0,0 +1,204 @@
+/*
+ * channelPlan20.h
+ *
+ *  Generated by src/hostSim/channelPlanGenerator.c, do not edit:
+ *    channelPlanGenerator -n 20 -c 20 -r 200000 -d 20 -t 45 -b 30
+ */
+
+#ifndef CHANNELPLAN20_H_
+#define CHANNELPLAN20_H_
+
+#include <stdint.h>
+#include "xparameters.h"
+
+// 20 players, 200000 Hz sampling, FIR outputs at 10000 Hz, filters 60 Hz wide. Same meaning as the
+// CHANNELPLAN_* values of channelPlan.h.
+#define CHANNELPLAN20_CHANNEL_COUNT 20
+#define CHANNELPLAN20_SAMPLE_RATE_HZ 200000
+#define CHANNELPLAN20_DECIMATION_FACTOR 20
+#define CHANNELPLAN20_FIR_TAP_COUNT 45
+#define CHANNELPLAN20_IIR_ORDER 10
+#define CHANNELPLAN20_POWER_WINDOW_LENGTH 20000
+#define CHANNELPLAN20_HALF_PERIOD_TICKS {90, 84, 79, 74, 69, 65, 61, 57, 53, 50, 47, 44, 41, 38, 36, 34, 32, 30, 28, 26}
+#define CHANNELPLAN20_PRIVATE_TIMER_LOAD_VALUE (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2 / CHANNELPLAN20_SAMPLE_RATE_HZ - 1)
+
+#ifdef __cplusplus
+#include "detectorCore.h"
+
+typedef detectorCore::ChannelPlan<20, 200000, 20, 45, 5, 20000> channelPlan20_t;
+
+static const double channelPlan20_firCoefficients[45] = {
+	3.9900759416044791e-06, 1.0095672508962512e-05, -2.2984110831263504e-20, -6.7752835435363573e-05,
+	-0.00026677965673818459, -0.00069768179747519018, -0.0014581239824081949, -0.0025823415922507625,
+	-0.0039543430161301405, -0.0052130226980427064, -0.0056809976906840578, -0.0043561666133594178,
+	2.4587480867309813e-18, 0.0086632917696085297, 0.022654720469502565, 0.042409753334345122,
+	0.067490968744561244, 0.096434244881209261, 0.12679944234686225, 0.15545165484285203,
+	0.1790390943430886, 0.1945757920900377, 0.20000000000000001, 0.1945757920900377,
+	0.1790390943430886, 0.15545165484285203, 0.1267994423468623, 0.096434244881209261,
+	0.067490968744561231, 0.042409753334345129, 0.022654720469502589, 0.0086632917696085315,
+	2.4587480867309801e-18, -0.0043561666133594126, -0.0056809976906840596, -0.0052130226980427125,
+	-0.003954343016130144, -0.0025823415922507672, -0.0014581239824081969, -0.00069768179747518942,
+	-0.00026677965673818508, -6.7752835435363343e-05, -2.2984110831263742e-20, 1.0095672508962253e-05,
+	3.9900759416054524e-06
+};
+
+// {b0, b1, b2, a1, a2} for each section, see detectorCore::Section.
+static const detectorCore::Section channelPlan20_sections[20][5] = {
+	{	// Player 0, 1111.1 Hz.
+		{0.0040055269904864998, 0.017687151225522484, 0.0039736750448309084, -1.5034784906014136, 0.96300050335126797},
+		{0.0067664279617378484, -0.029751330010842646, 0.0066562550020597723, -1.4947805662470388, 0.96996064525598391},
+		{0.0041846027677821217, 0.010739096883365827, 0.0065511058552810307, -1.5228380766592966, 0.96996064525598391},
+		{0.010589575197584401, -0.026936671825323905, 0.016284194051349378, -1.5000346470004475, 0.98841848004715627},
+		{0.0075380585501373188, 3.9991914506741348e-05, -0.0030186756326285821, -1.5458580157487003, 0.98841848004715649},
+	},
+	{	// Player 1, 1190.5 Hz.
+		{0.0041513175283173368, 0.019181408435659356, 0.0041168191649874558, -1.4387255618014729, 0.96300050335126797},
+		{0.0022890418684873098, -0.0063441780949166256, -0.016096220306917947, -1.4289821197497794, 0.96996064525598391},
+		{0.02594137227071153, -0.067001142608670419, 0.040897929007319277, -1.4586714811882304, 0.96996064525598391},
+		{0.0029322888586451891, 0.0047454426495521073, 0.0018149669382280232, -1.4331106977935377, 0.98841848004715649},
+		{0.013564092307758008, -0.011391818048178824, 0.0018753512263182765, -1.481599196491552, 0.98841848004715649},
+	},
+	{	// Player 2, 1265.8 Hz.
+		{0.0057319450231119277, 0.025090429305783795, -0.0056626831237097993, -1.3739388244183808, 0.96300050335126808},
+		{0.003709155630927918, -0.014724065830518928, -0.010291660975659964, -1.3632251773637831, 0.96996064525598391},
+		{0.0046922779065060143, 0.012386591322250378, 0.0076888097654795803, -1.3943955246917876, 0.96996064525598413},
+		{0.009018259085485229, -0.023616864067485647, 0.014540078017217826, -1.366275698279718, 0.98841848004715649},
+		{0.0098613402074550459, -0.0038058958084685487, -0.0012811326272832936, -1.4171829348319047, 0.9884184800471566},
+	},
+	{	// Player 3, 1351.4 Hz.
+		{0.0057487473781712246, 0.026447414468070009, -0.0056792577291237822, -1.2966744225135649, 0.96300050335126797},
+		{0.0046453336232822702, -0.021295850340080701, -0.0045888284750861576, -1.3176553199736298, 0.96996064525598391},
+		{0.012207426620895587, 0.013332233859907129, -0.012060151149084972, -1.284888670922798, 0.96996064525598413},
+		{0.0084213371188943051, -0.022384900223015165, 0.013906850395528908, -1.2867073002077025, 0.98841848004715649},
+		{0.003250267449240311, 0.0051681740009394466, 0.0019206476544275572, -1.3402216077866416, 0.98841848004715649},
+	},
+	{	// Player 4, 1449.3 Hz.
+		{0.0057536953248994646, 0.027846828533393736, -0.0056841202424837041, -1.2036290796634503, 0.96300050335126808},
+		{0.0047200932817782733, -0.022773409143943019, -0.0046627000510202753, -1.1906578077743109, 0.96996064525598413},
+		{0.005292998123593815, 0.014394671064327489, 0.0090926691374839889, -1.2251356822168442, 0.96996064525598402},
+		{0.0077421453632968594, -0.020910765809194123, 0.013114740441230548, -1.1910597748106575, 0.9884184800471566},
+		{0.0081643488547002881, 3.0236512004135368e-05, -0.0027048205770161529, -1.2473688461082286, 0.98841848004715671},
+	},
+	{	// Player 5, 1538.5 Hz.
+		{0.0057428668656864185, 0.028954469906743246, -0.005673401459686726, -1.11491328688691, 0.9630005033512683},
+		{0.0037087408053271039, -0.017252335578710407, -0.010940600864314204, -1.1368279105945243, 0.96996064525598402},
+		{0.012245737835897188, 0.01463929785660625, -0.012097838169925906, -1.1009048809056166, 0.96996064525598413},
+		{0.0071828785876953422, -0.019663357403819609, 0.012429398476054645, -1.1000151329440053, 0.98841848004715649},
+		{0.0047293176427386568, 0.0056123350870235338, 0.0008931056837767886, -1.1586844236901321, 0.98841848004715649},
+	},
+	{	// Player 6, 1639.3 Hz.
+		{0.0038592923349835676, 0.023103153972512627, 0.011602309546999704, -1.0103590087217209, 0.96300050335126808},
+		{0.0056363160787485022, -0.03157823516633939, 0.0055555919382094992, -0.99523062393216211, 0.9699606452559838},
+		{0.0059469192365297343, 0.016603017277281338, 0.01064212854442783, -1.0326521823775137, 0.96996064525598391},
+		{0.0068758727466205058, -0.01908747844365262, 0.012161948877095805, -1.0540000153922242, 0.98841848004715638},
+		{0.010578536349711296, -0.0038949353432743724, -0.0010610851507024104, -0.99288333588004363, 0.98841848004715649},
+	},
+	{	// Player 7, 1754.4 Hz.
+		{0.0059818620498783307, 0.030509948492800136, -0.018180714698661424, -0.88620274986317515, 0.96300050335126797},
+		{0.0047218047342902436, -0.025748499687171363, -0.0046644461197855504, -0.86987159617569842, 0.96996064525598391},
+		{0.011644343199048871, 0.019304711169224813, -0.0037391155811853502, -0.90881825944854078, 0.9699606452559838},
+		{0.0059873280237888304, -0.016858559463141382, 0.010827714021402216, -0.8658740392847184, 0.98841848004715649},
+		{0.0044689345434367599, 0.0068735935590773789, 0.0024115040061631612, -0.92948151145323243, 0.98841848004715649},
+	},
+	{	// Player 8, 1886.8 Hz.
+		{0.0058071240402793028, 0.030864681599993501, -0.017916436416628153, -0.73761867337993736, 0.96300050335126808},
+		{0.0047080408497481184, -0.026669669233668786, -0.0046508699489972829, -0.72000914294952467, 0.96996064525598391},
+		{0.0087653303028087954, 0.0210451982467658, 0.008692039413452932, -0.76045890103078151, 0.9699606452559838},
+		{0.0054242255007847968, -0.015488459145721207, 0.010025076706058358, -0.71413859398322055, 0.98841848004715649},
+		{0.0067930774588916285, 0.0056187370394556631, -0.0011441604251209389, -0.78020091216827447, 0.9884184800471566},
+	},
+	{	// Player 9, 2000.0 Hz.
+		{0.0056757783735947266, 0.031027424990281192, -0.01768892666633683, -0.60649275436473882, 0.96300050335126786},
+		{0.0039574745325386892, -0.02159853042421413, -0.012356506028381427, -0.58788649078362221, 0.96996064525598369},
+		{0.011136599886776163, 0.022975153804857248, 0.0034915574264954754, -0.6293998580397363, 0.96996064525598391},
+		{0.0052759569572695736, -0.0152156377470671, 0.0099022557913012368, -0.64824564514180794, 0.98841848004715649},
+		{0.0071585387945919347, 0.005947265167938161, -0.0011761955489065254, -0.58044624641370568, 0.98841848004715649},
+	},
+	{	// Player 10, 2127.7 Hz.
+		{0.0055423416040066512, 0.031045329232771104, -0.017423647642644154, -0.45498223079086236, 0.96300050335126808},
+		{0.0046852327998572222, -0.027869256252668853, -0.0046283728044040958, -0.43536511515059761, 0.96996064525598391},
+		{0.0078313827284129459, 0.022844766499142199, 0.01497963701090671, -0.47782577544632326, 0.96996064525598413},
+		{0.0046320506194010673, -0.013478354410544588, 0.0088144966854503803, -0.42620032699181598, 0.98841848004715638},
+		{0.0096409622196524398, 0.0034100070455651112, -0.00080241418593666027, -0.4955468394028133, 0.9884184800471566},
+	},
+	{	// Player 11, 2272.7 Hz.
+		{0.0057488263623553483, 0.034822329188255507, -0.0056791535426826594, -0.27931447079770938, 0.96300050335126797},
+		{0.004693446908893016, -0.028413208519342575, -0.0046365064266821179, -0.25870210326117793, 0.96996064525598391},
+		{0.0084820535402860865, 0.02489614361548784, 0.016372467798415984, -0.30190754934218378, 0.96996064525598391},
+		{0.0043711195374996218, -0.012810337978811395, 0.0084107592263742911, -0.31821262961643892, 0.98841848004715638},
+		{0.009202973807345893, 6.5613874874234195e-06, -0.0023887867697917962, -0.24764973723530562, 0.9884184800471566},
+	},
+	{	// Player 12, 2439.0 Hz.
+		{0.0052446757774397878, 0.030234336213134868, -0.016661155637002011, -0.07517492849335676, 0.96300050335126797},
+		{0.0042032788802646463, -0.02422627283820989, -0.013355933394272592, -0.053632620362536514, 0.96996064525598402},
+		{0.0093148447379384491, 0.027426018519900345, 0.01805940358794416, -0.097250326828787093, 0.96996064525598391},
+		{0.0038279924223635722, -0.011266269537320491, 0.0074153304670507639, -0.040530236666029798, 0.98841848004715649},
+		{0.011339282584274725, 2.5512689612210387e-07, -0.00028140646266356045, -0.11176643039770313, 0.98841848004715671},
+	},
+	{	// Player 13, 2631.6 Hz.
+		{0.0057638582249386096, -0.035147644374208802, -0.0056939880678495763, 0.16207449946387964, 0.96300050335126808},
+		{0.0041505508422555347, 0.023849966883110068, -0.013177247424252456, 0.14089883557774333, 0.96996064525598391},
+		{0.0089302504794398514, -0.026272424715169239, 0.017294952017447678, 0.18439948706488879, 0.96996064525598402},
+		{0.0040809281434316842, 0.011995304756540577, 0.0078889681198880054, 0.12865061636239103, 0.98841848004715649},
+		{0.0105231319431849, 0.0036755602277239552, -0.00084316785972007001, 0.19969563655826092, 0.9884184800471566},
+	},
+	{	// Player 14, 2777.8 Hz.
+		{0.0057570543577953031, -0.034697792235912142, -0.0056872899064226981, 0.3408109051628655, 0.96300050335126797},
+		{0.0040335223287990161, 0.02287453150328398, -0.012753586662440936, 0.36351260635223825, 0.96996064525598402},
+		{0.0084122440224833998, -0.02464716206568732, 0.016195372245211066, 0.32052600647411211, 0.96996064525598413},
+		{0.0054793559392974705, 0.0097083493894539637, -0.0016911268492073824, 0.38032664339222177, 0.98841848004715671},
+		{0.008689758395777852, 0.01306432987569623, 0.0044049124045490396, 0.31012116940304013, 0.9884184800471566},
+	},
+	{	// Player 15, 2941.2 Hz.
+		{0.0034940422355164841, -0.024620664529865832, 0.021048602411059221, 0.53710515485475707, 0.96300050335126819},
+		{0.0046901591689103633, 0.027582442103333452, -0.0046332300029734846, 0.5180178313198448, 0.96996064525598391},
+		{0.012486500430542379, -0.021807076101538508, -0.0038931137268443691, 0.56000126813695805, 0.96996064525598413},
+		{0.0061450046539017564, 0.014881707130337334, 0.0060539009936155866, 0.57834343549952871, 0.98841848004715627},
+		{0.007443389352648393, 0.0035248503552397759, -0.0038310526389660387, 0.50977632179905386, 0.98841848004715649},
+	},
+	{	// Player 16, 3125.0 Hz.
+		{0.0058310661694843348, -0.030889880164975507, -0.017968889434848742, 0.75107432008494002, 0.96300050335126797},
+		{0.0053196030672179612, 0.031847405400459106, 0.0052469653278638881, 0.73357382838449414, 0.96996064525598391},
+		{0.010314945884387198, -0.0090383290692298592, -0.019104825206565854, 0.77390092743319605, 0.96996064525598413},
+		{0.0057389832426213289, 0.0097031355451962179, -0.0018132353918529744, 0.79373062673573846, 0.98841848004715649},
+		{0.0051962583572731386, -0.0079356330936143742, 0.0027485357155412338, 0.72786863459517237, 0.9884184800471566},
+	},
+	{	// Player 17, 3333.3 Hz.
+		{0.0057399550691273026, -0.030446472613111172, -0.0056704970139032865, 0.98132589049268804, 0.96300050335126786},
+		{0.0046654856885539218, 0.024689962311832406, -0.0046087967847257359, 1.0037062339778151, 0.96996064525598391},
+		{0.006212503971861281, -0.017402967406988091, 0.011175246060871471, 0.96590445245963819, 0.96996064525598369},
+		{0.004729981280656363, 0.0058870471748242387, -0.0046724351135716763, 1.0249014499709301, 0.98841848004715638},
+		{0.011462009010272816, 0.017633354230859502, 0.0062185820664506335, 0.96316379226728976, 0.98841848004715649},
+	},
+	{	// Player 18, 3571.4 Hz.
+		{0.005740081221650194, -0.027499159815274732, -0.0056706759583546994, 1.2236933700442632, 0.96300050335126819},
+		{0.0046570757996484725, 0.022239581777648235, -0.0046004445560142038, 1.2450955461037745, 0.96996064525598413},
+		{0.0053722713744852029, -0.014564335895514853, 0.0091832732865673502, 1.2109688071476905, 0.96996064525598424},
+		{0.0048427739836991047, 0.0054312231703025349, -0.0047837807757153145, 1.267406203359918, 0.98841848004715649},
+		{0.013190585505198563, 0.020666549689828527, 0.0075309953330882215, 1.2116706045707684, 0.98841848004715671},
+	},
+	{	// Player 19, 3846.2 Hz.
+		{0.0013426319622341953, -2.3413625727039506e-05, -0.024678169204384735, 1.4690659529847088, 0.96300050335126808},
+		{0.0043288805984150877, -0.011199269184540844, 0.0068664824900761031, 1.488747333482648, 0.96996064525598413},
+		{0.012380114004048473, 0.011742812395286123, -0.01222901512824614, 1.4598022035395422, 0.96996064525598413},
+		{0.01659554694954923, 0.026740044363409106, 0.010211065292911074, 1.5117247138762391, 0.98841848004715671},
+		{0.0078623732724343014, -7.1901398962470472e-06, -0.00041744657175996742, 1.4644516898851454, 0.98841848004715671},
+	},
+};
+
+static const double channelPlan20_gains[20] = {
+	15.936488529196193, 14.715462624600434, 16.26239832933409, 16.169240988353216,
+	15.878957463425797, 16.284215616221921, 15.334003992280159, 16.394855110704437,
+	16.33917515556983, 15.27151916386603, 15.887203215553447, 15.671517886397879,
+	16.186946195009828, 15.725968832902796, 15.512084786069357, 15.415393710250932,
+	15.121128307390318, 15.996016416806338, 15.727383671455504, 15.367441945740891
+};
+
+static const uint16_t channelPlan20_halfPeriodTicks[20] = CHANNELPLAN20_HALF_PERIOD_TICKS;
+
+static const detectorCore::PlanTables<channelPlan20_t> channelPlan20_tables = {
+	channelPlan20_firCoefficients, channelPlan20_sections, channelPlan20_gains, channelPlan20_halfPeriodTicks
+};
+#endif
+
+#endif /* CHANNELPLAN20_H_ */
@@ -14,22 +14,67 @@
 #include "lockoutTimer.h"
 #include "hitLedTimer.h"
 #include "math.h"
+#include "supportFiles/globalTimer.h"
+#include "orderStats.h"
+#include "capture.h"
+#include "profiler.h"
+#include "amp.h"
 
-#define ADC_MAX 4095
-#define SCALED_WIDTH 2
-#define SCALED_OFFSET 1
 #define FUDGE_FACTOR 5
 #define MEDIAN_INDEX FILTER_IIR_FILTER_COUNT/2 - 1
 #define TEST_DATA_COUNT 200
 #define TRANSMITTER_TICK_MULTIPLIER 3	// Call the tick function this many times for each ADC interrupt.
+#define DETECTOR_BLOCK_SIZE 200	// Max number of ADC samples handed to filter_decimateBlock() at once.
+#define DETECTOR_ADC_SAMPLE_RATE_HZ CHANNELPLAN_SAMPLE_RATE_HZ	// isr_function() adds one sample to the ADC buffer per interrupt.
+#define SORT_BENCHMARK_ITERATION_COUNT 10000
 
 const double inputData[TEST_DATA_COUNT] = {1181,1421,1518,1394,1223,1305,1300,1100,1157,1054,1436,1137,1134,1305,1066,1059,1219,1372,1037,1266,1102,1127,977,1387,1496,1029,1261,1337,1326,1346,1314,1170,1224,1099,1544,1144,1071,1276,1402,1204,1270,1238,1066,1325,1076,1136,1262,1215,1275,1287,1088,1006,1422,1308,1201,1443,966,1254,1244,1507,1283,1364,1494,1069,945,1236,1183,1223,1177,986,1258,1176,1337,1376,1308,1045,1098,1350,1017,1176,1120,1123,1116,1161,1313,1138,897,989,1422,1332,1199,1305,1356,1202,1309,1268,1261,1274,1051,1310,1023,1109,1164,1281,1356,1231,1073,1207,1373,1156,1243,1453,1208,1451,1313,1249,1183,1397,1269,1043,1232,1230,1252,1386,1480,1303,1419,1084,1343,1318,1361,1358,1025,1277,1350,1049,1195,1133,1106,1371,953,1129,1300,1395,1520,1220,1335,1301,1113,1400,1242,1395,1111,1287,1240,1528,1422,1208,1009,1315,1261,1456,941,1327,1149,1345,1064,1129,1173,1259,1535,1285,1313,1357,1074,1200,1181,1104,1409,1295,1450,1388,1235,1397,1305,1724,1310,1307,1153,1111,1378,1124,1205,999,970,1349,1307,1147,1381,1180};
 const double computedMedian[TEST_DATA_COUNT/10] = {};
 
 static double sortedPower[FILTER_IIR_FILTER_COUNT] = {};
-static uint8_t sampleCount = 0; // This may need to be a global so it is not reset to zero every time detector() is called
 static bool detector_hitDetectedFlag = false;
-static detector_hitCount_t detector_hitArray[FILTER_IIR_FILTER_COUNT] = {0};
+static detector_blockLatency_t blockLatency = {0, 0, 0, 0.0, 0.0};
+
+#ifdef AMP_ENABLE
+// On CPU1 there is no timer interrupt to run the lockoutTimer and the hitLedTimer (amp.h). The lockout is counted
+// in FIR outputs instead, which is the same time in ADC samples, and CPU0 starts the hitLedTimer when it gets the hit.
+#define LOCKOUT_FIR_OUTPUTS (LOCKOUTTIMER_LOCKOUT_TICKS / FILTER_FIR_DECIMATION_FACTOR)
+typedef detectorCore::CountedLockout lockout_t;
+#define LOCKOUT_INIT(lockout) (lockout).init(LOCKOUT_FIR_OUTPUTS)
+#define HIT_LED_TIMER_START()
+#else
+// The lockoutTimer, run by the timer interrupt, as the lockout of the Detector<> below.
+struct lockout_t {
+	void start() {
+		lockoutTimer_start();
+	}
+	bool countFirOutput() {
+		return lockoutTimer_running();
+	}
+};
+#define LOCKOUT_INIT(lockout) lockoutTimer_init()
+#define HIT_LED_TIMER_START() hitLedTimer_start()
+#endif
+
+// filter.c from the FIR output on (IIR bank and power, in whichever engine filter.h selects) as the chain of the
+// Detector<> below.
+struct filterChain_t {
+	void addFirOutput(float firOutput) {
+		filter_addFirOutput(firOutput);
+		PROFILER_BEGIN(PROFILER_ZONE_IIR_BANK);
+		filter_iirFilterBank();	// All 10 IIR filters at once.
+		PROFILER_END(PROFILER_ZONE_IIR_BANK);
+		for(uint8_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
+			filter_computePower(i,false,false);
+		}
+	}
+	double getPower(int channel) const {
+		return filter_getCurrentPowerValue(channel);
+	}
+};
+
+// The lockout, the threshold test and the hit counts are the ones of detectorCore.h (see Detector<>).
+static detectorCore::Detector<channelPlan_t, filterChain_t, lockout_t> core;
 
 void detector_tick() {
 }
@@ -37,9 +82,14 @@ void detector_tick() {
 // Always have to init things.
 void detector_init() {
 	filter_init();
-	lockoutTimer_init();
+	LOCKOUT_INIT(core.getLockout());
+	core.init(FUDGE_FACTOR);
+	detector_blockLatency_t clearedLatency = {0, 0, 0, 0.0, 0.0};
+	blockLatency = clearedLatency;
 }
 
+// Insertion sort of the power values into sortedPower. detector_computeHit() uses orderStats_compute() now,
+// this is kept for the benchmark in detector_runTest().
 void detector_sort() {
 	//	 for i = 1 to length(A) - 1
 	//	    x = A[i]
@@ -65,76 +115,96 @@ void detector_sort() {
 	}
 }
 
-// Helper function I made
+// Sets the hit flag if the current power values are a hit (Detector<>::computeHit()). Does not count the hit.
 void detector_computeHit() {
-	detector_sort();
-	// Multiply the median value with a fudge-factor to compute a threshold.
-	double threshold = sortedPower[MEDIAN_INDEX] * FUDGE_FACTOR;
-	//printf("SortedPower at median_index %d is %f Threshold is %f\n\r", MEDIAN_INDEX,sortedPower[MEDIAN_INDEX], threshold);
-	// Find the band-pass filter that contains the maximum power.
-	// If the maximum power exceeds the threshold, you have detected a hit.
-	if(sortedPower[FILTER_IIR_FILTER_COUNT-1] > threshold)
+	if(core.computeHit())
 		detector_hitDetectedFlag = true;
 }
 
+// Runs the IIR filters, power computation and hit detection on one FIR output.
+void detector_processFirOutput(double firOutput) {
+	core.getChain().addFirOutput(firOutput);
+	// Unless the lockout is running, the hit test. A hit starts the lockout and is counted by Detector<>.
+	PROFILER_BEGIN(PROFILER_ZONE_HIT);
+	bool hit = core.testFirOutput();
+	PROFILER_END(PROFILER_ZONE_HIT);
+	if(hit) {
+		// Start the hitLedTimer.
+		HIT_LED_TIMER_START();
+		// Set detector_hitDetectedFlag to true.
+		detector_hitDetectedFlag = true;
+	}
+}
+
+// Processes one contiguous span of the ADC buffer in place, see detector.h.
+uint32_t detector_processBlock() {
+	u64 startTime = globalTimer_getTimerValue();
+	uint32_t backlog = isr_adcBufferElementCount();	// Samples waiting, the oldest one is this old.
+	const uint16_t* span;
+	uint32_t spanCount = isr_adcBufferPeekSpan(&span);	// Snapshots the producer index once.
+	if (!spanCount)
+		return 0;
+	PROFILER_BEGIN(PROFILER_ZONE_DETECTOR_BLOCK);
+	// The raw 16-bit samples go straight from the ADC buffer into the FIR filter, a chunk at a time
+	// so that the FIR outputs fit in a small array.
+	float firOutput[DETECTOR_BLOCK_SIZE / FILTER_FIR_DECIMATION_FACTOR + 1];
+	for (uint32_t chunkStart = 0; chunkStart < spanCount; chunkStart += DETECTOR_BLOCK_SIZE) {
+		uint32_t chunkCount = (spanCount - chunkStart < DETECTOR_BLOCK_SIZE) ? spanCount - chunkStart : DETECTOR_BLOCK_SIZE;
+		// The FIR filter scales the samples to -1.0 .. 1.0 and only computes every FILTER_FIR_DECIMATION_FACTOR-th output.
+		PROFILER_BEGIN(PROFILER_ZONE_FIR);
+		size_t firOutputCount = filter_decimateBlock(&span[chunkStart], chunkCount, firOutput);
+		PROFILER_END(PROFILER_ZONE_FIR);
+		for(size_t i = 0; i < firOutputCount; i++) {
+			detector_processFirOutput(firOutput[i]);
+		}
+		if (capture_running())
+			capture_recordBlock(&span[chunkStart], chunkCount);	// Records the power after this chunk.
+	}
+	isr_adcBufferConsume(spanCount);	// Publishes the consumer index once.
+	// Latency: how old the oldest sample was when we started, plus how long it took to get through the span.
+	double processingSeconds = (double) (globalTimer_getTimerValue() - startTime) / GLOBAL_TIMER_TICKS_PER_SECOND;
+	blockLatency.blockCount++;
+	blockLatency.lastSampleCount = spanCount;
+	blockLatency.lastLatencyInSeconds = (double) backlog / DETECTOR_ADC_SAMPLE_RATE_HZ + processingSeconds;
+	if (blockLatency.lastLatencyInSeconds > blockLatency.maxLatencyInSeconds)
+		blockLatency.maxLatencyInSeconds = blockLatency.lastLatencyInSeconds;
+	if (backlog > blockLatency.maxBacklog)
+		blockLatency.maxBacklog = backlog;
+	PROFILER_END(PROFILER_ZONE_DETECTOR_BLOCK);
+	return spanCount;
+}
+
 // Runs the entire detector: decimating fir-filter, iir-filters, power-computation, hit-detection.
 void detector() {
-	// Query the adcQueue to determine how many elements it contains.
-	// Use the ( isr_adcBufferElementCount() for this). Call this amount elementCount.
+	// Only process what is in the ADC buffer now, new samples are left for the next call.
+	// This usually takes one block, two if the samples wrap around the end of the buffer.
 	uint32_t elementCount = isr_adcBufferElementCount();
-	// Now, repeat the following steps elementCount times.
-	for(uint32_t i = 0; i < elementCount; i++) {
-		// Briefly disable interrupts by invoking interrupts_disableArmInts().
-		interrupts_disableArmInts();
-		// Pop a value from adcQueue (use isr_removeDataFromAdcBuffer() for this).
-		// Place this value in a variable called rawAdcValue.
-		uint32_t rawAdcValue = isr_removeDataFromAdcBuffer();
-		// Re-enable interrupts by invoking interrupts_enableArmInts().
-		interrupts_enableArmInts();
-		// Scale the integer value contained in rawAdcValue to a double that is between -1.0 and 1.0.
-		// Store this value into a variable named scaledAdcValue.
-		double scaledAdcValue = (rawAdcValue * 1.0 / ADC_MAX) * SCALED_WIDTH - SCALED_OFFSET;
-		// Invoke filter_addNewInput(scaledAdcValue). This provides a new input to the decimating FIR filter.
-		filter_addNewInput(scaledAdcValue);
-		sampleCount++;
-		// Perform the decimating FIR filter, IIR filter and power computation for all 10 channels.
-		// Remember to only invoke these filters after filter_addNewInput() has been called 10 times (decimation).
-		if (sampleCount == FILTER_FIR_DECIMATION_FACTOR) {  // Only invoke the filters after every DECIMATION_FACTOR times.
-			sampleCount = 0;                                  // Reset the sample count when you run the filters.
-			filter_firFilter();
-			for(uint8_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
-				filter_iirFilter(i);
-				filter_computePower(i,false,false);
-			}
-			// Pretty sure this should be here and not one bracket down.
-			if(!lockoutTimer_running()){
-				// If the lockoutTimer is not running, run the previously-described detection algorithm.
-				// Sort the power values in ascending order according to their magnitude.
-				detector_computeHit();
-				// If you detect a hit:
-				if(detector_hitDetectedFlag) {
-					// Start the lockoutTimer.
-					lockoutTimer_start();
-					// Start the hitLedTimer.
-					hitLedTimer_start();
-					// Increment detector_hitArray at the index of the frequency of the IIR-filter output where you detected the hit.
-					// Find the maxIndex
-					uint8_t maxIndex = 0;
-					for(uint8_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
-						if(sortedPower[FILTER_IIR_FILTER_COUNT-1] == filter_getCurrentPowerValue(i)) {
-							maxIndex = i;
-							return;
-						}
-					}
-					detector_hitArray[maxIndex]++;
-					// Set detector_hitDetectedFlag to true.
-					detector_hitDetectedFlag = true;
-				}
-			}
-		}
+	while (elementCount) {
+		uint32_t processedCount = detector_processBlock();
+		if (!processedCount)
+			break;
+		elementCount = (processedCount < elementCount) ? elementCount - processedCount : 0;
 	}
 }
 
+// Returns the latency statistics for detector_processBlock().
+void detector_getBlockLatency(detector_blockLatency_t* latency) {
+	*latency = blockLatency;
+}
+
+// Prints the latency statistics for detector_processBlock().
+void detector_printBlockLatency() {
+	printf("detector blocks: %lu, last block %lu samples, latency last %lf ms, max %lf ms, max backlog %lu samples\n\r",
+			(unsigned long) blockLatency.blockCount, (unsigned long) blockLatency.lastSampleCount,
+			blockLatency.lastLatencyInSeconds * 1000.0, blockLatency.maxLatencyInSeconds * 1000.0,
+			(unsigned long) blockLatency.maxBacklog);
+}
+
+// Ignores hits for the lockout time.
+void detector_startLockout() {
+	core.getLockout().start();
+}
+
 // Invoke to determine if a hit has occurred.
 bool detector_hitDetected() {
 	return detector_hitDetectedFlag;
@@ -148,7 +218,7 @@ void detector_clearHit() {
 // Get the current hit counts.
 void detector_getHitCounts(detector_hitCount_t hitArray[]) {
 	for(uint8_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
-		hitArray[i] = detector_hitArray[i];
+		hitArray[i] = core.getHitCount(i);
 	}
 }
 
@@ -158,8 +228,8 @@ void detector_runTest() {
 	//	for(uint8_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
 	//		filter_forceValueIntoPowerArray(10*i, i);
 	//	}
+	detector_init();	// The hit test needs the fudge factor.
 	// Test data 1 (from wiki)
-	static bool success = true;
 	printf("Isolated Tests\n\r");
 	printf("Warning: fudge factor must be 5 for these tests to pass\n\r");
 	printf("Data set 1: The following data should detect a hit.\n\r");
@@ -206,6 +276,30 @@ void detector_runTest() {
 		printf("Data set 2: Success!\n\r");
 	else
 		printf("Data set 2: Fail!\n\r");
+	detector_clearHit();
+	// Sort benchmark on data set 2: the old insertion sort vs. the orderStats sorting network.
+	double power[FILTER_IIR_FILTER_COUNT];
+	for(uint8_t i = 0; i < FILTER_IIR_FILTER_COUNT; i++) {
+		power[i] = filter_getCurrentPowerValue(i);
+	}
+	orderStats_t powerStats;
+	globalTimer_startTimer(false);	// Used to count cycles, false = no status message.
+	u64 startTime = globalTimer_getTimerValue();
+	for(uint32_t i = 0; i < SORT_BENCHMARK_ITERATION_COUNT; i++) {
+		detector_sort();
+	}
+	u64 midTime = globalTimer_getTimerValue();
+	for(uint32_t i = 0; i < SORT_BENCHMARK_ITERATION_COUNT; i++) {
+		orderStats_compute(power, &powerStats);
+	}
+	u64 endTime = globalTimer_getTimerValue();
+	if(powerStats.median == sortedPower[MEDIAN_INDEX] && powerStats.max == sortedPower[FILTER_IIR_FILTER_COUNT-1])
+		printf("Sort benchmark: orderStats matches detector_sort().\n\r");
+	else
+		printf("Sort benchmark: orderStats differs from detector_sort()!\n\r");
+	printf("Cycles per call: detector_sort() %llu, orderStats_compute() %llu\n\r",
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * (midTime - startTime) / SORT_BENCHMARK_ITERATION_COUNT,
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * (endTime - midTime) / SORT_BENCHMARK_ITERATION_COUNT);
 	printf("\n\rComprehensive test\n\r");
 //		uint16_t failedIndex = 0;  // Keep track of the index where things failed.
 //		int sampleCount = 0;
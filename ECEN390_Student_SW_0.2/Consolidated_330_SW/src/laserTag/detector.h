@@ -14,9 +14,33 @@ typedef uint16_t detector_hitCount_t;
 // Always have to init things.
 void detector_init();
 
+// Latency statistics for detector_processBlock(). Latency is the age of the oldest sample in the ADC buffer
+// when the block started plus the time spent processing the block, i.e., how far behind real time the detector is.
+typedef struct {
+	uint32_t blockCount;			// Number of blocks processed since detector_init().
+	uint32_t lastSampleCount;		// Number of samples in the last block.
+	uint32_t maxBacklog;			// Most samples ever waiting in the ADC buffer at the start of a block.
+	double lastLatencyInSeconds;
+	double maxLatencyInSeconds;
+} detector_blockLatency_t;
+
 // Runs the entire detector: decimating fir-filter, iir-filters, power-computation, hit-detection.
+// Processes everything that is in the ADC buffer when called, using detector_processBlock().
 void detector();
 
+// Processes one contiguous span of the ADC buffer in place. Reads the buffer's producer index once,
+// runs all of the samples in the span through the detector and then releases them all at once. Returns the number of samples processed (0 if the buffer is empty).
+uint32_t detector_processBlock();
+
+// Get the latency statistics for detector_processBlock().
+void detector_getBlockLatency(detector_blockLatency_t* latency);
+
+// Prints the latency statistics for detector_processBlock().
+void detector_printBlockLatency();
+
+// Ignores hits for the lockout time, as after a hit. Covers startup, when all power values are essentially 0.
+void detector_startLockout();
+
 // Invoke to determine if a hit has occurred.
 bool detector_hitDetected();
 
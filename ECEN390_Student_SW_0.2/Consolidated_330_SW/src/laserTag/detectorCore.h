@@ -0,0 +1,537 @@
+/*
+ * detectorCore.h
+ */
+
+#ifndef DETECTORCORE_H_
+#define DETECTORCORE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Header-only C++ core of the detector: decimating FIR, IIR bank, power windows, order statistics and the
+// threshold test, each a template on the sizes that used to be #defines (channel count, tap count, decimation,
+// window length). The loops over taps, sections and channels are unrolled at compile time with Unroll<>, so a 16- or
+// 20-player build gets straight-line code for its own sizes. The one exception is the IIR bank's channel loop, see
+// BiquadBank.
+//
+// The filter_*, iirBank_*, windowedEnergy_* and orderStats_* C functions are thin wrappers around a 10-channel
+// instantiation of these templates (channelPlan.h), with the coefficient tables from filter.c. Detector<> is the hit
+// logic on top of them: detector.c runs it on filter.c, and for other plans it strings the pieces together with
+// tables from src/hostSim/channelPlanGenerator.c (e.g. channelPlan16.h). Everything is C++98 so the Xilinx toolchain
+// builds it.
+//
+// The arithmetic is the same as the C code it replaced, in the same order, so the outputs are bit-identical.
+
+#define DETECTORCORE_INLINE inline __attribute__ ((always_inline))
+
+namespace detectorCore {
+
+/*================================ Unrolling =================================*/
+
+// Unroll<N>::run(body) calls body(0), body(1), ..., body(N-1) with constant arguments.
+// body is a functor, a class with an operator()(int) (C++98 does not allow local classes as template arguments).
+template <int N>
+struct Unroll {
+	template <class Body>
+	static DETECTORCORE_INLINE void run(Body& body) {
+		Unroll<N-1>::run(body);
+		body(N-1);
+	}
+};
+
+template <>
+struct Unroll<0> {
+	template <class Body>
+	static DETECTORCORE_INLINE void run(Body&) {}
+};
+
+/*============================= Decimating FIR ===============================*/
+
+// Runs the FIR filter on every DecimationFactor-th sample only. The history is mirrored: every sample is written
+// twice, TapCount apart, so the latest TapCount samples are always contiguous (oldest first) and each output is a
+// straight dot product. The decimation phase carries over between blocks, so blocks can be any size.
+template <int TapCount, int DecimationFactor>
+class DecimatingFir {
+public:
+	enum {TAP_COUNT = TapCount, DECIMATION_FACTOR = DecimationFactor};
+
+	// coefficients[] has TapCount taps, b0 first. Clears the history.
+	void init(const double coefficients[]) {
+		for (int i=0; i<TapCount; i++)
+			reversedCoeff[i] = (float) coefficients[TapCount-1-i];
+		memset(history, 0, sizeof(history));
+		historyIndex = 0;
+		phase = 0;
+	}
+
+	// Adds one input. Returns true and sets *y if it completed an output.
+	DETECTORCORE_INLINE bool addSample(float x, float* y) {
+		history[historyIndex] = x;
+		history[historyIndex + TapCount] = x;
+		if (++historyIndex == TapCount)
+			historyIndex = 0;
+		if (++phase < DecimationFactor)
+			return false;	// Not an output sample.
+		phase = 0;
+		DotProduct dot = {&history[historyIndex], reversedCoeff, 0.0f};	// Oldest sample first.
+		Unroll<TapCount>::run(dot);
+		*y = dot.sum;
+		return true;
+	}
+
+	// Scales n raw ADC samples with raw * scale - 1.0 and filters them. Returns the number of outputs written to out
+	// (at most n/DecimationFactor + 1).
+	size_t decimateBlock(const uint16_t* raw, size_t n, float scale, float* out) {
+		size_t outCount = 0;
+		for (size_t i=0; i<n; i++)
+			if (addSample(raw[i] * scale - 1.0f, &out[outCount]))
+				outCount++;
+		return outCount;
+	}
+
+private:
+	struct DotProduct {
+		const float* window;
+		const float* coeff;
+		float sum;
+		DETECTORCORE_INLINE void operator()(int j) { sum += window[j] * coeff[j]; }
+	};
+
+	float history[2*TapCount];
+	float reversedCoeff[TapCount];	// Reversed to match the oldest-first history.
+	uint16_t historyIndex;			// Oldest sample in the history, also where the next sample goes.
+	uint16_t phase;					// Samples added since the last output.
+};
+
+/*=============================== IIR bank ===================================*/
+
+// Unquantized biquad: y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2. Same fields as filterFixed_section_t.
+struct Section {
+	double b0, b1, b2;
+	double a1, a2;
+};
+
+// ChannelCount filters of SectionCount cascaded biquads each, all fed the same input (the FIR output). Laid out
+// [section][tap][lane] like iirBank.c, in float, with the channels padded to a multiple of 4 lanes (zero coefficients).
+// The sections are unrolled, but the lanes are a fixed-count loop: the compiler vectorizes that loop 4 lanes at a time,
+// while with the 10 channels unrolled it did not, and the bank came out 3 times slower on x86.
+template <int ChannelCount, int SectionCount>
+class BiquadBank {
+public:
+	enum {CHANNEL_COUNT = ChannelCount, SECTION_COUNT = SectionCount, LANE_COUNT = (ChannelCount + 3) / 4 * 4};
+
+	// Zeros the coefficients and the history.
+	void init() {
+		memset(coeff, 0, sizeof(coeff));
+		memset(gain, 0, sizeof(gain));
+		reset();
+	}
+
+	// Sets the sections of one channel, and the gain its cascade output is multiplied by.
+	void setChannel(int channel, const Section sections[], double channelGain) {
+		for (int s=0; s<SectionCount; s++) {
+			coeff[s][B0][channel] = (float) sections[s].b0;
+			coeff[s][B1][channel] = (float) sections[s].b1;
+			coeff[s][B2][channel] = (float) sections[s].b2;
+			coeff[s][A1][channel] = (float) sections[s].a1;
+			coeff[s][A2][channel] = (float) sections[s].a2;
+		}
+		gain[channel] = (float) channelGain;
+	}
+
+	// Zeros the history only.
+	void reset() {
+		memset(history, 0, sizeof(history));
+	}
+
+	// Runs every filter on x. out[] receives ChannelCount outputs.
+	DETECTORCORE_INLINE void filter(float x, float out[]) {
+		float input[LANE_COUNT];
+		for (int lane=0; lane<LANE_COUNT; lane++)
+			input[lane] = x;	// All filters see the same FIR output.
+		SectionStep step = {this, input};
+		Unroll<SectionCount>::run(step);
+		ApplyGain applyGain = {this, input, out};
+		Unroll<ChannelCount>::run(applyGain);
+	}
+
+private:
+	enum coeffIndex {B0, B1, B2, A1, A2, COEFF_COUNT};
+	enum historyIndex {X1, X2, Y1, Y2, HISTORY_COUNT};
+
+	// One section for every lane, in the same order as iirBank.c: b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2.
+	struct SectionStep {
+		BiquadBank* bank;
+		float* input;
+		DETECTORCORE_INLINE void operator()(int s) {
+			const float (*c)[LANE_COUNT] = bank->coeff[s];
+			float (*h)[LANE_COUNT] = bank->history[s];
+			for (int lane=0; lane<LANE_COUNT; lane++) {
+				float acc = c[B0][lane] * input[lane];
+				acc = acc + c[B1][lane] * h[X1][lane];
+				acc = acc + c[B2][lane] * h[X2][lane];
+				acc = acc - c[A1][lane] * h[Y1][lane];
+				acc = acc - c[A2][lane] * h[Y2][lane];
+				h[X2][lane] = h[X1][lane];
+				h[X1][lane] = input[lane];
+				h[Y2][lane] = h[Y1][lane];
+				h[Y1][lane] = acc;
+				input[lane] = acc;	// Output of this section is the input to the next.
+			}
+		}
+	};
+
+	struct ApplyGain {
+		const BiquadBank* bank;
+		const float* input;
+		float* out;
+		DETECTORCORE_INLINE void operator()(int channel) { out[channel] = input[channel] * bank->gain[channel]; }
+	};
+
+	float coeff[SectionCount][COEFF_COUNT][LANE_COUNT];
+	float history[SectionCount][HISTORY_COUNT][LANE_COUNT];
+	float gain[ChannelCount];
+};
+
+/*============================ Power windows =================================*/
+
+// Energy (sum of squares) of each channel over the last WindowLength samples, O(1) per sample, like
+// windowedEnergy.c: the squares are kept in float [sample][channel], the sums in double, and a second sum restarted
+// at every wrap of the history replaces the running sum at the next wrap so rounding cannot drift it.
+// The history is WindowLength * ChannelCount floats, so instances belong in static storage.
+template <int ChannelCount, uint32_t WindowLength>
+class SlidingEnergy {
+public:
+	enum {CHANNEL_COUNT = ChannelCount};
+
+	void init() {
+		memset(energy, 0, sizeof(energy));
+		memset(freshEnergy, 0, sizeof(freshEnergy));
+		memset(history, 0, sizeof(history));
+		historyIndex = 0;
+	}
+
+	// Adds one output per channel.
+	DETECTORCORE_INLINE void addSample(const float z[]) {
+		AddSquare add = {this, z, history[historyIndex]};	// The row holds the squares that fall out of the window.
+		Unroll<ChannelCount>::run(add);
+		if (++historyIndex == WindowLength) {
+			// Every row has been rewritten since the last wrap, so freshEnergy is the whole window without the drift.
+			historyIndex = 0;
+			Resync resync = {this};
+			Unroll<ChannelCount>::run(resync);
+		}
+	}
+
+	double getEnergy(int channel) const {
+		return energy[channel];
+	}
+
+	// Recomputes one channel's energy from the history and returns it.
+	double recompute(int channel) {
+		double sum = 0.0;
+		for (uint32_t i=0; i<WindowLength; i++)
+			sum += history[i][channel];
+		energy[channel] = sum;
+		return sum;
+	}
+
+private:
+	struct AddSquare {
+		SlidingEnergy* window;
+		const float* z;
+		float* row;
+		DETECTORCORE_INLINE void operator()(int c) {
+			float square = z[c] * z[c];
+			window->energy[c] += (double) square - (double) row[c];
+			window->freshEnergy[c] += square;
+			row[c] = square;
+		}
+	};
+
+	struct Resync {
+		SlidingEnergy* window;
+		DETECTORCORE_INLINE void operator()(int c) {
+			window->energy[c] = window->freshEnergy[c];
+			window->freshEnergy[c] = 0.0;
+		}
+	};
+
+	double energy[ChannelCount];
+	double freshEnergy[ChannelCount];			// Sum of the rows written since the history last wrapped.
+	float history[WindowLength][ChannelCount];	// Squared outputs, one row per sample.
+	uint32_t historyIndex;						// Oldest row, also the row the next sample goes into.
+};
+
+/*=========================== Order statistics ===============================*/
+
+// Puts the smaller of a[i], a[j] in a[i]. Two selects, so the compiler can use conditional moves.
+static DETECTORCORE_INLINE void compareExchange(double a[], int i, int j) {
+	double lo = (a[i] < a[j]) ? a[i] : a[j];
+	double hi = (a[i] < a[j]) ? a[j] : a[i];
+	a[i] = lo;
+	a[j] = hi;
+}
+
+// Sorts Count values with a fixed comparator network, no data-dependent branches. The general case is odd-even
+// transposition: Count rounds of neighbor compare-exchanges.
+template <int Count>
+struct SortingNetwork {
+	static DETECTORCORE_INLINE void sort(double a[]) {
+		Round round = {a};
+		Unroll<Count>::run(round);
+	}
+
+private:
+	struct Pair {
+		double* a;
+		int first;	// 0 on even rounds, 1 on odd rounds.
+		DETECTORCORE_INLINE void operator()(int p) {
+			int i = 2*p + first;
+			if (i + 1 < Count)	// Constant once unrolled.
+				compareExchange(a, i, i+1);
+		}
+	};
+
+	struct Round {
+		double* a;
+		DETECTORCORE_INLINE void operator()(int r) {
+			Pair pair = {a, r & 1};
+			Unroll<Count/2>::run(pair);
+		}
+	};
+};
+
+// 10 values: Waksman's network, 29 compare-exchanges in 9 levels.
+template <>
+struct SortingNetwork<10> {
+	static DETECTORCORE_INLINE void sort(double a[]) {
+		compareExchange(a, 0, 8); compareExchange(a, 1, 9); compareExchange(a, 2, 7); compareExchange(a, 3, 5); compareExchange(a, 4, 6);
+		compareExchange(a, 0, 2); compareExchange(a, 1, 4); compareExchange(a, 5, 8); compareExchange(a, 7, 9);
+		compareExchange(a, 0, 3); compareExchange(a, 2, 4); compareExchange(a, 5, 7); compareExchange(a, 6, 9);
+		compareExchange(a, 0, 1); compareExchange(a, 3, 6); compareExchange(a, 8, 9);
+		compareExchange(a, 1, 5); compareExchange(a, 2, 3); compareExchange(a, 4, 8); compareExchange(a, 6, 7);
+		compareExchange(a, 1, 2); compareExchange(a, 3, 5); compareExchange(a, 4, 6); compareExchange(a, 7, 8);
+		compareExchange(a, 2, 3); compareExchange(a, 4, 5); compareExchange(a, 6, 7);
+		compareExchange(a, 3, 4); compareExchange(a, 5, 6);
+	}
+};
+
+struct Stats {
+	double median;		// Value at OrderStats<>::MEDIAN_INDEX in ascending order.
+	double max;
+	uint16_t argmax;	// Lowest channel number that has the max value.
+};
+
+// Median, max and argmax of Count values in one pass.
+template <int Count>
+struct OrderStats {
+	enum {MEDIAN_INDEX = Count/2 - 1};	// Lower median, same as the detector always used.
+
+	static DETECTORCORE_INLINE void compute(const double values[], Stats* stats) {
+		double sorted[Count];
+		CopyAndArgmax copy = {values, sorted, 0};
+		Unroll<Count>::run(copy);
+		SortingNetwork<Count>::sort(sorted);
+		stats->median = sorted[MEDIAN_INDEX];
+		stats->max = sorted[Count-1];
+		stats->argmax = copy.argmax;
+	}
+
+private:
+	struct CopyAndArgmax {
+		const double* values;
+		double* sorted;
+		uint16_t argmax;
+		DETECTORCORE_INLINE void operator()(int i) {
+			sorted[i] = values[i];
+			if (values[i] > values[argmax])
+				argmax = i;
+		}
+	};
+};
+
+/*========================== Channel plan, detector ==========================*/
+
+// The sizes of one build. SampleRateHz is the ADC (and timer interrupt) rate, PowerWindowLength is in FIR outputs.
+template <int ChannelCount, uint32_t SampleRateHz, int DecimationFactor, int FirTapCount, int SectionCount,
+		uint32_t PowerWindowLength>
+struct ChannelPlan {
+	enum {
+		CHANNEL_COUNT = ChannelCount,
+		SAMPLE_RATE_HZ = SampleRateHz,
+		DECIMATION_FACTOR = DecimationFactor,
+		FIR_TAP_COUNT = FirTapCount,
+		SECTION_COUNT = SectionCount,
+		POWER_WINDOW_LENGTH = PowerWindowLength
+	};
+	typedef DecimatingFir<FirTapCount, DecimationFactor> fir_t;
+	typedef BiquadBank<ChannelCount, SectionCount> bank_t;
+	typedef SlidingEnergy<ChannelCount, PowerWindowLength> energy_t;
+	typedef OrderStats<ChannelCount> orderStats_t;
+};
+
+// Coefficient tables for a plan, as emitted by channelPlanGenerator.
+template <class Plan>
+struct PlanTables {
+	const double* firCoefficients;					// Plan::FIR_TAP_COUNT taps, b0 first.
+	const Section (*sections)[Plan::SECTION_COUNT];	// [Plan::CHANNEL_COUNT][Plan::SECTION_COUNT].
+	const double* gains;							// Multiplies each channel's cascade output.
+	const uint16_t* halfPeriodTicks;				// Transmitter half-period of each channel, in ADC samples.
+};
+
+// The default chain of Detector<>: the FIR, the IIR bank and the power windows above, with the plan's sizes and
+// tables. Any class with the same addFirOutput() and getPower() can stand in for it, detector.c uses filter.c's.
+template <class Plan>
+class CoreChain {
+public:
+	void init(const PlanTables<Plan>& tables) {
+		fir.init(tables.firCoefficients);
+		bank.init();
+		for (int c=0; c<Plan::CHANNEL_COUNT; c++)
+			bank.setChannel(c, tables.sections[c], tables.gains[c]);
+		energy.init();
+	}
+
+	// Adds one scaled ADC sample to the FIR. Returns true, with the output in y, on every DECIMATION_FACTOR-th sample.
+	DETECTORCORE_INLINE bool addSample(float x, float* y) {
+		return fir.addSample(x, y);
+	}
+
+	// Runs the IIR bank and the power windows on one FIR output.
+	DETECTORCORE_INLINE void addFirOutput(float y) {
+		float z[Plan::CHANNEL_COUNT];
+		bank.filter(y, z);
+		energy.addSample(z);
+	}
+
+	double getPower(int channel) const {
+		return energy.getEnergy(channel);
+	}
+
+private:
+	typename Plan::fir_t fir;
+	typename Plan::bank_t bank;
+	typename Plan::energy_t energy;
+};
+
+// The default lockout of Detector<>, counted in FIR outputs like the AMP build of detector.c.
+class CountedLockout {
+public:
+	// lockoutOutputs is the lockout in FIR outputs.
+	void init(uint32_t newLockoutOutputs) {
+		lockoutOutputs = newLockoutOutputs;
+		lockoutRemaining = 0;
+	}
+
+	void start() {
+		lockoutRemaining = lockoutOutputs;
+	}
+
+	// Called once per FIR output. Returns true while the lockout is running: the output that ends it is tested.
+	DETECTORCORE_INLINE bool countFirOutput() {
+		return lockoutRemaining && --lockoutRemaining;
+	}
+
+private:
+	uint32_t lockoutOutputs;
+	uint32_t lockoutRemaining;
+};
+
+// The hit logic of the detector for any plan: the chain runs on every FIR output, then, unless the lockout is
+// running, there is a hit when the loudest channel is above fudgeFactor times the median. detector.c is a
+// Detector<channelPlan_t> with filter.c as its chain and, outside of the AMP build, the lockoutTimer as its lockout.
+// The default chain holds the power history, so use static storage.
+template <class Plan, class Chain = CoreChain<Plan>, class Lockout = CountedLockout>
+class Detector {
+public:
+	enum {CHANNEL_COUNT = Plan::CHANNEL_COUNT};
+
+	// Clears the hit counts. The chain and the lockout are set up on their own, see getChain() and getLockout().
+	void init(double newFudgeFactor) {
+		fudgeFactor = newFudgeFactor;
+		memset(hitCounts, 0, sizeof(hitCounts));
+		lastHitChannel = -1;
+	}
+
+	// For the default chain and lockout: sets up all three. lockoutOutputs is the lockout in FIR outputs.
+	void init(const PlanTables<Plan>& tables, double newFudgeFactor, uint32_t newLockoutOutputs) {
+		chain.init(tables);
+		lockout.init(newLockoutOutputs);
+		init(newFudgeFactor);
+	}
+
+	// Runs the chain on n raw ADC samples, scaled with raw * scale - 1.0. Returns the number of hits in the block,
+	// getLastHitChannel() has the channel of the last one.
+	uint32_t processBlock(const uint16_t* raw, size_t n, float scale) {
+		uint32_t hitCount = 0;
+		for (size_t i=0; i<n; i++) {
+			float y;
+			if (chain.addSample(raw[i] * scale - 1.0f, &y) && processFirOutput(y))
+				hitCount++;
+		}
+		return hitCount;
+	}
+
+	// Runs the chain and then testFirOutput() on one FIR output. Returns true on a hit.
+	bool processFirOutput(float y) {
+		chain.addFirOutput(y);
+		return testFirOutput();
+	}
+
+	// The rest of processFirOutput(), once the chain has the FIR output: counts the lockout and, unless it is
+	// running, runs computeHit(). A hit is counted and starts the lockout. Returns true on a hit.
+	bool testFirOutput() {
+		if (lockout.countFirOutput())
+			return false;
+		if (!computeHit())
+			return false;
+		lockout.start();
+		hitCounts[stats.argmax]++;
+		lastHitChannel = stats.argmax;
+		return true;
+	}
+
+	// Just the threshold test on the chain's current power: true when the loudest channel is above fudgeFactor times
+	// the median. Does not count the hit or start the lockout.
+	bool computeHit() {
+		double power[CHANNEL_COUNT];
+		for (int c=0; c<CHANNEL_COUNT; c++)
+			power[c] = chain.getPower(c);
+		Plan::orderStats_t::compute(power, &stats);
+		return stats.max > stats.median * fudgeFactor;
+	}
+
+	double getPower(int channel) const {
+		return chain.getPower(channel);
+	}
+
+	uint32_t getHitCount(int channel) const {
+		return hitCounts[channel];
+	}
+
+	int16_t getLastHitChannel() const {
+		return lastHitChannel;
+	}
+
+	Chain& getChain() {
+		return chain;
+	}
+
+	Lockout& getLockout() {
+		return lockout;
+	}
+
+private:
+	Chain chain;
+	Lockout lockout;
+	double fudgeFactor;
+	Stats stats;				// Of the last computeHit().
+	uint32_t hitCounts[CHANNEL_COUNT];
+	int16_t lastHitChannel;		// -1 before the first hit.
+};
+
+}	// namespace detectorCore
+
+#endif /* DETECTORCORE_H_ */
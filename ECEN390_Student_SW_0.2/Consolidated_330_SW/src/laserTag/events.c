@@ -0,0 +1,246 @@
+/*
+ * events.c
+ */
+
+#include "events.h"
+#include "timerService.h"
+#include "inputs.h"
+#include "supportFiles/globalTimer.h"
+#include <stdio.h>
+
+#ifdef __arm__
+#include "xil_exception.h"
+// WFI wakes up on a pending interrupt even with IRQs masked. Masking them around the check and the WFI means an event
+// posted after the check cannot be missed: its interrupt is still pending, so the WFI falls straight through.
+#define DISABLE_INTERRUPTS() Xil_ExceptionDisable()
+#define ENABLE_INTERRUPTS() Xil_ExceptionEnable()	// The interrupt that woke us up is taken here.
+#define WAIT_FOR_INTERRUPT() __asm__ __volatile__ ("wfi" : : : "memory")
+#else
+// Host build: no interrupts to wait for, events_wait() just checks again.
+#define DISABLE_INTERRUPTS()
+#define ENABLE_INTERRUPTS()
+#define WAIT_FOR_INTERRUPT()
+#endif
+
+// A slot is free for position p when its sequence is p, and holds the event for position p when it is p + 1.
+// Consuming position p sets it to p + EVENTS_QUEUE_SIZE, which frees it for the next lap.
+typedef struct {
+	volatile uint32_t sequence;
+	events_event_t event;
+} slot_t;
+
+static slot_t slots[EVENTS_QUEUE_SIZE];
+static volatile uint32_t head = 0;	// Next position to claim, producers compare-and-swap it.
+static uint32_t tail = 0;			// Next position to take, main only.
+static volatile uint32_t droppedCount = 0;
+static uint32_t handledCount = 0;
+static uint64_t idleTicks = 0;
+
+// Set while an EVENTS_SAMPLES_READY or EVENTS_FRAME_DUE is in the queue, cleared when main takes it.
+static volatile bool samplesReadyQueued = false;
+static volatile bool frameDueQueued = false;
+
+static volatile bool running = false;
+static uint32_t framePeriodTicks = 0;
+
+static void detectorTimerCallback(timerService_timer_t* timer);
+static void frameTimerCallback(timerService_timer_t* timer);
+static timerService_timer_t detectorTimer = TIMERSERVICE_TIMER(detectorTimerCallback);
+static timerService_timer_t frameTimer = TIMERSERVICE_TIMER(frameTimerCallback);
+
+void events_init() {
+	for (uint32_t i=0; i<EVENTS_QUEUE_SIZE; i++)
+		slots[i].sequence = i;
+	head = 0;
+	tail = 0;
+	droppedCount = 0;
+	handledCount = 0;
+	idleTicks = 0;
+	samplesReadyQueued = false;
+	frameDueQueued = false;
+}
+
+bool events_post(events_type_t type, uint16_t value) {
+	uint32_t position = __atomic_load_n(&head, __ATOMIC_RELAXED);
+	slot_t* slot;
+	while (true) {
+		slot = &slots[position & EVENTS_QUEUE_INDEX_MASK];
+		int32_t difference = (int32_t) (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+		if (difference == 0) {
+			// Free, try to claim it. On failure position is reloaded with the head another producer left.
+			if (__atomic_compare_exchange_n(&head, &position, position + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		} else if (difference < 0) {
+			__atomic_fetch_add(&droppedCount, 1, __ATOMIC_RELAXED);	// Still holds the event from one lap ago: full.
+			return false;
+		} else {
+			position = __atomic_load_n(&head, __ATOMIC_RELAXED);	// Claimed by another producer since we read head.
+		}
+	}
+	slot->event.type = type;
+	slot->event.value = value;
+	__atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);	// The event is visible before the slot is.
+	return true;
+}
+
+bool events_get(events_event_t* event) {
+	slot_t* slot = &slots[tail & EVENTS_QUEUE_INDEX_MASK];
+	if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != tail + 1)
+		return false;	// Empty, or the producer of the oldest event has not finished.
+	*event = slot->event;
+	__atomic_store_n(&slot->sequence, tail + EVENTS_QUEUE_SIZE, __ATOMIC_RELEASE);	// Done reading before it is reused.
+	tail++;
+	if (event->type == EVENTS_SAMPLES_READY)
+		samplesReadyQueued = false;
+	else if (event->type == EVENTS_FRAME_DUE)
+		frameDueQueued = false;
+	handledCount++;
+	return true;
+}
+
+// True if events_get() would return an event.
+static bool eventWaiting() {
+	return __atomic_load_n(&slots[tail & EVENTS_QUEUE_INDEX_MASK].sequence, __ATOMIC_ACQUIRE) == tail + 1;
+}
+
+void events_wait(events_event_t* event) {
+	while (!events_get(event)) {
+		DISABLE_INTERRUPTS();
+		if (!eventWaiting()) {
+			uint64_t start = globalTimer_getTimerValue();
+			WAIT_FOR_INTERRUPT();
+			idleTicks += globalTimer_getTimerValue() - start;	// Before the ISR runs, so it is not counted as idle.
+		}
+		ENABLE_INTERRUPTS();
+	}
+}
+
+uint32_t events_getHandledCount() {
+	return handledCount;
+}
+
+uint32_t events_getDroppedCount() {
+	return droppedCount;
+}
+
+uint64_t events_getIdleTicks() {
+	return idleTicks;
+}
+
+/*========================= Event sources ==========================*/
+
+// Posts the event unless one is still queued.
+static void postOnce(volatile bool* queued, events_type_t type) {
+	if (*queued)
+		return;
+	*queued = true;
+	if (!events_post(type, 0))
+		*queued = false;	// Dropped, try again next period.
+}
+
+static void detectorTimerCallback(timerService_timer_t* timer) {
+	if (!running)
+		return;
+	postOnce(&samplesReadyQueued, EVENTS_SAMPLES_READY);
+	timerService_scheduleTicks(timer, EVENTS_DETECTOR_PERIOD_TICKS);
+}
+
+static void frameTimerCallback(timerService_timer_t* timer) {
+	if (!running)
+		return;
+	postOnce(&frameDueQueued, EVENTS_FRAME_DUE);
+	timerService_scheduleTicks(timer, framePeriodTicks);
+}
+
+// Called by inputs.c from the timer ISR with the debounced edges of the buttons and the switches.
+static void inputChanged(uint32_t pressed, uint32_t released, uint32_t state) {
+	if (!running)
+		return;
+	if ((pressed | released) & INPUTS_SWITCHES_MASK)
+		events_post(EVENTS_SWITCHES_CHANGED, (state & INPUTS_SWITCHES_MASK) >> INPUTS_SWITCHES_SHIFT);
+	if (pressed & INPUTS_BUTTONS_MASK)
+		events_post(EVENTS_BUTTONS_PRESSED, (pressed & INPUTS_BUTTONS_MASK) >> INPUTS_BUTTONS_SHIFT);
+}
+
+void events_start(uint32_t newFramePeriodTicks) {
+	framePeriodTicks = newFramePeriodTicks;
+	events_post(EVENTS_SWITCHES_CHANGED, inputs_getSwitches());
+	running = true;
+	inputs_addListener(INPUTS_BUTTONS_MASK | INPUTS_SWITCHES_MASK, inputChanged);	// Adding it again is a no-op.
+	timerService_request(&detectorTimer);
+	if (framePeriodTicks)
+		timerService_request(&frameTimer);
+}
+
+void events_stop() {
+	running = false;
+}
+
+/*=============================== Test Functions ==============================*/
+
+#define TEST_COUNTER_START 0xFFFFFFF0UL	// Start just below 2^32 so the positions wrap during the test.
+#define TEST_LAP_COUNT 3
+
+// Takes every event. Returns false if they are not of type and firstValue, firstValue+1, ...
+static bool testDrain(events_type_t type, uint16_t firstValue, uint32_t expectedCount) {
+	events_event_t event;
+	uint32_t count = 0;
+	while (events_get(&event)) {
+		if (event.type != type || event.value != (uint16_t) (firstValue + count)) {
+			printf("events_runTest: got type %d value %d, expected type %d value %d.\n\r", event.type, event.value,
+					type, (uint16_t) (firstValue + count));
+			return false;
+		}
+		count++;
+	}
+	if (count != expectedCount) {
+		printf("events_runTest: got %lu events, expected %lu.\n\r", (unsigned long) count, (unsigned long) expectedCount);
+		return false;
+	}
+	return true;
+}
+
+// Starts the queue at position start, as if that many events had gone through it.
+static void testInitAt(uint32_t start) {
+	events_init();
+	for (uint32_t i=0; i<EVENTS_QUEUE_SIZE; i++)
+		slots[(start + i) & EVENTS_QUEUE_INDEX_MASK].sequence = start + i;
+	head = tail = start;
+}
+
+bool events_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("events_runTest: single-threaded checks.\n\r");
+	// 1. Fill the queue exactly, a full queue drops the new event.
+	testInitAt(TEST_COUNTER_START);
+	for (uint32_t i=0; i<EVENTS_QUEUE_SIZE; i++)
+		success &= events_post(EVENTS_HIT_DETECTED, i);
+	success &= !events_post(EVENTS_HIT_DETECTED, 0);
+	if (events_getDroppedCount() != 1) {
+		printf("events_runTest: dropped count %lu, expected 1.\n\r", (unsigned long) events_getDroppedCount());
+		success = false;
+	}
+	success &= testDrain(EVENTS_HIT_DETECTED, 0, EVENTS_QUEUE_SIZE);
+	// 2. Several laps in half-queue batches, the positions wrap past 2^32.
+	testInitAt(TEST_COUNTER_START);
+	for (uint32_t batch=0; batch<2*TEST_LAP_COUNT; batch++) {
+		uint16_t first = batch * (EVENTS_QUEUE_SIZE / 2);
+		for (uint16_t i=0; i<EVENTS_QUEUE_SIZE/2; i++)
+			success &= events_post(EVENTS_SWITCHES_CHANGED, first + i);
+		success &= testDrain(EVENTS_SWITCHES_CHANGED, first, EVENTS_QUEUE_SIZE / 2);
+	}
+	// 3. The periodic events are queued once until main takes them.
+	events_init();
+	postOnce(&samplesReadyQueued, EVENTS_SAMPLES_READY);
+	postOnce(&samplesReadyQueued, EVENTS_SAMPLES_READY);
+	success &= testDrain(EVENTS_SAMPLES_READY, 0, 1);
+	postOnce(&samplesReadyQueued, EVENTS_SAMPLES_READY);
+	success &= testDrain(EVENTS_SAMPLES_READY, 0, 1);
+	if (events_getHandledCount() != 2) {
+		printf("events_runTest: handled count %lu, expected 2.\n\r", (unsigned long) events_getHandledCount());
+		success = false;
+	}
+	events_init();
+	printf("events_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
@@ -0,0 +1,71 @@
+/*
+ * events.h
+ */
+
+#ifndef EVENTS_H_
+#define EVENTS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Event queue for the main loops. Instead of spinning on interrupts_isrFlagGlobal and running the detector, the
+// switches and the transmitter on every tick, main waits in events_wait() and handles one typed event at a time.
+// - The timer ISR posts the periodic events from timerService callbacks (events_start()): EVENTS_SAMPLES_READY every
+//   EVENTS_DETECTOR_PERIOD_TICKS and EVENTS_FRAME_DUE every frame period. EVENTS_SWITCHES_CHANGED and
+//   EVENTS_BUTTONS_PRESSED come from the debounced edges of inputs.h.
+// - Main posts EVENTS_HIT_DETECTED after a detector run that found a hit.
+// The queue is bounded and lock-free with any number of producers and one consumer (main): a producer claims a slot
+// with a compare-and-swap on head, then publishes it through the slot's sequence number. The ISR can interrupt main
+// in the middle of a post and post its own event, neither one waits. When the queue is full the new event is dropped
+// and counted. EVENTS_SAMPLES_READY and EVENTS_FRAME_DUE are never queued twice, so a slow main cannot fill the queue
+// with them.
+// When the queue is empty, events_wait() sleeps with WFI until the next interrupt and adds the time to the idle count.
+
+#define EVENTS_QUEUE_SIZE 32				// A power of two.
+#define EVENTS_QUEUE_INDEX_MASK (EVENTS_QUEUE_SIZE - 1)
+#define EVENTS_DETECTOR_PERIOD_TICKS 100	// 1 ms of ADC samples per detector run.
+
+typedef enum {
+	EVENTS_SAMPLES_READY,		// Time to run the detector.
+	EVENTS_HIT_DETECTED,		// value unused, the hit counts have the channel.
+	EVENTS_SWITCHES_CHANGED,	// value: inputs_getSwitches().
+	EVENTS_BUTTONS_PRESSED,		// value: the buttons that went down, BUTTONS_BTN*_MASK bits.
+	EVENTS_FRAME_DUE			// Time to update the display.
+} events_type_t;
+
+typedef struct {
+	uint16_t type;	// events_type_t.
+	uint16_t value;
+} events_event_t;
+
+// Empties the queue and clears the counts.
+void events_init();
+
+// Starts posting the periodic events from the timer ISR. A framePeriodTicks of 0 means no EVENTS_FRAME_DUE.
+// Posts EVENTS_SWITCHES_CHANGED with the current switches right away. Call after isr_init() and inputs_init(), and
+// again after any later inputs_init(): that drops the listener this adds for the buttons and the switches.
+void events_start(uint32_t framePeriodTicks);
+
+// Stops the periodic events (after their next callback).
+void events_stop();
+
+// Any context. Adds an event. Returns false (and counts it) if the queue is full.
+bool events_post(events_type_t type, uint16_t value);
+
+// Main only. Takes the oldest event into *event. Returns false if there is none.
+bool events_get(events_event_t* event);
+
+// Main only. Takes the oldest event into *event, sleeping until there is one.
+void events_wait(events_event_t* event);
+
+// Events main has taken, events dropped because the queue was full.
+uint32_t events_getHandledCount();
+uint32_t events_getDroppedCount();
+
+// Time spent asleep in events_wait(), in global-timer ticks.
+uint64_t events_getIdleTicks();
+
+// Single-threaded checks of ordering, wrap-around, full queue and coalescing. The stress test is in src/hostSim.
+bool events_runTest();
+
+#endif /* EVENTS_H_ */
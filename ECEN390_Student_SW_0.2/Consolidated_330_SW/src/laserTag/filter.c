@@ -11,24 +11,42 @@
 #include <math.h>
 #include "histogram.h"
 #include "supportFiles/utils.h"
-
-#define FIR_COEF_COUNT 23
-#define IIR_A_COEFFICIENT_COUNT 10
-#define IIR_B_COEFFICIENT_COUNT 11
+#include "supportFiles/globalTimer.h"
+#include "filterFixed.h"
+#include "iirBank.h"
+#include "staticQueue.h"
+#include "windowedEnergy.h"
+#include "slidingDft.h"
+#include "detectorCore.h"
+
+#define FIR_COEF_COUNT FILTER_FIR_COEFFICIENT_COUNT
+#define IIR_A_COEFFICIENT_COUNT FILTER_IIR_ORDER
+#define IIR_B_COEFFICIENT_COUNT (FILTER_IIR_ORDER+1)
 #define X_QUEUE_SIZE FIR_COEF_COUNT
 #define Y_QUEUE_SIZE IIR_B_COEFFICIENT_COUNT
 #define Z_QUEUE_SIZE IIR_A_COEFFICIENT_COUNT
 #define TEST_DATA_COUNT 200
-#define POWER_OUTPUT_QUEUE_SIZE 20000
 #define MAX_ERROR .00001
 
-static queue_t xQueue;
-static queue_t yQueue;
-static queue_t zQueue[FILTER_IIR_FILTER_COUNT];
-static queue_t powerOutput[FILTER_IIR_FILTER_COUNT];
+// All of the queues are statically allocated (see staticQueue.h), so filter_init() needs no heap.
+// Storage is rounded up to a power of two: 32 for x, 16 for y and z.
+// The power computation keeps its own history, see windowedEnergy.h.
+STATICQUEUE_DECLARE_TYPE(filterQueue, double, "%le")
+STATICQUEUE_DEFINE(filterQueue, double, xQueue, X_QUEUE_SIZE, 5);
+STATICQUEUE_DEFINE(filterQueue, double, yQueue, Y_QUEUE_SIZE, 4);
+STATICQUEUE_DEFINE_ARRAY(filterQueue, double, zQueue, FILTER_IIR_FILTER_COUNT, Z_QUEUE_SIZE, 4);
 
 static double currentPowerValue[FILTER_IIR_FILTER_COUNT] = {0};
 
+// State for filter_decimateBlock(): the decimating FIR of detectorCore.h for this plan, which keeps a mirrored float
+// history so each output is a straight dot product, no wrap-around and no filterQueue_readElementAt().
+// The fixed-point engine keeps its own history, only the decimation phase is counted here.
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+static uint16_t firDecimationPhase = 0;			// Number of samples added since the last output.
+#else
+static detectorCore::DecimatingFir<FIR_COEF_COUNT, FILTER_FIR_DECIMATION_FACTOR> decimator;
+#endif
+
 double firBcoeff[FIR_COEF_COUNT] = {3.66000121597220e-05,-9.37983887116858e-20,-0.000853962386806215,-0.00403760479059139,-0.00991457334688855,-0.0132599560706162,5.44337364799067e-18,0.0482283541041642,0.139662648737947,0.257391560533714,0.359393702205797,0.400000000000000,0.359393702205797,0.257391560533714,0.139662648737947,0.0482283541041642,5.44337364799067e-18,-0.0132599560706162,-0.00991457334688855,-0.00403760479059139,-0.000853962386806215,-9.37983887116858e-20,3.66000121597220e-05};
 double iirAcoeff[FILTER_IIR_FILTER_COUNT][IIR_A_COEFFICIENT_COUNT] = {
 		{-7.50908233436483,27.3536234378542,-62.7047362383248,99.6056348149310,-114.201323557917,95.6364834552749,-57.8068381560701,24.2120744276596,-6.38177025817259,0.816001991091691},
@@ -81,101 +99,172 @@ const double outputIIRData[FILTER_IIR_FILTER_COUNT][TEST_DATA_COUNT] = {{7.86071
 // Make sure to fill your queues with zeros after you initialize them.
 
 void initXQueue() {
-	queue_init(&xQueue, X_QUEUE_SIZE);
-	for (int j=0; j<X_QUEUE_SIZE; j++)
-		queue_overwritePush(&xQueue, 0.0);
+	filterQueue_fill(&xQueue, 0.0);
 }
 
 void initYQueue() {
-	queue_init(&yQueue, Y_QUEUE_SIZE);
-	for (int j=0; j<Y_QUEUE_SIZE; j++)
-		queue_overwritePush(&yQueue, 0.0);
+	filterQueue_fill(&yQueue, 0.0);
 }
 
 void initZQueues() {
-	for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
-		queue_init(&(zQueue[i]), Z_QUEUE_SIZE);
-		for (int j=0; j<Z_QUEUE_SIZE; j++)
-			queue_overwritePush(&(zQueue[i]), 0.0);
-	}
+	STATICQUEUE_INIT_ARRAY(zQueue, FILTER_IIR_FILTER_COUNT, Z_QUEUE_SIZE, 4);
+	for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		filterQueue_fill(&(zQueue[i]), 0.0);
 }
 
-void initPowerQueues() {
-	for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
-		queue_init(&(powerOutput[i]), POWER_OUTPUT_QUEUE_SIZE);
-		for (int j=0; j<POWER_OUTPUT_QUEUE_SIZE; j++)
-			queue_overwritePush(&(powerOutput[i]), 0.0);
-	}
+void initDecimator() {
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+	firDecimationPhase = 0;
+#else
+	decimator.init(firBcoeff);
+#endif
 }
 
 void filter_init() {
 	// Init queues and fill them with 0s.
-	initXQueue();  // Call queue_init() on xQueue and fill it with zeros.
-	initYQueue();  // Call queue_init() on yQueue and fill it with zeros.
-	initZQueues(); // Call queue_init() on all of the zQueues and fill each z queue with zeros.
+	initDecimator();  // Clear the filter_decimateBlock() history.
+	initXQueue();  // Fill xQueue with zeros.
+	initYQueue();  // Fill yQueue with zeros.
+	initZQueues(); // Fill each z queue with zeros.
+#ifdef FILTER_USE_SLIDING_DFT
+	slidingDft_init(); // filter_iirFilterBank() updates the DFT bins instead of the power windows.
+#else
+	windowedEnergy_init(); // filter_iirFilterBank() adds every set of outputs to the power windows.
+#endif
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+	filterFixed_init();
+#else
+	iirBank_init();
+#endif
 }
 
 // Print out the contents of the xQueue for debugging purposes.
 void filter_printXQueue() {
-	queue_print(&xQueue);
+	filterQueue_print(&xQueue);
 }
 
 // Print out the contents of yQueue for debugging purposes.
 void filter_printYQueue() {
-	queue_print(&yQueue);
+	filterQueue_print(&yQueue);
 }
 
 // Print out the contents of the the specified zQueue for debugging purposes.
 void filter_printZQueue(uint16_t filterNumber) {
-	queue_print(&(zQueue[filterNumber]));
+	filterQueue_print(&(zQueue[filterNumber]));
 }
 
 // Use this to copy an input into the input queue (x_queue).
 void filter_addNewInput(double x) {
-	queue_overwritePush(&xQueue, x);
+	filterQueue_overwritePush(&xQueue, x);
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+	filterFixed_addNewInput(filterFixed_toSample(x));
+#endif
 }
 
 // Invokes the FIR filter. Returns the output from the FIR filter. Also adds the output to the y_queue for use by the IIR filter.
 double filter_firFilter() {
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+	double y = filterFixed_stateToDouble(filterFixed_firFilter());
+	filterQueue_overwritePush(&yQueue,y);
+	return y;
+#else
+	return filter_firFilterDouble();
+#endif
+}
+
+// Runs the decimating FIR filter on a block of raw ADC samples, see filter.h.
+// Polyphase decimation: only the phase that is kept gets a dot product, the other FILTER_FIR_DECIMATION_FACTOR-1
+// samples are just scaled and written into the history.
+size_t filter_decimateBlock(const uint16_t* raw, size_t n, float* out) {
+	const float scale = 2.0f / FILTER_ADC_MAX;	// Same scaling as detector(): 0 .. FILTER_ADC_MAX becomes -1.0 .. 1.0.
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+	size_t outCount = 0;
+	for (size_t i=0; i<n; i++) {
+		filterFixed_addNewInput(filterFixed_toSample(raw[i] * scale - 1.0f));
+		if (++firDecimationPhase < FILTER_FIR_DECIMATION_FACTOR)
+			continue;	// Not an output sample.
+		firDecimationPhase = 0;
+		out[outCount++] = (float) filterFixed_stateToDouble(filterFixed_firFilter());
+	}
+	return outCount;
+#else
+	return decimator.decimateBlock(raw, n, scale, out);
+#endif
+}
+
+// Adds an output from filter_decimateBlock() to the yQueue for use by the IIR filters.
+void filter_addFirOutput(double y) {
+	filterQueue_overwritePush(&yQueue, y);
+}
+
+// Use this to invoke a single iir filter. Uses the y_queue and z_queues as input. Returns the IIR-filter output.
+double filter_iirFilter(uint16_t filterNumber) {
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+	double z = filterFixed_iirFilter(filterNumber);
+	filterQueue_overwritePush(&(zQueue[filterNumber]),z);
+	return z;
+#else
+	return filter_iirFilterDouble(filterNumber);
+#endif
+}
+
+// Runs all of the IIR filters at once on the latest FIR output and adds the outputs to the power windows.
+void filter_iirFilterBank() {
+#ifdef FILTER_USE_SLIDING_DFT
+	slidingDft_addSample((float) filterQueue_readNewest(&yQueue));	// The bins replace the IIR filters and the power windows.
+#else
+	float z[FILTER_IIR_FILTER_COUNT];
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		z[i] = (float) filter_iirFilter(i);
+#else
+	iirBank_filter((float) filterQueue_readNewest(&yQueue), z);
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		filterQueue_overwritePush(&(zQueue[i]),z[i]);
+#endif
+	windowedEnergy_addSample(z);
+#endif
+}
+
+// Double-precision FIR filter, see filter_firFilter().
+double filter_firFilterDouble() {
 	// += accumulates the result during the for-loop. Must start out with y = 0.
 	double y = 0.0;
 	// This for-loop performs the identical computation to that shown above. for-loop is correct way to do it.
 	for (int i=0; i<FIR_COEF_COUNT; i++) {
-		y += queue_readElementAt(&xQueue, i) * firBcoeff[FIR_COEF_COUNT-1-i];  // iteratively adds the (b * input) products.
+		y += filterQueue_readElementAt(&xQueue, i) * firBcoeff[FIR_COEF_COUNT-1-i];  // iteratively adds the (b * input) products.
 	}
-	queue_overwritePush(&yQueue,y);
+	filterQueue_overwritePush(&yQueue,y);
 	return y;	// Might be wrong
 }
 
-// Use this to invoke a single iir filter. Uses the y_queue and z_queues as input. Returns the IIR-filter output.
-double filter_iirFilter(uint16_t filterNumber) {
+// Double-precision IIR filter, see filter_iirFilter().
+double filter_iirFilterDouble(uint16_t filterNumber) {
 	double aSum = 0.0, bSum = 0.0, z = 0.0;;
 	for (int i=0; i<IIR_B_COEFFICIENT_COUNT; i++) {
-		bSum += queue_readElementAt(&yQueue, i) * iirBcoeff[filterNumber][IIR_B_COEFFICIENT_COUNT-1-i];  // iteratively adds the (b * input) products.
+		bSum += filterQueue_readElementAt(&yQueue, i) * iirBcoeff[filterNumber][IIR_B_COEFFICIENT_COUNT-1-i];  // iteratively adds the (b * input) products.
 	}
 	for (int i=0; i<IIR_A_COEFFICIENT_COUNT; i++) {
-		aSum += queue_readElementAt(&(zQueue[filterNumber]), i) * iirAcoeff[filterNumber][IIR_A_COEFFICIENT_COUNT-1-i];  // iteratively adds the (b * input) products.
+		aSum += filterQueue_readElementAt(&(zQueue[filterNumber]), i) * iirAcoeff[filterNumber][IIR_A_COEFFICIENT_COUNT-1-i];  // iteratively adds the (b * input) products.
 	}
 	z = bSum - aSum;
-	queue_overwritePush(&(zQueue[filterNumber]),z);
-	queue_overwritePush(&(powerOutput[filterNumber]),z);
+	filterQueue_overwritePush(&(zQueue[filterNumber]),z);
 	return z;
 }
 
 // Use this to compute the power for values contained in a queue.
 // If force == true, then recompute everything from scratch.
+// windowedEnergy already updated the power when filter_iirFilterBank() ran, so this just picks it up.
 double filter_computePower(uint16_t filterNumber, bool forceComputeFromScratch, bool debugPrint) {
-	double power = 0;
-	if(forceComputeFromScratch) {
-		for(uint32_t i = 0; i < POWER_OUTPUT_QUEUE_SIZE; i++) {
-			power += queue_readElementAt(&(powerOutput[filterNumber]), i)*queue_readElementAt(&(powerOutput[filterNumber]), i);
-			currentPowerValue[filterNumber] = power;
-		}
-	} else { // Second subtraction does not need the multiply... Could be faster.
-		currentPowerValue[filterNumber] += queue_readElementAt(&(powerOutput[filterNumber]), POWER_OUTPUT_QUEUE_SIZE-1)*queue_readElementAt(&(powerOutput[filterNumber]), POWER_OUTPUT_QUEUE_SIZE-1);
-		currentPowerValue[filterNumber] -= queue_readElementAt(&(powerOutput[filterNumber]), 0)*queue_readElementAt(&(powerOutput[filterNumber]), 0);
-	}
-	return 0;
+#ifdef FILTER_USE_SLIDING_DFT
+	currentPowerValue[filterNumber] = slidingDft_getPower(filterNumber);	// Nothing to recompute, the bins resync every window.
+#else
+	if(forceComputeFromScratch)
+		currentPowerValue[filterNumber] = windowedEnergy_recompute(filterNumber);
+	else
+		currentPowerValue[filterNumber] = windowedEnergy_getEnergy(filterNumber);
+#endif
+	return currentPowerValue[filterNumber];
 }
 
 double filter_getCurrentPowerValue(uint16_t filterNumber) {
@@ -248,10 +337,13 @@ void filter_runTestDJs() {
 #include "supportFiles/intervalTimer.h"
 	printf("Power Tests:\n\r");
 	double seconds;
+	float powerTestOutput[FILTER_IIR_FILTER_COUNT];
+	for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++)
+		powerTestOutput[i] = i;
+	windowedEnergy_init();
+	for (int j=0; j<WINDOWEDENERGY_WINDOW_LENGTH; j++)
+		windowedEnergy_addSample(powerTestOutput);
 	for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
-		queue_init(&(powerOutput[i]), POWER_OUTPUT_QUEUE_SIZE);
-		for (int j=0; j<POWER_OUTPUT_QUEUE_SIZE; j++)
-			queue_overwritePush(&(powerOutput[i]), i);
 		intervalTimer_init(2);
 		intervalTimer_reset(2);
 		intervalTimer_start(2);
@@ -259,8 +351,6 @@ void filter_runTestDJs() {
 		intervalTimer_stop(2);
 		intervalTimer_getTotalDurationInSeconds(2,&seconds);
 		printf("Scratch: %e\t", seconds);
-		for (int j=0; j<POWER_OUTPUT_QUEUE_SIZE; j++)
-			queue_overwritePush(&(powerOutput[i]), i);
 		intervalTimer_reset(2);
 		intervalTimer_start(2);
 		filter_computePower(i,false,false);
@@ -334,6 +424,21 @@ uint32_t filterTest_getIirBCoefficientCount() {
 	return IIR_B_COEFFICIENT_COUNT;
 }
 
+// Returns the number of golden test samples.
+uint16_t filterTest_getTestDataCount() {
+	return TEST_DATA_COUNT;
+}
+
+// Returns the golden input data (raw ADC counts).
+const double* filterTest_getInputData() {
+	return inputData;
+}
+
+// Returns the golden output data for a particular IIR filter.
+const double* filterTest_getOutputIirData(uint16_t filterNumber) {
+	return outputIIRData[filterNumber];
+}
+
 // Returns the size of the yQueue.
 uint32_t filterTest_getYQueueSize() {
 	return Y_QUEUE_SIZE;
@@ -363,14 +468,14 @@ bool filterTest_floatingPointEqual(double a, double b) {
 }
 
 // Fills the queue with the fillValue, overwriting all previous contents.
-void filterTest_fillQueue(queue_t* q, double fillValue) {
-	for (queue_size_t i=0; i<q->size; i++) {
-		queue_overwritePush(q, fillValue);
+void filterTest_fillQueue(filterQueue_t* q, double fillValue) {
+	for (staticQueue_size_t i=0; i<filterQueue_size(q); i++) {
+		filterQueue_overwritePush(q, fillValue);
 	}
 }
 
-queue_data_t filterTest_filter_readMostRecentValueFromQueue(queue_t* q) {
-	return queue_readElementAt(q, q->elementCount-1);
+double filterTest_filter_readMostRecentValueFromQueue(filterQueue_t* q) {
+	return filterQueue_readNewest(q);
 }
 
 /* ============================ Major Test Functions ============================= */
@@ -448,7 +553,7 @@ bool filterTest_runIirBAlignmentTest(uint16_t filterNumber, bool printMessageFla
 	bool success = true;						// Be optimistic.
 	filterTest_fillQueue(&yQueue, 0.0);	// zero-out the yQueue.
 	filterTest_fillQueue(&(zQueue[filterNumber]), 0.0);	// zero out the zQueue for filterNumber.
-	queue_overwritePush(&yQueue, 1.0);							// Place a single 1.0 in the yQueue.
+	filterQueue_overwritePush(&yQueue, 1.0);							// Place a single 1.0 in the yQueue.
 	for (uint32_t i=0; i<filterTest_getIirBCoefficientCount(); i++) {
 		filter_iirFilter(filterNumber);										// Run the IIR filter.
 		double iirValue = filterTest_filter_readMostRecentValueFromQueue(&(zQueue[filterNumber]));										// Run the IIR filter.
@@ -458,7 +563,7 @@ bool filterTest_runIirBAlignmentTest(uint16_t filterNumber, bool printMessageFla
 			printf("filter_runIirBlignmentTest: Output from IIR Filter[%d](%le) does not match test-data(%le) at index(%ld).\n\r", filterNumber, iirValue, iirGoldenOutput, i);
 		}
 		filterTest_fillQueue(&(zQueue[filterNumber]), 0.0);	// zero out the zQueue for filterNumber so the A-summation is always 0.
-		queue_overwritePush(&yQueue, 0.0);							// Shift the 1.0 over one position in the yQueue.
+		filterQueue_overwritePush(&yQueue, 0.0);							// Shift the 1.0 over one position in the yQueue.
 	}
 	// Print informational messages.
 	if (printMessageFlag) {
@@ -481,9 +586,9 @@ bool filterTest_runIirAAlignmentTest(uint16_t filterNumber, bool printMessageFla
 	uint16_t startingIndex = filterTest_getIirACoefficientArrayStartingIndex();  // Varies according to student.
 	for (uint32_t i=0; i<filterTest_getIirACoefficientCount()-startingIndex; i++) {	// Loop through all of the A-coefficients.
 		filterTest_fillQueue(&(zQueue[filterNumber]), 0.0);				// zero out the zQueue for filterNumber.
-		queue_overwritePush(&(zQueue[filterNumber]), 1.0);		// Add a single 1.0 to the queue.
+		filterQueue_overwritePush(&(zQueue[filterNumber]), 1.0);		// Add a single 1.0 to the queue.
 		for (uint32_t j=0; j<i; j++) {												// Move over the 1.0 an additional position each time through the loop.
-			queue_overwritePush(&(zQueue[filterNumber]), 0.0);	// Move the 1.0 over by writing the correct number of zeros.
+			filterQueue_overwritePush(&(zQueue[filterNumber]), 0.0);	// Move the 1.0 over by writing the correct number of zeros.
 		}
 		filter_iirFilter(filterNumber);										// Run the IIR filter.
 		double iirValue = filterTest_filter_readMostRecentValueFromQueue(&(zQueue[filterNumber]));										// Run the IIR filter.
@@ -690,3 +795,76 @@ bool filter_runTest() {
 	}
 	return success;
 }
+
+#define DECIMATE_TEST_BLOCK_SIZE_COUNT 5
+#ifdef FILTER_USE_FIXED_POINT_ENGINE
+#define DECIMATE_TEST_MAX_ERROR 1.0E-3	// Q15 inputs vs. double.
+#else
+#define DECIMATE_TEST_MAX_ERROR 1.0E-5	// float vs. double.
+#endif
+#define DECIMATE_TEST_TIMING_PASSES 100	// Passes over the test data when timing, one pass is only 20 outputs.
+// Block sizes are chosen so that blocks start at different decimation phases.
+static const uint16_t decimateTestBlockSizes[DECIMATE_TEST_BLOCK_SIZE_COUNT] = {1, 7, 10, 23, TEST_DATA_COUNT};
+
+bool filter_runDecimateBlockTest() {
+	bool success = true;	// Be optimistic.
+	printf("filter_runDecimateBlockTest: filter_decimateBlock() vs. filter_firFilterDouble().\n\r");
+	uint16_t raw[TEST_DATA_COUNT];
+	for (uint16_t i=0; i<TEST_DATA_COUNT; i++)
+		raw[i] = (uint16_t) inputData[i];	// Golden inputs are raw ADC counts.
+	// Reference outputs, one sample at a time through the xQueue.
+	double golden[TEST_DATA_COUNT / FILTER_FIR_DECIMATION_FACTOR];
+	uint16_t goldenCount = 0;
+	filter_init();
+	for (uint16_t i=0; i<TEST_DATA_COUNT; i++) {
+		filter_addNewInput(raw[i] * (2.0 / FILTER_ADC_MAX) - 1.0);
+		if ((i+1) % FILTER_FIR_DECIMATION_FACTOR == 0)
+			golden[goldenCount++] = filter_firFilterDouble();
+	}
+	for (uint16_t b=0; b<DECIMATE_TEST_BLOCK_SIZE_COUNT; b++) {
+		uint16_t blockSize = decimateTestBlockSizes[b];
+		float out[TEST_DATA_COUNT / FILTER_FIR_DECIMATION_FACTOR + 1];
+		uint16_t outCount = 0;
+		filter_init();
+		for (uint16_t i=0; i<TEST_DATA_COUNT; i+=blockSize) {
+			uint16_t n = (TEST_DATA_COUNT-i < blockSize) ? TEST_DATA_COUNT-i : blockSize;
+			outCount += filter_decimateBlock(&raw[i], n, &out[outCount]);
+		}
+		if (outCount != goldenCount) {
+			printf("Block size %d: %d outputs, expected %d.\n\r", blockSize, outCount, goldenCount);
+			success = false;
+			continue;
+		}
+		for (uint16_t i=0; i<outCount; i++) {
+			if (fabs(out[i] - golden[i]) > DECIMATE_TEST_MAX_ERROR) {
+				printf("Block size %d: output %d is %le, expected %le.\n\r", blockSize, i, (double) out[i], golden[i]);
+				success = false;
+				break;
+			}
+		}
+	}
+	// Timing: both paths over the same data, filter_decimateBlock() with one big block the way detector() uses it.
+	globalTimer_startTimer(false);	// Used to count cycles, false = no status message.
+	filter_init();
+	u64 startTime = globalTimer_getTimerValue();
+	for (uint16_t pass=0; pass<DECIMATE_TEST_TIMING_PASSES; pass++)
+		for (uint16_t i=0; i<TEST_DATA_COUNT; i++) {
+			filter_addNewInput(raw[i] * (2.0 / FILTER_ADC_MAX) - 1.0);
+			if ((i+1) % FILTER_FIR_DECIMATION_FACTOR == 0)
+				filter_firFilterDouble();
+		}
+	u64 queueTicks = globalTimer_getTimerValue() - startTime;
+	filter_init();
+	startTime = globalTimer_getTimerValue();
+	for (uint16_t pass=0; pass<DECIMATE_TEST_TIMING_PASSES; pass++) {
+		float out[TEST_DATA_COUNT / FILTER_FIR_DECIMATION_FACTOR + 1];
+		filter_decimateBlock(raw, TEST_DATA_COUNT, out);
+	}
+	u64 blockTicks = globalTimer_getTimerValue() - startTime;
+	uint32_t timedCount = (uint32_t) DECIMATE_TEST_TIMING_PASSES * goldenCount;
+	printf("Cycles per decimated output: xQueue %llu, filter_decimateBlock() %llu\n\r",
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * queueTicks / timedCount,
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * blockTicks / timedCount);
+	printf("filter_runDecimateBlockTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
@@ -9,11 +9,27 @@
 #define FILTER_H_
 
 #include <stdint.h>
-#include "queue.h"
+#include <stddef.h>
+#include "channelPlan.h"
 
-#define FILTER_IIR_FILTER_COUNT 10      // You need this many IIR filters.
-#define FILTER_FIR_DECIMATION_FACTOR 10	// Filter needs this many new inputs to compute a new output.
+#define FILTER_IIR_FILTER_COUNT CHANNELPLAN_CHANNEL_COUNT      // You need this many IIR filters.
+#define FILTER_FIR_DECIMATION_FACTOR CHANNELPLAN_DECIMATION_FACTOR	// Filter needs this many new inputs to compute a new output.
 #define FILTER_INPUT_PULSE_WIDTH 200	// This is the width of the pulse you are looking for, in terms of decimated sample count.
+#define FILTER_FIR_COEFFICIENT_COUNT CHANNELPLAN_FIR_TAP_COUNT	// Number of taps in the decimating FIR filter.
+#define FILTER_IIR_ORDER CHANNELPLAN_IIR_ORDER	// Each IIR filter has this many A coefficients (leading 1 not stored) and one more B coefficient.
+#define FILTER_ADC_MAX 4095				// Raw ADC samples run from 0 to this value, filter_decimateBlock() scales them to -1.0 .. 1.0.
+
+// Uncomment to run the FIR and IIR filters on the fixed-point engine (filterFixed.c) instead of in double.
+// Queues, power computation and everything else in the filter_* API stay the same.
+// Off because it does not pay off yet: on the host (filterFixed_runTest() in src/hostSim/moduleTests.c) it takes
+// about as many cycles per decimated sample as the double engine, 190-250 for both, neither consistently faster.
+// It has not been timed on the ZYBO.
+//#define FILTER_USE_FIXED_POINT_ENGINE
+
+// Uncomment to estimate the channel powers with sliding DFT bins at the player frequencies (slidingDft.c)
+// instead of the IIR filters and the power windows. filter_iirFilterBank() then updates the bins, and
+// filter_computePower()/filter_getCurrentPowerValue() return the bin powers, so the detector does not change.
+//#define FILTER_USE_SLIDING_DFT
 
 // Filtering routines for the laser-tag project.
 // Filtering is performed by a two-stage filter, as described below.
@@ -21,6 +37,7 @@
 // 1. First filter is a decimating FIR filter with a configurable number of taps and decimation factor.
 // 2. The output from the decimating FIR filter is passed through a bank of 10 IIR filters. The
 // characteristics of the IIR filter are fixed.
+// The filters themselves are the templates in detectorCore.h, instantiated for the 10-player plan in channelPlan.h.
 
 // The decimation factor determines how many new samples must be read for each new filter output.
 //uint16_t filter_getFirDecimationFactor();
@@ -45,9 +62,23 @@ void filter_addNewInput(double x);
 // Invokes the FIR filter. Returns the output from the FIR filter. Also adds the output to the y_queue for use by the IIR filter.
 double filter_firFilter();
 
+// Runs the decimating FIR filter on a block of n raw ADC samples. Only every FILTER_FIR_DECIMATION_FACTOR-th sample
+// produces an output, and only those outputs are computed. The decimation phase carries over between calls, so blocks
+// can be any size. Returns the number of outputs written to out (at most n/FILTER_FIR_DECIMATION_FACTOR + 1).
+// The outputs are not added to the yQueue, pass each one to filter_addFirOutput() before running the IIR filters.
+size_t filter_decimateBlock(const uint16_t* raw, size_t n, float* out);
+
+// Adds an output from filter_decimateBlock() to the yQueue for use by the IIR filters.
+void filter_addFirOutput(double y);
+
 // Use this to invoke a single iir filter. Uses the y_queue and z_queues as input. Returns the IIR-filter output.
 double filter_iirFilter(uint16_t filterNumber);
 
+// Runs all of the IIR filters at once on the latest FIR output (see iirBank.h). Same as calling filter_iirFilter()
+// for each filter number but much faster. Also adds the outputs to the power windows (see windowedEnergy.h),
+// filter_iirFilter() on its own does not. With FILTER_USE_SLIDING_DFT, updates the sliding DFT bins instead.
+void filter_iirFilterBank();
+
 // Use this to compute the power for values contained in a queue.
 // If force == true, then recompute everything from scratch.
 double filter_computePower(uint16_t filterNumber, bool forceComputeFromScratch, bool debugPrint);
@@ -62,6 +93,23 @@ void filter_runTestDJs();
 
 bool filter_runTest();
 
+// Compares filter_decimateBlock() against filter_addNewInput()/filter_firFilterDouble() on the golden input data
+// for several block sizes and prints the cycles per decimated output for both (timed over 100 passes of the data).
+bool filter_runDecimateBlockTest();
+
 void filter_forceValueIntoPowerArray(double value, uint8_t index);
 
+// The double-precision FIR and IIR filters. filter_firFilter() and filter_iirFilter() use these
+// unless FILTER_USE_FIXED_POINT_ENGINE is defined. Handy for comparing the two engines.
+double filter_firFilterDouble();
+double filter_iirFilterDouble(uint16_t filterNumber);
+
+// Accessors for the coefficients and golden test data so that other filter engines can use them.
+double* filterTest_getFirCoefficientArray();
+double* filterTest_getIirACoefficientArray(uint16_t filterNumber);
+double* filterTest_getIirBCoefficientArray(uint16_t filterNumber);
+uint16_t filterTest_getTestDataCount();
+const double* filterTest_getInputData();
+const double* filterTest_getOutputIirData(uint16_t filterNumber);
+
 #endif /* FILTER_H_ */
@@ -0,0 +1,422 @@
+/*
+ * filterFixed.c
+ */
+
+#include "filterFixed.h"
+#include "filter.h"
+#include <stdio.h>
+#include <math.h>
+#include "supportFiles/globalTimer.h"
+
+#define FIR_COEF_COUNT FILTER_FIR_COEFFICIENT_COUNT
+#define IIR_ORDER FILTER_IIR_ORDER
+#define ROOT_FINDER_ITERATIONS 500		// Durand-Kerner converges long before this for 10th-order polynomials.
+#define ROOT_FINDER_REAL_EPSILON 1.0E-9	// Roots with a smaller imaginary part are treated as real.
+#define PEAK_GAIN_GRID_POINTS 1024		// Frequencies checked when scaling each section to a peak gain of 1.
+#define TEST_INPUT_SCALE 2048.0			// Golden input data are raw ADC counts, scale them to fit in Q15.
+#define TEST_MIN_SNR_IN_DB 60.0			// Fixed-point outputs must be at least this close to the double outputs.
+
+// Coefficients for a single biquad: y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2. All Q28.
+typedef struct {
+	int32_t b0, b1, b2;
+	int32_t a1, a2;
+} filterFixed_biquadCoeff_t;
+
+// Direct-form I history for a single biquad. All Q24.
+typedef struct {
+	filterFixed_state_t x1, x2;
+	filterFixed_state_t y1, y2;
+} filterFixed_biquadState_t;
+
+// Quadratic 1 + c1*z^-1 + c2*z^-2 used while factoring.
+typedef struct {
+	double c1, c2;
+	double radius;	// Radius of the roots, used to pair poles with zeros.
+	double angle;	// Angle of the root in the upper half-plane.
+} quadratic_t;
+
+typedef struct {
+	double re, im;
+} complex_t;
+
+// FIR history is mirrored (each sample is written twice) so the dot-product never wraps.
+static filterFixed_sample_t xHistory[2*FIR_COEF_COUNT];
+static uint16_t xIndex = 0;
+static int16_t firCoeff[FIR_COEF_COUNT];	// Q15, reversed so that the oldest sample multiplies firCoeff[0].
+static filterFixed_state_t firOutput = 0;	// Latest FIR output, input to all of the IIR filters.
+
+static filterFixed_biquadCoeff_t sectionCoeff[FILTER_IIR_FILTER_COUNT][FILTERFIXED_SECTION_COUNT];
+static filterFixed_biquadState_t sectionState[FILTER_IIR_FILTER_COUNT][FILTERFIXED_SECTION_COUNT];
+static double outputGain[FILTER_IIR_FILTER_COUNT];	// Leftover gain after each section was scaled to a peak of 1.
+
+/*=============================== Helper Functions ============================*/
+
+static complex_t complexMultiply(complex_t a, complex_t b) {
+	complex_t c = {a.re*b.re - a.im*b.im, a.re*b.im + a.im*b.re};
+	return c;
+}
+
+static complex_t complexDivide(complex_t a, complex_t b) {
+	double denominator = b.re*b.re + b.im*b.im;
+	complex_t c = {(a.re*b.re + a.im*b.im)/denominator, (a.im*b.re - a.re*b.im)/denominator};
+	return c;
+}
+
+// Rounds and saturates a double into a 32-bit fixed-point value with the given number of fraction bits.
+static int32_t toFixed(double value, uint16_t fractionBits) {
+	double scaled = value * (double) (1LL << fractionBits);
+	if (scaled >= (double) INT32_MAX)
+		return INT32_MAX;
+	if (scaled <= (double) INT32_MIN)
+		return INT32_MIN;
+	return (int32_t) lround(scaled);
+}
+
+// Rounds a 64-bit product back down by shift bits and saturates it to 32 bits.
+static inline int32_t roundAndSaturate(int64_t accumulator, uint16_t shift) {
+	accumulator = (accumulator + (1LL << (shift-1))) >> shift;
+	if (accumulator > INT32_MAX)
+		return INT32_MAX;
+	if (accumulator < INT32_MIN)
+		return INT32_MIN;
+	return (int32_t) accumulator;
+}
+
+// Finds the roots of the monic polynomial z^n + c[0]*z^(n-1) + ... + c[n-1] with the Durand-Kerner method.
+static void findRoots(const double c[], uint16_t n, complex_t roots[]) {
+	complex_t seed = {0.4, 0.9};	// Standard starting point, not a real number and not a root of unity.
+	complex_t power = {1.0, 0.0};
+	for (uint16_t i=0; i<n; i++) {
+		roots[i] = power;
+		power = complexMultiply(power, seed);
+	}
+	for (uint16_t iteration=0; iteration<ROOT_FINDER_ITERATIONS; iteration++) {
+		for (uint16_t i=0; i<n; i++) {
+			// Evaluate the polynomial at roots[i] using Horner's method.
+			complex_t value = {1.0, 0.0};
+			for (uint16_t k=0; k<n; k++) {
+				value = complexMultiply(value, roots[i]);
+				value.re += c[k];
+			}
+			// Divide by the product of the distances to all of the other roots.
+			complex_t denominator = {1.0, 0.0};
+			for (uint16_t j=0; j<n; j++) {
+				if (j != i) {
+					complex_t difference = {roots[i].re - roots[j].re, roots[i].im - roots[j].im};
+					denominator = complexMultiply(denominator, difference);
+				}
+			}
+			complex_t step = complexDivide(value, denominator);
+			roots[i].re -= step.re;
+			roots[i].im -= step.im;
+		}
+	}
+}
+
+// Groups the roots of a real polynomial into quadratics (conjugate pairs, or two real roots).
+static void groupRootsIntoQuadratics(const complex_t roots[], uint16_t n, quadratic_t quadratics[]) {
+	uint16_t quadraticCount = 0;
+	double pendingRealRoot = 0.0;
+	bool havePendingRealRoot = false;
+	for (uint16_t i=0; i<n; i++) {
+		if (fabs(roots[i].im) < ROOT_FINDER_REAL_EPSILON) {
+			if (havePendingRealRoot) {	// Two real roots make a quadratic.
+				quadratics[quadraticCount].c1 = -(pendingRealRoot + roots[i].re);
+				quadratics[quadraticCount].c2 = pendingRealRoot * roots[i].re;
+				quadratics[quadraticCount].radius = fmax(fabs(pendingRealRoot), fabs(roots[i].re));
+				quadratics[quadraticCount].angle = 0.0;
+				quadraticCount++;
+				havePendingRealRoot = false;
+			} else {
+				pendingRealRoot = roots[i].re;
+				havePendingRealRoot = true;
+			}
+		} else if (roots[i].im > 0) {	// Only use the upper half of each conjugate pair.
+			double radiusSquared = roots[i].re*roots[i].re + roots[i].im*roots[i].im;
+			quadratics[quadraticCount].c1 = -2.0 * roots[i].re;
+			quadratics[quadraticCount].c2 = radiusSquared;
+			quadratics[quadraticCount].radius = sqrt(radiusSquared);
+			quadratics[quadraticCount].angle = atan2(roots[i].im, roots[i].re);
+			quadraticCount++;
+		}
+	}
+	if (quadraticCount != n/2)
+		printf("filterFixed: Error - found %d quadratics, expected %d.\n\r", quadraticCount, n/2);
+}
+
+// Returns the peak magnitude of (1 + n1 z^-1 + n2 z^-2) / (1 + d1 z^-1 + d2 z^-2) on the unit circle.
+static double sectionPeakGain(const quadratic_t* zeros, const quadratic_t* poles) {
+	double peak = 0.0;
+	for (uint16_t i=0; i<PEAK_GAIN_GRID_POINTS; i++) {
+		double w = M_PI * i / (PEAK_GAIN_GRID_POINTS-1);
+		complex_t z1 = {cos(w), -sin(w)};	// z^-1
+		complex_t z2 = complexMultiply(z1, z1);	// z^-2
+		complex_t numerator = {1.0 + zeros->c1*z1.re + zeros->c2*z2.re, zeros->c1*z1.im + zeros->c2*z2.im};
+		complex_t denominator = {1.0 + poles->c1*z1.re + poles->c2*z2.re, poles->c1*z1.im + poles->c2*z2.im};
+		complex_t h = complexDivide(numerator, denominator);
+		peak = fmax(peak, sqrt(h.re*h.re + h.im*h.im));
+	}
+	return peak;
+}
+
+// Pole pairs are matched with the closest zero pair, sections are ordered from the lowest to the highest pole radius,
+// and each section is scaled to a peak gain of 1 so that nothing inside the cascade can overflow.
+void filterFixed_designSections(uint16_t filterNumber, filterFixed_section_t sections[], double* gain) {
+	double* a = filterTest_getIirACoefficientArray(filterNumber);	// a1..a10 (leading 1 is not stored).
+	double* b = filterTest_getIirBCoefficientArray(filterNumber);	// b0..b10.
+	double monicB[IIR_ORDER];
+	for (uint16_t i=0; i<IIR_ORDER; i++)
+		monicB[i] = b[i+1] / b[0];
+	complex_t poleRoots[IIR_ORDER], zeroRoots[IIR_ORDER];
+	findRoots(a, IIR_ORDER, poleRoots);
+	findRoots(monicB, IIR_ORDER, zeroRoots);
+	quadratic_t poles[FILTERFIXED_SECTION_COUNT], zeros[FILTERFIXED_SECTION_COUNT];
+	groupRootsIntoQuadratics(poleRoots, IIR_ORDER, poles);
+	groupRootsIntoQuadratics(zeroRoots, IIR_ORDER, zeros);
+	// Sort the pole pairs by radius, smallest first (simple insertion sort, there are only 5).
+	for (uint16_t i=1; i<FILTERFIXED_SECTION_COUNT; i++) {
+		quadratic_t x = poles[i];
+		uint16_t j = i;
+		while (j > 0 && poles[j-1].radius > x.radius) {
+			poles[j] = poles[j-1];
+			j--;
+		}
+		poles[j] = x;
+	}
+	// Starting with the pole pair closest to the unit circle, grab the closest zero pair that is left.
+	bool zeroUsed[FILTERFIXED_SECTION_COUNT] = {false};
+	quadratic_t matchedZeros[FILTERFIXED_SECTION_COUNT];
+	for (int16_t i=FILTERFIXED_SECTION_COUNT-1; i>=0; i--) {
+		int16_t best = -1;
+		double bestDistance = 0.0;
+		for (uint16_t j=0; j<FILTERFIXED_SECTION_COUNT; j++) {
+			if (zeroUsed[j])
+				continue;
+			double dx = zeros[j].radius*cos(zeros[j].angle) - poles[i].radius*cos(poles[i].angle);
+			double dy = zeros[j].radius*sin(zeros[j].angle) - poles[i].radius*sin(poles[i].angle);
+			double distance = dx*dx + dy*dy;
+			if (best < 0 || distance < bestDistance) {
+				best = j;
+				bestDistance = distance;
+			}
+		}
+		zeroUsed[best] = true;
+		matchedZeros[i] = zeros[best];
+	}
+	// Scale each section.
+	*gain = b[0];
+	for (uint16_t i=0; i<FILTERFIXED_SECTION_COUNT; i++) {
+		double scale = 1.0 / sectionPeakGain(&matchedZeros[i], &poles[i]);
+		*gain /= scale;
+		sections[i].b0 = scale;
+		sections[i].b1 = scale * matchedZeros[i].c1;
+		sections[i].b2 = scale * matchedZeros[i].c2;
+		sections[i].a1 = poles[i].c1;
+		sections[i].a2 = poles[i].c2;
+	}
+}
+
+// Designs the sections for one IIR filter and quantizes them.
+static void factorIirFilter(uint16_t filterNumber) {
+	filterFixed_section_t sections[FILTERFIXED_SECTION_COUNT];
+	filterFixed_designSections(filterNumber, sections, &outputGain[filterNumber]);
+	for (uint16_t i=0; i<FILTERFIXED_SECTION_COUNT; i++) {
+		filterFixed_biquadCoeff_t* c = &sectionCoeff[filterNumber][i];
+		c->b0 = toFixed(sections[i].b0, FILTERFIXED_COEFF_FRACTION_BITS);
+		c->b1 = toFixed(sections[i].b1, FILTERFIXED_COEFF_FRACTION_BITS);
+		c->b2 = toFixed(sections[i].b2, FILTERFIXED_COEFF_FRACTION_BITS);
+		c->a1 = toFixed(sections[i].a1, FILTERFIXED_COEFF_FRACTION_BITS);
+		c->a2 = toFixed(sections[i].a2, FILTERFIXED_COEFF_FRACTION_BITS);
+	}
+}
+
+/*=============================== Filter Functions ============================*/
+
+void filterFixed_init() {
+	double* b = filterTest_getFirCoefficientArray();
+	for (uint16_t i=0; i<FIR_COEF_COUNT; i++)
+		firCoeff[i] = (int16_t) toFixed(b[FIR_COEF_COUNT-1-i], FILTERFIXED_SAMPLE_FRACTION_BITS);
+	for (uint16_t i=0; i<2*FIR_COEF_COUNT; i++)
+		xHistory[i] = 0;
+	xIndex = 0;
+	firOutput = 0;
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
+		factorIirFilter(i);
+		for (uint16_t j=0; j<FILTERFIXED_SECTION_COUNT; j++) {
+			filterFixed_biquadState_t zero = {0, 0, 0, 0};
+			sectionState[i][j] = zero;
+		}
+	}
+}
+
+filterFixed_sample_t filterFixed_toSample(double x) {
+	int32_t sample = toFixed(x, FILTERFIXED_SAMPLE_FRACTION_BITS);
+	if (sample > INT16_MAX)
+		return INT16_MAX;
+	if (sample < INT16_MIN)
+		return INT16_MIN;
+	return (filterFixed_sample_t) sample;
+}
+
+double filterFixed_stateToDouble(filterFixed_state_t value) {
+	return (double) value / (double) (1L << FILTERFIXED_STATE_FRACTION_BITS);
+}
+
+// Each sample is written at xIndex and xIndex+FIR_COEF_COUNT so that the newest FIR_COEF_COUNT
+// samples always sit contiguously at xHistory[xIndex+1 .. xIndex+FIR_COEF_COUNT], oldest first.
+void filterFixed_addNewInput(filterFixed_sample_t x) {
+	xIndex = (xIndex == FIR_COEF_COUNT-1) ? 0 : xIndex+1;
+	xHistory[xIndex] = x;
+	xHistory[xIndex+FIR_COEF_COUNT] = x;
+}
+
+filterFixed_state_t filterFixed_firFilter() {
+	const filterFixed_sample_t* x = &xHistory[xIndex+1];
+	int64_t accumulator = 0;	// Q15 * Q15 = Q30.
+	for (uint16_t i=0; i<FIR_COEF_COUNT; i++)
+		accumulator += (int32_t) x[i] * firCoeff[i];
+	firOutput = roundAndSaturate(accumulator,
+			2*FILTERFIXED_SAMPLE_FRACTION_BITS - FILTERFIXED_STATE_FRACTION_BITS);
+	return firOutput;
+}
+
+double filterFixed_iirFilter(uint16_t filterNumber) {
+	filterFixed_state_t x = firOutput;
+	for (uint16_t i=0; i<FILTERFIXED_SECTION_COUNT; i++) {
+		const filterFixed_biquadCoeff_t* c = &sectionCoeff[filterNumber][i];
+		filterFixed_biquadState_t* s = &sectionState[filterNumber][i];
+		int64_t accumulator = (int64_t) c->b0 * x;	// Q28 * Q24 = Q52.
+		accumulator += (int64_t) c->b1 * s->x1;
+		accumulator += (int64_t) c->b2 * s->x2;
+		accumulator -= (int64_t) c->a1 * s->y1;
+		accumulator -= (int64_t) c->a2 * s->y2;
+		filterFixed_state_t y = roundAndSaturate(accumulator, FILTERFIXED_COEFF_FRACTION_BITS);
+		s->x2 = s->x1;
+		s->x1 = x;
+		s->y2 = s->y1;
+		s->y1 = y;
+		x = y;	// Output of this section is the input to the next.
+	}
+	return filterFixed_stateToDouble(x) * outputGain[filterNumber];
+}
+
+/*=============================== Test Functions ==============================*/
+
+// Half-periods (in 100 kHz ticks) of the player frequencies, same as freq[] in transmitter.c.
+static const uint16_t testHalfPeriods[FILTER_IIR_FILTER_COUNT] = {45, 36, 29, 25, 22, 19, 17, 15, 14, 13};
+#define TEST_TONE_AMPLITUDE 0.9			// Square-wave amplitude for the tone test.
+#define TEST_TONE_LENGTH 20000			// Same as the 200 ms transmitter pulse.
+#define TEST_TONE_SETTLE_LENGTH 5000	// Skip the start-up transient before measuring SNR.
+
+double filterFixed_snrInDb(double signalEnergy, double errorEnergy) {
+	if (errorEnergy == 0.0)
+		return INFINITY;
+	return 10.0 * log10(signalEnergy / errorEnergy);
+}
+
+// Drives both engines with a square wave at the player frequency for filterNumber and returns the SNR of the
+// fixed-point output for that filter, using the double output as the reference.
+// Also accumulates the global-timer ticks spent in each engine per decimated sample.
+static double runToneTest(uint16_t filterNumber, u64* doubleTicks, u64* fixedTicks, uint32_t* decimatedSampleCount) {
+	double signalEnergy = 0.0, errorEnergy = 0.0;
+	filter_init();
+	filterFixed_init();
+	uint16_t sampleCount = 0;
+	for (uint32_t tick=0; tick<TEST_TONE_LENGTH; tick++) {
+		double x = ((tick / testHalfPeriods[filterNumber]) & 0x1) ? -TEST_TONE_AMPLITUDE : TEST_TONE_AMPLITUDE;
+		filter_addNewInput(x);
+		filterFixed_addNewInput(filterFixed_toSample(x));
+		sampleCount++;
+		if (sampleCount == FILTER_FIR_DECIMATION_FACTOR) {
+			sampleCount = 0;
+			double doubleOutput = 0.0, fixedOutput = 0.0;
+			u64 startTime = globalTimer_getTimerValue();
+			filter_firFilterDouble();
+			for (uint16_t j=0; j<FILTER_IIR_FILTER_COUNT; j++) {
+				double z = filter_iirFilterDouble(j);
+				if (j == filterNumber)
+					doubleOutput = z;
+			}
+			u64 midTime = globalTimer_getTimerValue();
+			filterFixed_firFilter();
+			for (uint16_t j=0; j<FILTER_IIR_FILTER_COUNT; j++) {
+				double z = filterFixed_iirFilter(j);
+				if (j == filterNumber)
+					fixedOutput = z;
+			}
+			u64 endTime = globalTimer_getTimerValue();
+			*doubleTicks += midTime - startTime;
+			*fixedTicks += endTime - midTime;
+			(*decimatedSampleCount)++;
+			if (tick >= TEST_TONE_SETTLE_LENGTH) {
+				signalEnergy += doubleOutput * doubleOutput;
+				errorEnergy += (fixedOutput - doubleOutput) * (fixedOutput - doubleOutput);
+			}
+		}
+	}
+	return filterFixed_snrInDb(signalEnergy, errorEnergy);
+}
+
+// Minimum SNR against the golden output for each filter. The golden input (raw ADC counts) barely excites the upper
+// filters: their golden outputs are 42, 47, 60, 77, 98, 149, 165, 169, 158 and 152 dB below the FIR output. The Q15
+// input puts this engine's round-off about 115 dB below the FIR output, so filter i can reach about 115 dB minus its
+// depth; the thresholds are that with 10 dB of margin. The golden outputs of filters 5-9 are smaller than half an LSB
+// of the Q24 state, so the engine outputs round to zero there and the SNR is 0 dB whatever the filter does. Those
+// filters are only checked on the player tones.
+static const double testMinGoldenSnr[FILTER_IIR_FILTER_COUNT] =
+	{60.0, 55.0, 45.0, 25.0, 5.0, FILTERFIXED_TEST_NOT_CHECKED, FILTERFIXED_TEST_NOT_CHECKED,
+		FILTERFIXED_TEST_NOT_CHECKED, FILTERFIXED_TEST_NOT_CHECKED, FILTERFIXED_TEST_NOT_CHECKED};
+
+// Runs the golden input data through the fixed-point engine (no decimation, that is how the golden data were generated)
+// and returns the SNR of the output for filterNumber against the golden output. depth gets how far the golden output
+// is below the FIR output (of the double engine), in dB.
+static double runGoldenTest(uint16_t filterNumber, double* depth) {
+	const double* inputData = filterTest_getInputData();
+	double signalEnergy = 0.0, errorEnergy = 0.0, firEnergy = 0.0;
+	filter_init();
+	filterFixed_init();
+	for (uint16_t i=0; i<filterTest_getTestDataCount(); i++) {
+		filter_addNewInput(inputData[i]);
+		double firOutput = filter_firFilterDouble();
+		firEnergy += firOutput * firOutput;
+		filterFixed_addNewInput(filterFixed_toSample(inputData[i] / TEST_INPUT_SCALE));	// Golden input is raw ADC counts.
+		filterFixed_firFilter();
+		for (uint16_t j=0; j<FILTER_IIR_FILTER_COUNT; j++) {
+			double z = filterFixed_iirFilter(j) * TEST_INPUT_SCALE;
+			if (j == filterNumber) {
+				double golden = filterTest_getOutputIirData(j)[i];
+				signalEnergy += golden * golden;
+				errorEnergy += (z - golden) * (z - golden);
+			}
+		}
+	}
+	*depth = filterFixed_snrInDb(firEnergy, signalEnergy);
+	return filterFixed_snrInDb(signalEnergy, errorEnergy);
+}
+
+bool filterFixed_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("filterFixed_runTest: fixed-point engine vs. double engine.\n\r");
+	u64 doubleTicks = 0, fixedTicks = 0;	// Time spent in each engine.
+	uint32_t decimatedSampleCount = 0;
+	globalTimer_startTimer(false);	// Used to count cycles, false = no status message.
+	for (uint16_t i=0; i<FILTER_IIR_FILTER_COUNT; i++) {
+		double toneSnr = runToneTest(i, &doubleTicks, &fixedTicks, &decimatedSampleCount);
+		double depth;
+		double goldenSnr = runGoldenTest(i, &depth);
+		printf("IIR filter %d: SNR on player tone %5.1lf dB, SNR on golden data %5.1lf dB (golden %5.1lf dB below FIR)",
+				i, toneSnr, goldenSnr, depth);
+		if (testMinGoldenSnr[i] == FILTERFIXED_TEST_NOT_CHECKED)
+			printf(", not checked\n\r");
+		else
+			printf(", needs %4.1lf dB\n\r", testMinGoldenSnr[i]);
+		if (toneSnr < TEST_MIN_SNR_IN_DB || goldenSnr < testMinGoldenSnr[i])
+			success = false;
+	}
+	printf("Cycles per decimated sample: double %llu, fixed %llu, saved %lld\n\r",
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * doubleTicks / decimatedSampleCount,
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * fixedTicks / decimatedSampleCount,
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * ((long long) doubleTicks - (long long) fixedTicks) / decimatedSampleCount);
+	printf("filterFixed_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
@@ -0,0 +1,68 @@
+/*
+ * filterFixed.h
+ */
+
+#ifndef FILTERFIXED_H_
+#define FILTERFIXED_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Fixed-point version of the filter pipeline in filter.c.
+// Inputs are Q15 samples. The FIR coefficients are Q15, the IIR filters are factored into
+// cascaded second-order sections (biquads) with Q28 coefficients so that the 10th-order
+// filters stay stable after quantization. All multiply-accumulates are done in 64 bits.
+// filter.c uses this engine when FILTER_USE_FIXED_POINT_ENGINE is defined in filter.h.
+
+#define FILTERFIXED_SAMPLE_FRACTION_BITS 15	// Inputs are Q15.
+#define FILTERFIXED_STATE_FRACTION_BITS 24	// FIR outputs and biquad states are Q24 in 32 bits (range is +/- 128).
+#define FILTERFIXED_COEFF_FRACTION_BITS 28	// Biquad coefficients are Q28 (range is +/- 8).
+#define FILTERFIXED_SECTION_COUNT 5			// A 10th-order IIR is 5 biquads.
+
+typedef int16_t filterFixed_sample_t;	// Q15 sample.
+typedef int32_t filterFixed_state_t;	// Q24 value.
+
+// Unquantized biquad: y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2.
+typedef struct {
+	double b0, b1, b2;
+	double a1, a2;
+} filterFixed_section_t;
+
+// Factors one of the 10th-order IIR filters from filter.c into FILTERFIXED_SECTION_COUNT biquads, in double.
+// Each section has a peak gain of 1, whatever gain is left over is returned in gain (multiply the cascade output by it).
+// Also used by iirBank.c for the floating-point version of the cascade.
+void filterFixed_designSections(uint16_t filterNumber, filterFixed_section_t sections[], double* gain);
+
+// Factors the IIR filters into second-order sections, quantizes all coefficients and zeros the histories.
+// The factoring is done in double and only happens once, so call this before using anything else.
+void filterFixed_init();
+
+// Converts a double between -1.0 and 1.0 to a Q15 sample (saturates).
+filterFixed_sample_t filterFixed_toSample(double x);
+
+// Adds a new Q15 input to the FIR history.
+void filterFixed_addNewInput(filterFixed_sample_t x);
+
+// Runs the FIR filter over the history. Returns the output in Q24, also saves it as the input for the IIR filters.
+filterFixed_state_t filterFixed_firFilter();
+
+// Runs the biquad cascade for one IIR filter on the latest FIR output. Returns the output as a double.
+double filterFixed_iirFilter(uint16_t filterNumber);
+
+// Converts a Q24 value to a double.
+double filterFixed_stateToDouble(filterFixed_state_t value);
+
+// Minimum golden-data SNR for the filters that the golden data cannot check (see filterFixed.c), in the test routines.
+#define FILTERFIXED_TEST_NOT_CHECKED (-INFINITY)
+
+// Converts a signal-to-error energy ratio to dB, INFINITY if there is no error. Shared by the test routines.
+double filterFixed_snrInDb(double signalEnergy, double errorEnergy);
+
+// Runs the fixed-point engine and the double-precision engine side-by-side on the player tones, and the fixed-point
+// engine on the golden test data from filter.c. Fails if any filter is below 60 dB SNR on its tone, or below its
+// threshold against golden (filters 5-9 are not checked against golden, see filterFixed.c).
+// Also prints the cycles spent per decimated sample by each engine.
+bool filterFixed_runTest();
+
+#endif /* FILTERFIXED_H_ */
@@ -10,8 +10,10 @@
 #include "supportFiles/buttons.h"
 #include "supportFiles/utils.h"
 #include "supportFiles/leds.h"
+#include "timerService.h"
+#include "profiler.h"
 
-#define LED_TIME 50000
+#define LED_TIME CHANNELPLAN_MS_TO_TICKS(500)
 #define HIT_LED_PIN 11
 
 // States for the controller state machine.
@@ -20,8 +22,10 @@ enum ledStates {
 	high_st,
 } ledState = init_st;
 
+static void hitLedTimer_transition(timerService_timer_t* timer);
+
 volatile static bool enableFlag = false;
-static uint32_t count = 0;
+static timerService_timer_t transitionTimer = TIMERSERVICE_TIMER(hitLedTimer_transition);
 
 // Need to init things.
 void hitLedTimer_init() {
@@ -35,7 +39,10 @@ void hitLedTimer_setLed(int value) {
 
 // Calling this starts the timer.
 void hitLedTimer_start() {
+	if (enableFlag)
+		return;
 	enableFlag = true;
+	timerService_request(&transitionTimer);
 }
 
 // Returns true if the timer is currently running.
@@ -43,42 +50,27 @@ bool hitLedTimer_running() {
 	return enableFlag;
 }
 
-// Standard tick function.
-void hitLedTimer_tick() {
-	// Perform state action first.
-	switch(ledState) {
-	case init_st:
-		break;
-	case high_st:
-		count++;
-		break;
-	default:
-		printf("transmitter_tick state action: hit default\n\r");
-		break;
-	}
-
-	// Perform state update next.
+// Turns the LED on at the tick after hitLedTimer_start() and off LED_TIME ticks later.
+static void hitLedTimer_transition(timerService_timer_t* /*timer*/) {
+	PROFILER_BEGIN(PROFILER_ZONE_HIT_LED_TIMER);
 	switch(ledState) {
 	case init_st:
-		if(enableFlag) {
-			ledState = high_st;
-			hitLedTimer_setLed(1);
-			leds_write(1);
-			count = 0;
-		}
+		ledState = high_st;
+		hitLedTimer_setLed(1);
+		leds_write(1);
+		timerService_scheduleTicks(&transitionTimer, LED_TIME);
 		break;
 	case high_st:
-		if(count == LED_TIME) {
-			enableFlag = false;
-			hitLedTimer_setLed(0);
-			leds_write(0);
-			ledState = init_st;
-		}
+		enableFlag = false;
+		hitLedTimer_setLed(0);
+		leds_write(0);
+		ledState = init_st;
 		break;
 	default:
-		printf("transmitter_tick state update: hit default\n\r");
+		printf("hitLedTimer_transition: hit default\n\r");
 		break;
 	}
+	PROFILER_END(PROFILER_ZONE_HIT_LED_TIMER);
 }
 
 void hitLedTimer_runTest() {
@@ -17,9 +17,6 @@ void hitLedTimer_start();
 // Returns true if the timer is currently running.
 bool hitLedTimer_running();
 
-// Standard tick function.
-void hitLedTimer_tick();
-
 void hitLedTimer_runTest();
 
 
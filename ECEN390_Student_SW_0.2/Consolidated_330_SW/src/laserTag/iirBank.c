@@ -0,0 +1,244 @@
+/*
+ * iirBank.c
+ */
+
+#include "iirBank.h"
+#include "filterFixed.h"
+#include "detectorCore.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "supportFiles/globalTimer.h"
+#ifdef IIRBANK_NEON
+#include <arm_neon.h>
+#endif
+
+#define SECTION_COUNT FILTERFIXED_SECTION_COUNT
+#define TEST_MIN_TONE_SNR_IN_DB 100.0		// Each filter vs. filter_iirFilterDouble() on its own player tone.
+#define TEST_TONE_AMPLITUDE 0.9				// Square-wave amplitude for the tone test, after the -1.0 .. 1.0 scaling.
+#define TEST_TONE_LENGTH 20000				// Same as the 200 ms transmitter pulse.
+#define TEST_TONE_SETTLE_LENGTH 5000		// Skip the start-up transient before measuring SNR.
+
+// The scalar version is the BiquadBank of detectorCore.h for this plan: each channel does
+// y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2, in exactly that order, which is also the order that the NEON version uses.
+typedef detectorCore::BiquadBank<FILTER_IIR_FILTER_COUNT, SECTION_COUNT> scalarBank_t;
+
+#ifdef IIRBANK_NEON
+// Index of each coefficient within a section.
+enum iirBank_coeffIndex {B0, B1, B2, A1, A2, COEFF_COUNT};
+// Index of each history value within a section.
+enum iirBank_historyIndex {X1, X2, Y1, Y2, HISTORY_COUNT};
+
+// History for every section of every filter.
+typedef struct {
+	float history[SECTION_COUNT][HISTORY_COUNT][IIRBANK_LANE_COUNT] __attribute__ ((aligned (16)));
+} iirBank_state_t;
+
+static float coeff[SECTION_COUNT][COEFF_COUNT][IIRBANK_LANE_COUNT] __attribute__ ((aligned (16)));
+static float gain[IIRBANK_LANE_COUNT] __attribute__ ((aligned (16)));
+static iirBank_state_t bankState;
+#else
+static scalarBank_t bank;
+#endif
+
+// Designs the sections of every filter into scalarBank (unless it is NULL), and into the NEON arrays when they are built.
+static void designBank(scalarBank_t* scalarBank) {
+	if (scalarBank)
+		scalarBank->init();
+	for (uint16_t channel=0; channel<FILTER_IIR_FILTER_COUNT; channel++) {
+		filterFixed_section_t sections[SECTION_COUNT];
+		double channelGain;
+		filterFixed_designSections(channel, sections, &channelGain);
+		detectorCore::Section coreSections[SECTION_COUNT];
+		for (uint16_t s=0; s<SECTION_COUNT; s++) {
+			coreSections[s].b0 = sections[s].b0;
+			coreSections[s].b1 = sections[s].b1;
+			coreSections[s].b2 = sections[s].b2;
+			coreSections[s].a1 = sections[s].a1;
+			coreSections[s].a2 = sections[s].a2;
+		}
+		if (scalarBank)
+			scalarBank->setChannel(channel, coreSections, channelGain);
+#ifdef IIRBANK_NEON
+		// Transpose into [section][tap][channel].
+		for (uint16_t s=0; s<SECTION_COUNT; s++) {
+			coeff[s][B0][channel] = (float) sections[s].b0;
+			coeff[s][B1][channel] = (float) sections[s].b1;
+			coeff[s][B2][channel] = (float) sections[s].b2;
+			coeff[s][A1][channel] = (float) sections[s].a1;
+			coeff[s][A2][channel] = (float) sections[s].a2;
+		}
+		gain[channel] = (float) channelGain;
+#endif
+	}
+}
+
+#ifdef IIRBANK_NEON
+static void clearState(iirBank_state_t* state) {
+	memset(state, 0, sizeof(iirBank_state_t));
+}
+
+// NEON version, 4 channels per register. vmla/vmls round the product before the add (not fused),
+// so this should match the scalar bank bit-for-bit (untested, see iirBank.h).
+static void filterNeon(iirBank_state_t* state, float x, float out[]) {
+	float32x4_t input[IIRBANK_VECTOR_COUNT];
+	for (uint16_t v=0; v<IIRBANK_VECTOR_COUNT; v++)
+		input[v] = vdupq_n_f32(x);	// All filters see the same FIR output.
+	for (uint16_t s=0; s<SECTION_COUNT; s++) {
+		float (*h)[IIRBANK_LANE_COUNT] = state->history[s];
+		for (uint16_t v=0; v<IIRBANK_VECTOR_COUNT; v++) {
+			uint16_t lane = v * IIRBANK_LANES_PER_VECTOR;
+			float32x4_t x1 = vld1q_f32(&h[X1][lane]);
+			float32x4_t y1 = vld1q_f32(&h[Y1][lane]);
+			float32x4_t acc = vmulq_f32(vld1q_f32(&coeff[s][B0][lane]), input[v]);
+			acc = vmlaq_f32(acc, vld1q_f32(&coeff[s][B1][lane]), x1);
+			acc = vmlaq_f32(acc, vld1q_f32(&coeff[s][B2][lane]), vld1q_f32(&h[X2][lane]));
+			acc = vmlsq_f32(acc, vld1q_f32(&coeff[s][A1][lane]), y1);
+			acc = vmlsq_f32(acc, vld1q_f32(&coeff[s][A2][lane]), vld1q_f32(&h[Y2][lane]));
+			vst1q_f32(&h[X2][lane], x1);
+			vst1q_f32(&h[X1][lane], input[v]);
+			vst1q_f32(&h[Y2][lane], y1);
+			vst1q_f32(&h[Y1][lane], acc);
+			input[v] = acc;	// Output of this section is the input to the next.
+		}
+	}
+	float result[IIRBANK_LANE_COUNT] __attribute__ ((aligned (16)));
+	for (uint16_t v=0; v<IIRBANK_VECTOR_COUNT; v++) {
+		uint16_t lane = v * IIRBANK_LANES_PER_VECTOR;
+		vst1q_f32(&result[lane], vmulq_f32(input[v], vld1q_f32(&gain[lane])));
+	}
+	for (uint16_t channel=0; channel<FILTER_IIR_FILTER_COUNT; channel++)
+		out[channel] = result[channel];
+}
+#endif
+
+void iirBank_init() {
+#ifdef IIRBANK_NEON
+	memset(coeff, 0, sizeof(coeff));
+	memset(gain, 0, sizeof(gain));
+	designBank(NULL);	// The scalar bank only runs in the test.
+	clearState(&bankState);
+#else
+	designBank(&bank);
+#endif
+}
+
+void iirBank_filter(float x, float out[]) {
+#ifdef IIRBANK_NEON
+	filterNeon(&bankState, x, out);
+#else
+	bank.filter(x, out);
+#endif
+}
+
+/*=============================== Test Functions ==============================*/
+
+// Minimum SNR against the golden output for each filter. The golden input (raw ADC counts) barely excites the upper
+// filters: their golden outputs are 42, 47, 60, 77, 98, 149, 165, 169, 158 and 152 dB below the FIR output. Single
+// precision puts the bank's round-off about 150 dB below the FIR output, so filter i can reach about 150 dB minus its
+// depth; the thresholds are that with 10 dB of margin. For filters 5-9 that is at or below 0 dB: the golden outputs
+// are as small as the float round-off of the input itself, so no single-precision filter can match them. Those filters
+// are checked on the player tones instead.
+static const double testMinGoldenSnr[FILTER_IIR_FILTER_COUNT] =
+	{95.0, 90.0, 80.0, 60.0, 40.0, FILTERFIXED_TEST_NOT_CHECKED, FILTERFIXED_TEST_NOT_CHECKED,
+		FILTERFIXED_TEST_NOT_CHECKED, FILTERFIXED_TEST_NOT_CHECKED, FILTERFIXED_TEST_NOT_CHECKED};
+
+// Half-periods (in 100 kHz ticks) of the player frequencies.
+static const uint8_t testHalfPeriods[FILTER_IIR_FILTER_COUNT] = CHANNELPLAN_HALF_PERIOD_TICKS;
+
+// Drives the bank and filter_iirFilterDouble() with a square wave at the player frequency of filterNumber, decimated
+// like detector() does, and returns the SNR of the bank's output for that filter against the double output.
+static double runToneTest(uint16_t filterNumber) {
+	double signalEnergy = 0.0, errorEnergy = 0.0;
+	filter_init();
+	iirBank_init();
+	for (uint32_t tick=0; tick<TEST_TONE_LENGTH; tick++) {
+		filter_addNewInput(((tick / testHalfPeriods[filterNumber]) & 0x1) ? -TEST_TONE_AMPLITUDE : TEST_TONE_AMPLITUDE);
+		if ((tick+1) % FILTER_FIR_DECIMATION_FACTOR)
+			continue;
+		float y = (float) filter_firFilterDouble();
+		float out[FILTER_IIR_FILTER_COUNT];
+		iirBank_filter(y, out);
+		double reference = 0.0;
+		for (uint16_t j=0; j<FILTER_IIR_FILTER_COUNT; j++) {
+			double z = filter_iirFilterDouble(j);
+			if (j == filterNumber)
+				reference = z;
+		}
+		if (tick >= TEST_TONE_SETTLE_LENGTH) {
+			signalEnergy += reference * reference;
+			errorEnergy += (out[filterNumber] - reference) * (out[filterNumber] - reference);
+		}
+	}
+	return filterFixed_snrInDb(signalEnergy, errorEnergy);
+}
+
+bool iirBank_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("iirBank_runTest: IIR bank vs. golden data and vs. filter_iirFilterDouble() on the player tones.\n\r");
+	const double* inputData = filterTest_getInputData();
+	double inputEnergy = 0;	// Energy of the FIR output that drives the bank.
+	double goldenEnergy[FILTER_IIR_FILTER_COUNT] = {0};
+	double errorEnergy[FILTER_IIR_FILTER_COUNT] = {0};
+	u64 doubleTicks = 0, bankTicks = 0;
+#ifdef IIRBANK_NEON
+	uint32_t mismatchCount = 0;	// Scalar and NEON outputs that are not bit-identical.
+	static scalarBank_t scalarBank;	// Runs the scalar version alongside the NEON version.
+#endif
+	filter_init();
+	iirBank_init();
+#ifdef IIRBANK_NEON
+	designBank(&scalarBank);
+#endif
+	globalTimer_startTimer(false);	// Used to count cycles, false = no status message.
+	// The golden outputs were generated without decimation, so run the filters on every input.
+	for (uint16_t i=0; i<filterTest_getTestDataCount(); i++) {
+		filter_addNewInput(inputData[i]);
+		float y = (float) filter_firFilterDouble();
+		inputEnergy += (double) y * y;
+		u64 startTime = globalTimer_getTimerValue();
+		for (uint16_t j=0; j<FILTER_IIR_FILTER_COUNT; j++)
+			filter_iirFilterDouble(j);
+		u64 midTime = globalTimer_getTimerValue();
+		float out[FILTER_IIR_FILTER_COUNT];
+		iirBank_filter(y, out);
+		u64 endTime = globalTimer_getTimerValue();
+		doubleTicks += midTime - startTime;
+		bankTicks += endTime - midTime;
+#ifdef IIRBANK_NEON
+		float scalarOut[FILTER_IIR_FILTER_COUNT];
+		scalarBank.filter(y, scalarOut);
+		if (memcmp(scalarOut, out, sizeof(out)) != 0)
+			mismatchCount++;
+#endif
+		for (uint16_t j=0; j<FILTER_IIR_FILTER_COUNT; j++) {
+			double golden = filterTest_getOutputIirData(j)[i];
+			goldenEnergy[j] += golden * golden;
+			errorEnergy[j] += (out[j] - golden) * (out[j] - golden);
+		}
+	}
+	for (uint16_t j=0; j<FILTER_IIR_FILTER_COUNT; j++) {
+		double goldenSnr = filterFixed_snrInDb(goldenEnergy[j], errorEnergy[j]);
+		double toneSnr = runToneTest(j);
+		printf("IIR filter %d: SNR on player tone %5.1lf dB, SNR on golden data %5.1lf dB (golden %5.1lf dB below FIR)",
+				j, toneSnr, goldenSnr, filterFixed_snrInDb(inputEnergy, goldenEnergy[j]));
+		if (testMinGoldenSnr[j] == FILTERFIXED_TEST_NOT_CHECKED)
+			printf(", not checked\n\r");
+		else
+			printf(", needs %4.1lf dB\n\r", testMinGoldenSnr[j]);
+		if (toneSnr < TEST_MIN_TONE_SNR_IN_DB || goldenSnr < testMinGoldenSnr[j])
+			success = false;
+	}
+#ifdef IIRBANK_NEON
+	printf("NEON vs. scalar: %lu of %d outputs differ.\n\r", (unsigned long) mismatchCount, filterTest_getTestDataCount());
+	if (mismatchCount)
+		success = false;
+#else
+	printf("NEON not built, used the scalar bank.\n\r");
+#endif
+	printf("Cycles per decimated sample: 10 x filter_iirFilterDouble() %llu, iirBank_filter() %llu\n\r",
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * doubleTicks / filterTest_getTestDataCount(),
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * bankTicks / filterTest_getTestDataCount());
+	printf("iirBank_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
@@ -0,0 +1,42 @@
+/*
+ * iirBank.h
+ */
+
+#ifndef IIRBANK_H_
+#define IIRBANK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "filter.h"
+
+// Runs all of the IIR filters at once. All of the filters see the same input (the FIR output),
+// so the filters are laid out side-by-side: coefficients are stored [section][tap][channel] and each
+// NEON register holds the same tap for 4 channels. The 10th-order filters are run as cascaded biquads
+// (see filterFixed_designSections()) because the direct form is not stable in single precision.
+// Builds without NEON (e.g., x86) use a scalar version (the BiquadBank of detectorCore.h) that does the same float
+// operations in the same order, so the two versions should produce bit-identical outputs.
+// The NEON version is used when the compiler has NEON enabled (-mfpu=neon -mfloat-abi=softfp or hard). The Debug build
+// config does not pass those flags, so the NEON version has not been compiled or run yet: it is untested. With them,
+// iirBank_runTest() checks it against the scalar version.
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define IIRBANK_NEON
+#endif
+
+#define IIRBANK_LANES_PER_VECTOR 4	// One 128-bit NEON register holds 4 floats.
+#define IIRBANK_VECTOR_COUNT ((FILTER_IIR_FILTER_COUNT + IIRBANK_LANES_PER_VECTOR - 1) / IIRBANK_LANES_PER_VECTOR)
+#define IIRBANK_LANE_COUNT (IIRBANK_VECTOR_COUNT * IIRBANK_LANES_PER_VECTOR)	// Unused lanes have zero coefficients.
+
+// Designs the biquads for all of the filters and clears the histories.
+void iirBank_init();
+
+// Runs all of the IIR filters on the FIR output x. out[] receives FILTER_IIR_FILTER_COUNT outputs.
+// Uses the NEON version if it was built, otherwise the scalar version.
+void iirBank_filter(float x, float out[]);
+
+// Compares each filter of the bank against filter_iirFilterDouble() on its own player tone (100 dB SNR), and filters 0-4
+// against the golden data in filter.c (see iirBank.c for why not 5-9). Checks that the NEON and scalar versions agree
+// bit-for-bit when NEON is built, and prints the cycles per decimated sample against filter_iirFilterDouble().
+bool iirBank_runTest();
+
+#endif /* IIRBANK_H_ */
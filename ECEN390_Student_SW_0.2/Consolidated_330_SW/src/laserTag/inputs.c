@@ -0,0 +1,212 @@
+/*
+ * inputs.c
+ */
+
+#include "inputs.h"
+#include "timerService.h"
+#include "supportFiles/buttons.h"
+#include "supportFiles/switches.h"
+#include "supportFiles/mio.h"
+#include <stdio.h>
+
+typedef struct {
+	uint32_t mask;
+	inputs_listener_t listener;
+} listenerEntry_t;
+
+static volatile inputs_snapshot_t snapshot;
+// Bit i of the two counters is the 2-bit count of samples in a row where bit i of the input disagreed with the
+// debounced state.
+static uint32_t countLow = 0;
+static uint32_t countHigh = 0;
+static uint32_t triggerCount = 0;	// Samples in a row where the trigger bit disagreed, up to INPUTS_TRIGGER_DEBOUNCE_SAMPLES.
+static listenerEntry_t listeners[INPUTS_MAX_LISTENER_COUNT];
+static volatile uint32_t listenerCount = 0;
+
+static void sampleCallback(timerService_timer_t* timer);
+static timerService_timer_t sampleTimer = TIMERSERVICE_TIMER(sampleCallback);
+
+// Reads everything once, in the bit layout of inputs.h.
+static uint32_t readInputs() {
+	uint32_t sample = ((uint32_t) buttons_read() << INPUTS_BUTTONS_SHIFT) & INPUTS_BUTTONS_MASK;
+	sample |= ((uint32_t) switches_read() << INPUTS_SWITCHES_SHIFT) & INPUTS_SWITCHES_MASK;
+	if (mio_readPin(INPUTS_TRIGGER_MIO_PIN))
+		sample |= INPUTS_TRIGGER_MASK;
+	return sample;
+}
+
+// Starts over with state as the debounced state and no edges.
+static void resetDebouncer(uint32_t state) {
+	snapshot.raw = state;
+	snapshot.state = state;
+	snapshot.pressed = 0;
+	snapshot.released = 0;
+	snapshot.sampleCount = 0;
+	countLow = 0;
+	countHigh = 0;
+	triggerCount = 0;
+}
+
+// One sample through the vertical counters. Where the sample agrees with the state, both counter bits go to 0.
+// Where it disagrees, the 2-bit count goes 0, 1, 2, 3 and the state flips on the sample after 3, when it wraps to 0.
+// The trigger bit is left out of them and counted in triggerCount the same way, only longer.
+static void debounce(uint32_t sample) {
+	uint32_t state = snapshot.state;
+	uint32_t delta = sample ^ state;
+	uint32_t countedDelta = delta & ~INPUTS_TRIGGER_MASK;
+	countHigh = (countHigh ^ countLow) & countedDelta;
+	countLow = ~countLow & countedDelta;
+	uint32_t toggle = countedDelta & ~(countLow | countHigh);
+	if (!(delta & INPUTS_TRIGGER_MASK)) {
+		triggerCount = 0;
+	} else if (++triggerCount == INPUTS_TRIGGER_DEBOUNCE_SAMPLES) {
+		triggerCount = 0;
+		toggle |= INPUTS_TRIGGER_MASK;
+	}
+	state ^= toggle;
+	snapshot.raw = sample;
+	snapshot.state = state;
+	snapshot.pressed = toggle & state;
+	snapshot.released = toggle & ~state;
+	snapshot.sampleCount++;
+}
+
+static void sampleCallback(timerService_timer_t* timer) {
+	debounce(readInputs());
+	uint32_t pressed = snapshot.pressed, released = snapshot.released;
+	if (pressed | released) {
+		for (uint32_t i=0; i<listenerCount; i++) {
+			uint32_t mask = listeners[i].mask;
+			if ((pressed | released) & mask)
+				listeners[i].listener(pressed & mask, released & mask, snapshot.state);
+		}
+	}
+	timerService_scheduleTicks(timer, INPUTS_SAMPLE_TICKS);
+}
+
+void inputs_init() {
+	buttons_init();
+	switches_init();
+	mio_setPinAsInput(INPUTS_TRIGGER_MIO_PIN);
+	listenerCount = 0;
+	resetDebouncer(readInputs());
+}
+
+void inputs_start() {
+	timerService_request(&sampleTimer);
+}
+
+bool inputs_addListener(uint32_t mask, inputs_listener_t listener) {
+	for (uint32_t i=0; i<listenerCount; i++) {
+		if (listeners[i].listener == listener) {
+			listeners[i].mask = mask;	// Already there (e.g., events_start() after events_stop()): just the new mask.
+			return true;
+		}
+	}
+	if (listenerCount >= INPUTS_MAX_LISTENER_COUNT)
+		return false;
+	listeners[listenerCount].mask = mask;
+	listeners[listenerCount].listener = listener;
+	__atomic_thread_fence(__ATOMIC_RELEASE);	// The entry is complete before the ISR can see it.
+	listenerCount++;
+	return true;
+}
+
+uint32_t inputs_getState() {
+	return snapshot.state;
+}
+
+int32_t inputs_getButtons() {
+	return (snapshot.state & INPUTS_BUTTONS_MASK) >> INPUTS_BUTTONS_SHIFT;
+}
+
+int32_t inputs_getSwitches() {
+	return (snapshot.state & INPUTS_SWITCHES_MASK) >> INPUTS_SWITCHES_SHIFT;
+}
+
+void inputs_getSnapshot(inputs_snapshot_t* copy) {
+	copy->raw = snapshot.raw;
+	copy->state = snapshot.state;
+	copy->pressed = snapshot.pressed;
+	copy->released = snapshot.released;
+	copy->sampleCount = snapshot.sampleCount;
+}
+
+/*=============================== Test Functions ==============================*/
+
+#define TEST_SAMPLE_COUNT 12
+
+// Each bit is its own input: steady high, a short glitch, a clean press, a bouncy press and a bouncy release.
+// Columns are samples, 1 = that bit is high in the sample.
+static const uint8_t testInputs[5][TEST_SAMPLE_COUNT] = {
+	{1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},	// Bit 0, starts high: never an edge.
+	{0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0},	// Bit 1: 3 samples high is too short.
+	{0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},	// Bit 2: pressed on the 4th high sample (sample 5).
+	{0, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1},	// Bit 3: bounces, pressed on the 4th high sample in a row (sample 9).
+	{1, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0},	// Bit 4, starts high: released on sample 7, the bounce after is too short.
+};
+// The sample each bit's edge should come on, -1 for none.
+static const int8_t testEdgeSamples[5] = {-1, -1, 5, 9, 7};
+
+static void testListener(uint32_t /*pressed*/, uint32_t /*released*/, uint32_t /*state*/) {
+}
+
+bool inputs_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("inputs_runTest: vertical-counter debounce.\n\r");
+	inputs_snapshot_t saved;
+	inputs_getSnapshot(&saved);
+	uint32_t savedLow = countLow, savedHigh = countHigh, savedTriggerCount = triggerCount;
+	resetDebouncer((1 << 0) | (1 << 4));
+	for (uint32_t s=0; s<TEST_SAMPLE_COUNT; s++) {
+		uint32_t sample = 0;
+		for (uint32_t bit=0; bit<5; bit++)
+			sample |= testInputs[bit][s] << bit;
+		debounce(sample);
+		for (uint32_t bit=0; bit<5; bit++) {
+			bool edge = ((snapshot.pressed | snapshot.released) >> bit) & 1;
+			if (edge != (testEdgeSamples[bit] == (int8_t) s)) {
+				printf("inputs_runTest: bit %lu sample %lu: edge %d, expected %d.\n\r", (unsigned long) bit,
+						(unsigned long) s, edge, !edge);
+				success = false;
+			}
+		}
+	}
+	if (snapshot.state != ((1 << 0) | (1 << 2) | (1 << 3))) {
+		printf("inputs_runTest: final state 0x%lx, expected 0xd.\n\r", (unsigned long) snapshot.state);
+		success = false;
+	}
+	// The trigger: one sample short of its count and a low sample start over, then the full count presses it.
+	resetDebouncer(0);
+	for (uint32_t s=0; s<2*INPUTS_TRIGGER_DEBOUNCE_SAMPLES; s++) {
+		debounce(s == INPUTS_TRIGGER_DEBOUNCE_SAMPLES - 1 ? 0 : INPUTS_TRIGGER_MASK);
+		bool edge = snapshot.pressed & INPUTS_TRIGGER_MASK;
+		if (edge != (s == 2*INPUTS_TRIGGER_DEBOUNCE_SAMPLES - 1) || (snapshot.state & ~INPUTS_TRIGGER_MASK)) {
+			printf("inputs_runTest: trigger sample %lu: edge %d, state 0x%lx.\n\r", (unsigned long) s, edge,
+					(unsigned long) snapshot.state);
+			success = false;
+		}
+	}
+	// Adding the same listener twice keeps one entry.
+	uint32_t savedListenerCount = listenerCount;
+	if (listenerCount < INPUTS_MAX_LISTENER_COUNT) {
+		inputs_addListener(INPUTS_TRIGGER_MASK, testListener);
+		inputs_addListener(INPUTS_BUTTONS_MASK, testListener);
+		if (listenerCount != savedListenerCount + 1 || listeners[listenerCount-1].mask != INPUTS_BUTTONS_MASK) {
+			printf("inputs_runTest: %lu listeners after adding one twice, expected %lu.\n\r",
+					(unsigned long) (listenerCount - savedListenerCount), 1UL);
+			success = false;
+		}
+		listenerCount = savedListenerCount;
+	}
+	snapshot.raw = saved.raw;
+	snapshot.state = saved.state;
+	snapshot.pressed = saved.pressed;
+	snapshot.released = saved.released;
+	snapshot.sampleCount = saved.sampleCount;
+	countLow = savedLow;
+	countHigh = savedHigh;
+	triggerCount = savedTriggerCount;
+	printf("inputs_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
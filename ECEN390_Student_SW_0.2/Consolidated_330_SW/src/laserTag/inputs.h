@@ -0,0 +1,70 @@
+/*
+ * inputs.h
+ */
+
+#ifndef INPUTS_H_
+#define INPUTS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Input-sampling service: the only code that reads the buttons, the switches and the gun-trigger MIO pin while the
+// game runs. Every INPUTS_SAMPLE_TICKS a timerService callback reads the three of them once into one word (bit layout
+// below) and debounces all of the bits at once with 2-bit vertical counters: a bit of the debounced state only flips
+// after INPUTS_DEBOUNCE_SAMPLES samples in a row disagree with it. The gun trigger has its own counter instead, and
+// flips after INPUTS_TRIGGER_DEBOUNCE_SAMPLES, the 50 ms that the trigger state machine always debounced the gun for.
+// The bits that flipped are the edges of that sample.
+// Listeners (inputs_addListener()) are called from the same callback with the edges in the bits they asked for, so
+// the trigger state machine and the event queue get edges instead of reading the hardware every tick.
+// inputs_getState() and inputs_getSnapshot() are for everyone else.
+
+#define INPUTS_SAMPLE_TICKS 500			// 5 ms between samples.
+#define INPUTS_DEBOUNCE_SAMPLES 4		// What a 2-bit counter counts to: 20 ms of steady input.
+#define INPUTS_TRIGGER_DEBOUNCE_SAMPLES 10	// 50 ms for the gun trigger.
+#define INPUTS_MAX_LISTENER_COUNT 4
+#define INPUTS_TRIGGER_MIO_PIN 10		// The gun trigger.
+
+// Bit layout of the sampled and debounced words.
+#define INPUTS_BUTTONS_SHIFT 0
+#define INPUTS_BUTTONS_MASK (0xF << INPUTS_BUTTONS_SHIFT)		// buttons_read(), BUTTONS_BTN*_MASK.
+#define INPUTS_SWITCHES_SHIFT 4
+#define INPUTS_SWITCHES_MASK (0xF << INPUTS_SWITCHES_SHIFT)		// switches_read().
+#define INPUTS_TRIGGER_MASK (1 << 8)							// mio_readPin(INPUTS_TRIGGER_MIO_PIN).
+#define INPUTS_BUTTON(buttonMask) ((buttonMask) << INPUTS_BUTTONS_SHIFT)
+
+typedef struct {
+	uint32_t raw;			// The last sample.
+	uint32_t state;			// Debounced.
+	uint32_t pressed;		// Bits of state that went from 0 to 1 at the last sample.
+	uint32_t released;		// Bits of state that went from 1 to 0 at the last sample.
+	uint32_t sampleCount;
+} inputs_snapshot_t;
+
+// Called from the timer ISR with the edges of one sample, masked to the bits the listener asked for (never both 0).
+typedef void (*inputs_listener_t)(uint32_t pressed, uint32_t released, uint32_t state);
+
+// Initializes the buttons, the switches and the trigger pin (call mio_init() first), and takes one sample as the
+// debounced state, so whatever is held at startup is not an edge. Drops the listeners.
+void inputs_init();
+
+// Starts sampling from the timer ISR. Call after isr_init().
+void inputs_start();
+
+// Calls listener with the edges in mask from the next sample on. Returns false if there is no room for it.
+// Adding a listener that is already there only changes its mask, it is still called once per sample.
+bool inputs_addListener(uint32_t mask, inputs_listener_t listener);
+
+// The debounced state, bit layout above.
+uint32_t inputs_getState();
+
+// The debounced buttons and switches, same bits as buttons_read() and switches_read().
+int32_t inputs_getButtons();
+int32_t inputs_getSwitches();
+
+// Copy of the last sample. The ISR may update it during the copy, so the fields can be one sample apart.
+void inputs_getSnapshot(inputs_snapshot_t* snapshot);
+
+// Feeds made-up samples through the debouncer and checks the edges. Does not touch the hardware.
+bool inputs_runTest();
+
+#endif /* INPUTS_H_ */
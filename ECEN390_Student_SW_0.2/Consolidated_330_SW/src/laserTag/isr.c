@@ -1,10 +1,10 @@
-#include "transmitter.h"
 #include "supportFiles/interrupts.h"
-#include "queue.h"
 #include "xsysmon.h"
-#include "trigger.h"
-#include "lockoutTimer.h"
-#include "hitLedTimer.h"
+#include "timerService.h"
+#include "profiler.h"
+#include "adcRing.h"
+#include "amp.h"
+#include "isr.h"
 
 // Keep track of how many times isr_function() is called.
 static uint64_t isr_totalXadcSampleCount = 0;
@@ -13,69 +13,86 @@ uint64_t isr_getTotalAdcSampleCount() {return isr_totalXadcSampleCount;}
 
 // This implements a dedicated buffer for storing values from the ADC
 // until they are read and processed by detector().
-// adcBuffer_t is similar to a queue but is really a circular buffer.
-#define ADC_BUFFER_SIZE 100000
-typedef struct {
-  uint32_t indexIn;   // New values go here.
-  uint32_t indexOut;  // Pull old values from here.
-  uint32_t data[ADC_BUFFER_SIZE];  // Store values here.
-  uint32_t elementCount;  // Number of values contained in adcBuffer_t.
-} adcBuffer_t;
-
-// This is the instantiation of adcBuffer.
-static adcBuffer_t adcBuffer;
-
-// Init adcBuffer.
-void adcBufferInit() {
-  adcBuffer.indexIn = 0;
-  adcBuffer.indexOut = 0;
-  adcBuffer.elementCount = 0;
-}
+// adcRing_t is a lock-free single-producer/single-consumer ring: isr_function() is the only producer
+// and detector() the only consumer, so neither side needs to disable interrupts.
+#ifdef AMP_ENABLE
+#define adcBuffer (*amp_platformAdcRing())	// Shared with CPU1, where the detector runs (amp.h).
+#else
+static adcRing_t adcBuffer;
+#endif
 
 // Init everything in isr.
 void isr_init() {
-  adcBufferInit();  // init the local adcBuffer.
+  adcRing_init(&adcBuffer);  // init the local adcBuffer.
+  timerService_init();
+}
+
+// Drops the new value if the buffer is full (see isr_getAdcBufferOverflowCount()).
+void addDataToAdcBuffer(uint16_t adcData) {
+  adcRing_push(&adcBuffer, adcData);
 }
 
-// Implemented as a fixed-size circular buffer.
-// indexIn always points to an empty location (by definition).
-// indexOut always points to the oldest element.
-// buffer is empty if indexIn == indexOut. Buffer is full if incremented indexIn == indexOut
-void addDataToAdcBuffer(uint32_t adcData) {
-  if (adcBuffer.elementCount < ADC_BUFFER_SIZE)  // Increment the element count unless you are already full.
-    adcBuffer.elementCount++;
-  adcBuffer.data[adcBuffer.indexIn] = adcData;                    // write,
-  adcBuffer.indexIn = (adcBuffer.indexIn + 1) % ADC_BUFFER_SIZE;  // then increment.
-  if (adcBuffer.indexIn == adcBuffer.indexOut) {                  // If you are now pointing at the out pointer,
-    adcBuffer.indexOut = (adcBuffer.indexOut + 1) % ADC_BUFFER_SIZE;  // move the out pointer up.
+// Same conversion as interrupts_getAdcData(): the XADC data registers hold the 12-bit result in the upper bits.
+#define XADC_DATA_SHIFT 4
+
+// Converts a block from the DMA straight into the ring, one head update per contiguous span.
+void isr_addXadcBlockToAdcBuffer(const uint32_t* xadcData, uint32_t count) {
+  uint32_t addedCount = 0;
+  adcRing_data_t* span;
+  uint32_t spanCount;
+  while (addedCount < count && (spanCount = adcRing_reserveSpan(&adcBuffer, &span)) != 0) {
+    if (spanCount > count - addedCount)
+      spanCount = count - addedCount;
+    for (uint32_t i=0; i<spanCount; i++)
+      span[i] = xadcData[addedCount + i] >> XADC_DATA_SHIFT;
+    adcRing_commit(&adcBuffer, spanCount);
+    addedCount += spanCount;
   }
+  adcRing_addOverflow(&adcBuffer, count - addedCount);  // Newest samples are dropped, same as addDataToAdcBuffer().
+  isr_totalXadcSampleCount += count;
 }
 
 // Returns default value of 0 if the buffer is currently empty.
 uint32_t isr_removeDataFromAdcBuffer() {
-  uint32_t returnValue = 0;
-  if (adcBuffer.indexIn == adcBuffer.indexOut)  // Just return 0 if empty.
-    return 0;
-  else {
-    returnValue = adcBuffer.data[adcBuffer.indexOut];  // Not empty, get the return value from buffer.
-    adcBuffer.indexOut = (adcBuffer.indexOut + 1) % ADC_BUFFER_SIZE;  // increment the out index.
-    adcBuffer.elementCount--;  // One less element.
-  }
+  adcRing_data_t returnValue = 0;
+  adcRing_pop(&adcBuffer, &returnValue);
   return returnValue;
 }
 
 // Functional interface to access element count.
 uint32_t isr_adcBufferElementCount() {
-  return adcBuffer.elementCount;
+  return adcRing_elementCount(&adcBuffer);
+}
+
+// Reads the producer index once, returns the contiguous span starting at the oldest sample.
+uint32_t isr_adcBufferPeekSpan(const uint16_t** data) {
+  return adcRing_peekSpan(&adcBuffer, data);
+}
+
+// Publishes the new consumer index. No need to disable interrupts, only the consumer writes it.
+void isr_adcBufferConsume(uint32_t count) {
+  adcRing_consume(&adcBuffer, count);
+}
+
+// Number of ADC samples dropped because the buffer was full.
+uint32_t isr_getAdcBufferOverflowCount() {
+  return adcRing_getOverflowCount(&adcBuffer);
+}
+
+// Most ADC samples that have been waiting in the buffer at once.
+uint32_t isr_getAdcBufferHighWatermark() {
+  return adcRing_getHighWatermark(&adcBuffer);
 }
 
 void isr_function() {
-  queue_data_t adcData = (queue_data_t) interrupts_getAdcData();
-  addDataToAdcBuffer(adcData);
+  PROFILER_BEGIN(PROFILER_ZONE_ISR);
+#ifndef ISR_USE_ADC_DMA
+  addDataToAdcBuffer(interrupts_getAdcData());  // 12-bit sample, stored as-is.
   isr_totalXadcSampleCount++;
-  // Place tick functions here.
-  transmitter_tick();
-  hitLedTimer_tick();
-  lockoutTimer_tick();
-  trigger_tick();
+#endif
+  // The transmitter, hitLedTimer, lockoutTimer and trigger state machines run from here when they are due.
+  PROFILER_BEGIN(PROFILER_ZONE_TIMER_DISPATCH);
+  timerService_dispatch();
+  PROFILER_END(PROFILER_ZONE_TIMER_DISPATCH);
+  PROFILER_END(PROFILER_ZONE_ISR);
 }
@@ -4,18 +4,41 @@
 // isr provides the isr_function() where you will place functions that require accurate timing.
 // A buffer for storing values from the Analog to Digital Converter (ADC) is implemented in isr.c
 
+// Uncomment to have the DMA move the XADC samples into the ADC buffer a block at a time (see adcDma.h).
+// isr_function() then only dispatches the timer service (see timerService.h).
+//#define ISR_USE_ADC_DMA
+
 // Performs inits for anything in isr.c
 void isr_init();
 
 // This function is invoked by the timer interrupt at 100 kHz.
 void isr_function();
 
+// DMA acquisition: adds count raw XADC data-register values (see interrupts_getAdcData()) to the ADC buffer.
+// Called once per block by the DMA done interrupt, samples that do not fit are counted as overflows.
+void isr_addXadcBlockToAdcBuffer(const uint32_t* xadcData, uint32_t count);
+
 // This removes a value from the ADC buffer.
 uint32_t isr_removeDataFromAdcBuffer();
 
+// Block access to the ADC buffer, used by detector_processBlock(). Samples are the raw 12-bit ADC values.
+// Reads the producer index once and points *data at the oldest sample. Returns how many samples can be read
+// in place from there (stops at the end of the circular buffer, the rest is returned by the next call).
+uint32_t isr_adcBufferPeekSpan(const uint16_t** data);
+
+// Releases count samples that were returned by isr_adcBufferPeekSpan(). Updates the consumer index once,
+// without disabling interrupts.
+void isr_adcBufferConsume(uint32_t count);
+
 // This returns the number of values in the ADC buffer.
 uint32_t isr_adcBufferElementCount();
 
+// Number of ADC samples dropped because the buffer was full (detector() fell more than a second behind).
+uint32_t isr_getAdcBufferOverflowCount();
+
+// Most ADC samples that have been waiting in the buffer at once.
+uint32_t isr_getAdcBufferHighWatermark();
+
 // Gives you the total of ADC samples that have been taken thus far.
 uint64_t isr_getTotalAdcSampleCount();
 
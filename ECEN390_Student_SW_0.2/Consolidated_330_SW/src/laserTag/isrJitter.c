@@ -0,0 +1,178 @@
+/*
+ * isrJitter.c
+ */
+
+#include "isrJitter.h"
+
+#ifdef ISRJITTER_ENABLE
+
+#include "supportFiles/globalTimer.h"
+#include "supportFiles/interrupts.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_PERIOD 3250
+
+static isrJitter_stats_t stats;
+static uint32_t periodTicks;			// Timer interrupt period in global-timer ticks.
+static uint32_t ticksPerPrivateTimerTick;
+static uint32_t loadValue;
+static isrJitter_traceEntry_t trace[ISRJITTER_TRACE_LENGTH];
+static uint32_t traceCount = 0;			// Events ever traced, the next one goes in trace[traceCount % length].
+static isrJitter_traceEntry_t worstTrace[ISRJITTER_TRACE_LENGTH];	// Oldest first.
+static uint16_t worstTraceLength = 0;
+
+// Same order as isrJitter_event_t.
+static const char* eventNames[ISRJITTER_EVENT_COUNT] = {
+	"timerIsr", "missedTicks", "armIntsDisabled", "armIntsEnabled", "histogramRedrawBegin", "histogramRedrawEnd"
+};
+
+// The main loop and the ISR both add events, so the slot is claimed atomically. If the ISR copies the trace while
+// main is between claiming a slot and filling it, that one entry in the copy is stale. Fine for a diagnostic.
+static void traceEvent(uint64_t time, isrJitter_event_t event, uint32_t value) {
+	uint32_t index = __atomic_fetch_add(&traceCount, 1, __ATOMIC_RELAXED) % ISRJITTER_TRACE_LENGTH;
+	trace[index].time = time;
+	trace[index].value = value;
+	trace[index].event = event;
+}
+
+// The ARM interrupt hook.
+static void armIntsChanged(bool enabled) {
+	isrJitter_markEvent(enabled ? ISRJITTER_EVENT_ARM_INTS_ENABLED : ISRJITTER_EVENT_ARM_INTS_DISABLED);
+}
+
+void isrJitter_init() {
+	memset(&stats, 0, sizeof(stats));
+	traceCount = 0;
+	worstTraceLength = 0;
+	// The private timer counts (prescaler + 1) global-timer ticks per count, load + 1 counts per interrupt.
+	loadValue = interrupts_getPrivateTimerLoadValue();
+	ticksPerPrivateTimerTick = interrupts_getPrivateTimerPrescalerValue() + 1;
+	periodTicks = (loadValue + 1) * ticksPerPrivateTimerTick;
+	globalTimer_startTimer(false);	// false = no status message.
+	interrupts_setTimerIsrEntryHook(isrJitter_timerIsrEntry);
+	interrupts_setArmIntsHook(armIntsChanged);
+}
+
+void isrJitter_timerIsrEntry(uint32_t privateTimerCounterValue) {
+	isrJitter_recordEntry(globalTimer_getTimerValue(), (loadValue - privateTimerCounterValue) * ticksPerPrivateTimerTick);
+}
+
+void isrJitter_recordEntry(uint64_t time, uint32_t latency) {
+	if (!stats.entryCount) {
+		stats.firstEntryTime = time;
+		stats.firstIsrInvocationCount = interrupts_isrInvocationCount();
+		stats.minLatency = latency;
+	} else {
+		uint64_t sinceLast = time - stats.lastEntryTime;
+		if (sinceLast > periodTicks + periodTicks / 2) {	// Only divides when ticks were lost.
+			uint32_t missed = (sinceLast + periodTicks / 2) / periodTicks - 1;
+			stats.missedTickCount += missed;
+			traceEvent(time, ISRJITTER_EVENT_MISSED_TICKS, missed);
+		}
+	}
+	stats.lastEntryTime = time;
+	stats.entryCount++;
+	stats.totalLatency += latency;
+	if (latency < stats.minLatency)
+		stats.minLatency = latency;
+	uint32_t bin = latency / ISRJITTER_BIN_TICKS;
+	stats.histogram[bin < ISRJITTER_BIN_COUNT ? bin : ISRJITTER_BIN_COUNT - 1]++;
+	traceEvent(time, ISRJITTER_EVENT_TIMER_ISR, latency);
+	if (latency > stats.maxLatency || stats.entryCount == 1) {
+		stats.maxLatency = latency;
+		// Copy out the ring, oldest first. Only happens when the worst case gets worse.
+		uint32_t count = traceCount;
+		worstTraceLength = count < ISRJITTER_TRACE_LENGTH ? count : ISRJITTER_TRACE_LENGTH;
+		for (uint16_t i=0; i<worstTraceLength; i++)
+			worstTrace[i] = trace[(count - worstTraceLength + i) % ISRJITTER_TRACE_LENGTH];
+	}
+}
+
+void isrJitter_markEvent(isrJitter_event_t event) {
+	traceEvent(globalTimer_getTimerValue(), event, 0);
+}
+
+uint16_t isrJitter_getStats(isrJitter_stats_t* statsCopy, isrJitter_traceEntry_t worstTraceCopy[ISRJITTER_TRACE_LENGTH]) {
+	*statsCopy = stats;
+	for (uint16_t i=0; i<worstTraceLength; i++)
+		worstTraceCopy[i] = worstTrace[i];
+	return worstTraceLength;
+}
+
+// Format, one record per line, comma-separated:
+//   #isrJitter,1,<ticksPerSecond>,<periodTicks>,<binTicks>,<binCount>
+//   entries,<entries>,isrInvocations,<isrInvocationCount since the first entry>,expected,<from global time>,missed,<missed ticks>
+//   latency,<min>,<max>,<mean>
+//   histogram,<bin0> <bin1> ...
+//   trace,<ticks relative to the worst entry>,<event>,<value>     (one per traced event, oldest first)
+//   #end
+void isrJitter_printReport() {
+	uint32_t expected = 0;
+	if (stats.entryCount)
+		expected = (stats.lastEntryTime - stats.firstEntryTime + periodTicks / 2) / periodTicks + 1;
+	printf("#isrJitter,1,%lu,%lu,%d,%d\n\r", (unsigned long) GLOBAL_TIMER_TICKS_PER_SECOND, (unsigned long) periodTicks,
+			ISRJITTER_BIN_TICKS, ISRJITTER_BIN_COUNT);
+	printf("entries,%lu,isrInvocations,%lu,expected,%lu,missed,%lu\n\r", (unsigned long) stats.entryCount,
+			(unsigned long) (interrupts_isrInvocationCount() - stats.firstIsrInvocationCount), (unsigned long) expected,
+			(unsigned long) stats.missedTickCount);
+	printf("latency,%lu,%lu,%lu\n\r", (unsigned long) stats.minLatency, (unsigned long) stats.maxLatency,
+			(unsigned long) (stats.entryCount ? stats.totalLatency / stats.entryCount : 0));
+	printf("histogram,");
+	for (uint16_t bin=0; bin<ISRJITTER_BIN_COUNT; bin++)
+		printf(bin ? " %lu" : "%lu", (unsigned long) stats.histogram[bin]);
+	printf("\n\r");
+	uint64_t worstTime = worstTraceLength ? worstTrace[worstTraceLength - 1].time : 0;
+	for (uint16_t i=0; i<worstTraceLength; i++)
+		printf("trace,%lld,%s,%lu\n\r", (long long) (worstTrace[i].time - worstTime), eventNames[worstTrace[i].event],
+				(unsigned long) worstTrace[i].value);
+	printf("#end\n\r");
+}
+
+bool isrJitter_runTest() {
+	bool failed = false;
+	isrJitter_init();
+	periodTicks = TEST_PERIOD;	// Made-up times, whatever the timer is set to.
+	uint64_t time = 1000000;
+	// 40 entries 100 to 139 ticks late, then a 2.2-period gap (ticks lost: 1) with a 1000-tick latency, then 3 more.
+	for (uint16_t i=0; i<40; i++) {
+		isrJitter_recordEntry(time + 100 + i, 100 + i);
+		time += TEST_PERIOD;
+	}
+	isrJitter_markEvent(ISRJITTER_EVENT_ARM_INTS_DISABLED);
+	time += TEST_PERIOD;
+	isrJitter_recordEntry(time + 1000, 1000);
+	time += TEST_PERIOD;
+	for (uint16_t i=0; i<3; i++) {
+		isrJitter_recordEntry(time + 100, 100);
+		time += TEST_PERIOD;
+	}
+	isrJitter_stats_t testStats;
+	isrJitter_traceEntry_t testTrace[ISRJITTER_TRACE_LENGTH];
+	uint16_t traceLength = isrJitter_getStats(&testStats, testTrace);
+	if (testStats.entryCount != 44 || testStats.missedTickCount != 1 || testStats.minLatency != 100 ||
+			testStats.maxLatency != 1000) {
+		printf("isrJitter_runTest: entries %lu, missed %lu, min %lu, max %lu\n\r", (unsigned long) testStats.entryCount,
+				(unsigned long) testStats.missedTickCount, (unsigned long) testStats.minLatency,
+				(unsigned long) testStats.maxLatency);
+		failed = true;
+	}
+	// 100 .. 127 and the three 100s are in bin 1, 128 .. 139 in bin 2, 1000 in bin 15.
+	if (testStats.histogram[1] != 31 || testStats.histogram[2] != 12 || testStats.histogram[15] != 1) {
+		printf("isrJitter_runTest: histogram %lu %lu %lu\n\r", (unsigned long) testStats.histogram[1],
+				(unsigned long) testStats.histogram[2], (unsigned long) testStats.histogram[15]);
+		failed = true;
+	}
+	// The worst trace ends with: the marked event, the missed ticks, then the worst entry itself.
+	if (traceLength != ISRJITTER_TRACE_LENGTH || testTrace[traceLength - 1].event != ISRJITTER_EVENT_TIMER_ISR ||
+			testTrace[traceLength - 1].value != 1000 || testTrace[traceLength - 2].event != ISRJITTER_EVENT_MISSED_TICKS ||
+			testTrace[traceLength - 3].event != ISRJITTER_EVENT_ARM_INTS_DISABLED) {
+		printf("isrJitter_runTest: worst trace is wrong (%d entries)\n\r", traceLength);
+		failed = true;
+	}
+	isrJitter_init();
+	printf(failed ? "isrJitter_runTest failed.\n\r" : "isrJitter_runTest passed.\n\r");
+	return !failed;
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * isrJitter.h
+ */
+
+#ifndef ISRJITTER_H_
+#define ISRJITTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Uncomment to measure the timer interrupt's entry latency and jitter. Commented out, the ISRJITTER_* macros compile
+// to nothing and nothing is plugged into the interrupts.c hooks.
+//#define ISRJITTER_ENABLE
+
+// The private timer counts down from its load value and interrupts when it reloads, so the counter value at the top
+// of timerIsr() says how long ago the interrupt was raised: latency = (load - counter) private-timer ticks. The private
+// timer and the global timer both run at half the CPU clock, so everything here is in global-timer ticks.
+// - Every entry goes into a latency histogram (ISRJITTER_BIN_TICKS per bin, the last bin gets everything longer).
+// - The last ISRJITTER_TRACE_LENGTH events (timer ISR entries, plus what the main loop marks with ISRJITTER_MARK():
+//   ARM interrupts off/on from interrupts.c's hook, histogram redraws in main.c) are kept in a ring. Each time an entry sets
+//   a new worst latency, the ring is copied out, so the report shows what led up to the worst case.
+// - An entry more than 1.5 periods after the previous one means the interrupt was held off so long that ticks were
+//   lost (the timer only remembers one). Those are counted and traced. The report also compares the number of
+//   entries and interrupts_isrInvocationCount() with what the elapsed global-timer time says there should have been.
+
+#define ISRJITTER_BIN_TICKS 64
+#define ISRJITTER_BIN_COUNT 64			// 4096 ticks, more than the 3250-tick period at 100 kHz.
+#define ISRJITTER_TRACE_LENGTH 32
+
+typedef enum {
+	ISRJITTER_EVENT_TIMER_ISR,			// value: entry latency.
+	ISRJITTER_EVENT_MISSED_TICKS,		// value: ticks lost before this entry.
+	ISRJITTER_EVENT_ARM_INTS_DISABLED,
+	ISRJITTER_EVENT_ARM_INTS_ENABLED,
+	ISRJITTER_EVENT_HISTOGRAM_REDRAW_BEGIN,
+	ISRJITTER_EVENT_HISTOGRAM_REDRAW_END,
+	ISRJITTER_EVENT_COUNT
+} isrJitter_event_t;
+
+typedef struct {
+	uint64_t time;						// globalTimer_getTimerValue().
+	uint32_t value;
+	uint8_t event;						// isrJitter_event_t
+} isrJitter_traceEntry_t;
+
+typedef struct {
+	uint32_t entryCount;
+	uint32_t missedTickCount;
+	uint32_t minLatency;
+	uint32_t maxLatency;
+	uint64_t totalLatency;
+	uint64_t firstEntryTime;
+	uint64_t lastEntryTime;
+	uint32_t firstIsrInvocationCount;	// interrupts_isrInvocationCount() at the first entry.
+	uint32_t histogram[ISRJITTER_BIN_COUNT];
+} isrJitter_stats_t;
+
+#ifdef ISRJITTER_ENABLE
+#define ISRJITTER_INIT() isrJitter_init()
+#define ISRJITTER_MARK(event) isrJitter_markEvent(event)
+#define ISRJITTER_REPORT() isrJitter_printReport()
+#else
+#define ISRJITTER_INIT()
+#define ISRJITTER_MARK(event)
+#define ISRJITTER_REPORT()
+#endif
+
+#ifdef ISRJITTER_ENABLE
+
+// Clears everything, reads the private-timer period and plugs isrJitter_timerIsrEntry() and the ARM-interrupt events
+// into the interrupts.c hooks. Call after interrupts_initAll().
+void isrJitter_init();
+
+// The timer ISR entry hook: timerIsr() calls it first thing, with XScuTimer_GetCounterValue().
+void isrJitter_timerIsrEntry(uint32_t privateTimerCounterValue);
+
+// Records one entry that arrived at time with this latency. isrJitter_timerIsrEntry() calls it, so does the test.
+void isrJitter_recordEntry(uint64_t time, uint32_t latency);
+
+// Any context. Adds a main-loop event to the trace.
+void isrJitter_markEvent(isrJitter_event_t event);
+
+// Copies the statistics, and the trace that led up to the worst latency (oldest first). Returns the trace length.
+uint16_t isrJitter_getStats(isrJitter_stats_t* stats, isrJitter_traceEntry_t worstTrace[ISRJITTER_TRACE_LENGTH]);
+
+// Prints the statistics, histogram and worst-case trace over the UART. Run it with interrupts off.
+void isrJitter_printReport();
+
+// Feeds made-up entries through isrJitter_recordEntry() and checks the histogram, missed ticks and worst-case trace.
+// Clears the statistics. Returns true if they are right.
+bool isrJitter_runTest();
+
+#endif
+
+#endif /* ISRJITTER_H_ */
@@ -7,8 +7,11 @@
 #include <stdio.h>
 #include "supportFiles/buttons.h"
 #include "supportFiles/intervalTimer.h"
+#include "timerService.h"
+#include "profiler.h"
+#include "lockoutTimer.h"
 
-#define LOCKOUT_TIME 50000
+#define LOCKOUT_TIME LOCKOUTTIMER_LOCKOUT_TICKS
 
 // States for the controller state machine.
 enum lockoutStates {
@@ -16,8 +19,10 @@ enum lockoutStates {
 	run_st,
 } lockoutState = init_st;
 
+static void lockoutTimer_transition(timerService_timer_t* timer);
+
 volatile static bool enableFlag = false;
-static uint32_t count = 0;
+static timerService_timer_t transitionTimer = TIMERSERVICE_TIMER(lockoutTimer_transition);
 
 // Standard init function.
 void lockoutTimer_init() {
@@ -26,7 +31,10 @@ void lockoutTimer_init() {
 
 // Calling this starts the timer.
 void lockoutTimer_start() {
+	if (enableFlag)
+		return;
 	enableFlag = true;
+	timerService_request(&transitionTimer);
 }
 
 // Returns true if the timer is running.
@@ -34,38 +42,23 @@ bool lockoutTimer_running() {
 	return enableFlag;
 }
 
-// Standard tick function.
-void lockoutTimer_tick() {
-	// Perform state action first.
-	switch(lockoutState) {
-	case init_st:
-		break;
-	case run_st:
-		count++;
-		break;
-	default:
-		printf("transmitter_tick state action: hit default\n\r");
-		break;
-	}
-
-	// Perform state update next.
+// Runs at the tick after lockoutTimer_start() and again LOCKOUT_TIME ticks later.
+static void lockoutTimer_transition(timerService_timer_t* /*timer*/) {
+	PROFILER_BEGIN(PROFILER_ZONE_LOCKOUT_TIMER);
 	switch(lockoutState) {
 	case init_st:
-		if(enableFlag) {
-			lockoutState = run_st;
-			count = 0;
-		}
+		lockoutState = run_st;
+		timerService_scheduleTicks(&transitionTimer, LOCKOUT_TIME);
 		break;
 	case run_st:
-		if(count == LOCKOUT_TIME) {
-			enableFlag = false;
-			lockoutState = init_st;
-		}
+		enableFlag = false;
+		lockoutState = init_st;
 		break;
 	default:
-		printf("transmitter_tick state update: hit default\n\r");
+		printf("lockoutTimer_transition: hit default\n\r");
 		break;
 	}
+	PROFILER_END(PROFILER_ZONE_LOCKOUT_TIMER);
 }
 
 void lockoutTimer_runTest() {
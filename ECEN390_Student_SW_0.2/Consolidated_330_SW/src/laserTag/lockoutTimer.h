@@ -8,6 +8,10 @@
 #ifndef LOCKOUTTIMER_H_
 #define LOCKOUTTIMER_H_
 
+#include "channelPlan.h"
+
+#define LOCKOUTTIMER_LOCKOUT_TICKS CHANNELPLAN_MS_TO_TICKS(500)	// In timer ticks.
+
 // Standard init function.
 void lockoutTimer_init();
 
@@ -17,9 +21,6 @@ void lockoutTimer_start();
 // Returns true if the timer is running.
 bool lockoutTimer_running();
 
-// Standard tick function.
-void lockoutTimer_tick();
-
 void lockoutTimer_runTest();
 
 
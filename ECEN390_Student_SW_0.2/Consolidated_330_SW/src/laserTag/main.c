@@ -7,7 +7,9 @@
 #include "queue.h"
 #include "xparameters.h"
 #include "filter.h"
+#include "iirBank.h"
 #include "histogram.h"
+#include "barGraph.h"
 #include "transmitter.h"
 #include <stdlib.h>
 #include "supportFiles/buttons.h"
@@ -20,6 +22,12 @@
 #include "lockoutTimer.h"
 #include "hitLedTimer.h"
 #include "detector.h"
+#include "adcDma.h"
+#include "profiler.h"
+#include "isrJitter.h"
+#include "amp.h"
+#include "events.h"
+#include "inputs.h"
 
 #define HISTOGRAM_BAR_COUNT 10
 #define TOTAL_RUNTIME_TIMER 1
@@ -28,25 +36,62 @@
 #define MAIN_CUMULATIVE_TIMER 2
 
 #define SYSTEM_TICKS_PER_HISTOGRAM_UPDATE 50000	// Effectively 2 times per second.
+#define HISTOGRAM_LABEL_BUFFER_SIZE (BARGRAPH_MAX_LABEL_CHARS + 1)
 
+#ifdef AMP_ENABLE
+// The detector runs on CPU1 (amp.h). These start and stop it and read what it sent.
+#define DETECTOR_START() amp_start()
+#define DETECTOR_STOP() amp_stop()
+#define RUN_DETECTOR() amp_poll()
+#define HIT_DETECTED() amp_hitDetected()
+#define CLEAR_HIT() amp_clearHit()
+#define GET_HIT_COUNTS(hitCounts) amp_getHitCounts(hitCounts)
+#define GET_NORMALIZED_POWER_VALUES(values, indexOfMaxValue) amp_getNormalizedPowerValues(values, indexOfMaxValue)
+#define GET_CURRENT_POWER_VALUE(filterNumber) amp_getCurrentPowerValue(filterNumber)
+#define MAX_DETECTOR_LATENCY_IN_SECONDS() amp_getMaxDetectorLatencyInSeconds()
+#else
+#define DETECTOR_START()
+#define DETECTOR_STOP()
+#define RUN_DETECTOR() detector()
+#define HIT_DETECTED() detector_hitDetected()
+#define CLEAR_HIT() detector_clearHit()
+#define GET_HIT_COUNTS(hitCounts) detector_getHitCounts(hitCounts)
+#define GET_NORMALIZED_POWER_VALUES(values, indexOfMaxValue) filter_getNormalizedPowerValues(values, indexOfMaxValue)
+#define GET_CURRENT_POWER_VALUE(filterNumber) filter_getCurrentPowerValue(filterNumber)
+#define MAX_DETECTOR_LATENCY_IN_SECONDS() maxDetectorLatencyInSeconds()
 
-static uint32_t countInterruptsViaInterruptsIsrFlag = 0;
+static double maxDetectorLatencyInSeconds() {
+	detector_blockLatency_t detectorLatency;
+	detector_getBlockLatency(&detectorLatency);
+	return detectorLatency.maxLatencyInSeconds;
+}
+#endif
+
+#ifndef AMP_CPU1	// Everything up to main() is CPU0's, the CPU1 ELF only runs amp_cpu1Main() (amp.h).
 
 // Prints out various run-time statistics on the TFT display.
 // Assumes the following:
-// main is keeping track of detected interrupts with countInterruptsViaInterruptsIsrFlag,
 // interval_timer(0) is the cumulative run-time of the ISR,
 // interval_timer(1) is the total run-time,
-// interval_timer(2) is the time spent in main running the filters, updating the display, and so forth.
+// interval_timer(2) is the time spent in main running the filters, updating the display, and so forth,
+// events_getIdleTicks() is the time main spent asleep waiting for events.
 // No comments in the code, the print statements are self-explanatory.
 void printRunTimeStatistics() {
 	display_setTextSize(1);
-	display_setTextColor(DISPLAY_WHITE);
+	display_setTextColor(DISPLAY_WHITE, DISPLAY_BLACK);	// Opaque, so the text goes out in glyph runs.
 	display_setCursor(0, 0);
 	display_fillScreen(DISPLAY_BLACK);
 	display_print("Elements remaining in ADC queue:");
 	display_print(isr_adcBufferElementCount());
 	display_println(); display_println();
+	display_print("Max detector latency in ms: ");
+	display_print(MAX_DETECTOR_LATENCY_IN_SECONDS() * 1000.0);
+	display_println(); display_println();
+	display_print("ADC buffer high watermark: ");
+	display_print(isr_getAdcBufferHighWatermark());
+	display_print(", overflows: ");
+	display_print(isr_getAdcBufferOverflowCount());
+	display_println(); display_println();
 	double runningSeconds, isrRunningSeconds, mainLoopRunningSeconds;
 	intervalTimer_getTotalDurationInSeconds(TOTAL_RUNTIME_TIMER, &runningSeconds);
 	display_print("Measured run time in seconds: ");
@@ -60,10 +105,12 @@ void printRunTimeStatistics() {
 	display_print(mainLoopRunningSeconds); display_print(" ("); display_print((mainLoopRunningSeconds/runningSeconds)*100); display_println("%)"); display_println();
 	uint32_t interruptCount = interrupts_isrInvocationCount();
 	display_print("Total interrupts:            "); display_println(interruptCount); display_println();
-	display_print("Interrupts detected in main: ");
-	display_println(countInterruptsViaInterruptsIsrFlag); display_println();
-	display_print("Detected interrupts in main: ");
-	display_print(((double) countInterruptsViaInterruptsIsrFlag / (double) interruptCount)*100); display_print("%");
+	display_print("Events handled in main: ");
+	display_print(events_getHandledCount()); display_print(", dropped: "); display_println(events_getDroppedCount()); display_println();
+	double idleSeconds = (double) events_getIdleTicks() / GLOBAL_TIMER_TICKS_PER_SECOND;
+	display_print("Idle (WFI) in main: ");
+	display_print(idleSeconds); display_print(" ("); display_print(idleSeconds/runningSeconds*100); display_print("%)");
+	display_flush();	// Nothing unless DISPLAY_USE_FRAMEBUFFER is defined in display.h.
 }
 
 // This mode runs continously until btn3 is pressed.
@@ -71,80 +118,99 @@ void printRunTimeStatistics() {
 // During operation, it continously displays that received power on each channel, on the TFT.
 void continuousPowerMode() {
 	// Lots of init's.
-	buttons_init();
-	switches_init();
 	mio_init(false);
+	inputs_init();	// Buttons, switches and the trigger pin: only inputs.c reads them from here on.
 	display_init();
 	intervalTimer_initAll();
-	histogram_init(HISTOGRAM_BAR_COUNT);
+	barGraph_init(HISTOGRAM_BAR_COUNT);	// Only redraws what changed, see barGraph.h.
 	leds_init(true);
 	transmitter_init();
 	detector_init();
 	filter_init();
 	isr_init();
+	DETECTOR_START();	// Nothing unless AMP_ENABLE is defined in amp.h. Needs the ADC buffer from isr_init().
+	inputs_start();		// Sampled from the timer ISR, isr_init() set up the timer service.
+	events_init();
+	PROFILER_INIT();	// Nothing unless PROFILER_ENABLE is defined in profiler.h.
 	// Init all interrupts (but does not enable the interrupts at the devices).
 	// Prints an error message if an internal failure occurs because the argument = true.
 	interrupts_initAll(true);
+	interrupts_setPrivateTimerLoadValue(CHANNELPLAN_PRIVATE_TIMER_LOAD_VALUE);	// Timer interrupt at CHANNELPLAN_SAMPLE_RATE_HZ.
+	ISRJITTER_INIT();	// Nothing unless ISRJITTER_ENABLE is defined in isrJitter.h. Reads the timer period set up above.
+#ifdef ISR_USE_ADC_DMA
+	adcDma_init();	// Connects the DMA done interrupt, so it has to come after interrupts_initAll().
+	adcDma_start();	// The first done interrupt is taken once the ARM interrupts are enabled below.
+#endif
 	interrupts_enableTimerGlobalInts();		// Allows the timer to generate interrupts.
 	interrupts_startArmPrivateTimer();		// Start the private ARM timer running.
 
-	uint16_t histogramSystemTicks = 0;		// Only update the histogram display every so many ticks.
+	uint16_t frequencyNumber = 0;			// From the switches, applied between pulses.
 	double normalizedPowerValues[FILTER_IIR_FILTER_COUNT];// Use this to store normalized power values for the histogram.
 	uint16_t indexOfMaxValue;										// Keep track of the index of the maximum value.
 	intervalTimer_reset(ISR_CUMULATIVE_TIMER);	// Used to measure ISR execution time.
 	intervalTimer_reset(TOTAL_RUNTIME_TIMER);		// Used to measure total program execution time.
 	intervalTimer_reset(MAIN_CUMULATIVE_TIMER);	// Used to measure main-loop execution time.
 	intervalTimer_start(TOTAL_RUNTIME_TIMER);		// Start measuring total execution time.
+	events_start(SYSTEM_TICKS_PER_HISTOGRAM_UPDATE);	// The timer ISR posts the events from here on.
 	interrupts_enableArmInts();									// The ARM will start seeing interrupts after this.
-	while (!(buttons_read() & BUTTONS_BTN3_MASK)) {	// Run until you detect btn3 pressed.
-//		if (transmitter_running())
-//			printf("Transmitter running\n\r");
-//		else
-//			printf("Not running\n\r");
-		if (interrupts_isrFlagGlobal) {		// Only do something if an interrupt has occurred.
-//			printf("Got here\n\r");
-			transmitter_run();							// Run the transmitter continuously, stops after one period if you don't constantly invoke this.
-			intervalTimer_start(MAIN_CUMULATIVE_TIMER);					// Measure run-time when you are doing something.
-			histogramSystemTicks++;					// Keep track of ticks so you know when to update the histogram.
-			countInterruptsViaInterruptsIsrFlag++;	// Keep track of the interrupt-count based on the global flag.
-			interrupts_isrFlagGlobal = 0;						// Reset the global flag.
-			detector();												// Run filters, compute power, etc.
-			filter_getNormalizedPowerValues(normalizedPowerValues, &indexOfMaxValue);	// This normalizes power between 1 and 0.
-			if (histogramSystemTicks >= SYSTEM_TICKS_PER_HISTOGRAM_UPDATE) {	// If enough ticks have transpired, update the histogram.
-				for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++) {									// Update across all filters.
-					// The height of the histogram bar depends upon the normalized value.
-					histogram_data_t histogramBarValue = ((double) (HISTOGRAM_MAX_BAR_DATA_IN_PIXELS)) * normalizedPowerValues[i];
-					// You can have a dynamic label at the top of the bar.
-					char label[HISTOGRAM_BAR_TOP_MAX_LABEL_WIDTH_IN_CHARS];	// Get a buffer for the label.
-					// Create the label, based upon the actual power value.
-					if (snprintf(label, HISTOGRAM_BAR_TOP_MAX_LABEL_WIDTH_IN_CHARS, "%0.0e", filter_getCurrentPowerValue(i)) == -1)
-						printf("Error: snprintf encountered an error during conversion.\n\r");
-					// Pull out the 'e' from the exponent to make better use of your characters.
-					trimLabel(label);
-					// Have the bar value and the label, send the data to the histogram.
-					if (!histogram_setBarData(i, histogramBarValue, label)) {
-						// If returns false, histogram_setBarData() is not happy. Print out some information.
-						printf("Error:histogram_setBarData() histogramBarValue(%d) out of range.\n\r", histogramBarValue);
-						printf("Provided normalizedPowerValue[%d]:%lf\n\r", i, normalizedPowerValues[i]);
-						printf("Dumping current and normalized power values.\n\r");
-						for (int tmp_i=0; tmp_i<FILTER_IIR_FILTER_COUNT; tmp_i++) {
-							printf("currentPowerValue[%d]:%lf\n\r", tmp_i, filter_getCurrentPowerValue(tmp_i));
-							printf("normalizedPowerValue[%d]:%lf\n\r", tmp_i, normalizedPowerValues[tmp_i]);
-						}
+	events_event_t event;
+	do {
+		events_wait(&event);										// Sleeps (WFI) until there is something to do.
+		intervalTimer_start(MAIN_CUMULATIVE_TIMER);	// Measure run-time when you are doing something.
+		switch (event.type) {
+		case EVENTS_SAMPLES_READY:
+			// The transmitter stops after one pulse, start the next one. The frequency only changes between pulses.
+			if (!transmitter_running()) {
+				transmitter_setFrequencyNumber(frequencyNumber);
+				transmitter_run();
+			}
+			RUN_DETECTOR();										// Run filters, compute power, etc.
+			break;
+		case EVENTS_FRAME_DUE: {
+			GET_NORMALIZED_POWER_VALUES(normalizedPowerValues, &indexOfMaxValue);	// This normalizes power between 1 and 0.
+			for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++) {									// Update across all filters.
+				// The height of the histogram bar depends upon the normalized value.
+				uint16_t histogramBarValue = ((double) barGraph_getMaxBarHeight()) * normalizedPowerValues[i];
+				// You can have a dynamic label at the top of the bar.
+				char label[HISTOGRAM_LABEL_BUFFER_SIZE];	// Get a buffer for the label.
+				// Create the label, based upon the actual power value.
+				if (snprintf(label, HISTOGRAM_LABEL_BUFFER_SIZE, "%0.0e", GET_CURRENT_POWER_VALUE(i)) == -1)
+					printf("Error: snprintf encountered an error during conversion.\n\r");
+				// Pull out the 'e' from the exponent to make better use of your characters.
+				trimLabel(label);
+				// Have the bar value and the label, send the data to the histogram. Nothing is drawn until the flush below.
+				if (!barGraph_setBar(i, histogramBarValue, label)) {
+					// If returns false, barGraph_setBar() is not happy. Print out some information.
+					printf("Error:barGraph_setBar() histogramBarValue(%d) out of range.\n\r", histogramBarValue);
+					printf("Provided normalizedPowerValue[%d]:%lf\n\r", i, normalizedPowerValues[i]);
+					printf("Dumping current and normalized power values.\n\r");
+					for (int tmp_i=0; tmp_i<FILTER_IIR_FILTER_COUNT; tmp_i++) {
+						printf("currentPowerValue[%d]:%lf\n\r", tmp_i, GET_CURRENT_POWER_VALUE(tmp_i));
+						printf("normalizedPowerValue[%d]:%lf\n\r", tmp_i, normalizedPowerValues[tmp_i]);
 					}
 				}
-				histogram_updateDisplay();	// Finally, render the histogram on the TFT.
-				histogramSystemTicks = 0;		// Reset the tick count and wait for the next update time.
-				uint16_t switchValue = switches_read();	// Read the switches and switch frequency as required.
-				// Note that Brian sends the coefficients with the min. frequency at 0, max. frequency at 9. Transmitter does likewise.
-				transmitter_setFrequencyNumber(switchValue);
 			}
-			intervalTimer_stop(2);
-		} //else
-			//printf("No interrupts occurred\n\r");
-	}
+			PROFILER_BEGIN(PROFILER_ZONE_HISTOGRAM_REDRAW);
+			ISRJITTER_MARK(ISRJITTER_EVENT_HISTOGRAM_REDRAW_BEGIN);
+			barGraph_flush();	// Finally, render what changed on the TFT.
+			display_flush();	// Nothing unless DISPLAY_USE_FRAMEBUFFER is defined in display.h.
+			ISRJITTER_MARK(ISRJITTER_EVENT_HISTOGRAM_REDRAW_END);
+			PROFILER_END(PROFILER_ZONE_HISTOGRAM_REDRAW);
+			break;
+		}
+		case EVENTS_SWITCHES_CHANGED:
+			// Note that Brian sends the coefficients with the min. frequency at 0, max. frequency at 9. Transmitter does likewise.
+			frequencyNumber = event.value;
+			break;
+		}
+		intervalTimer_stop(MAIN_CUMULATIVE_TIMER);
+	} while (!(event.type == EVENTS_BUTTONS_PRESSED && (event.value & BUTTONS_BTN3_MASK)));	// Run until btn3 is pressed.
+	events_stop();
 	interrupts_disableArmInts();
+	DETECTOR_STOP();
 	printRunTimeStatistics();
+	PROFILER_REPORT();	// Over the UART, see profiler.h for the format.
+	ISRJITTER_REPORT();	// Over the UART, see isrJitter.c for the format.
 }
 
 void computeNormalizedHitValues(double normalizedHitValues[], uint16_t hitArray[]) {
@@ -163,79 +229,111 @@ void computeNormalizedHitValues(double normalizedHitValues[], uint16_t hitArray[
 // Game-playing mode. Each shot is registered on the histogram on the TFT.
 void shooterMode() {
 	// Lots of init's.
-	buttons_init();
-	switches_init();
 	mio_init(false);
+	inputs_init();	// Buttons, switches and the trigger pin: only inputs.c reads them from here on.
 	display_init();
 	intervalTimer_initAll();
-	histogram_init(HISTOGRAM_BAR_COUNT);
+	barGraph_init(HISTOGRAM_BAR_COUNT);	// Only redraws what changed, see barGraph.h.
 	leds_init(true);
 	transmitter_init();
 	detector_init();
 	filter_init();
 	isr_init();
+	DETECTOR_START();	// Nothing unless AMP_ENABLE is defined in amp.h. Needs the ADC buffer from isr_init().
+	inputs_start();		// Sampled from the timer ISR, isr_init() set up the timer service.
+	events_init();
+	PROFILER_INIT();	// Nothing unless PROFILER_ENABLE is defined in profiler.h.
 	hitLedTimer_init();
 	trigger_init();
 	trigger_enable();	// Makes the trigger state machine responsive to the trigger.
 	// Init all interrupts (but does not enable the interrupts at the devices).
 	// Prints an error message if an internal failure occurs because the argument = true.
 	interrupts_initAll(true);
+	interrupts_setPrivateTimerLoadValue(CHANNELPLAN_PRIVATE_TIMER_LOAD_VALUE);	// Timer interrupt at CHANNELPLAN_SAMPLE_RATE_HZ.
+	ISRJITTER_INIT();	// Nothing unless ISRJITTER_ENABLE is defined in isrJitter.h. Reads the timer period set up above.
+#ifdef ISR_USE_ADC_DMA
+	adcDma_init();	// Connects the DMA done interrupt, so it has to come after interrupts_initAll().
+	adcDma_start();	// The first done interrupt is taken once the ARM interrupts are enabled below.
+#endif
 	interrupts_enableTimerGlobalInts();		// Allows the timer to generate interrupts.
 	interrupts_startArmPrivateTimer();		// Start the private ARM timer running.
 	interrupts_enableSysMonGlobalInts();	// Enable global interrupt of System Monitor.
 
-	uint16_t histogramSystemTicks = 0;		// Only update the histogram display every so many ticks.
+	uint16_t frequencyNumber = 0;			// From the switches, applied between shots.
 	double normalizedPowerValues[FILTER_IIR_FILTER_COUNT];// Use this to store normalized power values for the histogram.
 	uint16_t indexOfMaxValue;		// Keep track of the index of the maximum value.
 	intervalTimer_reset(0);	// Used to measure ISR execution time.
 	intervalTimer_reset(1);	// Used to measure total program execution time.
 	intervalTimer_reset(2);	// Used to measure main-loop execution time.
 	intervalTimer_start(1);	// Start measuring total execution time.
+	events_start(0);				// The timer ISR posts the events from here on, no frames: the bars change on hits.
 	interrupts_enableArmInts();		// The ARM will start seeing interrupts after this.
 	lockoutTimer_start();					// Ignore erroneous hits at startup (when all power values are essentially 0).
-	while (!(buttons_read() & BUTTONS_BTN3_MASK)) {	// Run until you detect btn3 pressed.
-		if (interrupts_isrFlagGlobal) {		// Only do something if an interrupt has occurred.
-			intervalTimer_start(2);					// Measure run-time when you are doing something.
-			histogramSystemTicks++;					// Keep track of ticks so you know when to update the histogram.
-			countInterruptsViaInterruptsIsrFlag++;	// Keep track of the interrupt-count based on the global flag.
-			interrupts_isrFlagGlobal = 0;						// Reset the global flag.
-			detector();															// Power across all channels is computed, hit-detection, etc.
-			if (detector_hitDetected()) {						// Hit detected?
-				detector_clearHit();									// Clear the hit.
-				detector_hitCount_t hitCounts[DETECTOR_HIT_ARRAY_SIZE];	// Store the hit-counts here.
-				detector_getHitCounts(hitCounts);												// Get the current hit counts.
-				filter_getNormalizedPowerValues(normalizedPowerValues, &indexOfMaxValue);	// This normalizes power between 1 and 0.
-				// Have the bar value and the label, send the data to the histogram.
-				double normalizedHitValues[FILTER_IIR_FILTER_COUNT];				// Store normalized values here for the histogram.
-				computeNormalizedHitValues(normalizedHitValues, hitCounts);	// Get the normalized hit values.
-				for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++) {							// Iterate through the results for each channel.
-					char label[HISTOGRAM_BAR_TOP_MAX_LABEL_WIDTH_IN_CHARS];		// Get a buffer for the label.
-					// Create the label, based upon the actual power value.
-					if (snprintf(label, HISTOGRAM_BAR_TOP_MAX_LABEL_WIDTH_IN_CHARS, "%d", hitCounts[i]) == -1)
-						printf("Error: snprintf encountered an error during conversion.\n\r");
-					histogram_setBarData(i, normalizedHitValues[i] * HISTOGRAM_MAX_BAR_DATA_IN_PIXELS, label);
-					histogram_updateDisplay();	// Redraw the histogram.
-				}
+	events_event_t event;
+	do {
+		events_wait(&event);				// Sleeps (WFI) until there is something to do.
+		intervalTimer_start(2);			// Measure run-time when you are doing something.
+		switch (event.type) {
+		case EVENTS_SAMPLES_READY:
+			transmitter_setFrequencyNumber(frequencyNumber);	// Does nothing while a shot is going out.
+			RUN_DETECTOR();													// Power across all channels is computed, hit-detection, etc.
+			if (HIT_DETECTED()) {										// Hit detected?
+				CLEAR_HIT();													// Clear the hit.
+				events_post(EVENTS_HIT_DETECTED, 0);	// Redrawn when it comes out of the queue.
 			}
-			uint16_t switchValue = switches_read();	// Read the switches and switch frequency as required.
+			break;
+		case EVENTS_HIT_DETECTED: {
+			detector_hitCount_t hitCounts[DETECTOR_HIT_ARRAY_SIZE];	// Store the hit-counts here.
+			GET_HIT_COUNTS(hitCounts);															// Get the current hit counts.
+			GET_NORMALIZED_POWER_VALUES(normalizedPowerValues, &indexOfMaxValue);	// This normalizes power between 1 and 0.
+			// Have the bar value and the label, send the data to the histogram.
+			double normalizedHitValues[FILTER_IIR_FILTER_COUNT];				// Store normalized values here for the histogram.
+			computeNormalizedHitValues(normalizedHitValues, hitCounts);	// Get the normalized hit values.
+			for (int i=0; i<FILTER_IIR_FILTER_COUNT; i++) {							// Iterate through the results for each channel.
+				char label[HISTOGRAM_LABEL_BUFFER_SIZE];		// Get a buffer for the label.
+				// Create the label, based upon the actual power value.
+				if (snprintf(label, HISTOGRAM_LABEL_BUFFER_SIZE, "%d", hitCounts[i]) == -1)
+					printf("Error: snprintf encountered an error during conversion.\n\r");
+				barGraph_setBar(i, normalizedHitValues[i] * barGraph_getMaxBarHeight(), label);
+			}
+			PROFILER_BEGIN(PROFILER_ZONE_HISTOGRAM_REDRAW);
+			ISRJITTER_MARK(ISRJITTER_EVENT_HISTOGRAM_REDRAW_BEGIN);
+			barGraph_flush();	// One redraw per hit, of only the bars and digits that changed.
+			display_flush();	// Nothing unless DISPLAY_USE_FRAMEBUFFER is defined in display.h.
+			ISRJITTER_MARK(ISRJITTER_EVENT_HISTOGRAM_REDRAW_END);
+			PROFILER_END(PROFILER_ZONE_HISTOGRAM_REDRAW);
+			break;
+		}
+		case EVENTS_SWITCHES_CHANGED:
 			// Note that Brian sends the coefficients with the min. frequency at 0, max. frequency at 9. Transmitter does likewise.
-			transmitter_setFrequencyNumber(switchValue);
+			frequencyNumber = event.value;
+			break;
 		}
 		intervalTimer_stop(2);			// All done with actual processing.
-	}
+	} while (!(event.type == EVENTS_BUTTONS_PRESSED && (event.value & BUTTONS_BTN3_MASK)));	// Run until btn3 is pressed.
+	events_stop();
 	interrupts_disableArmInts();	// Done with loop, disable the interrupts.
+	DETECTOR_STOP();
 	printRunTimeStatistics();			// Print the statistics to the TFT.
+	PROFILER_REPORT();						// Over the UART, see profiler.h for the format.
+	ISRJITTER_REPORT();						// Over the UART, see isrJitter.c for the format.
 }
-
+#endif	// AMP_CPU1
 
 // Default is continuous-power mode. Hold btn2 during reset/power-up to come up in shooter mode.
 int main() {
+#ifdef AMP_CPU1
+	amp_cpu1Main();	// The CPU1 ELF only runs the detector, see amp.h.
+#else
 	filter_runTest();
+	iirBank_runTest();
 	detector_runTest();
-	buttons_init();
+	mio_init(false);
+	inputs_init();
 	printf("Buttons initialized!\n\r");
-	if (buttons_read() & BUTTONS_BTN2_MASK)
+	if (inputs_getButtons() & BUTTONS_BTN2_MASK)
 		shooterMode();
 	else
 		continuousPowerMode();
+#endif
 }
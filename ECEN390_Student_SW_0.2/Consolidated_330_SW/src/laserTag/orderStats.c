@@ -0,0 +1,90 @@
+/*
+ * orderStats.c
+ */
+
+#include "orderStats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "detectorCore.h"
+
+#define TEST_RANDOM_TRIAL_COUNT 100000
+
+// The sorting network and the one-pass median/max/argmax are the OrderStats template of detectorCore.h.
+typedef detectorCore::OrderStats<ORDERSTATS_COUNT> coreOrderStats_t;
+
+static void sortValues(double a[]) {
+	detectorCore::SortingNetwork<ORDERSTATS_COUNT>::sort(a);
+}
+
+void orderStats_compute(const double values[], orderStats_t* stats) {
+	detectorCore::Stats coreStats;
+	coreOrderStats_t::compute(values, &coreStats);
+	stats->median = coreStats.median;
+	stats->max = coreStats.max;
+	stats->argmax = coreStats.argmax;
+}
+
+/*=============================================================================
+ * ================= Test Routines Start Here =================================
+ ==============================================================================*/
+
+static void insertionSort(double a[]) {
+	for (uint16_t i=1; i<ORDERSTATS_COUNT; i++) {
+		double x = a[i];
+		uint16_t j = i;
+		while (j > 0 && a[j-1] > x) {
+			a[j] = a[j-1];
+			j--;
+		}
+		a[j] = x;
+	}
+}
+
+static bool isSorted(const double a[]) {
+	for (uint16_t i=1; i<ORDERSTATS_COUNT; i++)
+		if (a[i-1] > a[i])
+			return false;
+	return true;
+}
+
+bool orderStats_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("orderStats_runTest: %d-value sorting network.\n\r", ORDERSTATS_COUNT);
+	// 1. A comparator network that sorts every 0/1 input sorts everything (the 0-1 principle).
+	if (ORDERSTATS_COUNT <= 16) {
+		uint32_t failedCount = 0;
+		for (uint32_t bits=0; bits<(1UL << ORDERSTATS_COUNT); bits++) {
+			double a[ORDERSTATS_COUNT];
+			for (uint16_t i=0; i<ORDERSTATS_COUNT; i++)
+				a[i] = (bits >> i) & 1;
+			sortValues(a);
+			if (!isSorted(a))
+				failedCount++;
+		}
+		printf("0/1 inputs not sorted: %lu of %lu\n\r", (unsigned long) failedCount, 1UL << ORDERSTATS_COUNT);
+		if (failedCount)
+			success = false;
+	}
+	// 2. Random values (with some repeats) vs. insertion sort, plus the argmax.
+	srand(1);
+	uint32_t mismatchCount = 0;
+	for (uint32_t trial=0; trial<TEST_RANDOM_TRIAL_COUNT; trial++) {
+		double values[ORDERSTATS_COUNT], expected[ORDERSTATS_COUNT];
+		for (uint16_t i=0; i<ORDERSTATS_COUNT; i++)
+			expected[i] = values[i] = (double) (rand() % 50);
+		insertionSort(expected);
+		orderStats_t stats;
+		orderStats_compute(values, &stats);
+		uint16_t expectedArgmax = 0;
+		while (values[expectedArgmax] != expected[ORDERSTATS_COUNT-1])
+			expectedArgmax++;
+		if (stats.median != expected[ORDERSTATS_MEDIAN_INDEX] || stats.max != expected[ORDERSTATS_COUNT-1] ||
+				stats.argmax != expectedArgmax)
+			mismatchCount++;
+	}
+	printf("Random trials that differ from insertion sort: %lu of %d\n\r", (unsigned long) mismatchCount, TEST_RANDOM_TRIAL_COUNT);
+	if (mismatchCount)
+		success = false;
+	printf("orderStats_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
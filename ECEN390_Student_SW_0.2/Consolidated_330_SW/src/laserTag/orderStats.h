@@ -0,0 +1,34 @@
+/*
+ * orderStats.h
+ */
+
+#ifndef ORDERSTATS_H_
+#define ORDERSTATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "filter.h"
+
+// Median, max and argmax of the FILTER_IIR_FILTER_COUNT channel powers, for the detector's threshold.
+// Every channel's power changes on every decimated sample, so there is no single changed channel to re-rank.
+// Instead the values go through a fixed sorting network: no data-dependent loops, and for 10 channels only
+// 29 compare-exchanges (Waksman's network, 9 levels). Other channel counts use odd-even transposition
+// (detectorCore.h).
+
+#define ORDERSTATS_COUNT FILTER_IIR_FILTER_COUNT
+#define ORDERSTATS_MEDIAN_INDEX (ORDERSTATS_COUNT/2 - 1)	// Lower median, same as the detector always used.
+
+typedef struct {
+	double median;		// Value at ORDERSTATS_MEDIAN_INDEX in ascending order.
+	double max;
+	uint16_t argmax;	// Lowest channel number that has the max value.
+} orderStats_t;
+
+// Computes the median, max and argmax of values[0 .. ORDERSTATS_COUNT-1] in one pass. values[] is not changed.
+void orderStats_compute(const double values[], orderStats_t* stats);
+
+// Checks the sorting network on every 0/1 input (enough to prove it sorts) and against an insertion sort
+// on random values.
+bool orderStats_runTest();
+
+#endif /* ORDERSTATS_H_ */
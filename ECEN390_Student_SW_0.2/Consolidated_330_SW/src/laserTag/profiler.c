@@ -0,0 +1,113 @@
+/*
+ * profiler.c
+ */
+
+#include "profiler.h"
+
+#ifdef PROFILER_ENABLE
+
+#include <stdio.h>
+
+#define TEST_ZONE PROFILER_ZONE_HISTOGRAM_REDRAW
+
+static profiler_zoneStats_t zones[PROFILER_ZONE_COUNT];
+static const profiler_zoneStats_t clearedStats = {0, 0, 0, 0, {0}};
+
+// Same order as profiler_zone_t.
+static const char* zoneNames[PROFILER_ZONE_COUNT] = {
+	"isr", "timerDispatch", "transmitter", "hitLedTimer", "lockoutTimer", "trigger", "adcDma",
+	"detectorBlock", "fir", "iirBank", "hit", "histogramRedraw"
+};
+
+// Index of the highest set bit, 0 for 0 and 1.
+static uint16_t log2Bin(uint64_t ticks) {
+	uint16_t bin = 0;
+	while (ticks > 1 && bin < PROFILER_HISTOGRAM_BIN_COUNT - 1) {
+		ticks >>= 1;
+		bin++;
+	}
+	return bin;
+}
+
+void profiler_init() {
+	for (uint16_t i=0; i<PROFILER_ZONE_COUNT; i++)
+		zones[i] = clearedStats;
+	globalTimer_startTimer(false);	// false = no status message.
+}
+
+void profiler_record(profiler_zone_t zone, uint64_t ticks) {
+	profiler_zoneStats_t* stats = &zones[zone];
+	if (!stats->count || ticks < stats->minTicks)
+		stats->minTicks = ticks;
+	if (ticks > stats->maxTicks)
+		stats->maxTicks = ticks;
+	stats->count++;
+	stats->totalTicks += ticks;
+	stats->histogram[log2Bin(ticks)]++;
+}
+
+void profiler_getZoneStats(profiler_zone_t zone, profiler_zoneStats_t* stats) {
+	*stats = zones[zone];
+}
+
+const char* profiler_getZoneName(profiler_zone_t zone) {
+	return zoneNames[zone];
+}
+
+void profiler_printReport() {
+	printf("#profiler,1,%lu,%d,%d\n\r", (unsigned long) GLOBAL_TIMER_TICKS_PER_SECOND, PROFILER_ZONE_COUNT,
+			PROFILER_HISTOGRAM_BIN_COUNT);
+	printf("zone,count,totalTicks,minTicks,maxTicks,meanTicks,log2Histogram\n\r");
+	for (uint16_t i=0; i<PROFILER_ZONE_COUNT; i++) {
+		profiler_zoneStats_t* stats = &zones[i];
+		printf("%s,%lu,%llu,%llu,%llu,%llu,", zoneNames[i], (unsigned long) stats->count,
+				(unsigned long long) stats->totalTicks, (unsigned long long) stats->minTicks,
+				(unsigned long long) stats->maxTicks, (unsigned long long) (stats->count ? stats->totalTicks / stats->count : 0));
+		for (uint16_t bin=0; bin<PROFILER_HISTOGRAM_BIN_COUNT; bin++)
+			printf(bin ? " %lu" : "%lu", (unsigned long) stats->histogram[bin]);
+		printf("\n\r");
+	}
+	printf("#end\n\r");
+}
+
+bool profiler_runTest() {
+	profiler_zoneStats_t savedStats = zones[TEST_ZONE];	// The test borrows a zone.
+	zones[TEST_ZONE] = clearedStats;
+	bool failed = false;
+	// 0 and 1 go in bin 0, 2 and 3 in bin 1, 1000 in bin 9, and anything past 2^32 in the last bin.
+	const uint64_t durations[] = {0, 1, 2, 3, 1000, 1ULL << 40};
+	const uint16_t bins[] = {0, 0, 1, 1, 9, PROFILER_HISTOGRAM_BIN_COUNT - 1};
+	const uint16_t durationCount = sizeof(durations) / sizeof(durations[0]);
+	uint64_t total = 0;
+	for (uint16_t i=0; i<durationCount; i++) {
+		profiler_record(TEST_ZONE, durations[i]);
+		total += durations[i];
+	}
+	profiler_zoneStats_t stats;
+	profiler_getZoneStats(TEST_ZONE, &stats);
+	if (stats.count != durationCount || stats.totalTicks != total || stats.minTicks != 0 || stats.maxTicks != 1ULL << 40) {
+		printf("profiler_runTest: count %lu, total %llu, min %llu, max %llu\n\r", (unsigned long) stats.count,
+				(unsigned long long) stats.totalTicks, (unsigned long long) stats.minTicks, (unsigned long long) stats.maxTicks);
+		failed = true;
+	}
+	uint32_t expectedHistogram[PROFILER_HISTOGRAM_BIN_COUNT] = {0};
+	for (uint16_t i=0; i<durationCount; i++)
+		expectedHistogram[bins[i]]++;
+	for (uint16_t bin=0; bin<PROFILER_HISTOGRAM_BIN_COUNT; bin++) {
+		if (stats.histogram[bin] != expectedHistogram[bin]) {
+			printf("profiler_runTest: bin %d has %lu, expected %lu\n\r", bin, (unsigned long) stats.histogram[bin],
+					(unsigned long) expectedHistogram[bin]);
+			failed = true;
+		}
+	}
+	// An empty zone measures what the two timer reads cost.
+	zones[TEST_ZONE] = clearedStats;
+	PROFILER_BEGIN(TEST_ZONE);
+	PROFILER_END(TEST_ZONE);
+	printf("profiler_runTest: empty zone %llu global-timer ticks\n\r", (unsigned long long) zones[TEST_ZONE].totalTicks);
+	zones[TEST_ZONE] = savedStats;
+	printf(failed ? "profiler_runTest failed.\n\r" : "profiler_runTest passed.\n\r");
+	return !failed;
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * profiler.h
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Uncomment to profile the ISR and the main loop. Commented out, every PROFILER_* macro below compiles to nothing
+// and profiler.c is empty, so the profiler costs nothing in a normal build.
+//#define PROFILER_ENABLE
+
+// Named zones timed with the ARM global timer (globalTimer_getTimerValue(), 64 bits, GLOBAL_TIMER_TICKS_PER_SECOND,
+// half the CPU clock). A zone is bracketed in the code by PROFILER_BEGIN(zone) ... PROFILER_END(zone) in one block.
+// Each zone keeps the count, total, min and max of its durations, and a log2 histogram: bin i counts durations of
+// 2^i to 2^(i+1)-1 global-timer ticks (bin 0 also gets 0 ticks, the last bin everything longer).
+//
+// Times are wall-clock: a main-loop zone includes the interrupts that ran inside it. Each zone must only be used
+// from one context (ISR or main), and profiler_printReport() should run with interrupts off, e.g., after the mode
+// loop in main.c.
+//
+// The report is plain text on the UART (printf), one zone per line, easy to split on commas:
+//   #profiler,1,<ticksPerSecond>,<zoneCount>,<binCount>
+//   zone,count,totalTicks,minTicks,maxTicks,meanTicks,log2Histogram
+//   <one line per zone: name,count,total,min,max,mean,bin0 bin1 ... (space-separated), unused zones have count 0>
+//   #end
+
+typedef enum {
+	PROFILER_ZONE_ISR,					// isr_function(), everything the timer interrupt runs.
+	PROFILER_ZONE_TIMER_DISPATCH,		// timerService_dispatch() in isr_function(), including the callbacks below.
+	PROFILER_ZONE_TRANSMITTER,			// One state-machine transition (they replaced the tick functions).
+	PROFILER_ZONE_HIT_LED_TIMER,
+	PROFILER_ZONE_LOCKOUT_TIMER,
+	PROFILER_ZONE_TRIGGER,
+	PROFILER_ZONE_ADC_DMA,				// The DMA done interrupt (ISR_USE_ADC_DMA).
+	PROFILER_ZONE_DETECTOR_BLOCK,		// detector_processBlock().
+	PROFILER_ZONE_FIR,					// filter_decimateBlock(), one chunk.
+	PROFILER_ZONE_IIR_BANK,				// filter_iirFilterBank(), one decimated sample.
+	PROFILER_ZONE_HIT,					// The lockout check and the hit test on one decimated sample.
+	PROFILER_ZONE_HISTOGRAM_REDRAW,		// barGraph_flush() in main.c.
+	PROFILER_ZONE_COUNT
+} profiler_zone_t;
+
+#define PROFILER_HISTOGRAM_BIN_COUNT 32	// Up to 2^32 ticks (13 s) is resolved.
+
+typedef struct {
+	uint32_t count;
+	uint64_t totalTicks;
+	uint64_t minTicks;
+	uint64_t maxTicks;
+	uint32_t histogram[PROFILER_HISTOGRAM_BIN_COUNT];
+} profiler_zoneStats_t;
+
+#ifdef PROFILER_ENABLE
+
+#include "supportFiles/globalTimer.h"
+
+// PROFILER_BEGIN() declares a local, so a zone can only be begun once per block.
+#define PROFILER_BEGIN(zone) uint64_t profiler_start_##zone = globalTimer_getTimerValue()
+#define PROFILER_END(zone) profiler_record(zone, globalTimer_getTimerValue() - profiler_start_##zone)
+#define PROFILER_INIT() profiler_init()
+#define PROFILER_REPORT() profiler_printReport()
+
+#else
+
+#define PROFILER_BEGIN(zone)
+#define PROFILER_END(zone)
+#define PROFILER_INIT()
+#define PROFILER_REPORT()
+
+#endif
+
+#ifdef PROFILER_ENABLE
+
+// Clears every zone and starts the global timer.
+void profiler_init();
+
+// Adds one duration to a zone. Called by PROFILER_END().
+void profiler_record(profiler_zone_t zone, uint64_t ticks);
+
+// Copies a zone's statistics.
+void profiler_getZoneStats(profiler_zone_t zone, profiler_zoneStats_t* stats);
+
+// Name used in the report.
+const char* profiler_getZoneName(profiler_zone_t zone);
+
+// Prints the report described above.
+void profiler_printReport();
+
+// Records known durations into a zone and checks the statistics and the histogram. Returns true if they are right.
+bool profiler_runTest();
+
+#endif
+
+#endif /* PROFILER_H_ */
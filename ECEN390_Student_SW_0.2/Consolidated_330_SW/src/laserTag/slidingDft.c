@@ -0,0 +1,188 @@
+/*
+ * slidingDft.c
+ */
+
+#include "slidingDft.h"
+#include "iirBank.h"
+#include "windowedEnergy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "supportFiles/globalTimer.h"
+
+#define WINDOW_LENGTH SLIDINGDFT_WINDOW_LENGTH
+#define BIN_COUNT SLIDINGDFT_BIN_COUNT
+
+// Full period of each player's frequency in 100 kHz ticks, twice the half-periods in freq[] in transmitter.c.
+static const uint16_t playerPeriodTicks[BIN_COUNT] = {90, 72, 58, 50, 44, 38, 34, 30, 28, 26};
+
+static float history[WINDOW_LENGTH];	// Decimated FIR outputs, x(n-N) is the next one to be overwritten.
+static uint32_t historyIndex;
+static float wRe[BIN_COUNT], wIm[BIN_COUNT];	// e^(j*omega), one step of rotation.
+static float wNRe[BIN_COUNT], wNIm[BIN_COUNT];	// e^(j*omega*N), the rotation of the sample leaving the window.
+static float sRe[BIN_COUNT], sIm[BIN_COUNT];	// Sliding DFT of the last N samples.
+static float freshRe[BIN_COUNT], freshIm[BIN_COUNT];	// DFT of the samples since the history last wrapped.
+static float powerHistory[SLIDINGDFT_AVERAGE_LENGTH][BIN_COUNT];	// 2*|S|^2/N, one row per sample.
+static uint32_t powerIndex;
+static double powerSum[BIN_COUNT];		// Sum of powerHistory over the last SLIDINGDFT_AVERAGE_LENGTH samples.
+static double freshPowerSum[BIN_COUNT];	// Sum of the rows written since powerHistory last wrapped.
+
+// Radians per decimated sample for a player.
+static double binOmega(uint16_t bin) {
+	return 2.0 * M_PI * FILTER_FIR_DECIMATION_FACTOR / playerPeriodTicks[bin];
+}
+
+void slidingDft_init() {
+	for (uint32_t i=0; i<WINDOW_LENGTH; i++)
+		history[i] = 0.0f;
+	historyIndex = 0;
+	for (uint32_t i=0; i<SLIDINGDFT_AVERAGE_LENGTH; i++)
+		for (uint16_t k=0; k<BIN_COUNT; k++)
+			powerHistory[i][k] = 0.0f;
+	powerIndex = 0;
+	for (uint16_t k=0; k<BIN_COUNT; k++) {
+		double omega = binOmega(k);
+		wRe[k] = (float) cos(omega);
+		wIm[k] = (float) sin(omega);
+		wNRe[k] = (float) cos(omega * WINDOW_LENGTH);
+		wNIm[k] = (float) sin(omega * WINDOW_LENGTH);
+		sRe[k] = sIm[k] = freshRe[k] = freshIm[k] = 0.0f;
+		powerSum[k] = freshPowerSum[k] = 0.0;
+	}
+}
+
+void slidingDft_addSample(float x) {
+	const float powerScale = 2.0f / WINDOW_LENGTH;
+	float xOld = history[historyIndex];
+	history[historyIndex] = x;
+	for (uint16_t k=0; k<BIN_COUNT; k++) {
+		// S = x + w*S - w^N*xOld
+		float re = x + wRe[k] * sRe[k] - wIm[k] * sIm[k] - wNRe[k] * xOld;
+		float im = wRe[k] * sIm[k] + wIm[k] * sRe[k] - wNIm[k] * xOld;
+		sRe[k] = re;
+		sIm[k] = im;
+		// F = x + w*F
+		re = x + wRe[k] * freshRe[k] - wIm[k] * freshIm[k];
+		im = wRe[k] * freshIm[k] + wIm[k] * freshRe[k];
+		freshRe[k] = re;
+		freshIm[k] = im;
+	}
+	if (++historyIndex == WINDOW_LENGTH) {
+		// The fresh sums have seen exactly the samples in the window, without the sliding sums' rounding.
+		historyIndex = 0;
+		for (uint16_t k=0; k<BIN_COUNT; k++) {
+			sRe[k] = freshRe[k];
+			sIm[k] = freshIm[k];
+			freshRe[k] = freshIm[k] = 0.0f;
+		}
+	}
+	// Boxcar average of the power, same as windowedEnergy_addSample().
+	float* row = powerHistory[powerIndex];	// Holds the powers that are about to fall out of the average.
+	for (uint16_t k=0; k<BIN_COUNT; k++) {
+		float power = powerScale * (sRe[k] * sRe[k] + sIm[k] * sIm[k]);
+		powerSum[k] += (double) power - (double) row[k];
+		freshPowerSum[k] += power;
+		row[k] = power;
+	}
+	if (++powerIndex == SLIDINGDFT_AVERAGE_LENGTH) {
+		powerIndex = 0;
+		for (uint16_t k=0; k<BIN_COUNT; k++) {
+			powerSum[k] = freshPowerSum[k];
+			freshPowerSum[k] = 0.0;
+		}
+	}
+}
+
+double slidingDft_getPower(uint16_t bin) {
+	return powerSum[bin] / SLIDINGDFT_AVERAGE_LENGTH;
+}
+
+/*=============================================================================
+ * ================= Test Routines Start Here =================================
+ ==============================================================================*/
+
+#define TEST_SAMPLE_COUNT (5*WINDOW_LENGTH+333)
+#define TEST_CHECK_PERIOD 777				// Compare against the direct DFT this often.
+#define TEST_TONE_AMPLITUDE 0.5
+#define TEST_NOISE_AMPLITUDE 0.2
+#define TEST_TONE_BIN 3
+#define TEST_MAX_DFT_ERROR 1.0E-3			// |sliding - direct| relative to the sum of |x| over the window, about N * float epsilon.
+#define TEST_MAX_TONE_POWER_ERROR 0.01		// Tone power vs. N*A^2/2.
+#define TEST_TONE_SAMPLE_COUNT (WINDOW_LENGTH + SLIDINGDFT_AVERAGE_LENGTH)	// Fills the DFT window, then the average.
+
+// Direct DFT of the window at the bin's frequency, in double, newest sample first (same as S).
+static void directDft(uint16_t bin, double* re, double* im, double* absSum) {
+	double omega = binOmega(bin);
+	*re = *im = *absSum = 0.0;
+	for (uint32_t m=0; m<WINDOW_LENGTH; m++) {
+		double x = history[(historyIndex + WINDOW_LENGTH - 1 - m) % WINDOW_LENGTH];
+		*re += x * cos(omega * m);
+		*im += x * sin(omega * m);
+		*absSum += fabs(x);
+	}
+}
+
+bool slidingDft_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("slidingDft_runTest: sliding DFT bins vs. direct DFT.\n\r");
+	// 1. Tone plus noise, checked against the direct DFT across several wraps of the history.
+	slidingDft_init();
+	srand(1);
+	double maxError = 0.0;
+	for (uint32_t n=0; n<TEST_SAMPLE_COUNT; n++) {
+		double noise = TEST_NOISE_AMPLITUDE * ((double) rand() / RAND_MAX - 0.5);
+		slidingDft_addSample((float) (TEST_TONE_AMPLITUDE * sin(binOmega(TEST_TONE_BIN) * n) + noise));
+		if (n % TEST_CHECK_PERIOD)
+			continue;
+		for (uint16_t k=0; k<BIN_COUNT; k++) {
+			double re, im, absSum;
+			directDft(k, &re, &im, &absSum);
+			double error = hypot(sRe[k] - re, sIm[k] - im) / absSum;
+			if (error > maxError)
+				maxError = error;
+		}
+	}
+	printf("Max error vs. direct DFT: %le of the window's sum of |x|.\n\r", maxError);
+	if (maxError > TEST_MAX_DFT_ERROR)
+		success = false;
+	// 2. A steady tone at each player frequency must be loudest in its own bin, with the energy of the tone.
+	for (uint16_t player=0; player<BIN_COUNT; player++) {
+		slidingDft_init();
+		for (uint32_t n=0; n<TEST_TONE_SAMPLE_COUNT; n++)
+			slidingDft_addSample((float) (TEST_TONE_AMPLITUDE * sin(binOmega(player) * n)));
+		uint16_t loudest = 0;
+		for (uint16_t k=1; k<BIN_COUNT; k++)
+			if (slidingDft_getPower(k) > slidingDft_getPower(loudest))
+				loudest = k;
+		double expectedPower = WINDOW_LENGTH * TEST_TONE_AMPLITUDE * TEST_TONE_AMPLITUDE / 2.0;
+		double powerError = fabs(slidingDft_getPower(player) - expectedPower) / expectedPower;
+		if (loudest != player || powerError > TEST_MAX_TONE_POWER_ERROR) {
+			printf("Player %d tone: loudest bin %d, power error %le\n\r", player, loudest, powerError);
+			success = false;
+		}
+	}
+	// 3. Cycles per decimated sample against the IIR bank and its power window.
+	iirBank_init();
+	windowedEnergy_init();
+	slidingDft_init();
+	u64 iirTicks = 0, dftTicks = 0;
+	globalTimer_startTimer(false);	// Used to count cycles, false = no status message.
+	for (uint32_t n=0; n<TEST_SAMPLE_COUNT; n++) {
+		float x = (float) ((double) rand() / RAND_MAX - 0.5);
+		float z[FILTER_IIR_FILTER_COUNT];
+		u64 startTime = globalTimer_getTimerValue();
+		iirBank_filter(x, z);
+		windowedEnergy_addSample(z);
+		u64 midTime = globalTimer_getTimerValue();
+		slidingDft_addSample(x);
+		u64 endTime = globalTimer_getTimerValue();
+		iirTicks += midTime - startTime;
+		dftTicks += endTime - midTime;
+	}
+	printf("Cycles per decimated sample: iirBank_filter() + windowedEnergy_addSample() %llu, slidingDft_addSample() %llu\n\r",
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * iirTicks / TEST_SAMPLE_COUNT,
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * dftTicks / TEST_SAMPLE_COUNT);
+	slidingDft_init();
+	printf("slidingDft_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
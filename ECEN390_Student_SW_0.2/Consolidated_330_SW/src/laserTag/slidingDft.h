@@ -0,0 +1,41 @@
+/*
+ * slidingDft.h
+ */
+
+#ifndef SLIDINGDFT_H_
+#define SLIDINGDFT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "filter.h"
+
+// Per-player energy from one sliding DFT bin per player frequency, run on the decimated FIR output.
+// Replaces the 10th-order IIR filters and the windowed energy when FILTER_USE_SLIDING_DFT is defined (see filter.h).
+// Each bin is centered on a player frequency, which does not have to be an integer bin of the window:
+//   S(n) = x(n) + w*S(n-1) - w^N * x(n-N),  w = e^(j*omega), N = SLIDINGDFT_WINDOW_LENGTH
+// so S(n) is the DFT of the last N samples at omega. 2*|S|^2/N equals the energy (sum of squares) of a tone at omega.
+// One bin is a single complex value, so its noise power is exponentially distributed and the detector's
+// median-based threshold would trip on noise all the time. The power is therefore averaged over the last
+// SLIDINGDFT_AVERAGE_LENGTH samples, i.e., over several independent DFT windows. The average is a boxcar, not
+// an exponential average, so a shot's power is gone completely before the lockout timer ends.
+// The bins are single precision. Both S and the power sum have a second, non-sliding sum that restarts every
+// window and replaces them when it has seen exactly one window, so rounding errors never build up (like windowedEnergy.c).
+
+#define SLIDINGDFT_WINDOW_LENGTH 250	// 25 ms at the 10 kHz decimated rate, 40 Hz bins (players are >= 275 Hz apart).
+#define SLIDINGDFT_AVERAGE_LENGTH 2000	// Power is averaged over 200 ms (the length of a shot), 8 DFT windows.
+#define SLIDINGDFT_BIN_COUNT FILTER_IIR_FILTER_COUNT
+
+// Computes the bin rotations and clears the history and the bins.
+void slidingDft_init();
+
+// Adds one decimated FIR output and updates every bin.
+void slidingDft_addSample(float x);
+
+// Current (averaged) power for one player's bin.
+double slidingDft_getPower(uint16_t bin);
+
+// Checks the bins against a direct DFT of the window, checks that a tone at each player frequency is loudest
+// in its own bin and prints the cycles per sample against iirBank_filter() + windowedEnergy_addSample().
+bool slidingDft_runTest();
+
+#endif /* SLIDINGDFT_H_ */
@@ -0,0 +1,78 @@
+/*
+ * staticQueue.c
+ */
+
+#include "staticQueue.h"
+#include "queue.h"
+#include <stdlib.h>
+#include "supportFiles/globalTimer.h"
+
+#define TEST_QUEUE_SIZE 20000		// Same as the power window (windowedEnergy.h).
+#define TEST_QUEUE_STORAGE_LOG2 15
+#define TEST_PUSH_COUNT 25000		// More than the size so that both queues wrap.
+#define TEST_BENCHMARK_PASS_COUNT 10
+
+STATICQUEUE_DECLARE_TYPE(testQueue, double, "%le")
+STATICQUEUE_DEFINE(testQueue, double, staticTestQueue, TEST_QUEUE_SIZE, TEST_QUEUE_STORAGE_LOG2);
+
+bool staticQueue_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("staticQueue_runTest: static queue vs. queue_t.\n\r");
+	queue_t mallocQueue;
+	queue_init(&mallocQueue, TEST_QUEUE_SIZE);
+	testQueue_fill(&staticTestQueue, 0.0);
+	for (uint32_t i=0; i<TEST_QUEUE_SIZE; i++)
+		queue_overwritePush(&mallocQueue, 0.0);
+	// 1. Same contents after lots of overwritePush() calls.
+	for (uint32_t i=0; i<TEST_PUSH_COUNT; i++) {
+		double value = (double) rand() / (double) RAND_MAX;
+		queue_overwritePush(&mallocQueue, value);
+		testQueue_overwritePush(&staticTestQueue, value);
+	}
+	if (testQueue_elementCount(&staticTestQueue) != queue_elementCount(&mallocQueue)) {
+		printf("Element counts differ: %lu vs. %lu\n\r", (unsigned long) testQueue_elementCount(&staticTestQueue),
+				(unsigned long) queue_elementCount(&mallocQueue));
+		success = false;
+	}
+	for (uint32_t i=0; i<TEST_QUEUE_SIZE; i++) {
+		if (testQueue_readElementAt(&staticTestQueue, i) != queue_readElementAt(&mallocQueue, i)) {
+			printf("readElementAt(%lu) differs: %le vs. %le\n\r", (unsigned long) i,
+					testQueue_readElementAt(&staticTestQueue, i), queue_readElementAt(&mallocQueue, i));
+			success = false;
+			break;
+		}
+	}
+	if (testQueue_readNewest(&staticTestQueue) != queue_readElementAt(&mallocQueue, TEST_QUEUE_SIZE-1)) {
+		printf("readNewest() differs from the newest queue_t element.\n\r");
+		success = false;
+	}
+	// 2. pop() returns the oldest element.
+	double oldest = queue_readElementAt(&mallocQueue, 0);
+	if (testQueue_pop(&staticTestQueue) != oldest || queue_pop(&mallocQueue) != oldest) {
+		printf("pop() did not return the oldest element.\n\r");
+		success = false;
+	}
+	// 3. Benchmark: read every element, the way a power computation does when it starts from scratch.
+	globalTimer_startTimer(false);	// Used to count cycles, false = no status message.
+	double mallocSum = 0.0, staticSum = 0.0;	// Printed so the compiler can't throw the reads away.
+	u64 startTime = globalTimer_getTimerValue();
+	for (uint32_t pass=0; pass<TEST_BENCHMARK_PASS_COUNT; pass++)
+		for (uint32_t i=0; i<TEST_QUEUE_SIZE-1; i++)
+			mallocSum += queue_readElementAt(&mallocQueue, i);
+	u64 midTime = globalTimer_getTimerValue();
+	for (uint32_t pass=0; pass<TEST_BENCHMARK_PASS_COUNT; pass++)
+		for (uint32_t i=0; i<TEST_QUEUE_SIZE-1; i++)
+			staticSum += testQueue_readElementAt(&staticTestQueue, i);
+	u64 endTime = globalTimer_getTimerValue();
+	if (mallocSum != staticSum) {
+		printf("Benchmark sums differ: %le vs. %le\n\r", mallocSum, staticSum);
+		success = false;
+	}
+	uint32_t readCount = TEST_BENCHMARK_PASS_COUNT * (TEST_QUEUE_SIZE-1);
+	printf("Cycles per readElementAt(): queue_t (%%) %4.2lf, static queue (mask) %4.2lf\n\r",
+			(double) (GLOBAL_TIMER_CPU_CYCLES_PER_TICK * (midTime - startTime)) / readCount,
+			(double) (GLOBAL_TIMER_CPU_CYCLES_PER_TICK * (endTime - midTime)) / readCount);
+	gueue_garbageCollect(&mallocQueue);
+	printf("staticQueue_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
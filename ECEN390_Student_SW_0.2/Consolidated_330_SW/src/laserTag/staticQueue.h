@@ -0,0 +1,117 @@
+/*
+ * staticQueue.h
+ */
+
+#ifndef STATICQUEUE_H_
+#define STATICQUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Statically allocated version of queue_t. No malloc: the storage is a static array whose size is fixed at compile time.
+// The storage is rounded up to a power of two so that indexes wrap with a mask instead of % or a compare.
+// indexIn is a free-running counter, the oldest element is always at indexIn - elementCount.
+//
+// STATICQUEUE_DECLARE_TYPE(prefix, dataType, printFormat) generates the queue type prefix_t and its functions
+// for one element type: prefix_fill(), prefix_overwritePush(), prefix_pop(), prefix_readElementAt(),
+// prefix_readNewest(), prefix_elementCount(), prefix_size() and prefix_print().
+//
+// STATICQUEUE_DEFINE(prefix, dataType, name, queueSize, storageLog2) defines a queue called name that holds up to queueSize elements
+// in 2^storageLog2 elements of static storage. It starts out empty, use prefix_fill() to fill it with zeros.
+//
+// Example:
+//   STATICQUEUE_DECLARE_TYPE(doubleQueue, double, "%le")
+//   STATICQUEUE_DEFINE(doubleQueue, double, xQueue, 23, 5);	// 23 elements in 32 doubles.
+//   doubleQueue_fill(&xQueue, 0.0);
+//   doubleQueue_overwritePush(&xQueue, 1.0);
+
+typedef uint32_t staticQueue_index_t;
+typedef uint32_t staticQueue_size_t;
+
+#define STATICQUEUE_DECLARE_TYPE(prefix, dataType, printFormat) \
+typedef struct { \
+	dataType* data;						/* Points at the static storage. */ \
+	staticQueue_index_t mask;			/* Storage size - 1. */ \
+	staticQueue_size_t size;			/* Max number of elements. */ \
+	staticQueue_index_t indexIn;		/* Free-running, masked on every access. */ \
+	staticQueue_size_t elementCount; \
+} prefix##_t; \
+\
+/* Empties the queue then pushes value until the queue is full. */ \
+static inline void prefix##_fill(prefix##_t* q, dataType value) { \
+	q->indexIn = 0; \
+	q->elementCount = q->size; \
+	for (staticQueue_index_t i=0; i<q->size; i++) \
+		q->data[i] = value; \
+	q->indexIn = q->size; \
+} \
+\
+/* Pushes a new element into the queue, making room by removing the oldest element. */ \
+static inline void prefix##_overwritePush(prefix##_t* q, dataType value) { \
+	q->data[q->indexIn & q->mask] = value; \
+	q->indexIn++; \
+	if (q->elementCount < q->size) \
+		q->elementCount++; \
+} \
+\
+/* Removes the oldest element in the queue. Prints an error and returns whatever is in the storage if empty. */ \
+static inline dataType prefix##_pop(prefix##_t* q) { \
+	if (!q->elementCount) \
+		printf("Error: " #prefix "_pop - empty queue, pop data invalid\n\r"); \
+	else \
+		q->elementCount--; \
+	return q->data[(q->indexIn - q->elementCount - 1) & q->mask]; \
+} \
+\
+/* Random access, index 0 is the oldest element and elementCount-1 the newest. */ \
+static inline dataType prefix##_readElementAt(const prefix##_t* q, staticQueue_index_t index) { \
+	return q->data[(q->indexIn - q->elementCount + index) & q->mask]; \
+} \
+\
+/* Returns the most recently pushed element. */ \
+static inline dataType prefix##_readNewest(const prefix##_t* q) { \
+	return q->data[(q->indexIn - 1) & q->mask]; \
+} \
+\
+static inline staticQueue_size_t prefix##_elementCount(const prefix##_t* q) { \
+	return q->elementCount; \
+} \
+\
+static inline staticQueue_size_t prefix##_size(const prefix##_t* q) { \
+	return q->size; \
+} \
+\
+/* Prints the current contents of the queue, oldest first. Handy for debugging. */ \
+static inline void prefix##_print(const prefix##_t* q) { \
+	for (staticQueue_index_t i=0; i<q->elementCount; i++) \
+		printf("data[%lu]:" printFormat "\n\r", (unsigned long) i, prefix##_readElementAt(q, i)); \
+	printf("\n\r"); \
+}
+
+// Fails to compile (negative array size) if queueSize does not fit in the storage.
+#define STATICQUEUE_DEFINE(prefix, dataType, name, queueSize, storageLog2) \
+typedef char name##_sizeCheck[((queueSize) <= (1UL << (storageLog2))) ? 1 : -1]; \
+static dataType name##_storage[1UL << (storageLog2)]; \
+static prefix##_t name = {name##_storage, (1UL << (storageLog2)) - 1, (queueSize), 0, 0}
+
+// Same as STATICQUEUE_DEFINE() but for an array of count queues called name, each with its own storage.
+#define STATICQUEUE_DEFINE_ARRAY(prefix, dataType, name, count, queueSize, storageLog2) \
+typedef char name##_sizeCheck[((queueSize) <= (1UL << (storageLog2))) ? 1 : -1]; \
+static dataType name##_storage[count][1UL << (storageLog2)]; \
+static prefix##_t name[count]
+
+// Points each queue of an array defined with STATICQUEUE_DEFINE_ARRAY() at its storage. Call once before using them.
+#define STATICQUEUE_INIT_ARRAY(name, count, queueSize, storageLog2) \
+	for (uint32_t name##_i=0; name##_i<(count); name##_i++) { \
+		name[name##_i].data = name##_storage[name##_i]; \
+		name[name##_i].mask = (1UL << (storageLog2)) - 1; \
+		name[name##_i].size = (queueSize); \
+		name[name##_i].indexIn = 0; \
+		name[name##_i].elementCount = 0; \
+	}
+
+// Compares readElementAt() against queue_t (queue.c) and prints the cycles per read for both.
+bool staticQueue_runTest();
+
+#endif /* STATICQUEUE_H_ */
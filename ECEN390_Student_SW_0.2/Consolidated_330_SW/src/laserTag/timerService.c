@@ -0,0 +1,134 @@
+/*
+ * timerService.c
+ */
+
+#include "timerService.h"
+#include "supportFiles/globalTimer.h"
+#include <stdio.h>
+
+#define GLOBAL_TICKS_PER_TICK (GLOBAL_TIMER_TICKS_PER_SECOND / TIMERSERVICE_TICKS_PER_SECOND)
+#define DEADLINE_GUARD (GLOBAL_TICKS_PER_TICK / 2)	// Deadlines are this early, see timerService.h.
+
+static timerService_timer_t* heap[TIMERSERVICE_MAX_TIMER_COUNT];	// heap[0] has the earliest deadline.
+static uint16_t heapCount = 0;
+static timerService_timer_t* requestList = NULL;	// Pushed by anyone, taken whole by dispatch.
+static uint64_t dispatchTime;	// globalTimer_getTimerValue() at the start of the current dispatch.
+static uint32_t callbackCount = 0;
+
+/*================================ Heap ================================*/
+
+static void heapSet(uint16_t index, timerService_timer_t* timer) {
+	heap[index] = timer;
+	timer->heapIndex = index;
+}
+
+static void siftUp(uint16_t index) {
+	timerService_timer_t* timer = heap[index];
+	while (index > 0) {
+		uint16_t parent = (index - 1) / 2;
+		if (heap[parent]->deadline <= timer->deadline)
+			break;
+		heapSet(index, heap[parent]);
+		index = parent;
+	}
+	heapSet(index, timer);
+}
+
+static void siftDown(uint16_t index) {
+	timerService_timer_t* timer = heap[index];
+	while (true) {
+		uint16_t child = 2 * index + 1;
+		if (child >= heapCount)
+			break;
+		if (child + 1 < heapCount && heap[child + 1]->deadline < heap[child]->deadline)
+			child++;
+		if (timer->deadline <= heap[child]->deadline)
+			break;
+		heapSet(index, heap[child]);
+		index = child;
+	}
+	heapSet(index, timer);
+}
+
+static void heapRemove(timerService_timer_t* timer) {
+	uint16_t index = timer->heapIndex;
+	timer->heapIndex = -1;
+	heapCount--;
+	if (index == heapCount)
+		return;
+	timerService_timer_t* moved = heap[heapCount];	// Move the last one into the hole, it can belong above or below it.
+	heapSet(index, moved);
+	siftUp(index);
+	if (moved->heapIndex == index)
+		siftDown(index);
+}
+
+/*================================ Interface ================================*/
+
+void timerService_init() {
+	globalTimer_startTimer(false);	// The deadlines come from it, false = no status message.
+	for (uint16_t i=0; i<heapCount; i++)
+		heap[i]->heapIndex = -1;
+	heapCount = 0;
+	timerService_timer_t* timer = __atomic_exchange_n(&requestList, (timerService_timer_t*) NULL, __ATOMIC_ACQUIRE);
+	while (timer) {
+		timer->requested = false;
+		timer = timer->nextRequest;
+	}
+	callbackCount = 0;
+}
+
+void timerService_request(timerService_timer_t* timer) {
+	if (__atomic_exchange_n(&timer->requested, true, __ATOMIC_ACQUIRE))
+		return;	// Already on the list.
+	timerService_timer_t* head = __atomic_load_n(&requestList, __ATOMIC_RELAXED);
+	do {
+		timer->nextRequest = head;
+	} while (!__atomic_compare_exchange_n(&requestList, &head, timer, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+void timerService_scheduleTicks(timerService_timer_t* timer, uint32_t tickCount) {
+	if (timer->heapIndex >= 0)
+		heapRemove(timer);
+	if (heapCount == TIMERSERVICE_MAX_TIMER_COUNT) {
+		printf("timerService_scheduleTicks: more than %d timers.\n\r", TIMERSERVICE_MAX_TIMER_COUNT);
+		return;
+	}
+	timer->deadline = dispatchTime + (uint64_t) tickCount * GLOBAL_TICKS_PER_TICK - DEADLINE_GUARD;
+	heap[heapCount] = timer;
+	siftUp(heapCount++);
+}
+
+void timerService_cancel(timerService_timer_t* timer) {
+	if (timer->heapIndex >= 0)
+		heapRemove(timer);
+}
+
+bool timerService_scheduled(timerService_timer_t* timer) {
+	return timer->heapIndex >= 0;
+}
+
+void timerService_dispatch() {
+	dispatchTime = globalTimer_getTimerValue();
+	if (requestList) {
+		// Requests made by these callbacks go on the new list and run at the next dispatch, like a flag set during a tick.
+		timerService_timer_t* timer = __atomic_exchange_n(&requestList, (timerService_timer_t*) NULL, __ATOMIC_ACQUIRE);
+		while (timer) {
+			timerService_timer_t* next = timer->nextRequest;
+			timer->requested = false;
+			callbackCount++;
+			timer->callback(timer);
+			timer = next;
+		}
+	}
+	while (heapCount && heap[0]->deadline <= dispatchTime) {
+		timerService_timer_t* timer = heap[0];
+		heapRemove(timer);
+		callbackCount++;
+		timer->callback(timer);	// May schedule itself again.
+	}
+}
+
+uint32_t timerService_getCallbackCount() {
+	return callbackCount;
+}
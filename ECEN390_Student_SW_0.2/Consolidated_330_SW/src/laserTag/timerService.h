@@ -0,0 +1,65 @@
+/*
+ * timerService.h
+ */
+
+#ifndef TIMERSERVICE_H_
+#define TIMERSERVICE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "channelPlan.h"
+
+// Deadline service for the state machines (transmitter, hitLedTimer, lockoutTimer, trigger). They used to count
+// 100 kHz ticks toward PULSE_LENGTH, LED_TIME, ... in a tick function. Now each one schedules its next transition
+// and timerService_dispatch(), called from isr_function(), only runs the timers that are due.
+//
+// Deadlines are global-timer values (globalTimer_getTimerValue()) kept in a binary min-heap, so a dispatch with
+// nothing due costs one timer read and one compare.
+// Timing is still counted in ticks (TIMERSERVICE_TICKS_PER_SECOND) to keep the tick functions' behavior:
+// - timerService_request() (from main or from a callback) runs the callback at the next dispatch, which is where
+//   a tick function would have first seen an enable flag.
+// - timerService_scheduleTicks(n) (from a callback) runs it n ticks after the current dispatch. The deadline is
+//   half a tick early so that interrupt-entry jitter cannot push it into the following dispatch.
+// Requests use a lock-free list (the same __atomic builtins as adcRing.h), so main never disables interrupts.
+// The heap is only touched from dispatch context.
+
+#define TIMERSERVICE_TICKS_PER_SECOND CHANNELPLAN_SAMPLE_RATE_HZ	// Timer interrupt rate, the unit of the state machines' times.
+#define TIMERSERVICE_MAX_TIMER_COUNT 8			// Timers that can be scheduled at once.
+
+struct timerService_timer_t;
+typedef void (*timerService_callback_t)(struct timerService_timer_t* timer);
+
+typedef struct timerService_timer_t {
+	timerService_callback_t callback;
+	uint64_t deadline;							// Global-timer value, valid while scheduled.
+	int16_t heapIndex;							// -1 when not scheduled.
+	volatile bool requested;					// On the request list.
+	struct timerService_timer_t* nextRequest;
+} timerService_timer_t;
+
+// Static initializer: static timerService_timer_t timer = TIMERSERVICE_TIMER(callback);
+#define TIMERSERVICE_TIMER(callback) {callback, 0, -1, false, NULL}
+
+// Drops every scheduled timer and pending request.
+void timerService_init();
+
+// Any context. Runs the timer's callback at the next dispatch. Does nothing if the timer is already requested.
+void timerService_request(timerService_timer_t* timer);
+
+// Dispatch context (a callback) only. Runs the callback tickCount (>= 1) ticks after the current dispatch,
+// replacing the timer's previous deadline if it had one.
+void timerService_scheduleTicks(timerService_timer_t* timer, uint32_t tickCount);
+
+// Dispatch context only. Unschedules the timer (pending requests still run).
+void timerService_cancel(timerService_timer_t* timer);
+
+// Dispatch context only. True if the timer has a deadline.
+bool timerService_scheduled(timerService_timer_t* timer);
+
+// Call once per timer interrupt: runs the requests, then every timer whose deadline has passed, earliest first.
+void timerService_dispatch();
+
+// Number of callbacks dispatch has run, for measuring how often the state machines actually do something.
+uint32_t timerService_getCallbackCount();
+
+#endif /* TIMERSERVICE_H_ */
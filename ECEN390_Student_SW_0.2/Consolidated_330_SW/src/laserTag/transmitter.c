@@ -12,29 +12,82 @@
 #include "supportFiles/mio.h"
 #include "supportFiles/utils.h"
 #include <stdio.h>
+#include "timerService.h"
+#include "profiler.h"
+#ifdef TRANSMITTER_USE_PL_TIMER
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xtmrctr_l.h"
+#endif
 
 #define TRANSMITTER_OUTPUT_PIN 13
 #define TRANSMITTER_HIGH_VALUE 1
 #define TRANSMITTER_LOW_VALUE 0
-#define PULSE_LENGTH 20000
-#define PLAYER_FREQUENCIES 10
+#define PULSE_LENGTH CHANNELPLAN_MS_TO_TICKS(200)
+#define PLAYER_FREQUENCIES CHANNELPLAN_CHANNEL_COUNT
 
 // States for the controller state machine.
 enum transmitterStates {
-	init_st,                 // Start here, stay in this state for just one tick.
+	init_st,                 // Idle until transmitter_run() requests a pulse.
 	high_st,
 	low_st
 } transmitterState = init_st;
 
-static bool enableFlag = false;
-static uint16_t count = 0;
+static void transmitter_transition(timerService_timer_t* timer);
+
+static volatile bool enableFlag = false;
+static uint16_t edgesLeft = 0;	// Edges still to come in the current pulse.
 static uint8_t freqIndex = 0;
+static timerService_timer_t transitionTimer = TIMERSERVICE_TIMER(transmitter_transition);
+
+const uint8_t freq[PLAYER_FREQUENCIES] = CHANNELPLAN_HALF_PERIOD_TICKS;
+
+// The pulse for one frequency: high, then edgeCount toggles halfPeriodTicks apart, then low lastSegmentTicks after
+// the last toggle. Same edges as toggling at every multiple of freq[] below PULSE_LENGTH and stopping at PULSE_LENGTH.
+typedef struct {
+	uint16_t halfPeriodTicks;
+	uint16_t edgeCount;
+	uint16_t lastSegmentTicks;	// 1 to halfPeriodTicks.
+} toggleSchedule_t;
+
+static toggleSchedule_t schedules[PLAYER_FREQUENCIES];
+
+#ifdef TRANSMITTER_USE_PL_TIMER
+#define PWM_CONTROL (XTC_CSR_ENABLE_PWM_MASK | XTC_CSR_EXT_GENERATE_MASK | XTC_CSR_DOWN_COUNT_MASK | \
+		XTC_CSR_AUTO_RELOAD_MASK)
+
+static void writePwmRegister(uint8_t counter, uint32_t registerOffset, uint32_t value) {
+	Xil_Out32(TRANSMITTER_PWM_TIMER_BASEADDR + counter * XTC_TIMER_COUNTER_OFFSET + registerOffset, value);
+}
+
+// Loads both counters and starts them together: counter 0 sets the period, counter 1 the high time.
+static void pwmStart(uint16_t halfPeriodTicks) {
+	writePwmRegister(0, XTC_TLR_OFFSET, TRANSMITTER_PWM_PERIOD_LOAD(halfPeriodTicks));
+	writePwmRegister(1, XTC_TLR_OFFSET, TRANSMITTER_PWM_HIGH_LOAD(halfPeriodTicks));
+	writePwmRegister(0, XTC_TCSR_OFFSET, PWM_CONTROL | XTC_CSR_LOAD_MASK);
+	writePwmRegister(1, XTC_TCSR_OFFSET, PWM_CONTROL | XTC_CSR_LOAD_MASK);
+	writePwmRegister(0, XTC_TCSR_OFFSET, PWM_CONTROL | XTC_CSR_ENABLE_ALL_MASK);
+}
 
-const uint8_t freq[PLAYER_FREQUENCIES] = {45,36,29,25,22,19,17,15,14,13};
+// Stops both counters, which takes pwm0 low.
+static void pwmStop() {
+	writePwmRegister(0, XTC_TCSR_OFFSET, PWM_CONTROL);
+	writePwmRegister(1, XTC_TCSR_OFFSET, PWM_CONTROL);
+}
+#endif
 
 void transmitter_init() {
 	mio_init(false);  // false disables any debug printing if there is a system failure during init.
 	mio_setPinAsOutput(TRANSMITTER_OUTPUT_PIN);  // Configure the signal direction of the pin to be an output.
+	// The only divides: the edges strictly inside the pulse, and what is left after the last one.
+	for (uint16_t i=0; i<PLAYER_FREQUENCIES; i++) {
+		schedules[i].halfPeriodTicks = freq[i];
+		schedules[i].edgeCount = (PULSE_LENGTH - 1) / freq[i];
+		schedules[i].lastSegmentTicks = PULSE_LENGTH - schedules[i].edgeCount * freq[i];
+	}
+#ifdef TRANSMITTER_USE_PL_TIMER
+	pwmStop();
+#endif
 }
 
 void transmitter_set_jf1_to_one() {
@@ -47,7 +100,10 @@ void transmitter_set_jf1_to_zero() {
 
 // Starts the transmitter. Does nothing if the transmitter is already running.
 void transmitter_run() {
+	if (enableFlag)
+		return;
 	enableFlag = true;
+	timerService_request(&transitionTimer);	// The pulse starts at the next tick.
 }
 
 // Returns true if the transmitter is running.
@@ -63,55 +119,56 @@ void transmitter_setFrequencyNumber(uint16_t frequencyNumber) {
 		freqIndex = frequencyNumber;
 }
 
-// Standard tick function.
-void transmitter_tick() {
-	// Perform state action first.
-	switch(transmitterState) {
-	case init_st:
-		break;
-	case high_st:
-		count++;
-		break;
-	case low_st:
-		count++;
-		break;
-	default:
-		printf("transmitter_tick state action: hit default\n\r");
-		break;
-	}
+// Schedules the next edge, or the end of the pulse after the last one.
+static void scheduleNextTransition() {
+	const toggleSchedule_t* schedule = &schedules[freqIndex];
+	timerService_scheduleTicks(&transitionTimer, edgesLeft ? schedule->halfPeriodTicks : schedule->lastSegmentTicks);
+}
 
-	// Perform state update next.
+// Runs at the start of a pulse, at every edge and at the end. Same edges as the old 100 kHz tick function,
+// which toggled the output every freq[freqIndex] ticks and stopped after PULSE_LENGTH ticks.
+static void transmitter_transition(timerService_timer_t* /*timer*/) {
+	PROFILER_BEGIN(PROFILER_ZONE_TRANSMITTER);
 	switch(transmitterState) {
 	case init_st:
-		if(enableFlag) {
-			transmitterState = high_st;
-			transmitter_set_jf1_to_one();
-			count = 0;
-		}
+		transmitterState = high_st;
+#ifdef TRANSMITTER_USE_PL_TIMER
+		pwmStart(schedules[freqIndex].halfPeriodTicks);
+		edgesLeft = 0;
+		timerService_scheduleTicks(&transitionTimer, PULSE_LENGTH);	// The timer makes the edges.
+#else
+		transmitter_set_jf1_to_one();
+		edgesLeft = schedules[freqIndex].edgeCount;
+		scheduleNextTransition();
+#endif
 		break;
 	case high_st:
-		if(count == PULSE_LENGTH) {
+	case low_st:
+		if (!edgesLeft) {
 			enableFlag = false;
+#ifdef TRANSMITTER_USE_PL_TIMER
+			pwmStop();
+#else
 			transmitter_set_jf1_to_zero();
+#endif
 			transmitterState = init_st;
-		} else if(!(count % freq[freqIndex])) {
+		} else if (transmitterState == high_st) {
+			edgesLeft--;
 			transmitter_set_jf1_to_zero();
 			transmitterState = low_st;
-		}
-		break;
-	case low_st:
-		if(count == PULSE_LENGTH) {
-			enableFlag = false;
-			transmitterState = init_st;
-		} else if(!(count % freq[freqIndex])) {
+			scheduleNextTransition();
+		} else {
+			edgesLeft--;
 			transmitter_set_jf1_to_one();
 			transmitterState = high_st;
+			scheduleNextTransition();
 		}
 		break;
 	default:
-		printf("transmitter_tick state update: hit default\n\r");
+		printf("transmitter_transition: hit default\n\r");
 		break;
 	}
+	PROFILER_END(PROFILER_ZONE_TRANSMITTER);
 }
 
 // Tests the transmitter.
@@ -123,20 +180,3 @@ void transmitter_runTest() {
 		utils_msDelay(300);
 	}
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
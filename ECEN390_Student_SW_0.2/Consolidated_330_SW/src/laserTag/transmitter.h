@@ -10,6 +10,22 @@
 
 #define TRANSMITTER_OUTPUT_PIN 13	// JF1 (pg. 25 of ZYBO reference manual).
 #include <stdint.h>
+#include "channelPlan.h"
+
+// The pulse is a precomputed toggle schedule: transmitter_init() works out, for each player frequency, how many
+// half-period edges fit in the pulse and how long the last segment is, so a transition only counts down.
+// Define TRANSMITTER_USE_PL_TIMER to have an AXI timer in PWM mode generate the square wave instead: the timer
+// service then only starts it and stops it PULSE_LENGTH ticks later. That needs a fourth AXI timer in the bitstream
+// (timers 0-2 are the interval timers) with its pwm0 output on JF1 in place of the MIO pin, which the HW3 hardware
+// does not have.
+//#define TRANSMITTER_USE_PL_TIMER
+#define TRANSMITTER_PWM_TIMER_BASEADDR XPAR_AXI_TIMER_3_BASEADDR
+#define TRANSMITTER_PWM_CLOCK_HZ 100000000	// XPAR_AXI_TIMER_*_CLOCK_FREQ_HZ.
+#define TRANSMITTER_PWM_CLOCKS_PER_TICK (TRANSMITTER_PWM_CLOCK_HZ / CHANNELPLAN_SAMPLE_RATE_HZ)
+// Load values for a square wave with the given half-period in ticks. In PWM mode the AXI timer's period is
+// TLR0 + 2 clocks and its high time is TLR1 + 2 clocks.
+#define TRANSMITTER_PWM_PERIOD_LOAD(halfPeriodTicks) (2 * (halfPeriodTicks) * TRANSMITTER_PWM_CLOCKS_PER_TICK - 2)
+#define TRANSMITTER_PWM_HIGH_LOAD(halfPeriodTicks) ((halfPeriodTicks) * TRANSMITTER_PWM_CLOCKS_PER_TICK - 2)
 
 // Standard init function.
 void transmitter_init();
@@ -25,9 +41,6 @@ bool transmitter_running();
 // transmitter stops and transmitter_run() is called again.
 void transmitter_setFrequencyNumber(uint16_t frequencyNumber);
 
-// Standard tick function.
-void transmitter_tick();
-
 // Tests the transmitter.
 void transmitter_runTest();
 
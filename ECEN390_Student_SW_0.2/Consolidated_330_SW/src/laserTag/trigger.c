@@ -6,110 +6,73 @@
  */
 
 #include "trigger.h"
-#include "supportFiles/mio.h"
 #include <stdio.h>
 #include "supportFiles/buttons.h"
 #include "transmitter.h"
+#include "inputs.h"
+#include "profiler.h"
 
-#define TRIGGER_GUN_TRIGGER_MIO_PIN 10
-#define DEBOUNCE_TIME 5000
-#define GUN_TRIGGER_PRESSED 1
-
-// States for the controller state machine.
+// States for the controller state machine. It only runs on the debounced edges from inputs.c.
 enum triggerStates {
-	init_st,
 	waitPress_st,
-	press_st,
-	waitRelease_st,
-	release_st
-} triggerState = init_st;
+	waitRelease_st
+} triggerState = waitPress_st;
+
+static void trigger_inputChanged(uint32_t pressed, uint32_t released, uint32_t state);
 
-static bool enableFlag = false;
-static uint32_t count = 0;
+static volatile bool enableFlag = false;
 static bool ignoreGunInput = false;
 
-// Trigger can be activated by either btn0 or the external gun that is attached to TRIGGER_GUN_TRIGGER_MIO_PIN
+// Trigger can be activated by either btn0 or the external gun that is attached to INPUTS_TRIGGER_MIO_PIN.
 // Gun input is ignored if the gun-input is high when the init() function is invoked.
-bool triggerPressed() {
-	return ((!ignoreGunInput & (mio_readPin(TRIGGER_GUN_TRIGGER_MIO_PIN) == GUN_TRIGGER_PRESSED)) ||
-			(buttons_read() & BUTTONS_BTN0_MASK));
+static bool triggerPressed(uint32_t inputState) {
+	return ((!ignoreGunInput && (inputState & INPUTS_TRIGGER_MASK)) ||
+			(inputState & INPUTS_BUTTON(BUTTONS_BTN0_MASK)));
 }
 
-// Init trigger data-structures.
+// Init trigger data-structures. Call after inputs_init().
 void trigger_init() {
-	mio_setPinAsInput(TRIGGER_GUN_TRIGGER_MIO_PIN);
 	// If the trigger is pressed when trigger_init() is called, assume that the gun is not connected and ignore it.
-	if (triggerPressed()) {
+	if (triggerPressed(inputs_getState())) {
 		ignoreGunInput = true;
 	}
+	inputs_addListener(INPUTS_TRIGGER_MASK | INPUTS_BUTTON(BUTTONS_BTN0_MASK), trigger_inputChanged);
 }
 
 // Enable the trigger state machine. The state-machine does nothing until it is enabled.
 void trigger_enable() {
-	if(!transmitter_running())
-		enableFlag = true;
+	if(transmitter_running() || enableFlag)
+		return;
+	triggerState = waitPress_st;
+	enableFlag = true;
 }
 
-// Standard tick function.
-void trigger_tick() {
-	// Perform state action first.
-	switch(triggerState) {
-	case init_st:
-		break;
-	case waitPress_st:
-		break;
-	case press_st:
-		if(count < DEBOUNCE_TIME)
-			count++;
-		break;
-	case waitRelease_st:
-		break;
-	case release_st:
-		if(count < DEBOUNCE_TIME)
-			count++;
-		break;
-	default:
-		printf("transmitter_tick state action: hit default\n\r");
-		break;
-	}
-
-	// Perform state update next.
+// Called by inputs.c from the timer ISR when the gun or btn0 changes. The edges are already debounced, so a press
+// fires the transmitter right away and the release ends the state machine.
+static void trigger_inputChanged(uint32_t /*pressed*/, uint32_t /*released*/, uint32_t state) {
+	if (!enableFlag)
+		return;
+	PROFILER_BEGIN(PROFILER_ZONE_TRIGGER);
 	switch(triggerState) {
-	case init_st:
-		if(enableFlag) {
-			triggerState = waitPress_st;
-		}
-		break;
 	case waitPress_st:
-		if(triggerPressed()) {
-			triggerState = press_st;
-			count = 0;
-		}
-		break;
-	case press_st:
-		if(count == DEBOUNCE_TIME) {
+		if(triggerPressed(state)) {
 			triggerState = waitRelease_st;
 			//printf("D\n\r");
 			transmitter_run();
 		}
 		break;
 	case waitRelease_st:
-		if(!triggerPressed()) {
-			triggerState = release_st;
-			count = 0;
-		}
-		break;
-	case release_st:
-		if(count == DEBOUNCE_TIME) {
+		if(!triggerPressed(state)) {
 			enableFlag = false;
 			//printf("U\n\r");
-			triggerState = init_st;
+			triggerState = waitPress_st;
 		}
 		break;
 	default:
-		printf("transmitter_tick state update: hit default\n\r");
+		printf("trigger_inputChanged: hit default\n\r");
 		break;
 	}
+	PROFILER_END(PROFILER_ZONE_TRIGGER);
 }
 
 void trigger_runTest() {
@@ -8,15 +8,12 @@
 #ifndef TRIGGER_H_
 #define TRIGGER_H_
 
-// Init trigger data-structures.
+// Init trigger data-structures. Call after inputs_init(), the trigger only sees the debounced edges from inputs.h.
 void trigger_init();
 
 // Enable the trigger state machine. The state-machine does nothing until it is enabled.
 void trigger_enable();
 
-// Standard tick function.
-void trigger_tick();
-
 void trigger_runTest();
 
 
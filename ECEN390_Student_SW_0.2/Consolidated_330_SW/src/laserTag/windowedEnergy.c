@@ -0,0 +1,186 @@
+/*
+ * windowedEnergy.c
+ */
+
+#include "windowedEnergy.h"
+#include "queue.h"
+#include "detectorCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "supportFiles/globalTimer.h"
+
+#define WINDOW_LENGTH WINDOWEDENERGY_WINDOW_LENGTH
+#define CHANNEL_COUNT FILTER_IIR_FILTER_COUNT
+
+#ifdef WINDOWEDENERGY_USE_EXPONENTIAL
+static double energy[CHANNEL_COUNT];
+static double average[CHANNEL_COUNT];	// Exponential moving average of the squares.
+#else
+static detectorCore::SlidingEnergy<CHANNEL_COUNT, WINDOW_LENGTH> window;	// The sliding mode is in detectorCore.h.
+#endif
+
+void windowedEnergy_init() {
+#ifdef WINDOWEDENERGY_USE_EXPONENTIAL
+	for (uint16_t c=0; c<CHANNEL_COUNT; c++) {
+		energy[c] = 0.0;
+		average[c] = 0.0;
+	}
+#else
+	window.init();
+#endif
+}
+
+void windowedEnergy_addSample(const float z[]) {
+#ifdef WINDOWEDENERGY_USE_EXPONENTIAL
+	const double alpha = 1.0 / WINDOW_LENGTH;
+	for (uint16_t c=0; c<CHANNEL_COUNT; c++) {
+		float square = z[c] * z[c];
+		average[c] += alpha * (square - average[c]);
+		energy[c] = WINDOW_LENGTH * average[c];
+	}
+#else
+	window.addSample(z);
+#endif
+}
+
+double windowedEnergy_getEnergy(uint16_t channel) {
+#ifdef WINDOWEDENERGY_USE_EXPONENTIAL
+	return energy[channel];
+#else
+	return window.getEnergy(channel);
+#endif
+}
+
+double windowedEnergy_recompute(uint16_t channel) {
+#ifdef WINDOWEDENERGY_USE_EXPONENTIAL
+	return energy[channel];
+#else
+	return window.recompute(channel);
+#endif
+}
+
+/*=============================================================================
+ * ================= Test Routines Start Here =================================
+ ==============================================================================*/
+
+#define TEST_STEADY_SAMPLE_COUNT (6*WINDOW_LENGTH)	// Steady tones first, long enough for the exponential average to settle.
+#define TEST_BURST_SAMPLE_COUNT (3*WINDOW_LENGTH+777)	// Then bursts that move the loudest channel around.
+#define TEST_BURST_LENGTH 3000
+#define TEST_NOISE_AMPLITUDE 0.001
+#define TEST_MAX_RELATIVE_ERROR 1.0E-5			// vs. the loudest channel, sliding mode.
+#define TEST_MAX_EXPONENTIAL_ERROR 0.05			// Exponential vs. window sum on the steady tones.
+#define TEST_TIE_MARGIN 1.0E-4					// Loudest channels closer than this are a tie, either answer is fine.
+
+// One synthesized IIR output: a tone per channel whose amplitude depends on the channel, plus noise.
+// During the burst part, channel (t / TEST_BURST_LENGTH) % CHANNEL_COUNT gets much louder for a while.
+static float testOutput(uint32_t t, uint16_t channel) {
+	double amplitude = 0.02 * (channel + 1);
+	if (t >= TEST_STEADY_SAMPLE_COUNT) {
+		uint32_t burstTime = t - TEST_STEADY_SAMPLE_COUNT;
+		if ((burstTime / TEST_BURST_LENGTH) % CHANNEL_COUNT == channel && burstTime % TEST_BURST_LENGTH < TEST_BURST_LENGTH / 2)
+			amplitude = 1.0;
+	}
+	double noise = TEST_NOISE_AMPLITUDE * ((double) rand() / RAND_MAX - 0.5);
+	return (float) (amplitude * sin(0.05 * (channel + 1) * t) + noise);
+}
+
+static uint16_t loudestChannel(const double values[], bool* tie) {
+	uint16_t max = 0;
+	for (uint16_t c=1; c<CHANNEL_COUNT; c++)
+		if (values[c] > values[max])
+			max = c;
+	*tie = false;
+	for (uint16_t c=0; c<CHANNEL_COUNT; c++)
+		if (c != max && values[max] - values[c] <= TEST_TIE_MARGIN * values[max])
+			*tie = true;
+	return max;
+}
+
+bool windowedEnergy_runTest() {
+	bool success = true;	// Be optimistic.
+	printf("windowedEnergy_runTest: windowed energy vs. sliding queue_t of doubles.\n\r");
+	// The reference is what filter_computePower() used to do: a double queue per channel, add the newest square
+	// and subtract the square that fell out.
+	queue_t referenceQueue[CHANNEL_COUNT];
+	double referenceEnergy[CHANNEL_COUNT];
+	for (uint16_t c=0; c<CHANNEL_COUNT; c++) {
+		queue_init(&referenceQueue[c], WINDOW_LENGTH);
+		for (uint32_t i=0; i<WINDOW_LENGTH; i++)
+			queue_overwritePush(&referenceQueue[c], 0.0);
+		referenceEnergy[c] = 0.0;
+	}
+	windowedEnergy_init();
+	srand(1);
+	double maxRelativeError = 0.0;
+	uint32_t loudestMismatchCount = 0, tieCount = 0;
+	u64 referenceTicks = 0, windowedTicks = 0;
+	globalTimer_startTimer(false);	// Used to count cycles, false = no status message.
+	for (uint32_t t=0; t<TEST_STEADY_SAMPLE_COUNT+TEST_BURST_SAMPLE_COUNT; t++) {
+		float z[CHANNEL_COUNT];
+		for (uint16_t c=0; c<CHANNEL_COUNT; c++)
+			z[c] = testOutput(t, c);
+		u64 startTime = globalTimer_getTimerValue();
+		for (uint16_t c=0; c<CHANNEL_COUNT; c++) {
+			double oldest = queue_readElementAt(&referenceQueue[c], 0);
+			queue_overwritePush(&referenceQueue[c], z[c]);
+			referenceEnergy[c] += (double) z[c] * z[c] - oldest * oldest;
+		}
+		u64 midTime = globalTimer_getTimerValue();
+		windowedEnergy_addSample(z);
+		u64 endTime = globalTimer_getTimerValue();
+		referenceTicks += midTime - startTime;
+		windowedTicks += endTime - midTime;
+		double windowed[CHANNEL_COUNT];
+		for (uint16_t c=0; c<CHANNEL_COUNT; c++)
+			windowed[c] = windowedEnergy_getEnergy(c);
+#ifdef WINDOWEDENERGY_USE_EXPONENTIAL
+		// Only comparable once the tones have been steady for a while.
+		if (t != TEST_STEADY_SAMPLE_COUNT-1)
+			continue;
+		bool tie;
+		uint16_t loudest = loudestChannel(referenceEnergy, &tie);
+		for (uint16_t c=0; c<CHANNEL_COUNT; c++) {
+			double relativeError = fabs(windowed[c] - referenceEnergy[c]) / referenceEnergy[c];
+			if (relativeError > maxRelativeError)
+				maxRelativeError = relativeError;
+		}
+		if (maxRelativeError > TEST_MAX_EXPONENTIAL_ERROR)
+			success = false;
+#else
+		bool tie;
+		uint16_t loudest = loudestChannel(referenceEnergy, &tie);
+		for (uint16_t c=0; c<CHANNEL_COUNT; c++) {
+			double relativeError = fabs(windowed[c] - referenceEnergy[c]) / referenceEnergy[loudest];
+			if (relativeError > maxRelativeError)
+				maxRelativeError = relativeError;
+		}
+		if (maxRelativeError > TEST_MAX_RELATIVE_ERROR)
+			success = false;
+#endif
+		// The detector only cares about which channel is loudest.
+		bool windowedTie;
+		if (tie)
+			tieCount++;
+		else if (loudestChannel(windowed, &windowedTie) != loudest)
+			loudestMismatchCount++;
+	}
+	if (loudestMismatchCount)
+		success = false;
+	uint32_t sampleCount = TEST_STEADY_SAMPLE_COUNT + TEST_BURST_SAMPLE_COUNT;
+#ifdef WINDOWEDENERGY_USE_EXPONENTIAL
+	printf("Exponential mode: max error %le of the window sum on steady tones.\n\r", maxRelativeError);
+#else
+	printf("Sliding mode: max error %le of the loudest channel over %lu samples.\n\r", maxRelativeError,
+			(unsigned long) sampleCount);
+#endif
+	printf("Loudest channel differs on %lu samples (%lu ties skipped).\n\r", (unsigned long) loudestMismatchCount,
+			(unsigned long) tieCount);
+	printf("Cycles per sample (all channels): queue_t %llu, windowedEnergy %llu\n\r",
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * referenceTicks / sampleCount,
+			GLOBAL_TIMER_CPU_CYCLES_PER_TICK * windowedTicks / sampleCount);
+	for (uint16_t c=0; c<CHANNEL_COUNT; c++)
+		gueue_garbageCollect(&referenceQueue[c]);
+	printf("windowedEnergy_runTest %s.\n\r", success ? "passed" : "failed");
+	return success;
+}
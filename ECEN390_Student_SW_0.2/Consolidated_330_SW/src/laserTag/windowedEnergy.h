@@ -0,0 +1,47 @@
+/*
+ * windowedEnergy.h
+ */
+
+#ifndef WINDOWEDENERGY_H_
+#define WINDOWEDENERGY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "filter.h"
+
+// Energy (sum of squares) of the IIR outputs over the last WINDOWEDENERGY_WINDOW_LENGTH decimated samples,
+// for all of the channels at once. O(1) per sample, no matter how long the window is.
+//
+// Sliding mode (default): the squared outputs are kept in float, interleaved [sample][channel], so each new
+// sample writes one row and reads back the row that falls out of the window, both contiguous.
+// The running sums are double. To keep rounding from drifting them, a second sum is restarted every time
+// the history wraps. When it wraps again that sum covers exactly the window, so it replaces the running sum.
+// This mode is the SlidingEnergy template of detectorCore.h.
+//
+// Exponential mode: energy = N * (exponential moving average of the squares), alpha = 1/N. No history at all,
+// but the result is only an approximation of the window sum (it weights recent samples more and decays instead of
+// dropping old samples). Comparable to the window sum for a steady signal, so the same thresholds work.
+
+#define WINDOWEDENERGY_WINDOW_LENGTH CHANNELPLAN_POWER_WINDOW_LENGTH	// 2 s at the 100 kHz / 10 decimated rate.
+
+// Uncomment to use the exponential estimator instead of the exact sliding window (saves the 800 KB history).
+//#define WINDOWEDENERGY_USE_EXPONENTIAL
+
+// Clears the history and the sums.
+void windowedEnergy_init();
+
+// Adds one IIR output for every channel (FILTER_IIR_FILTER_COUNT values) and updates all of the energies.
+void windowedEnergy_addSample(const float z[]);
+
+// Current energy for one channel.
+double windowedEnergy_getEnergy(uint16_t channel);
+
+// Recomputes the energy for one channel from the history and returns it. Only needed for debugging,
+// the drift correction already does this for free. Just returns the current energy in exponential mode.
+double windowedEnergy_recompute(uint16_t channel);
+
+// Compares the energies against the old double-precision sliding queues (queue_t) on synthesized IIR outputs,
+// checks that the loudest channel is the same on every sample and prints the cycles per sample for both.
+bool windowedEnergy_runTest();
+
+#endif /* WINDOWEDENERGY_H_ */
@@ -471,17 +471,15 @@ void Adafruit_TFTLCD::flood(uint16_t color, uint32_t len) {
     	LCD_strobeWriteLine(); LCD_strobeWriteLine();
     }
   } else {
-    while(blocks--) {
-      i = 16; // 64 pixels/block / 4 pixels/pass
-      do {
-        write8(hi); write8(lo); write8(hi); write8(lo);
-        write8(hi); write8(lo); write8(hi); write8(lo);
-      } while(--i);
-    }
-    for(i = (uint8_t)len & 63; i--; ) {
-      write8(hi);
-      write8(lo);
+    // One block of the color, sent with LCD_writeBurst() as many times as needed. BLH
+    uint8_t block[64 * 2];
+    for(i = 0; i < 64; i++) {
+      block[2 * i] = hi;
+      block[2 * i + 1] = lo;
     }
+    while(blocks--)
+      LCD_writeBurst(block, sizeof(block));
+    LCD_writeBurst(block, ((uint8_t)len & 63) * 2);
   }
 //  CS_IDLE;
 }
@@ -702,16 +700,32 @@ void Adafruit_TFTLCD::pushColors(uint16_t *data, uint8_t len, bool first) {
   }
 //  CD_DATA;
   LCD_setDataMode();
-  while(len--) {
-    color = *data++;
-    hi    = color >> 8; // Don't simplify or merge these
-    lo    = color;      // lines, there's macro shenanigans
-    write8(hi);         // going on.
-    write8(lo);
+  // Byte-swap into a buffer and send it as one burst. BLH
+  uint8_t bytes[255 * 2];
+  for(uint16_t i = 0; i < len; i++) {
+    color = data[i];
+    hi    = color >> 8;
+    lo    = color;
+    bytes[2 * i] = hi;
+    bytes[2 * i + 1] = lo;
   }
+  LCD_writeBurst(bytes, (size_t)len * 2);
 //  CS_IDLE;
 }
 
+// Same as pushColors(), for pixels that are already bytes in bus order (high byte first), any length.
+// Only the first call of a series sends the GRAM write command and switches to data mode. BLH
+void Adafruit_TFTLCD::pushBytes(const uint8_t *data, uint32_t len, bool first) {
+  if(first == true) {
+    LCD_setCommandMode();
+    if(driver == ID_932X) write8(0x00);
+    if(driver == ID_9341) write8(0x2C);
+    else                  write8(0x22);
+    LCD_setDataMode();
+  }
+  LCD_writeBurst(data, len);
+}
+
 void Adafruit_TFTLCD::setRotation(uint8_t x) {
 
   // Call parent rotation func first -- sets up rotation flags, etc.
@@ -41,6 +41,7 @@ class Adafruit_TFTLCD : public Adafruit_GFX {
        // These methods are public in order for BMP examples to work:
   void     setAddrWindow(int x1, int y1, int x2, int y2);
   void     pushColors(uint16_t *data, uint8_t len, bool first);
+  void     pushBytes(const uint8_t *data, uint32_t len, bool first);  // Already high byte first. BLH
 
   uint16_t color565(uint8_t r, uint8_t g, uint8_t b),
            readPixel(int16_t x, int16_t y),
@@ -9,6 +9,12 @@
 #include "Adafruit_TFTLCD.h"
 #include "Adafruit_STMPE610.h"
 #include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "globalTimer.h"
+#include "lcd.h"
+#include "framebuffer.h"
+#include "glyphCache.h"
 
 // Just define these values here. They won't change in practice and I want to avoid
 // too much tangling between the LCD control code and the touch-controller code.
@@ -25,45 +31,167 @@
 #define TOUCH_SCREEN_MAX_Y 4095.0
 
 static bool initFlag = false;  // Only allow init to be called once.
-static Adafruit_TFTLCD lcdDisplay = Adafruit_TFTLCD();  // Handle to the LCD display.
+
+// Adafruit_TFTLCD that prints opaque text (a background color set, size up to GLYPHCACHE_MAX_TEXT_SIZE) in glyph runs:
+// the characters that fit on the current line go out in one address window, row by row, from cells expanded once
+// by glyphCache.c. Adafruit_GFX::drawChar() sets up a window for every pixel instead. Transparent text, text that
+// would be clipped, and '\n', '\r' still go through Adafruit_GFX::write().
+class GlyphRunTFTLCD : public Adafruit_TFTLCD {
+ public:
+  // True if drawGlyphRun() can draw count characters at (x, y).
+  bool canDrawGlyphRun(int16_t x, int16_t y, uint16_t count, uint16_t color, uint16_t bg, uint8_t size) {
+    return color != bg && size && size <= GLYPHCACHE_MAX_TEXT_SIZE && count && count <= GLYPHCACHE_ENTRY_COUNT &&
+        x >= 0 && y >= 0 && x + count * GLYPHCACHE_CHAR_WIDTH * size <= _width && y + GLYPHCACHE_CHAR_HEIGHT * size <= _height;
+  }
+
+  void drawGlyphRun(int16_t x, int16_t y, const uint8_t* text, uint16_t count, uint16_t color, uint16_t bg, uint8_t size) {
+    const uint8_t* cells[GLYPHCACHE_ENTRY_COUNT];  // All stay cached: count is at most the cache size.
+    for (uint16_t i=0; i<count; i++)
+      cells[i] = glyphCache_get(text[i], color, bg, size);
+    uint16_t rowBytes = GLYPHCACHE_ROW_BYTES(size);
+    setAddrWindow(x, y, x + count * GLYPHCACHE_CHAR_WIDTH * size - 1, y + GLYPHCACHE_CHAR_HEIGHT * size - 1);
+    bool first = true;
+    for (uint16_t row=0; row<GLYPHCACHE_CHAR_HEIGHT * size; row++) {
+      for (uint16_t i=0; i<count; i++) {
+        pushBytes(cells[i] + row * rowBytes, rowBytes, first);
+        first = false;
+      }
+    }
+  }
+
+  size_t write(uint8_t c) {
+    return write(&c, 1);
+  }
+
+  size_t write(const uint8_t* buffer, size_t size) {
+    size_t written = size;
+    int16_t charWidth = textsize * GLYPHCACHE_CHAR_WIDTH;
+    while (size) {
+      // The characters whose cells fit on this line, up to a newline.
+      uint16_t count = 0;
+      while (count < size && count < GLYPHCACHE_ENTRY_COUNT && buffer[count] != '\n' && buffer[count] != '\r' &&
+          cursor_x + (count + 1) * charWidth <= _width)
+        count++;
+      if (!canDrawGlyphRun(cursor_x, cursor_y, count, textcolor, textbgcolor, textsize)) {
+        Adafruit_GFX::write(*buffer++);
+        size--;
+        continue;
+      }
+      drawGlyphRun(cursor_x, cursor_y, buffer, count, textcolor, textbgcolor, textsize);
+      buffer += count;
+      size -= count;
+      // Only the last character can wrap, the others fit.
+      cursor_x += count * charWidth;
+      if (wrap && (cursor_x > (_width - charWidth))) {
+        cursor_y += textsize * GLYPHCACHE_CHAR_HEIGHT;
+        cursor_x = 0;
+      }
+    }
+    return written;
+  }
+};
+
+static GlyphRunTFTLCD lcdDisplay;  // Handle to the LCD display.
 static Adafruit_STMPE610 touchController = Adafruit_STMPE610();
 
+#ifdef DISPLAY_USE_FRAMEBUFFER
+// Adafruit_GFX on top of framebuffer.c. The GFX shapes end up in drawPixel() and fillRect() here, which are only
+// memory writes, and text goes straight to framebuffer_drawChar() so a character is one dirty rectangle instead of
+// 48 pixels. Starts out 240 x 320 like the TFT, setRotation() swaps the two.
+class FramebufferGFX : public Adafruit_GFX {
+ public:
+  FramebufferGFX() : Adafruit_GFX(240, 320) {}
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {framebuffer_drawPixel(x, y, color);}
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {framebuffer_fillRect(x, y, w, h, color);}
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {framebuffer_fillRect(x, y, 1, h, color);}
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {framebuffer_fillRect(x, y, w, 1, color);}
+  void fillScreen(uint16_t color) {framebuffer_fillRect(0, 0, _width, _height, color);}
+  // Same cursor handling as Adafruit_GFX::write().
+  size_t write(uint8_t c) {
+    if (c == '\n') {
+      cursor_y += textsize*8;
+      cursor_x  = 0;
+    } else if (c != '\r') {
+      framebuffer_drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+      cursor_x += textsize*6;
+      if (wrap && (cursor_x > (_width - textsize*6))) {
+        cursor_y += textsize*8;
+        cursor_x = 0;
+      }
+    }
+    return 1;
+  }
+};
+
+static FramebufferGFX framebufferDisplay;
+#define gfx framebufferDisplay  // Where the drawing calls below go.
+#else
+#define gfx lcdDisplay
+#endif
+
 // Will only execute the body once.
 void display_init() {
   if (!initFlag) {
     lcdDisplay.begin();
     lcdDisplay.setRotation(1);
     touchController.begin();
+#ifdef DISPLAY_USE_FRAMEBUFFER
+    framebufferDisplay.setRotation(1);
+    framebuffer_init(framebufferDisplay.width(), framebufferDisplay.height());  // Black, all dirty.
+#endif
+  }
+}
+
+// Sends the dirty parts of the framebuffer to the TFT, one address window per rectangle, the pixels
+// of each row in bursts.
+void display_flush() {
+#ifdef DISPLAY_USE_FRAMEBUFFER
+  framebuffer_rect_t rects[FRAMEBUFFER_MAX_DIRTY_RECTS];
+  uint16_t count = framebuffer_takeDirtyRects(rects);
+  for (uint16_t i=0; i<count; i++) {
+    framebuffer_rect_t* r = &rects[i];
+    lcdDisplay.setAddrWindow(r->x, r->y, r->x + r->w - 1, r->y + r->h - 1);
+    bool first = true;  // pushColors() sends the GRAM write command with the first chunk.
+    for (int16_t row=r->y; row<r->y+r->h; row++) {
+      const uint16_t* pixels = framebuffer_getRow(row) + r->x;
+      for (int16_t done=0; done<r->w; ) {
+        uint8_t chunk = r->w - done > 255 ? 255 : r->w - done;  // pushColors() takes up to 255.
+        lcdDisplay.pushColors((uint16_t*) pixels + done, chunk, first);
+        first = false;
+        done += chunk;
+      }
+    }
   }
+#endif
 }
 
 // These are functions related to display. Functionality comes from Adafruit_GFX.
 void display_drawPixel(int16_t x0, int16_t y0, uint16_t color) {
-  lcdDisplay.drawPixel(x0, y0, color);
+  gfx.drawPixel(x0, y0, color);
 }
 
 void display_drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
-  lcdDisplay.drawLine(x0, y0, x1, y1, color);
+  gfx.drawLine(x0, y0, x1, y1, color);
 }
 
 void display_drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
-  lcdDisplay.drawFastVLine(x, y, h, color);
+  gfx.drawFastVLine(x, y, h, color);
 }
 
 void display_drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
-  lcdDisplay.drawFastHLine(x, y, w, color);
+  gfx.drawFastHLine(x, y, w, color);
 }
 
 void display_drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-  lcdDisplay.drawRect(x, y, w, h, color);
+  gfx.drawRect(x, y, w, h, color);
 }
 
 void display_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-  lcdDisplay.fillRect(x, y, w, h, color);
+  gfx.fillRect(x, y, w, h, color);
 }
 
 void display_fillScreen(uint16_t color) {
-  lcdDisplay.fillScreen(color);
+  gfx.fillScreen(color);
 }
 
 void display_invertDisplay(bool i) {
@@ -71,73 +199,84 @@ void display_invertDisplay(bool i) {
 }
 
 void display_drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
-  lcdDisplay.drawCircle(x0, y0, r, color);
+  gfx.drawCircle(x0, y0, r, color);
 }
 
 void display_fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
-  lcdDisplay.fillCircle(x0, y0, r, color);
+  gfx.fillCircle(x0, y0, r, color);
 }
 
 void display_drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
 int16_t x2, int16_t y2, uint16_t color) {
-  lcdDisplay.drawTriangle(x0, y0, x1, y1, x2, y2, color);
+  gfx.drawTriangle(x0, y0, x1, y1, x2, y2, color);
 }
 
 void display_fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
 int16_t x2, int16_t y2, uint16_t color) {
-  lcdDisplay.fillTriangle(x0, y0, x1, y1, x2, y2, color);
+  gfx.fillTriangle(x0, y0, x1, y1, x2, y2, color);
 }
 
 void display_drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
 int16_t radius, uint16_t color) {
-  lcdDisplay.drawRoundRect(x0, y0, w, h, radius, color);
+  gfx.drawRoundRect(x0, y0, w, h, radius, color);
 }
 
 void display_fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
 int16_t radius, uint16_t color) {
-  lcdDisplay.fillRoundRect(x0, y0, w, h, radius, color);
+  gfx.fillRoundRect(x0, y0, w, h, radius, color);
 }
 
 void display_drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
 int16_t w, int16_t h, uint16_t color) {
-  lcdDisplay.drawBitmap(x, y, bitmap, w, h, color);
+  gfx.drawBitmap(x, y, bitmap, w, h, color);
 }
 
 void display_drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
 uint16_t bg, uint8_t size) {
-  lcdDisplay.drawChar(x, y, c, color, bg, size);
+#ifdef DISPLAY_USE_FRAMEBUFFER
+  framebuffer_drawChar(x, y, c, color, bg, size);  // Adafruit_GFX::drawChar() would go pixel by pixel.
+#else
+  if (lcdDisplay.canDrawGlyphRun(x, y, 1, color, bg, size))
+    lcdDisplay.drawGlyphRun(x, y, &c, 1, color, bg, size);
+  else
+    lcdDisplay.drawChar(x, y, c, color, bg, size);
+#endif
 }
 
 void display_setCursor(int16_t x, int16_t y) {
-  lcdDisplay.setCursor(x, y);
+  gfx.setCursor(x, y);
 }
 
 void display_setTextColor(uint16_t c) {
-  lcdDisplay.setTextColor(c);
+  gfx.setTextColor(c);
 }
 
 void display_setTextColor(uint16_t c, uint16_t bg) {
-  lcdDisplay.setTextColor(c, bg);
+  gfx.setTextColor(c, bg);
 }
 
 void display_setTextSize(uint8_t s) {
-  lcdDisplay.setTextSize(s);
+  gfx.setTextSize(s);
 }
 
 void display_setTextWrap(bool w) {
-  lcdDisplay.setTextWrap(w);
+  gfx.setTextWrap(w);
 }
 
 void display_setRotation(uint8_t r) {
   lcdDisplay.setRotation(r);
+#ifdef DISPLAY_USE_FRAMEBUFFER
+  framebufferDisplay.setRotation(r);
+  framebuffer_init(framebufferDisplay.width(), framebufferDisplay.height());  // The old contents do not fit anymore.
+#endif
 }
 
 int16_t display_height() {
-  return lcdDisplay.height();
+  return gfx.height();
 }
 
 int16_t display_width() {
-  return lcdDisplay.width();
+  return gfx.width();
 }
 
 // Obscure function name = just packs the RGB data into a 16-bit int.
@@ -146,71 +285,71 @@ uint16_t display_color565(uint8_t r, uint8_t g, uint8_t b) {
 }
 
 size_t display_println(const char str[]) {
-  return lcdDisplay.println(str);
+  return gfx.println(str);
 }
 
 size_t display_println(char c) {
-  return lcdDisplay.println(c);
+  return gfx.println(c);
 }
 
 size_t display_println(unsigned char c, int base) {
-  return lcdDisplay.println(c, base);
+  return gfx.println(c, base);
 }
 
 size_t display_println(int num, int base) {
-  return lcdDisplay.println(num, base);
+  return gfx.println(num, base);
 }
 
 size_t display_println(unsigned int num, int base) {
-  return lcdDisplay.println(num, base);
+  return gfx.println(num, base);
 }
 
 size_t display_println(long num, int base) {
-  return lcdDisplay.println(num, base);
+  return gfx.println(num, base);
 }
 
 size_t display_println(unsigned long num, int base) {
-  return lcdDisplay.println(num, base);
+  return gfx.println(num, base);
 }
 
 size_t display_println(double num, int fieldWidth) {
-  return lcdDisplay.println(num, fieldWidth);
+  return gfx.println(num, fieldWidth);
 }
 
 size_t display_println(void) {
-  return lcdDisplay.println();
+  return gfx.println();
 }
 
 size_t display_print(const char str[]) {
-	return lcdDisplay.print(str);
+	return gfx.print(str);
 }
 
 size_t display_print(char c) {
-	return lcdDisplay.print(c);
+	return gfx.print(c);
 }
 
 size_t display_print(unsigned char c, int base) {
-	return lcdDisplay.print(c, base);
+	return gfx.print(c, base);
 }
 
 size_t display_print(int num, int base) {
-	return lcdDisplay.print(num, base);
+	return gfx.print(num, base);
 }
 
 size_t display_print(unsigned int num, int base) {
-	return lcdDisplay.print(num, base);
+	return gfx.print(num, base);
 }
 
 size_t display_print(long num, int base) {
-	return lcdDisplay.print(num, base);
+	return gfx.print(num, base);
 }
 
 size_t display_print(unsigned long num, int base) {
-	return lcdDisplay.print(num, base);
+	return gfx.print(num, base);
 }
 
 size_t display_print(double num, int fieldWidth) {
-	return lcdDisplay.print(num, fieldWidth);
+	return gfx.print(num, fieldWidth);
 }
 
 
@@ -438,6 +577,65 @@ unsigned long display_testFillScreen() {
   return 0;
 }
 
+// Times display_fillScreen() and prints the fill rate over the UART. Returns pixels per second.
+// Build once with LCD_USE_XGPIO_DRIVER (lcd.h) and once without to compare the two GPIO paths.
+#define FILL_RATE_TEST_SCREENS 10
+unsigned long display_testFillRate() {
+  const uint16_t colors[] = {DISPLAY_RED, DISPLAY_GREEN, DISPLAY_BLUE, DISPLAY_BLACK, DISPLAY_WHITE};  // hi != lo and hi == lo.
+  const uint16_t colorCount = sizeof(colors) / sizeof(colors[0]);
+  globalTimer_startTimer(false);
+  u64 startTime = globalTimer_getTimerValue();
+  for (uint16_t i=0; i<FILL_RATE_TEST_SCREENS; i++) {
+    display_fillScreen(colors[i % colorCount]);
+    display_flush();  // Nothing without DISPLAY_USE_FRAMEBUFFER.
+  }
+  u64 ticks = globalTimer_getTimerValue() - startTime;
+  double seconds = (double) ticks / GLOBAL_TIMER_TICKS_PER_SECOND;
+  double pixels = (double) FILL_RATE_TEST_SCREENS * display_width() * display_height();
+  unsigned long pixelsPerSecond = seconds > 0 ? pixels / seconds : 0;
+#ifdef LCD_USE_XGPIO_DRIVER
+  const char* path = "XGpio driver";
+#else
+  const char* path = "shadowed Xil_Out32";
+#endif
+  printf("display_testFillRate (%s): %d screens in %lu ms, %lu pixels/s.\n\r", path, FILL_RATE_TEST_SCREENS,
+      (unsigned long) (seconds * 1000), pixelsPerSecond);
+  return pixelsPerSecond;
+}
+
+// Times the same screen of opaque text drawn with Adafruit_GFX::drawChar(), one character at a time, and as glyph
+// runs, and prints characters per second for both over the UART. Returns the glyph-run rate.
+#define TEXT_RATE_TEST_SIZE 1
+unsigned long display_testTextRate() {
+  const char* line = "Cumulative run time in timerIsr: 3.51 (8.32%)";  // Like printRunTimeStatistics().
+  const uint16_t length = strlen(line);
+  const uint16_t lines = lcdDisplay.height() / (GLYPHCACHE_CHAR_HEIGHT * TEXT_RATE_TEST_SIZE);
+  const int16_t charWidth = GLYPHCACHE_CHAR_WIDTH * TEXT_RATE_TEST_SIZE;
+  globalTimer_startTimer(false);
+  display_fillScreen(DISPLAY_BLACK);
+  u64 startTime = globalTimer_getTimerValue();
+  for (uint16_t y=0; y<lines; y++)
+    for (uint16_t i=0; i<length; i++)
+      lcdDisplay.drawChar(i * charWidth, y * GLYPHCACHE_CHAR_HEIGHT * TEXT_RATE_TEST_SIZE, line[i], DISPLAY_WHITE,
+          DISPLAY_BLACK, TEXT_RATE_TEST_SIZE);
+  u64 drawCharTicks = globalTimer_getTimerValue() - startTime;
+  display_fillScreen(DISPLAY_BLACK);
+  glyphCache_clear();
+  startTime = globalTimer_getTimerValue();
+  for (uint16_t y=0; y<lines; y++)
+    lcdDisplay.drawGlyphRun(0, y * GLYPHCACHE_CHAR_HEIGHT * TEXT_RATE_TEST_SIZE, (const uint8_t*) line, length, DISPLAY_WHITE,
+        DISPLAY_BLACK, TEXT_RATE_TEST_SIZE);
+  u64 glyphRunTicks = globalTimer_getTimerValue() - startTime;
+  double chars = (double) lines * length;
+  unsigned long drawCharRate = drawCharTicks ? chars * GLOBAL_TIMER_TICKS_PER_SECOND / drawCharTicks : 0;
+  unsigned long glyphRunRate = glyphRunTicks ? chars * GLOBAL_TIMER_TICKS_PER_SECOND / glyphRunTicks : 0;
+  uint32_t hits, misses;
+  glyphCache_getStats(&hits, &misses);
+  printf("display_testTextRate: %lu chars, drawChar %lu chars/s, glyph runs %lu chars/s, cache %lu hits %lu misses.\n\r",
+      (unsigned long) chars, drawCharRate, glyphRunRate, (unsigned long) hits, (unsigned long) misses);
+  return glyphRunRate;
+}
+
 unsigned long display_testText() {
   display_fillScreen(DISPLAY_BLACK);
   display_setCursor(0, 0);
@@ -29,9 +29,18 @@
 // will be C-like, with a functional interface that does not require the user to use constructors or objects.
 // These functions are mostly just wrappers around C++ methods so they can be used for C programming.
 
+// Uncomment to draw into an RGB565 framebuffer in memory (framebuffer.h) instead of straight to the TFT. Nothing shows
+// up until display_flush(), which sends only the rectangles that changed, each with a single address-window setup.
+// Much faster for text: Adafruit_GFX::drawChar() sets up an address window for every pixel of every character.
+//#define DISPLAY_USE_FRAMEBUFFER
+
 // Constructs the necessary LCD and touch-controller objects and performs necessary initializations.
 void display_init();
 
+// Sends what changed in the framebuffer to the TFT. Does nothing unless DISPLAY_USE_FRAMEBUFFER is defined, so code
+// that draws can always call it when it is done with a frame.
+void display_flush();
+
 // The functionality for these functions comes from Adafruit_GFX.cpp and Adafruit_TFTLCD.cpp.
 void
   display_drawPixel(int16_t x0, int16_t y0, uint16_t color),
@@ -98,6 +107,8 @@ void
   unsigned long display_testRoundRects();
   unsigned long display_testFilledRoundRects();
   unsigned long display_testFillScreen();
+  unsigned long display_testFillRate();  // Pixels per second of display_fillScreen(), also printed.
+  unsigned long display_testTextRate();  // Characters per second, drawChar() against glyph runs, also printed.
   unsigned long display_testText();
 
 // The functionality for these routines comes from Adafruit_STMPE610 (touch controller).
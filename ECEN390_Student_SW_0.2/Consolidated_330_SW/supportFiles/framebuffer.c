@@ -0,0 +1,182 @@
+/*
+ * framebuffer.c
+ */
+
+#include "framebuffer.h"
+#include "glcdfont.c"
+
+#define CHAR_WIDTH 6   // 5 font columns and a blank one.
+#define CHAR_HEIGHT 8
+
+static uint16_t pixels[FRAMEBUFFER_MAX_WIDTH * FRAMEBUFFER_MAX_HEIGHT];
+static int16_t width = FRAMEBUFFER_MAX_WIDTH;
+static int16_t height = FRAMEBUFFER_MAX_HEIGHT;
+static framebuffer_rect_t dirtyRects[FRAMEBUFFER_MAX_DIRTY_RECTS];
+static uint16_t dirtyRectCount = 0;
+
+static int32_t area(const framebuffer_rect_t* r) {
+  return (int32_t) r->w * r->h;
+}
+
+static framebuffer_rect_t rectUnion(const framebuffer_rect_t* a, const framebuffer_rect_t* b) {
+  int16_t x1 = a->x < b->x ? a->x : b->x;
+  int16_t y1 = a->y < b->y ? a->y : b->y;
+  int16_t x2 = a->x + a->w > b->x + b->w ? a->x + a->w : b->x + b->w;
+  int16_t y2 = a->y + a->h > b->y + b->h ? a->y + a->h : b->y + b->h;
+  framebuffer_rect_t u = {x1, y1, (int16_t) (x2 - x1), (int16_t) (y2 - y1)};
+  return u;
+}
+
+static bool overlaps(const framebuffer_rect_t* a, const framebuffer_rect_t* b) {
+  return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+static bool contains(const framebuffer_rect_t* outer, const framebuffer_rect_t* inner) {
+  return inner->x >= outer->x && inner->y >= outer->y && inner->x + inner->w <= outer->x + outer->w &&
+      inner->y + inner->h <= outer->y + outer->h;
+}
+
+// Clips to the screen. Returns false if nothing is left.
+static bool clip(framebuffer_rect_t* r) {
+  if (r->x < 0) {
+    r->w += r->x;
+    r->x = 0;
+  }
+  if (r->y < 0) {
+    r->h += r->y;
+    r->y = 0;
+  }
+  if (r->x + r->w > width)
+    r->w = width - r->x;
+  if (r->y + r->h > height)
+    r->h = height - r->y;
+  return r->w > 0 && r->h > 0;
+}
+
+// Keeps the list free of overlaps: a new rectangle absorbs every rectangle it overlaps, or that it can be merged with
+// for at most FRAMEBUFFER_DIRTY_MERGE_SLACK extra pixels, until there are none left. When the list is full, the
+// rectangle that grows the least takes it.
+static void addDirtyRect(framebuffer_rect_t r) {
+  for (uint16_t i=0; i<dirtyRectCount; i++)
+    if (contains(&dirtyRects[i], &r))
+      return;  // Common case: another pixel of what was just drawn.
+  while (true) {
+    bool merged = false;
+    for (uint16_t i=0; i<dirtyRectCount; i++) {
+      framebuffer_rect_t u = rectUnion(&r, &dirtyRects[i]);
+      if (overlaps(&r, &dirtyRects[i]) || area(&u) <= area(&r) + area(&dirtyRects[i]) + FRAMEBUFFER_DIRTY_MERGE_SLACK) {
+        r = u;
+        dirtyRects[i] = dirtyRects[--dirtyRectCount];
+        merged = true;
+        break;
+      }
+    }
+    if (merged)
+      continue;
+    if (dirtyRectCount < FRAMEBUFFER_MAX_DIRTY_RECTS)
+      break;
+    uint16_t best = 0;
+    int32_t bestGrowth = INT32_MAX;
+    for (uint16_t i=0; i<dirtyRectCount; i++) {
+      framebuffer_rect_t u = rectUnion(&r, &dirtyRects[i]);
+      int32_t growth = area(&u) - area(&dirtyRects[i]);
+      if (growth < bestGrowth) {
+        bestGrowth = growth;
+        best = i;
+      }
+    }
+    r = rectUnion(&r, &dirtyRects[best]);
+    dirtyRects[best] = dirtyRects[--dirtyRectCount];  // The union may overlap others now, go around again.
+  }
+  dirtyRects[dirtyRectCount++] = r;
+}
+
+void framebuffer_init(int16_t newWidth, int16_t newHeight) {
+  width = newWidth;
+  height = newHeight;
+  if ((int32_t) width * height > FRAMEBUFFER_MAX_WIDTH * FRAMEBUFFER_MAX_HEIGHT) {
+    width = FRAMEBUFFER_MAX_WIDTH;
+    height = FRAMEBUFFER_MAX_HEIGHT;
+  }
+  for (int32_t i=0; i<(int32_t) width * height; i++)
+    pixels[i] = 0;
+  dirtyRectCount = 0;
+  framebuffer_markDirty(0, 0, width, height);
+}
+
+int16_t framebuffer_width() {
+  return width;
+}
+
+int16_t framebuffer_height() {
+  return height;
+}
+
+void framebuffer_drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= width || y >= height)
+    return;
+  pixels[(int32_t) y * width + x] = color;
+  framebuffer_rect_t r = {x, y, 1, 1};
+  addDirtyRect(r);
+}
+
+void framebuffer_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  framebuffer_rect_t r = {x, y, w, h};
+  if (!clip(&r))
+    return;
+  for (int16_t row=r.y; row<r.y+r.h; row++) {
+    uint16_t* p = &pixels[(int32_t) row * width + r.x];
+    for (int16_t column=0; column<r.w; column++)
+      p[column] = color;
+  }
+  addDirtyRect(r);
+}
+
+void framebuffer_drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+  framebuffer_rect_t cell = {x, y, (int16_t) (CHAR_WIDTH * size), (int16_t) (CHAR_HEIGHT * size)};
+  if (!clip(&cell))
+    return;
+  for (int16_t column=0; column<CHAR_WIDTH; column++) {
+    uint8_t line = column < CHAR_WIDTH - 1 ? font[c * 5 + column] : 0;
+    for (int16_t row=0; row<CHAR_HEIGHT; row++, line >>= 1) {
+      if (!(line & 0x1) && bg == color)
+        continue;  // Transparent background.
+      uint16_t pixelColor = (line & 0x1) ? color : bg;
+      for (int16_t dy=0; dy<size; dy++) {
+        int16_t py = y + row * size + dy;
+        if (py < 0 || py >= height)
+          continue;
+        for (int16_t dx=0; dx<size; dx++) {
+          int16_t px = x + column * size + dx;
+          if (px >= 0 && px < width)
+            pixels[(int32_t) py * width + px] = pixelColor;
+        }
+      }
+    }
+  }
+  addDirtyRect(cell);  // The whole cell, one entry instead of one per pixel.
+}
+
+uint16_t framebuffer_getPixel(int16_t x, int16_t y) {
+  if (x < 0 || y < 0 || x >= width || y >= height)
+    return 0;
+  return pixels[(int32_t) y * width + x];
+}
+
+const uint16_t* framebuffer_getRow(int16_t y) {
+  return &pixels[(int32_t) y * width];
+}
+
+void framebuffer_markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  framebuffer_rect_t r = {x, y, w, h};
+  if (clip(&r))
+    addDirtyRect(r);
+}
+
+uint16_t framebuffer_takeDirtyRects(framebuffer_rect_t rects[FRAMEBUFFER_MAX_DIRTY_RECTS]) {
+  uint16_t count = dirtyRectCount;
+  for (uint16_t i=0; i<count; i++)
+    rects[i] = dirtyRects[i];
+  dirtyRectCount = 0;
+  return count;
+}
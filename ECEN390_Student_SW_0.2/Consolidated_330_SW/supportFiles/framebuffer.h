@@ -0,0 +1,49 @@
+/*
+ * framebuffer.h
+ */
+
+#ifndef FRAMEBUFFER_H_
+#define FRAMEBUFFER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// RGB565 copy of the screen in memory, with a list of the rectangles that changed since the last
+// framebuffer_takeDirtyRects(). Drawing here is plain memory writes. display.cpp uses it when DISPLAY_USE_FRAMEBUFFER
+// is defined, and display_flush() sends each dirty rectangle to the TFT with one address-window setup.
+// Pixels are stored row by row in the current orientation, (0, 0) top left, same as the display_* coordinates.
+// No hardware is touched here, so the host build uses it as is (see src/hostSim/framebufferTest.c).
+
+#define FRAMEBUFFER_MAX_WIDTH 320
+#define FRAMEBUFFER_MAX_HEIGHT 240
+#define FRAMEBUFFER_MAX_DIRTY_RECTS 16
+#define FRAMEBUFFER_DIRTY_MERGE_SLACK 64	// Pixels two rectangles may waste and still be merged into one.
+
+typedef struct {
+  int16_t x, y, w, h;
+} framebuffer_rect_t;
+
+// Sets the size (width * height must fit in FRAMEBUFFER_MAX_WIDTH * FRAMEBUFFER_MAX_HEIGHT), clears the pixels to 0
+// (DISPLAY_BLACK) and marks the whole screen dirty.
+void framebuffer_init(int16_t width, int16_t height);
+
+int16_t framebuffer_width();
+int16_t framebuffer_height();
+
+// Drawing, clipped to the screen. Same results as the Adafruit_GFX calls with the same names.
+void framebuffer_drawPixel(int16_t x, int16_t y, uint16_t color);
+void framebuffer_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+// Text size 1 is a 6 x 8 cell, glyphs from glcdfont.c. bg == color leaves the background alone.
+void framebuffer_drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+uint16_t framebuffer_getPixel(int16_t x, int16_t y);
+// framebuffer_width() pixels starting at (0, y).
+const uint16_t* framebuffer_getRow(int16_t y);
+
+// Adds a rectangle to the dirty list (clipped). The drawing calls do this themselves.
+void framebuffer_markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// Copies out the dirty rectangles, which do not overlap, and empties the list. Returns how many there were.
+uint16_t framebuffer_takeDirtyRects(framebuffer_rect_t rects[FRAMEBUFFER_MAX_DIRTY_RECTS]);
+
+#endif /* FRAMEBUFFER_H_ */
@@ -16,6 +16,8 @@
 #define GLOBAL_TIMER_CLOCK_FREQUENCY (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2)
 // one second equals GLOBAL_TIMER_CLOCK_FREQUENCY ticks (by definition).
 #define GLOBAL_TIMER_TICKS_PER_SECOND GLOBAL_TIMER_CLOCK_FREQUENCY
+// Processor cycles per global timer tick, to print cycle counts from global timer values.
+#define GLOBAL_TIMER_CPU_CYCLES_PER_TICK 2
 
 #define globalTimer_readRegister(registerOffset) \
  Xil_In32(XPAR_GLOBAL_TMR_BASEADDR + registerOffset)
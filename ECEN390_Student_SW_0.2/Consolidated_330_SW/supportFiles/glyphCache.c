@@ -0,0 +1,119 @@
+/*
+ * glyphCache.c
+ */
+
+#include "glyphCache.h"
+#include "glcdfont.c"
+
+#define CELL_BYTES (GLYPHCACHE_ROW_BYTES(GLYPHCACHE_MAX_TEXT_SIZE) * GLYPHCACHE_CHAR_HEIGHT * GLYPHCACHE_MAX_TEXT_SIZE)
+#define BUCKET_COUNT 128				// Power of 2.
+#define NONE 0xFF
+
+typedef struct {
+  uint64_t key;
+  uint8_t newer, older;				// LRU list.
+  uint8_t nextInBucket;
+  uint8_t cell[CELL_BYTES];
+} entry_t;
+
+static entry_t entries[GLYPHCACHE_ENTRY_COUNT];
+static uint8_t buckets[BUCKET_COUNT];
+static uint8_t newest = NONE, oldest = NONE;
+static uint8_t handedOutCount = 0;		// Entries handed out so far, the rest are still free.
+static uint32_t hitCount, missCount;
+static bool initialized = false;
+
+static uint64_t makeKey(unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+  return c | ((uint64_t) size << 8) | ((uint64_t) color << 16) | ((uint64_t) bg << 32);
+}
+
+static uint16_t bucketOf(uint64_t key) {
+  return (uint16_t) ((key * 0x9E3779B97F4A7C15ULL) >> 57) & (BUCKET_COUNT - 1);
+}
+
+static void unlink(uint8_t i) {
+  entry_t* e = &entries[i];
+  if (e->newer != NONE) entries[e->newer].older = e->older; else newest = e->older;
+  if (e->older != NONE) entries[e->older].newer = e->newer; else oldest = e->newer;
+}
+
+static void pushNewest(uint8_t i) {
+  entries[i].newer = NONE;
+  entries[i].older = newest;
+  if (newest != NONE)
+    entries[newest].newer = i;
+  newest = i;
+  if (oldest == NONE)
+    oldest = i;
+}
+
+static void removeFromBucket(uint8_t i) {
+  uint8_t* link = &buckets[bucketOf(entries[i].key)];
+  while (*link != i)
+    link = &entries[*link].nextInBucket;
+  *link = entries[i].nextInBucket;
+}
+
+// Same pixels as Adafruit_GFX::drawChar() with bg != color.
+static void expand(uint8_t* cell, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+  uint16_t width = GLYPHCACHE_CHAR_WIDTH * size;
+  for (uint16_t y=0; y<GLYPHCACHE_CHAR_HEIGHT * size; y++) {
+    uint8_t bit = 1 << (y / size);
+    for (uint16_t x=0; x<width; x++) {
+      uint16_t column = x / size;
+      uint8_t line = column < GLYPHCACHE_CHAR_WIDTH - 1 ? font[c * 5 + column] : 0;
+      uint16_t pixel = (line & bit) ? color : bg;
+      *cell++ = pixel >> 8;
+      *cell++ = pixel;
+    }
+  }
+}
+
+void glyphCache_clear() {
+  for (uint16_t i=0; i<BUCKET_COUNT; i++)
+    buckets[i] = NONE;
+  newest = oldest = NONE;
+  handedOutCount = 0;
+  hitCount = missCount = 0;
+  initialized = true;
+}
+
+const uint8_t* glyphCache_get(unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+  if (!size || size > GLYPHCACHE_MAX_TEXT_SIZE)
+    return 0;
+  if (!initialized)
+    glyphCache_clear();
+  uint64_t key = makeKey(c, color, bg, size);
+  uint16_t bucket = bucketOf(key);
+  for (uint8_t i=buckets[bucket]; i!=NONE; i=entries[i].nextInBucket) {
+    if (entries[i].key == key) {
+      hitCount++;
+      if (newest != i) {
+        unlink(i);
+        pushNewest(i);
+      }
+      return entries[i].cell;
+    }
+  }
+  missCount++;
+  uint8_t i;
+  if (handedOutCount < GLYPHCACHE_ENTRY_COUNT) {
+    i = handedOutCount++;
+  } else {
+    i = oldest;  // Evict the least recently used.
+    unlink(i);
+    removeFromBucket(i);
+  }
+  entry_t* e = &entries[i];
+  e->key = key;
+  e->nextInBucket = buckets[bucket];
+  buckets[bucket] = i;
+  pushNewest(i);
+  expand(e->cell, c, color, bg, size);
+  return e->cell;
+}
+
+void glyphCache_getStats(uint32_t* hits, uint32_t* misses) {
+  *hits = hitCount;
+  *misses = missCount;
+}
@@ -0,0 +1,36 @@
+/*
+ * glyphCache.h
+ */
+
+#ifndef GLYPHCACHE_H_
+#define GLYPHCACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Characters from glcdfont.c expanded into ready-to-send RGB565 cells, kept in a small LRU cache keyed by
+// (character, color, background, size). A cell is 6*size x 8*size pixels, row by row, each pixel high byte first,
+// which is the order the TFT takes them after a GRAM write command. display.cpp sends a whole string with one address
+// window: for each pixel row, the matching row of every character's cell (see display_drawGlyphRun()).
+// Only opaque text is cached; with a transparent background (bg == color) the pixels behind the text are needed.
+// No hardware is touched here, so src/hostSim/glyphCacheTest.c checks it on the host.
+
+#define GLYPHCACHE_ENTRY_COUNT 64		// The statistics screen uses about 40 different characters.
+#define GLYPHCACHE_MAX_TEXT_SIZE 3		// Bigger text is left to Adafruit_GFX::drawChar().
+#define GLYPHCACHE_CHAR_WIDTH 6
+#define GLYPHCACHE_CHAR_HEIGHT 8
+
+// Bytes in one pixel row of a cell.
+#define GLYPHCACHE_ROW_BYTES(size) (GLYPHCACHE_CHAR_WIDTH * (size) * 2)
+
+// Returns the cell, or NULL if size is 0 or bigger than GLYPHCACHE_MAX_TEXT_SIZE. The pointer stays valid until
+// GLYPHCACHE_ENTRY_COUNT other cells have been asked for.
+const uint8_t* glyphCache_get(unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+// Empties the cache and clears the counts.
+void glyphCache_clear();
+
+// Lookups that found the cell already expanded, and ones that had to expand it.
+void glyphCache_getStats(uint32_t* hits, uint32_t* misses);
+
+#endif /* GLYPHCACHE_H_ */
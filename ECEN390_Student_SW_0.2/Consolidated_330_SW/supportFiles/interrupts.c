@@ -45,6 +45,18 @@ static XSysMon xSysMonInst;          // Instance of the system monitor (to acces
 volatile int interrupts_isrFlagGlobal = 0;
 // *********************************** Globals End   ****************************************
 
+// Measurement hooks, see interrupts_setTimerIsrEntryHook() and interrupts_setArmIntsHook(). NULL when not used.
+static void (*timerIsrEntryHook)(uint32_t privateTimerCounterValue) = NULL;
+static void (*armIntsHook)(bool enabled) = NULL;
+
+void interrupts_setTimerIsrEntryHook(void (*hook)(uint32_t privateTimerCounterValue)) {
+  timerIsrEntryHook = hook;
+}
+
+void interrupts_setArmIntsHook(void (*hook)(bool enabled)) {
+  armIntsHook = hook;
+}
+
 // The sysmon (XADC) runs off the bus-clock when accessed via the AXI_XADC IP (as is done here).
 // This default will allow nearly a 26 Mhz clock which is the maximum frequency to achieve 1 megasamples
 // because a single conversion requires 26 clock cycles.
@@ -81,6 +93,9 @@ void interrupts_setPrivateTimerPrescalerValue(u32 prescalerValue) {
   privateTimerTicksPerHeartbeat = (ZYBO_BUS_CLOCK /((privateTimerPrescaler+1) * (privateTimerLoadValue+1))) / HEARTBEAT_TOGGLES_PER_SECOND;
 }
 
+u32 interrupts_getPrivateTimerLoadValue() {return privateTimerLoadValue;}
+u32 interrupts_getPrivateTimerPrescalerValue() {return privateTimerPrescaler;}
+
 u32 interrupts_isrInvocationCount() {return isrInvocationCount;}  // Functional accessor for isrInvocationCount.
 // Accessor to retrieve the number of times the ISR was invoked (same as count of timer ticks).
 u32 interrupts_getPrivateTimerTicksPerSecond() {return ZYBO_BUS_CLOCK /((privateTimerPrescaler+1) * (privateTimerLoadValue+1));}
@@ -165,6 +180,8 @@ void sysMonIsr(void *CallBackRef) {
 // ******************************* Timer ISR ***************************************
 // *********************************************************************************
 void timerIsr(void* callBackRef){
+	if (timerIsrEntryHook)	// First, so the counter is read as close to the entry as possible.
+		timerIsrEntryHook(XScuTimer_GetCounterValue(&TimerInstance));
 #ifdef ENABLE_INTERVAL_TIMER_0_IN_TIMER_ISR  // Enable interval timing when this is defined.
 	intervalTimer_start(0);
 #endif
@@ -355,11 +372,28 @@ int interrupts_initAll(bool printFailedStatusFlag) {
   return 0;
 }
 
+// Connects an ISR for a device that is not handled in this file and enables it at the GIC.
+int interrupts_connectHandler(u32 interruptId, void (*handler)(void* callBackRef), void* callBackRef) {
+  if (!initGicFlag) {
+    printf("interrupts_connectHandler(): call interrupts_initAll() first.\n\r");
+    return XST_FAILURE;
+  }
+  int status = XScuGic_Connect(&InterruptController, interruptId, (Xil_ExceptionHandler) handler, callBackRef);
+  if (status != XST_SUCCESS) {
+    printf("XScuGic_Connect failed (interrupt %lu).\n\r", interruptId);
+    return status;
+  }
+  XScuGic_Enable(&InterruptController, interruptId);
+  return XST_SUCCESS;
+}
+
 // This enables overall ARM interrupts.
 // Checks the init flag to make sure that the user has init'd the GIC.
 int interrupts_enableArmInts() {
   if (initGicFlag) {
     Xil_ExceptionEnable();
+    if (armIntsHook)
+      armIntsHook(true);
     return 0;
   } else {
     printf("Error: Must call initGIC before enableArmInterrupts()\n\r.");
@@ -371,6 +405,8 @@ int interrupts_enableArmInts() {
 // Checks the init flag to make sure that the user has init'd the GIC.
 int interrupts_disableArmInts() {
   if (initGicFlag) {
+    if (armIntsHook)
+      armIntsHook(false);
     Xil_ExceptionDisable();
     return 0;
   } else {
@@ -26,10 +26,20 @@
 // if printFailedStatusFlag is true, it prints out diagnostic messages if something goes awry.
 int interrupts_initAll(bool printFailedStatusFlag);
 
+// Connects handler to GIC interrupt interruptId and enables it at the GIC (not at the device), for devices that
+// are set up outside of this file (e.g., the DMA in adcDma.c). Call after interrupts_initAll().
+int interrupts_connectHandler(u32 interruptId, void (*handler)(void* callBackRef), void* callBackRef);
+
 // Used to enable and disable ARM ints.
 int interrupts_enableArmInts();
 int interrupts_disableArmInts();
 
+// Hooks for measuring the interrupts from outside of this file (e.g., src/laserTag/isrJitter.c). NULL removes a hook.
+// timerIsr() calls the entry hook before anything else, with the private-timer counter value.
+void interrupts_setTimerIsrEntryHook(void (*hook)(uint32_t privateTimerCounterValue));
+// Called with true right after the ARM ints are enabled and with false right before they are disabled.
+void interrupts_setArmIntsHook(void (*hook)(bool enabled));
+
 // Useeed to enable and disable the global timer int output.
 int interrupts_enableTimerGlobalInts();
 int interrupts_disableTimerGlobalInts();
@@ -40,6 +50,8 @@ int interrupts_stopArmPrivateTimer();
 u32 interrupts_getPrivateTimerCounterValue(void);
 void interrupts_setPrivateTimerLoadValue(u32 loadValue);
 void interrupts_setPrivateTimerPrescalerValue(u32 prescalerValue);
+u32 interrupts_getPrivateTimerLoadValue();
+u32 interrupts_getPrivateTimerPrescalerValue();
 
 // Globally enable/disable SysMon interrupts.
 int interrupts_enableSysMonGlobalInts();
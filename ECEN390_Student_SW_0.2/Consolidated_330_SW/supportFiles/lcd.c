@@ -8,11 +8,23 @@
 #include "lcd.h"
 #include "arduinoTypes.h"
 #include "mio.h"
+#include "xil_io.h"
 
 static XGpio gpioTftControl;  // Provides the RD, WR and CD pins for the LCD controller.
 static XGpio gpioTftDataBus;  // Provides an 8-bit data bus for the LCD controller.
 static bool initFlag = false; // Make sure that body of init routine only gets invoked once.
 
+#ifndef LCD_USE_XGPIO_DRIVER
+// Nothing else writes the control GPIO, so a copy of its data register replaces the read half of every
+// read-modify-write, and the data registers are written directly instead of through XGpio_DiscreteWrite().
+static uint32_t controlShadow;      // What is in the control data register.
+static uint32_t controlDataAddress; // Channel 1 data registers.
+static uint32_t dataBusDataAddress;
+
+#define WRITE_CONTROL() Xil_Out32(controlDataAddress, controlShadow)
+#define WRITE_DATA_BUS(value) Xil_Out32(dataBusDataAddress, (value))
+#endif
+
 // This init intializes all of the hardware that talks to the LCD panel.
 void LCD_init() {
 //  printf("LCD_init called.\n\r");
@@ -30,6 +42,11 @@ void LCD_init() {
   // Set the direction for all signals to be outputs (0 = output, 1 = input).
   XGpio_SetDataDirection(&gpioTftControl, 1, 0);  // Control bits are always outputs.
   XGpio_SetDataDirection(&gpioTftDataBus, 1, 0);  // Set up data-bus direction as output (write).
+#ifndef LCD_USE_XGPIO_DRIVER
+  controlDataAddress = gpioTftControl.BaseAddress + XGPIO_DATA_OFFSET;
+  dataBusDataAddress = gpioTftDataBus.BaseAddress + XGPIO_DATA_OFFSET;
+  controlShadow = Xil_In32(controlDataAddress);  // Only read once, from here on the shadow is the truth.
+#endif
   mio_init(true);
   LCD_negateRd();  // negate the RD control signal.
   LCD_negateWr();  // negate the WR control signal.
@@ -38,38 +55,68 @@ void LCD_init() {
 
 // Sets the logic value on the command/data pin for the LCD controller to command mode.
 void LCD_setCommandMode() {
+#ifdef LCD_USE_XGPIO_DRIVER
   uint32_t regValue = XGpio_DiscreteRead(&gpioTftControl, 1);
   XGpio_DiscreteWrite(&gpioTftControl, 1, regValue & ~LCD_DCX_BIT_MASK);  // Clears the DCX bit.
+#else
+  controlShadow &= ~LCD_DCX_BIT_MASK;  // Clears the DCX bit.
+  WRITE_CONTROL();
+#endif
 }
 
 // Sets the logic value on the command/data pin for the LCD controller to data mode.
 void LCD_setDataMode() {
+#ifdef LCD_USE_XGPIO_DRIVER
   uint32_t regValue = XGpio_DiscreteRead(&gpioTftControl, 1);
   XGpio_DiscreteWrite(&gpioTftControl, 1, regValue | LCD_DCX_BIT_MASK);  // Sets the DCX bit.
+#else
+  controlShadow |= LCD_DCX_BIT_MASK;  // Sets the DCX bit.
+  WRITE_CONTROL();
+#endif
 }
 
 // Set the logic value on the LCD RD pin for read operations for the LCD data bus.
 void LCD_assertRd() {
+#ifdef LCD_USE_XGPIO_DRIVER
   uint32_t regValue = XGpio_DiscreteRead(&gpioTftControl, 1);
   XGpio_DiscreteWrite(&gpioTftControl, 1, regValue & ~LCD_RD_BIT_MASK);  // Asserts RD
+#else
+  controlShadow &= ~LCD_RD_BIT_MASK;  // Asserts RD
+  WRITE_CONTROL();
+#endif
 }
 
 // Set the logic value on the LCD RD pin to disable read operations on the LCD data bus.
 void LCD_negateRd() {
+#ifdef LCD_USE_XGPIO_DRIVER
   uint32_t regValue = XGpio_DiscreteRead(&gpioTftControl, 1);
   XGpio_DiscreteWrite(&gpioTftControl, 1, regValue | LCD_RD_BIT_MASK);  // Negates RD
+#else
+  controlShadow |= LCD_RD_BIT_MASK;  // Negates RD
+  WRITE_CONTROL();
+#endif
 }
 
 // Set the logic value on the LCD WR pin to enable write operations on the LCD data bus.
 void LCD_assertWr() {
+#ifdef LCD_USE_XGPIO_DRIVER
   uint32_t regValue = XGpio_DiscreteRead(&gpioTftControl, 1);
   XGpio_DiscreteWrite(&gpioTftControl, 1, regValue & ~LCD_WR_BIT_MASK);  // Asserts WR
+#else
+  controlShadow &= ~LCD_WR_BIT_MASK;  // Asserts WR
+  WRITE_CONTROL();
+#endif
 }
 
 // Set the logic value on the LCD WR pin to disable write operations on the LCD data bus.
 void LCD_negateWr() {
+#ifdef LCD_USE_XGPIO_DRIVER
   uint32_t regValue = XGpio_DiscreteRead(&gpioTftControl, 1);
   XGpio_DiscreteWrite(&gpioTftControl, 1, regValue | LCD_WR_BIT_MASK);  // Negates WR
+#else
+  controlShadow |= LCD_WR_BIT_MASK;  // Negates WR
+  WRITE_CONTROL();
+#endif
 }
 
 
@@ -114,9 +161,38 @@ void LCD_setWriteDataDirection() {
 
 // Writes 8 bits to the TFT controller.
 void LCD_write8(uint8_t value){
+#ifdef LCD_USE_XGPIO_DRIVER
   LCD_assertWr();               // Assert the WR line.
   LCD_writeData(value);         // Copy the data out to the MIO pins.
   LCD_negateWr();               // Negate WR.
+#else
+  // The controller latches on the rising edge of WR, so the data can go out first. Three bus writes in all.
+  WRITE_DATA_BUS(value);
+  uint32_t wrNegated = controlShadow | LCD_WR_BIT_MASK;
+  Xil_Out32(controlDataAddress, wrNegated & ~LCD_WR_BIT_MASK);
+  Xil_Out32(controlDataAddress, wrNegated);
+  controlShadow = wrNegated;
+#endif
+}
+
+// Writes length bytes to the TFT controller, same as calling LCD_write8() on each.
+void LCD_writeBurst(const uint8_t* data, size_t length) {
+#ifdef LCD_USE_XGPIO_DRIVER
+  while (length--)
+    LCD_write8(*data++);
+#else
+  // The control values are computed once and kept in registers for the whole burst.
+  uint32_t wrNegated = controlShadow | LCD_WR_BIT_MASK;
+  uint32_t wrAsserted = wrNegated & ~LCD_WR_BIT_MASK;
+  uint32_t controlAddress = controlDataAddress;
+  uint32_t dataAddress = dataBusDataAddress;
+  while (length--) {
+    Xil_Out32(dataAddress, *data++);
+    Xil_Out32(controlAddress, wrAsserted);
+    Xil_Out32(controlAddress, wrNegated);
+  }
+  controlShadow = wrNegated;
+#endif
 }
 
 // Reads 8 bits from the TFT controller.
@@ -129,6 +205,15 @@ uint8_t LCD_read8(){
 
 // Write cycle time requires at least a minimum of 66 ns for a write-strobe.
 void LCD_strobeWriteLine(){
+#ifndef LCD_USE_XGPIO_DRIVER
+  if (controlShadow & LCD_WR_BIT_MASK) {  // Already negated, skip the first write.
+    controlShadow &= ~LCD_WR_BIT_MASK;
+    WRITE_CONTROL();
+    controlShadow |= LCD_WR_BIT_MASK;
+    WRITE_CONTROL();
+    return;
+  }
+#endif
   LCD_negateWr();             // Make sure it is negated.
   LCD_assertWr();             // Assert it.
 //  LCD_delay10Nanoseconds(4);  // Wait for 40 ns.
@@ -138,7 +223,11 @@ void LCD_strobeWriteLine(){
 
 // Copies the argument value to the MIO pins serving as data pins for the LCD.
 void LCD_writeData(uint8_t value) {
+#ifdef LCD_USE_XGPIO_DRIVER
 	XGpio_DiscreteWrite(&gpioTftDataBus, 1, value);  // Perform the write using Xilinx GPIO call.
+#else
+	WRITE_DATA_BUS(value);
+#endif
 }
 
 // Copies the value from the MIO pins serving as the data pins for the LCD.
@@ -14,6 +14,12 @@
 
 // Provides an API to read/write the LCD controller.
 
+// By default the control pins are kept in a shadow copy of the control GPIO data register, and both GPIO data
+// registers are written with Xil_Out32(), one bus write per pin change. Uncomment to go back to the Xilinx driver's
+// read-modify-write calls (two bus accesses plus the driver overhead per pin change), e.g., to compare fill rates
+// with display_testFillRate().
+//#define LCD_USE_XGPIO_DRIVER
+
 // Processor clock is 650 MHz. Clock period = 1.54 ns.
 #define LCD_10_NANOSECOND_DELAY_COUNT    1       // Should be approximately 10 ns.
 #define LCD_MICROSECOND_DELAY_COUNT    649       // Should be approximately 1 microsecond.
@@ -42,6 +48,7 @@ void LCD_delay10Nanoseconds(uint16_t delay);  // delay in 15 ns chunks
 
 // These calls are related to the data bus pins (GPIO) that are connected to the LCD controller.
 void LCD_write8(uint8_t value);              // Writes 8 bits to the TFT controller.
+void LCD_writeBurst(const uint8_t* data, size_t length);  // Writes length bytes, WR strobed for each.
 uint8_t LCD_read8();                         // Reads 8 bits from the TFT controller.
 void LCD_setCommandMode();
 void LCD_setDataMode();